@@ -7,24 +7,24 @@
  * 25 July 2006
  */
 
+#include <sys/time.h>
+
 #include "BrokerageHouse.h"
-#include "CommonStructs.h"
-#include "DBConnection.h"
-#include "DBConnectionClientSide.h"
-#include "DBConnectionServerSide.h"
-
-#include "BrokerVolumeDB.h"
-#include "CustomerPositionDB.h"
-#include "DataMaintenanceDB.h"
-#include "MarketFeedDB.h"
-#include "MarketWatchDB.h"
-#include "SecurityDetailDB.h"
-#include "TradeCleanupDB.h"
-#include "TradeLookupDB.h"
-#include "TradeOrderDB.h"
-#include "TradeResultDB.h"
-#include "TradeStatusDB.h"
-#include "TradeUpdateDB.h"
+#include "DBConnectionNull.h"
+#include "DBStatsSampler.h"
+#include "InProcessMarket.h"
+#include "PlanCapture.h"
+#include "Probes.h"
+#include "TxnExecutor.h"
+#include "WaitEventSampler.h"
+
+static INT64
+microsecondsNow()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (INT64) tv.tv_sec * 1000000 + tv.tv_usec;
+}
 
 void *
 workerThread(void *data)
@@ -37,70 +37,27 @@ workerThread(void *data)
 	PMsgDriverBrokerage pMessage = new TMsgDriverBrokerage;
 	memset(pMessage, 0, sizeof(TMsgDriverBrokerage)); // zero the structure
 
-	CDBConnection *pDBConnection = NULL;
+	CSendToMarket *pSendToMarket = NULL;
+	CInProcessMarketClient *pMarketClient = NULL;
+	CTxnExecutor *pExecutor = NULL;
 
 	try {
 		TMsgBrokerageDriver Reply; // return message
-		INT32 iRet = 0; // transaction return code
-
-		// new database connection
-		if (pThrParam->pBrokerageHouse->m_ClientSide == 1) {
-			pDBConnection = new CDBConnectionClientSide(
-					pThrParam->pBrokerageHouse->m_szHost,
-					pThrParam->pBrokerageHouse->m_szDBName,
-					pThrParam->pBrokerageHouse->m_szDBPort,
-					pThrParam->pBrokerageHouse->verbose());
+
+		// Trade requests go over a connection of this thread's own to the
+		// market, or onto the queue of the in-process market.
+		CSendToMarketInterface *pMarket;
+		if (pThrParam->pBrokerageHouse->m_pMarket == NULL) {
+			pSendToMarket = new CSendToMarket(
+					&(pThrParam->pBrokerageHouse->m_fLog),
+					pThrParam->m_szMEEHost, atoi(pThrParam->m_szMEEPort));
+			pMarket = pSendToMarket;
 		} else {
-			pDBConnection = new CDBConnectionServerSide(
-					pThrParam->pBrokerageHouse->m_szHost,
-					pThrParam->pBrokerageHouse->m_szDBName,
-					pThrParam->pBrokerageHouse->m_szDBPort,
-					pThrParam->pBrokerageHouse->verbose());
+			pMarketClient = new CInProcessMarketClient(
+					pThrParam->pBrokerageHouse->m_pMarket);
+			pMarket = pMarketClient;
 		}
-		pDBConnection->setBrokerageHouse(pThrParam->pBrokerageHouse);
-		CSendToMarket sendToMarket
-				= CSendToMarket(&(pThrParam->pBrokerageHouse->m_fLog),
-						pThrParam->m_szMEEHost, atoi(pThrParam->m_szMEEPort));
-		CMarketFeedDB marketFeedDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CMarketFeed marketFeed = CMarketFeed(&marketFeedDB, &sendToMarket);
-		CTradeOrderDB tradeOrderDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CTradeOrder tradeOrder = CTradeOrder(&tradeOrderDB, &sendToMarket);
-
-		// Initialize all classes that will be used to execute transactions.
-		CBrokerVolumeDB brokerVolumeDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CBrokerVolume brokerVolume = CBrokerVolume(&brokerVolumeDB);
-		CCustomerPositionDB customerPositionDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CCustomerPosition customerPosition
-				= CCustomerPosition(&customerPositionDB);
-		CMarketWatchDB marketWatchDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CMarketWatch marketWatch = CMarketWatch(&marketWatchDB);
-		CSecurityDetailDB securityDetailDB = CSecurityDetailDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CSecurityDetail securityDetail = CSecurityDetail(&securityDetailDB);
-		CTradeLookupDB tradeLookupDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CTradeLookup tradeLookup = CTradeLookup(&tradeLookupDB);
-		CTradeStatusDB tradeStatusDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CTradeStatus tradeStatus = CTradeStatus(&tradeStatusDB);
-		CTradeUpdateDB tradeUpdateDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CTradeUpdate tradeUpdate = CTradeUpdate(&tradeUpdateDB);
-		CDataMaintenanceDB dataMaintenanceDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CDataMaintenance dataMaintenance
-				= CDataMaintenance(&dataMaintenanceDB);
-		CTradeCleanupDB tradeCleanupDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CTradeCleanup tradeCleanup = CTradeCleanup(&tradeCleanupDB);
-		CTradeResultDB tradeResultDB(
-				pDBConnection, pThrParam->pBrokerageHouse->verbose());
-		CTradeResult tradeResult = CTradeResult(&tradeResultDB);
+		pExecutor = new CTxnExecutor(pThrParam->pBrokerageHouse, pMarket);
 
 		do {
 			try {
@@ -134,115 +91,26 @@ workerThread(void *data)
 				break;
 			}
 
-			// Serialization failures and deadlocks abort the whole
-			// transaction; retry it instead of counting it as the
-			// intentional TPC-E rollback.
-			bool bRetry;
-			int nRetries = 0;
-			do {
-				bRetry = false;
-				try {
-					//  Parse Txn type
-					switch (pMessage->TxnType) {
-					case BROKER_VOLUME:
-						iRet = pThrParam->pBrokerageHouse->RunBrokerVolume(
-								&(pMessage->TxnInput.BrokerVolumeTxnInput),
-								brokerVolume);
-						break;
-					case CUSTOMER_POSITION:
-						iRet = pThrParam->pBrokerageHouse->RunCustomerPosition(
-								&(pMessage->TxnInput.CustomerPositionTxnInput),
-								customerPosition);
-						if (iRet != 0)
-							pDBConnection->rollback();
-						break;
-					case MARKET_FEED:
-						iRet = pThrParam->pBrokerageHouse->RunMarketFeed(
-								&(pMessage->TxnInput.MarketFeedTxnInput),
-								marketFeed);
-						break;
-					case MARKET_WATCH:
-						iRet = pThrParam->pBrokerageHouse->RunMarketWatch(
-								&(pMessage->TxnInput.MarketWatchTxnInput),
-								marketWatch);
-						break;
-					case SECURITY_DETAIL:
-						iRet = pThrParam->pBrokerageHouse->RunSecurityDetail(
-								&(pMessage->TxnInput.SecurityDetailTxnInput),
-								securityDetail);
-						break;
-					case TRADE_LOOKUP:
-						iRet = pThrParam->pBrokerageHouse->RunTradeLookup(
-								&(pMessage->TxnInput.TradeLookupTxnInput),
-								tradeLookup);
-						break;
-					case TRADE_ORDER:
-						iRet = pThrParam->pBrokerageHouse->RunTradeOrder(
-								&(pMessage->TxnInput.TradeOrderTxnInput),
-								tradeOrder);
-						break;
-					case TRADE_RESULT:
-						iRet = pThrParam->pBrokerageHouse->RunTradeResult(
-								&(pMessage->TxnInput.TradeResultTxnInput),
-								tradeResult);
-						if (iRet != 0)
-							pDBConnection->rollback();
-						break;
-					case TRADE_STATUS:
-						iRet = pThrParam->pBrokerageHouse->RunTradeStatus(
-								&(pMessage->TxnInput.TradeStatusTxnInput),
-								tradeStatus);
-						break;
-					case TRADE_UPDATE:
-						iRet = pThrParam->pBrokerageHouse->RunTradeUpdate(
-								&(pMessage->TxnInput.TradeUpdateTxnInput),
-								tradeUpdate);
-						break;
-					case DATA_MAINTENANCE:
-						iRet = pThrParam->pBrokerageHouse->RunDataMaintenance(
-								&(pMessage->TxnInput.DataMaintenanceTxnInput),
-								dataMaintenance);
-						break;
-					case TRADE_CLEANUP:
-						iRet = pThrParam->pBrokerageHouse->RunTradeCleanup(
-								&(pMessage->TxnInput.TradeCleanupTxnInput),
-								tradeCleanup);
-						break;
-					default:
-						cout << "wrong txn type" << endl;
-						iRet = ERR_TYPE_WRONGTXN;
-					}
-				} catch (CDBRetryableError &e) {
-					if (++nRetries <= iMaxRetries) {
-						bRetry = true;
-					} else {
-						pid_t pid = syscall(SYS_gettid);
-						ostringstream msg;
-						msg << time(NULL) << " " << pid << " "
-							<< szTransactionName[pMessage->TxnType]
-							<< " giving up after " << iMaxRetries
-							<< " retries " << e << endl;
-						pThrParam->pBrokerageHouse->logErrorMessage(msg.str());
-						iRet = CBaseTxnErr::EXPECTED_ROLLBACK;
-					}
-				} catch (std::string const &e) {
-					pid_t pid = syscall(SYS_gettid);
-					ostringstream msg;
-					msg << time(NULL) << " " << pid << " "
-						<< szTransactionName[pMessage->TxnType] << " " << e
-						<< endl;
-					pThrParam->pBrokerageHouse->logErrorMessage(msg.str());
-					iRet = CBaseTxnErr::EXPECTED_ROLLBACK;
-				}
-			} while (bRetry);
-
-			if (iRet < 0)
-				cerr << "INVALID RUN : see "
-					 << pThrParam->pBrokerageHouse->errorLogFilename()
-					 << " for transaction details" << endl;
+			// Time the stages of sampled requests, and tag the trade
+			// requests they send so the MEE can sample what follows.
+			memset(&Reply, 0, sizeof(Reply));
+			if (pMessage->bSample)
+				Reply.iReceived = microsecondsNow();
+			INT64 iTxnId = pMessage->bSample ? pMessage->iTxnId : 0;
+			if (pSendToMarket != NULL)
+				pSendToMarket->setTxnId(iTxnId);
+			else
+				pMarketClient->setTxnId(iTxnId);
+
+			DBT5_PROBE2(bh__request__start, pMessage->iTxnId,
+					pMessage->TxnType);
+			Reply.iStatus = pExecutor->execute(pMessage, &Reply.iDBStart);
+			DBT5_PROBE3(bh__request__done, pMessage->iTxnId,
+					pMessage->TxnType, Reply.iStatus);
+			if (pMessage->bSample)
+				Reply.iDBEnd = microsecondsNow();
 
 			// send status to driver
-			Reply.iStatus = iRet;
 			try {
 				sockDrv.dbt5Send(
 						reinterpret_cast<void *>(&Reply), sizeof(Reply));
@@ -273,7 +141,9 @@ workerThread(void *data)
 	// close socket connection with the driver, if not already closed by
 	// an error path above
 	sockDrv.dbt5Disconnect();
-	delete pDBConnection;
+	delete pExecutor;
+	delete pSendToMarket;
+	delete pMarketClient;
 	delete pThrParam;
 	delete pMessage;
 	return NULL;
@@ -327,7 +197,9 @@ CBrokerageHouse::CBrokerageHouse(const char *szHost, const char *szDBName,
 		const char *szDBPort, const char *szMEEHost, const char *szMEEPort,
 		const int iListenPort, char *outputDirectory, int iClientSide,
 		bool verbose = false)
-: m_iListenPort(iListenPort), m_ClientSide(iClientSide), m_Verbose(verbose)
+: m_iListenPort(iListenPort), m_ClientSide(iClientSide), m_pNullDB(NULL),
+  m_Verbose(verbose), m_pMarket(NULL), m_pStatsSampler(NULL),
+  m_pWaitSampler(NULL), m_pPlanCapture(NULL)
 {
 	strncpy(m_szHost, szHost, iMaxHostname);
 	m_szHost[iMaxHostname] = '\0';
@@ -350,6 +222,11 @@ CBrokerageHouse::CBrokerageHouse(const char *szHost, const char *szDBName,
 CBrokerageHouse::~CBrokerageHouse()
 {
 	m_Socket.closeListenerSocket();
+	delete m_pPlanCapture;
+	delete m_pWaitSampler;
+	delete m_pStatsSampler;
+	delete m_pMarket;
+	delete m_pNullDB;
 	m_fLog.close();
 }
 
@@ -1018,6 +895,44 @@ CBrokerageHouse::RunTradeUpdate(
 	return tuOutput.status;
 }
 
+void
+CBrokerageHouse::startInProcessMarket(const char *szFileLoc,
+		TIdent iConfiguredCustomerCount, TIdent iActiveCustomerCount,
+		int iExecutors, char *outputDirectory)
+{
+	m_pMarket = new CInProcessMarket(this, szFileLoc,
+			iConfiguredCustomerCount, iActiveCustomerCount, iExecutors,
+			outputDirectory);
+}
+
+void
+CBrokerageHouse::useNullDatabase(const TNullDBSettings &settings)
+{
+	delete m_pNullDB;
+	m_pNullDB = new TNullDBSettings(settings);
+}
+
+void
+CBrokerageHouse::startStatsSampler(int iInterval, char *outputDirectory)
+{
+	m_pStatsSampler = new CDBStatsSampler(this,
+			CTxnExecutor::newDBConnection(this), outputDirectory, iInterval);
+}
+
+void
+CBrokerageHouse::startWaitEventSampler(int iInterval, char *outputDirectory)
+{
+	m_pWaitSampler = new CWaitEventSampler(this,
+			CTxnExecutor::newDBConnection(this), outputDirectory, iInterval);
+}
+
+void
+CBrokerageHouse::startPlanCapture(int iThreshold, char *outputDirectory)
+{
+	m_pPlanCapture = new CPlanCapture(this,
+			CTxnExecutor::newDBConnection(this), outputDirectory, iThreshold);
+}
+
 // Listener
 void
 CBrokerageHouse::startListener(void)
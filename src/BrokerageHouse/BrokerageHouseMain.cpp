@@ -11,7 +11,9 @@
 #include <unistd.h>
 
 #include "BrokerageHouse.h"
+#include "DBConnectionNull.h"
 #include "DBT5Consts.h"
+#include "InProcessMarket.h"
 
 // Establish defaults for command line option
 int iClientSide = 0;
@@ -24,6 +26,18 @@ char szDBPort[iMaxPort + 1] = "";
 char szMEEHost[iMaxHostname + 1] = "localhost";
 char szMEEPort[iMaxPort + 1] = "";
 char outputDirectory[iMaxPath + 1] = ".";
+int iStatsInterval = 0; // seconds between database statistics samples
+int iWaitInterval = 0; // milliseconds between wait event samples
+int iPlanThreshold = 0; // milliseconds a statement takes to have its plan
+bool bNullDB = false;
+TNullDBSettings NullDBSettings;
+
+// In-process Market Exchange Emulator, used when the EGen flat_in directory
+// is given
+char szFileLoc[iMaxPath + 1] = "";
+TIdent iConfiguredCustomerCount = iDefaultCustomerCount;
+TIdent iActiveCustomerCount = iDefaultCustomerCount;
+int iMarketExecutors = iDefaultMarketExecutors;
 
 // shows program usage
 void
@@ -33,15 +47,47 @@ usage()
 	cout << "   Option      Default    Description" << endl;
 	cout << "   =========   =========  ===============" << endl;
 	cout << "   -1                     Use client-side app logic" << endl;
+	printf("   -c integer  %-9ld  Active customer count, in-process MEE\n",
+			iActiveCustomerCount);
 	cout << "   -d string              Database name" << endl;
+	printf("   -e integer  %-9d  Milliseconds between wait event samples,\n",
+			iWaitInterval);
+	cout << "                          0 for none" << endl;
 	cout << "   -h string   localhost  Database server" << endl;
+	cout << "   -i string              EGen flat_in directory, runs the"
+		 << endl
+		 << "                          Market Exchange Emulator in-process"
+		 << endl;
 	printf("   -l integer  %-9d  Socket listen port\n", iListenPort);
 	printf("   -m string   %9s  Market Exchange Emulator hostname\n",
 			szMEEHost);
 	printf("   -M integer  %9s  Market Exchange Emulator port\n", szMEEPort);
+	cout << "   -n                     Use no database, answer every frame"
+		 << endl
+		 << "                          with made up rows" << endl;
+	cout << "   -N name=value          Setting of no database: latency,"
+		 << endl
+		 << "                          customer, broker, first-trade,"
+		 << endl
+		 << "                          trades or symbols, see dbt5-run(1)"
+		 << endl;
 	cout << "   -o string   .          Output directory" << endl;
 	cout << "   -p integer             Database port" << endl;
+	printf("   -s integer  %-9d  Seconds between database statistics\n",
+			iStatsInterval);
+	cout << "                          samples, 0 for none" << endl;
+	printf("   -t integer  %-9ld  Configured customer count, in-process MEE\n",
+			iConfiguredCustomerCount);
+	printf("   -u integer  %-9d  Microseconds each frame takes, no database\n",
+			NullDBSettings.iLatency);
 	cout << "   -v                     Verbose output" << endl;
+	printf("   -x integer  %-9d  Capture the plans of statements slower\n",
+			iPlanThreshold);
+	cout << "                          than this in milliseconds, 0 for none"
+		 << endl;
+	printf("   -w integer  %-9d  Trade-Result and Market-Feed threads,\n",
+			iMarketExecutors);
+	cout << "                          in-process MEE" << endl;
 	cout << endl;
 }
 
@@ -53,19 +99,34 @@ parse_command_line(int argc, char *argv[])
 
 	// getopt reports missing option arguments and unknown options,
 	// unlike the old hand rolled parser, which silently accepted them.
-	while ((ch = getopt(argc, argv, "1d:h:l:m:M:o:p:v")) != -1) {
+	while ((ch = getopt(argc, argv, "1c:d:e:h:i:l:m:M:nN:o:p:s:t:u:vw:x:"))
+			!= -1) {
 		switch (ch) {
 		case '1':
 			iClientSide = 1;
 			break;
+		case 'c':
+			iActiveCustomerCount = atol(optarg);
+			break;
 		case 'd': // Database name.
 			strncpy(szDBName, optarg, iMaxDBName);
 			szDBName[iMaxDBName] = '\0';
 			break;
+		case 'e':
+			iWaitInterval = atoi(optarg);
+			if (iWaitInterval < 0) {
+				cerr << "Error: invalid interval for -e: " << optarg << endl;
+				exit(1);
+			}
+			break;
 		case 'h': // Database host name.
 			strncpy(szHost, optarg, iMaxHostname);
 			szHost[iMaxHostname] = '\0';
 			break;
+		case 'i':
+			strncpy(szFileLoc, optarg, iMaxPath);
+			szFileLoc[iMaxPath] = '\0';
+			break;
 		case 'l':
 			iListenPort = atoi(optarg);
 			if (iListenPort < 1 || iListenPort > 65535) {
@@ -81,6 +142,15 @@ parse_command_line(int argc, char *argv[])
 			strncpy(szMEEPort, optarg, iMaxPort);
 			szMEEPort[iMaxPort] = '\0';
 			break;
+		case 'n':
+			bNullDB = true;
+			break;
+		case 'N':
+			if (!NullDBSettings.set(optarg)) {
+				cerr << "Error: invalid setting for -N: " << optarg << endl;
+				exit(1);
+			}
+			break;
 		case 'o': // output directory
 			strncpy(outputDirectory, optarg, iMaxPath);
 			outputDirectory[iMaxPath] = '\0';
@@ -89,9 +159,41 @@ parse_command_line(int argc, char *argv[])
 			strncpy(szDBPort, optarg, iMaxPort);
 			szDBPort[iMaxPort] = '\0';
 			break;
+		case 's':
+			iStatsInterval = atoi(optarg);
+			if (iStatsInterval < 0) {
+				cerr << "Error: invalid interval for -s: " << optarg << endl;
+				exit(1);
+			}
+			break;
+		case 't':
+			iConfiguredCustomerCount = atol(optarg);
+			break;
+		case 'u':
+			NullDBSettings.iLatency = atoi(optarg);
+			if (NullDBSettings.iLatency < 0) {
+				cerr << "Error: invalid latency for -u: " << optarg << endl;
+				exit(1);
+			}
+			break;
 		case 'v':
 			verbose = true;
 			break;
+		case 'w':
+			iMarketExecutors = atoi(optarg);
+			if (iMarketExecutors < 1) {
+				cerr << "Error: invalid number of threads for -w: " << optarg
+					 << endl;
+				exit(1);
+			}
+			break;
+		case 'x':
+			iPlanThreshold = atoi(optarg);
+			if (iPlanThreshold < 0) {
+				cerr << "Error: invalid threshold for -x: " << optarg << endl;
+				exit(1);
+			}
+			break;
 		default:
 			usage();
 			exit(1);
@@ -104,6 +206,13 @@ parse_command_line(int argc, char *argv[])
 			 << endl;
 		exit(1);
 	}
+
+	if (bNullDB
+			&& (iStatsInterval > 0 || iWaitInterval > 0
+					|| iPlanThreshold > 0)) {
+		cerr << "Error: -s, -e and -x need a database, not -n" << endl;
+		exit(1);
+	}
 }
 
 int
@@ -130,20 +239,65 @@ main(int argc, char *argv[])
 	delete[] pidFilename;
 
 	// Let the user know what settings will be used.
-	cout << "Using the following database settings:" << endl
-		 << "  Database hostname: " << szHost << endl
-		 << "  Database port: " << szDBPort << endl
-		 << "  Database name: " << szDBName << endl;
+	if (bNullDB) {
+		cout << "Using no database:" << endl
+			 << "  Microseconds each frame takes: " << NullDBSettings.iLatency
+			 << endl
+			 << "  Customer id: " << NullDBSettings.iCustomerId << endl
+			 << "  Broker id: " << NullDBSettings.iBrokerId << endl
+			 << "  First trade id: " << NullDBSettings.iFirstTradeId << endl
+			 << "  Trades kept: " << NullDBSettings.iMaxTrades << endl
+			 << "  Symbols kept: " << NullDBSettings.iMaxSymbols << endl;
+	} else {
+		cout << "Using the following database settings:" << endl
+			 << "  Database hostname: " << szHost << endl
+			 << "  Database port: " << szDBPort << endl
+			 << "  Database name: " << szDBName << endl;
+	}
 
-	cout << "Using the following Market Exchange Emulator settings:" << endl
-		 << "  Hostname: " << szMEEHost << endl
-		 << "  Port: " << szMEEPort << endl;
+	cout << "Using the following Market Exchange Emulator settings:" << endl;
+	if (szFileLoc[0] == '\0') {
+		cout << "  Hostname: " << szMEEHost << endl
+			 << "  Port: " << szMEEPort << endl;
+	} else {
+		cout << "  In-process" << endl
+			 << "  EGen flat_in directory location: " << szFileLoc << endl
+			 << "  Configured customer count: " << iConfiguredCustomerCount
+			 << endl
+			 << "  Active customer count: " << iActiveCustomerCount << endl
+			 << "  Trade-Result and Market-Feed threads: " << iMarketExecutors
+			 << endl;
+	}
+
+	if (iStatsInterval > 0)
+		cout << "Sampling database statistics every " << iStatsInterval
+			 << " seconds" << endl;
+	if (iWaitInterval > 0)
+		cout << "Sampling wait events every " << iWaitInterval
+			 << " milliseconds" << endl;
+	if (iPlanThreshold > 0)
+		cout << "Capturing the plans of statements slower than "
+			 << iPlanThreshold << " milliseconds" << endl;
 
 	CBrokerageHouse BrokerageHouse(szHost, szDBName, szDBPort, szMEEHost,
 			szMEEPort, iListenPort, outputDirectory, iClientSide, verbose);
-	cout << "Brokerage House opened for business, waiting for traders..."
-		 << endl;
+	if (bNullDB)
+		BrokerageHouse.useNullDatabase(NullDBSettings);
 	try {
+		// Before any connections are made, so they are all watched.
+		if (iPlanThreshold > 0)
+			BrokerageHouse.startPlanCapture(iPlanThreshold, outputDirectory);
+		if (szFileLoc[0] != '\0')
+			BrokerageHouse.startInProcessMarket(szFileLoc,
+					iConfiguredCustomerCount, iActiveCustomerCount,
+					iMarketExecutors, outputDirectory);
+		if (iStatsInterval > 0)
+			BrokerageHouse.startStatsSampler(iStatsInterval, outputDirectory);
+		if (iWaitInterval > 0)
+			BrokerageHouse.startWaitEventSampler(
+					iWaitInterval, outputDirectory);
+		cout << "Brokerage House opened for business, waiting for traders..."
+			 << endl;
 		BrokerageHouse.startListener();
 	} catch (CBaseErr *pErr) {
 		cout << "Error " << pErr->ErrorNum() << ": " << pErr->ErrorText();
@@ -152,6 +306,13 @@ main(int argc, char *argv[])
 		}
 		cout << endl;
 		return 1;
+	} catch (CBaseErr &err) {
+		cout << "Error " << err.ErrorNum() << ": " << err.ErrorText();
+		if (err.ErrorLoc()) {
+			cout << " at " << err.ErrorLoc();
+		}
+		cout << endl;
+		return 1;
 	} catch (std::bad_alloc const &) {
 		// operator new will throw std::bad_alloc exception if there is not
 		// sufficient memory for the request.
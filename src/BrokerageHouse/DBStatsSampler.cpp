@@ -0,0 +1,188 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include "DBStatsSampler.h"
+#include "CThreadErr.h"
+
+typedef struct TStatsView
+{
+	const char *name;
+	const char *sql;
+} *PStatsView;
+
+// Only the columns worth charting, to keep the files small.
+static const TStatsView statsViews[] = {
+	{ "database",
+			"SELECT numbackends, xact_commit, xact_rollback, blks_read, "
+			"blks_hit, tup_returned, tup_fetched, tup_inserted, "
+			"tup_updated, tup_deleted, conflicts, temp_files, temp_bytes, "
+			"deadlocks\n"
+			"FROM pg_stat_database\n"
+			"WHERE datname = current_database()" },
+	{ "tables",
+			"SELECT relname, seq_scan, seq_tup_read, idx_scan, "
+			"idx_tup_fetch, n_tup_ins, n_tup_upd, n_tup_del, n_tup_hot_upd, "
+			"n_live_tup, n_dead_tup, vacuum_count, autovacuum_count, "
+			"analyze_count, autoanalyze_count\n"
+			"FROM pg_stat_user_tables\n"
+			"ORDER BY relname" },
+	{ "io",
+			"SELECT backend_type, object, context, reads, writes, extends, "
+			"hits, evictions, reuses, fsyncs\n"
+			"FROM pg_stat_io\n"
+			"ORDER BY backend_type, object, context" },
+	{ "wal",
+			"SELECT wal_records, wal_fpi, wal_bytes, wal_buffers_full\n"
+			"FROM pg_stat_wal" },
+	{ "locks",
+			"SELECT locktype, mode, granted, count(*)\n"
+			"FROM pg_locks\n"
+			"WHERE pid <> pg_backend_pid()\n"
+			"GROUP BY locktype, mode, granted\n"
+			"ORDER BY locktype, mode, granted" },
+};
+
+static const int iStatsViews = sizeof(statsViews) / sizeof(statsViews[0]);
+
+void *
+dbStatsSamplerThread(void *data)
+{
+	reinterpret_cast<CDBStatsSampler *>(data)->run();
+	return NULL;
+}
+
+CDBStatsSampler::CDBStatsSampler(CBrokerageHouse *pBrokerageHouse,
+		CDBConnection *pDBConnection, const char *outputDirectory,
+		int iInterval)
+: m_pBrokerageHouse(pBrokerageHouse), m_pDBConnection(pDBConnection),
+  m_iInterval(iInterval), m_StopCond(m_StopLock), m_bStop(false)
+{
+	for (int i = 0; i < iStatsViews; i++) {
+		char filename[iMaxPath + 1];
+		snprintf(filename, sizeof(filename), "%s/dbstat-%s.csv",
+				outputDirectory, statsViews[i].name);
+		m_files.push_back(new ofstream(filename, ios::out));
+		m_headers.push_back(false);
+	}
+
+	if (pthread_create(&m_ThreadId, NULL, &dbStatsSamplerThread, this)
+			!= 0) {
+		throw CThreadErr(
+				CThreadErr::ERR_THREAD_CREATE, "CDBStatsSampler::ctor");
+	}
+}
+
+CDBStatsSampler::~CDBStatsSampler()
+{
+	m_StopCond.lock();
+	m_bStop = true;
+	m_StopCond.signal();
+	m_StopCond.unlock();
+	pthread_join(m_ThreadId, NULL);
+
+	for (size_t i = 0; i < m_files.size(); i++)
+		delete m_files[i];
+	delete m_pDBConnection;
+}
+
+void
+CDBStatsSampler::run()
+{
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	m_StopCond.lock();
+	while (!m_bStop) {
+		m_StopCond.unlock();
+		sample();
+		m_StopCond.lock();
+
+		next.tv_sec += m_iInterval;
+		while (!m_bStop) {
+			struct timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			long wait = (long) (next.tv_sec - now.tv_sec) * 1000000
+					+ (next.tv_nsec - now.tv_nsec) / 1000;
+			if (wait <= 0)
+				break;
+			m_StopCond.timedwait(wait);
+		}
+	}
+	m_StopCond.unlock();
+}
+
+// Every view of a sample gets the same time, taken before the first query.
+void
+CDBStatsSampler::sample()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	char szTime[32];
+	snprintf(szTime, sizeof(szTime), "%ld.%06ld", (long) tv.tv_sec,
+			(long) tv.tv_usec);
+
+	// Skip the sample if the server is still gone, try again next time.
+	if (!m_pDBConnection->connected()) {
+		m_pDBConnection->reconnect();
+		if (!m_pDBConnection->connected())
+			return;
+	}
+
+	for (int i = 0; i < iStatsViews; i++) {
+		ofstream *pFile = m_files[i];
+		if (pFile == NULL)
+			continue;
+
+		PGresult *res;
+		try {
+			res = m_pDBConnection->exec(statsViews[i].sql);
+		} catch (const CDBUndefinedError &e) {
+			// An older server without the view.
+			ostringstream msg;
+			msg << "Not sampling " << statsViews[i].name
+				<< " statistics any more:" << endl
+				<< e;
+			m_pBrokerageHouse->logErrorMessage(msg.str());
+			delete pFile;
+			m_files[i] = NULL;
+			continue;
+		} catch (const string &e) {
+			ostringstream msg;
+			msg << "Could not sample " << statsViews[i].name
+				<< " statistics, retrying next time:" << endl
+				<< e;
+			m_pBrokerageHouse->logErrorMessage(msg.str());
+			if (!m_pDBConnection->connected())
+				break;
+			continue;
+		}
+		PGresultHolder holder(res);
+
+		int iFields = PQnfields(res);
+		if (!m_headers[i]) {
+			*pFile << "time";
+			for (int j = 0; j < iFields; j++)
+				*pFile << "," << PQfname(res, j);
+			*pFile << endl;
+			m_headers[i] = true;
+		}
+
+		int iRows = PQntuples(res);
+		for (int j = 0; j < iRows; j++) {
+			*pFile << szTime;
+			for (int k = 0; k < iFields; k++)
+				*pFile << "," << PQgetvalue(res, j, k);
+			*pFile << "\n";
+		}
+		// The Brokerage House is usually killed at the end of a test.
+		pFile->flush();
+	}
+}
@@ -0,0 +1,318 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <time.h>
+#include <sys/time.h>
+
+#include "InProcessMarket.h"
+#include "Probes.h"
+#include "TxnExecutor.h"
+
+static INT64
+monotonicNanoseconds()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (INT64) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static INT64
+microsecondsNow()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (INT64) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+void *
+inProcessMarketThread(void *data)
+{
+	reinterpret_cast<CInProcessMarket *>(data)->runMarket();
+	return NULL;
+}
+
+void *
+inProcessExecutorThread(void *data)
+{
+	CInProcessMarket::PExecutorParam pParam
+			= reinterpret_cast<CInProcessMarket::PExecutorParam>(data);
+	pParam->pMarket->runExecutor(pParam->iExecutor);
+	delete pParam;
+	return NULL;
+}
+
+CInProcessMarket::CInProcessMarket(CBrokerageHouse *pBrokerageHouse,
+		const char *szFileLoc, TIdent iConfiguredCustomerCount,
+		TIdent iActiveCustomerCount, int iExecutors, char *outputDirectory)
+: m_pBrokerageHouse(pBrokerageHouse), m_OrderCond(m_OrderLock),
+  m_bMarketShutdown(false), m_WorkCond(m_WorkLock),
+  m_bExecutorShutdown(false), m_bTimerPending(false), m_iTimerDue(0)
+{
+	strncpy(m_szOutputDirectory, outputDirectory, iMaxPath);
+	m_szOutputDirectory[iMaxPath] = '\0';
+
+	char filename[iMaxPath + 1];
+	snprintf(filename, sizeof(filename), "%s/MarketExchange.log",
+			outputDirectory);
+	m_pLog = new CEGenLogger(eDriverEGenLoader, 0, filename, &m_fmt);
+
+	m_pInputFiles = new DataFileManager(szFileLoc, iConfiguredCustomerCount,
+			iActiveCustomerCount, TPCE::DataFileManager::IMMEDIATE_LOAD);
+	m_pCMEE = new CMEE(0, this, m_pLog, *m_pInputFiles, 1);
+	m_pCMEE->SetBaseTime();
+	m_pLatency = CLatencyLog::attach(outputDirectory);
+
+	if (pthread_create(&m_MarketThreadId, NULL, &inProcessMarketThread, this)
+			!= 0) {
+		throw CThreadErr(
+				CThreadErr::ERR_THREAD_CREATE, "CInProcessMarket::ctor");
+	}
+
+	for (int i = 0; i < iExecutors; i++) {
+		PExecutorParam pParam = new TExecutorParam;
+		pParam->pMarket = this;
+		pParam->iExecutor = i + 1;
+
+		pthread_t threadId;
+		if (pthread_create(&threadId, NULL, &inProcessExecutorThread, pParam)
+				!= 0) {
+			delete pParam;
+			throw CThreadErr(
+					CThreadErr::ERR_THREAD_CREATE, "CInProcessMarket::ctor");
+		}
+		m_ExecutorThreadIds.push_back(threadId);
+	}
+}
+
+CInProcessMarket::~CInProcessMarket()
+{
+	m_OrderCond.lock();
+	m_bMarketShutdown = true;
+	m_OrderCond.signal();
+	m_OrderCond.unlock();
+	pthread_join(m_MarketThreadId, NULL);
+
+	// The market thread is gone, so no more work is queued.  The executors
+	// finish what is queued before they stop.
+	m_WorkCond.lock();
+	m_bExecutorShutdown = true;
+	m_WorkCond.broadcast();
+	m_WorkCond.unlock();
+	for (size_t i = 0; i < m_ExecutorThreadIds.size(); i++)
+		pthread_join(m_ExecutorThreadIds[i], NULL);
+
+	CLatencyLog::detach();
+	delete m_pCMEE;
+	delete m_pInputFiles;
+	delete m_pLog;
+}
+
+bool
+CInProcessMarket::SendToMarket(TTradeRequest &trade_mes)
+{
+	return SendToMarket(trade_mes, 0);
+}
+
+bool
+CInProcessMarket::SendToMarket(TTradeRequest &trade_mes, INT64 iTxnId)
+{
+	TMarketOrder order;
+	order.request = trade_mes;
+	order.iTxnId = iTxnId;
+
+	m_OrderCond.lock();
+	m_orders.push_back(order);
+	if (m_orders.size() == 1)
+		m_OrderCond.signal();
+	m_OrderCond.unlock();
+
+	return true;
+}
+
+bool
+CInProcessMarket::TradeResult(PTradeResultTxnInput pTxnInput)
+{
+	TMsgDriverBrokerage request;
+	memset(&request, 0, sizeof(request));
+	request.TxnType = TRADE_RESULT;
+	DBT5_PROBE1(mee__trade__result, pTxnInput->trade_id);
+	memcpy(&(request.TxnInput.TradeResultTxnInput), pTxnInput,
+			sizeof(request.TxnInput.TradeResultTxnInput));
+
+	// Called on the market thread, which submitted the trade.
+	std::map<TTrade, INT64>::iterator it
+			= m_parents.find(pTxnInput->trade_id);
+	if (it != m_parents.end()) {
+		request.iParentTxnId = it->second;
+		m_parents.erase(it);
+	}
+
+	return queueWork(request);
+}
+
+bool
+CInProcessMarket::MarketFeed(PMarketFeedTxnInput pTxnInput)
+{
+	TMsgDriverBrokerage request;
+	memset(&request, 0, sizeof(request));
+	request.TxnType = MARKET_FEED;
+	DBT5_PROBE(mee__market__feed);
+	memcpy(&(request.TxnInput.MarketFeedTxnInput), pTxnInput,
+			sizeof(request.TxnInput.MarketFeedTxnInput));
+
+	return queueWork(request);
+}
+
+bool
+CInProcessMarket::queueWork(const TMsgDriverBrokerage &request)
+{
+	PMarketWork pWork = new TMarketWork;
+	pWork->request = request;
+	pWork->iQueued = monotonicNanoseconds();
+	pWork->iGenerated = microsecondsNow();
+
+	m_WorkCond.lock();
+	m_work.push_back(pWork);
+	m_WorkCond.signal();
+	m_WorkCond.unlock();
+
+	return true;
+}
+
+// Submit the queued trade requests and fire the MEE timers, as
+// MarketWorkerThread and MarketTimerThread do in MarketExchangeMain.  The
+// MEE is only used by this thread.
+void
+CInProcessMarket::runMarket()
+{
+	std::deque<TMarketOrder> orders;
+
+	while (true) {
+		m_OrderCond.lock();
+		while (m_orders.empty() && !m_bMarketShutdown) {
+			if (!m_bTimerPending) {
+				m_OrderCond.wait();
+				continue;
+			}
+			INT64 now = monotonicNanoseconds();
+			if (now >= m_iTimerDue)
+				break;
+			m_OrderCond.timedwait((long) ((m_iTimerDue - now + 999) / 1000));
+		}
+		if (m_bMarketShutdown) {
+			m_OrderCond.unlock();
+			break;
+		}
+		orders.swap(m_orders);
+		m_OrderCond.unlock();
+
+		for (size_t i = 0; i < orders.size(); i++) {
+			PTradeRequest pTradeRequest = &orders[i].request;
+			if (orders[i].iTxnId != 0)
+				m_parents[pTradeRequest->trade_id] = orders[i].iTxnId;
+			DBT5_PROBE2(mee__submit, pTradeRequest->trade_id,
+					orders[i].iTxnId);
+			scheduleTimer(m_pCMEE->SubmitTradeRequest(pTradeRequest));
+		}
+		orders.clear();
+
+		INT64 now = monotonicNanoseconds();
+		if (m_bTimerPending && now >= m_iTimerDue) {
+			DBT5_PROBE1(mee__timer, now - m_iTimerDue);
+			m_bTimerPending = false;
+			scheduleTimer(m_pCMEE->GenerateTradeResult());
+		}
+	}
+}
+
+// The MEE returns the milliseconds until its earliest timer, or a negative
+// number if none is pending.
+void
+CInProcessMarket::scheduleTimer(INT32 delay)
+{
+	if (delay < 0)
+		return;
+
+	m_bTimerPending = true;
+	m_iTimerDue = monotonicNanoseconds() + (INT64) delay * 1000000;
+}
+
+// Run the generated transactions on a database connection of this thread's
+// own.  Response times are measured from when the MEE generated the
+// transaction, which covers the time spent waiting for an executor.  The
+// transaction ids have the thread id in the high 32 bits, and a Trade-Result
+// is sampled when the request that sent its trade was.
+void
+CInProcessMarket::runExecutor(int iExecutor)
+{
+	INT64 iThreadId = (INT64) syscall(SYS_gettid);
+	UINT32 iSeq = 0;
+
+	// Named apart from the mix-me-<pid>.bin logs of MarketExchangeMain,
+	// which may write to the same directory.
+	char filename[iMaxPath + 1];
+	snprintf(filename, sizeof(filename), "%s/mix-ime-%d.bin",
+			m_szOutputDirectory, (int) iThreadId);
+	CMixLogWriter mix(filename);
+
+	CTxnExecutor executor(m_pBrokerageHouse, this);
+
+	while (true) {
+		m_WorkCond.lock();
+		while (m_work.empty() && !m_bExecutorShutdown)
+			m_WorkCond.wait();
+		if (m_work.empty()) {
+			m_WorkCond.unlock();
+			break;
+		}
+		PMarketWork pWork = m_work.front();
+		m_work.pop_front();
+		m_WorkCond.unlock();
+
+		PMsgDriverBrokerage pRequest = &pWork->request;
+		pRequest->iTxnId = (iThreadId << 32) | ++iSeq;
+		pRequest->bSample = pRequest->iParentTxnId != 0
+				|| iSeq % iStageSampleInterval == 0;
+
+		TMsgBrokerageDriver reply;
+		memset(&reply, 0, sizeof(reply));
+		if (pRequest->bSample)
+			reply.iReceived = microsecondsNow();
+		reply.iStatus = executor.execute(pRequest, &reply.iDBStart);
+		if (pRequest->bSample)
+			reply.iDBEnd = microsecondsNow();
+		double dRT = (double) (monotonicNanoseconds() - pWork->iQueued)
+				/ 1000000000.0;
+
+		mix.log(pRequest->TxnType, reply.iStatus, dRT, iExecutor,
+				(INT32) iSeq);
+		m_pLatency->record(pRequest->TxnType, reply.iStatus, dRT, iExecutor);
+		if (pRequest->bSample)
+			m_pLatency->stages(
+					pRequest, &reply, pWork->iGenerated, reply.iDBEnd);
+		delete pWork;
+	}
+
+	mix.logStop(iExecutor);
+}
+
+CInProcessMarketClient::CInProcessMarketClient(CInProcessMarket *pMarket)
+: m_pMarket(pMarket), m_iTxnId(0)
+{
+}
+
+bool
+CInProcessMarketClient::SendToMarket(TTradeRequest &trade_mes)
+{
+	return m_pMarket->SendToMarket(trade_mes, m_iTxnId);
+}
+
+void
+CInProcessMarketClient::setTxnId(INT64 iTxnId)
+{
+	m_iTxnId = iTxnId;
+}
@@ -0,0 +1,279 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "PlanCapture.h"
+#include "CThreadErr.h"
+#include "DBConnection.h"
+
+void *
+planCaptureThread(void *data)
+{
+	reinterpret_cast<CPlanCapture *>(data)->run();
+	return NULL;
+}
+
+// auto_explain sends the plans of the statements in the frame functions as
+// notices.
+void
+planCaptureNotice(void *data, const char *message)
+{
+	reinterpret_cast<CPlanCapture *>(data)->m_notices.append(message);
+}
+
+CPlanCapture::CPlanCapture(CBrokerageHouse *pBrokerageHouse,
+		CDBConnection *pDBConnection, const char *outputDirectory,
+		int iThreshold)
+: m_pBrokerageHouse(pBrokerageHouse), m_pDBConnection(pDBConnection),
+  m_dThreshold((double) iThreshold), m_QueueCond(m_QueueLock),
+  m_iDropped(0), m_bStop(false)
+{
+	char filename[iMaxPath + 1];
+	snprintf(filename, sizeof(filename), "%s/plans.txt", outputDirectory);
+	m_fPlans.open(filename, ios::out);
+
+	m_pDBConnection->setNoticeProcessor(&planCaptureNotice, this);
+
+	if (pthread_create(&m_ThreadId, NULL, &planCaptureThread, this) != 0) {
+		throw CThreadErr(CThreadErr::ERR_THREAD_CREATE, "CPlanCapture::ctor");
+	}
+}
+
+CPlanCapture::~CPlanCapture()
+{
+	m_QueueCond.lock();
+	m_bStop = true;
+	m_QueueCond.signal();
+	m_QueueCond.unlock();
+	pthread_join(m_ThreadId, NULL);
+
+	while (!m_queue.empty()) {
+		delete m_queue.front();
+		m_queue.pop_front();
+	}
+	map<const CDBConnection *, vector<PSlowStatement> >::iterator it;
+	for (it = m_held.begin(); it != m_held.end(); ++it)
+		for (size_t i = 0; i < it->second.size(); i++)
+			delete it->second[i];
+	delete m_pDBConnection;
+}
+
+void
+CPlanCapture::capture(const CDBConnection *pDBConnection, INT64 iTxnId,
+		double dElapsed, const char *sql, int nParams, const Oid *paramTypes,
+		const char *const *paramValues, const int *paramLengths,
+		const int *paramFormats)
+{
+	PSlowStatement pStatement = new TSlowStatement;
+	pStatement->iTxnId = iTxnId;
+	gettimeofday(&pStatement->tv, NULL);
+	pStatement->dElapsed = dElapsed;
+	pStatement->sql = sql;
+	for (int i = 0; i < nParams; i++) {
+		if (paramTypes != NULL)
+			pStatement->types.push_back(paramTypes[i]);
+		int iFormat = paramFormats == NULL ? 0 : paramFormats[i];
+		pStatement->formats.push_back(iFormat);
+		pStatement->nulls.push_back(paramValues[i] == NULL);
+		if (paramValues[i] == NULL)
+			pStatement->values.push_back(string());
+		else if (iFormat == 1)
+			pStatement->values.push_back(
+					string(paramValues[i], paramLengths[i]));
+		else
+			pStatement->values.push_back(string(paramValues[i]));
+	}
+
+	// Running the statement again while its transaction is open would
+	// wait for the transaction's locks, so it waits for the transaction.
+	m_QueueCond.lock();
+	vector<PSlowStatement> &held = m_held[pDBConnection];
+	if (held.size() >= iPlanQueueMax) {
+		++m_iDropped;
+		m_QueueCond.unlock();
+		delete pStatement;
+		return;
+	}
+	held.push_back(pStatement);
+	m_QueueCond.unlock();
+}
+
+void
+CPlanCapture::release(const CDBConnection *pDBConnection)
+{
+	m_QueueCond.lock();
+	map<const CDBConnection *, vector<PSlowStatement> >::iterator it
+			= m_held.find(pDBConnection);
+	if (it == m_held.end() || it->second.empty()) {
+		m_QueueCond.unlock();
+		return;
+	}
+	for (size_t i = 0; i < it->second.size(); i++) {
+		if (m_queue.size() >= iPlanQueueMax) {
+			++m_iDropped;
+			delete it->second[i];
+		} else {
+			m_queue.push_back(it->second[i]);
+		}
+	}
+	it->second.clear();
+	m_QueueCond.signal();
+	m_QueueCond.unlock();
+}
+
+void
+CPlanCapture::run()
+{
+	static const char *autoExplain[] = { "LOAD 'auto_explain'",
+		"SET auto_explain.log_min_duration = 0",
+		"SET auto_explain.log_analyze = on",
+		"SET auto_explain.log_buffers = on",
+		"SET auto_explain.log_nested_statements = on",
+		"SET auto_explain.log_level = notice" };
+
+	char sql[64];
+	try {
+		snprintf(sql, sizeof(sql), "SET lock_timeout = %d", iPlanLockTimeout);
+		PQclear(m_pDBConnection->exec(sql));
+		snprintf(sql, sizeof(sql), "SET statement_timeout = %d",
+				iPlanStatementTimeout);
+		PQclear(m_pDBConnection->exec(sql));
+	} catch (const string &e) {
+		m_pBrokerageHouse->logErrorMessage(e);
+	}
+
+	try {
+		for (size_t i = 0; i < sizeof(autoExplain) / sizeof(autoExplain[0]);
+				i++)
+			PQclear(m_pDBConnection->exec(autoExplain[i]));
+	} catch (const string &e) {
+		ostringstream msg;
+		msg << "auto_explain not available, capturing the plans of "
+			   "statements only:"
+			<< endl
+			<< e;
+		m_pBrokerageHouse->logErrorMessage(msg.str());
+	}
+	m_notices.clear();
+
+	m_QueueCond.lock();
+	while (true) {
+		while (!m_bStop && m_queue.empty())
+			m_QueueCond.wait();
+		if (m_bStop)
+			break;
+
+		PSlowStatement pStatement = m_queue.front();
+		m_queue.pop_front();
+		INT64 iDropped = m_iDropped;
+		m_iDropped = 0;
+		m_QueueCond.unlock();
+
+		if (iDropped > 0)
+			m_fPlans << "== " << iDropped
+					 << " slow statement(s) dropped, queue full" << endl
+					 << endl;
+		explain(pStatement);
+		delete pStatement;
+
+		m_QueueCond.lock();
+	}
+	m_QueueCond.unlock();
+}
+
+void
+CPlanCapture::explain(PSlowStatement pStatement)
+{
+	char line[128];
+	snprintf(line, sizeof(line), "== txn %lld at %ld.%06ld, %.3f ms",
+			(long long) pStatement->iTxnId, (long) pStatement->tv.tv_sec,
+			(long) pStatement->tv.tv_usec, pStatement->dElapsed);
+	m_fPlans << line << endl << pStatement->sql << endl;
+
+	int nParams = (int) pStatement->values.size();
+	vector<const char *> values(nParams);
+	vector<int> lengths(nParams);
+	for (int i = 0; i < nParams; i++) {
+		m_fPlans << "$" << i + 1 << " = ";
+		if (pStatement->nulls[i]) {
+			values[i] = NULL;
+			lengths[i] = 0;
+			m_fPlans << "NULL" << endl;
+			continue;
+		}
+
+		const string &value = pStatement->values[i];
+		values[i] = value.data();
+		lengths[i] = (int) value.length();
+		if (pStatement->formats[i] == 0) {
+			m_fPlans << "'" << value << "'" << endl;
+		} else {
+			// Binary parameters in network byte order.
+			m_fPlans << "\\x";
+			for (size_t j = 0; j < value.length(); j++) {
+				snprintf(line, sizeof(line), "%02x",
+						(unsigned char) value[j]);
+				m_fPlans << line;
+			}
+			m_fPlans << endl;
+		}
+	}
+
+	// A read only transaction rejects the statements that modify data or
+	// lock rows before they do, those are explained without running.
+	string error;
+	PGresult *res = explain(pStatement, "EXPLAIN (ANALYZE, BUFFERS) ", true,
+			values, lengths, error);
+	if (res == NULL) {
+		m_fPlans << endl << "Not run again:" << endl << error;
+		res = explain(pStatement, "EXPLAIN ", false, values, lengths, error);
+	}
+
+	if (res == NULL) {
+		m_fPlans << endl << "EXPLAIN failed:" << endl << error;
+	} else {
+		PGresultHolder holder(res);
+		m_fPlans << endl;
+		for (int i = 0; i < PQntuples(res); i++)
+			m_fPlans << PQgetvalue(res, i, 0) << endl;
+		if (!m_notices.empty())
+			m_fPlans << endl << m_notices;
+	}
+	m_fPlans << endl;
+	m_fPlans.flush();
+}
+
+// The result of the statement under the given EXPLAIN, in a transaction
+// that is rolled back, or NULL and the error.
+PGresult *
+CPlanCapture::explain(PSlowStatement pStatement, const char *szExplain,
+		bool bReadOnly, const vector<const char *> &values,
+		const vector<int> &lengths, string &error)
+{
+	string sql(szExplain);
+	sql.append(pStatement->sql);
+	int nParams = (int) values.size();
+	m_notices.clear();
+	try {
+		m_pDBConnection->begin();
+		if (bReadOnly)
+			PQclear(m_pDBConnection->exec("SET TRANSACTION READ ONLY"));
+		PGresult *res = m_pDBConnection->exec(sql.c_str(), nParams,
+				pStatement->types.empty() ? NULL : &pStatement->types[0],
+				nParams == 0 ? NULL : &values[0],
+				nParams == 0 ? NULL : &lengths[0],
+				nParams == 0 ? NULL : &pStatement->formats[0], 0);
+		m_pDBConnection->rollback();
+		return res;
+	} catch (const string &e) {
+		// exec() has rolled back already.
+		error = e;
+		return NULL;
+	}
+}
@@ -0,0 +1,215 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <sys/time.h>
+
+#include "TxnExecutor.h"
+#include "DBConnectionClientSide.h"
+#include "DBConnectionNull.h"
+#include "DBConnectionServerSide.h"
+#include "Probes.h"
+#include "WaitEventSampler.h"
+
+static INT64
+microsecondsNow()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (INT64) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+CTxnExecutor::CTxnExecutor(
+		CBrokerageHouse *pBrokerageHouse, CSendToMarketInterface *pMarket)
+: m_pBrokerageHouse(pBrokerageHouse),
+  m_pDBConnection(newDBConnection(pBrokerageHouse, true)),
+  m_BrokerVolumeDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_CustomerPositionDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_DataMaintenanceDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_MarketFeedDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_MarketWatchDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_SecurityDetailDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_TradeCleanupDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_TradeLookupDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_TradeOrderDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_TradeResultDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_TradeStatusDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_TradeUpdateDB(m_pDBConnection, pBrokerageHouse->verbose()),
+  m_BrokerVolume(&m_BrokerVolumeDB),
+  m_CustomerPosition(&m_CustomerPositionDB),
+  m_DataMaintenance(&m_DataMaintenanceDB),
+  m_MarketFeed(&m_MarketFeedDB, pMarket), m_MarketWatch(&m_MarketWatchDB),
+  m_SecurityDetail(&m_SecurityDetailDB), m_TradeCleanup(&m_TradeCleanupDB),
+  m_TradeLookup(&m_TradeLookupDB), m_TradeOrder(&m_TradeOrderDB, pMarket),
+  m_TradeResult(&m_TradeResultDB), m_TradeStatus(&m_TradeStatusDB),
+  m_TradeUpdate(&m_TradeUpdateDB)
+{
+	m_pDBConnection->setPlanCapture(pBrokerageHouse->m_pPlanCapture);
+}
+
+CTxnExecutor::~CTxnExecutor()
+{
+	delete m_pDBConnection;
+}
+
+CDBConnection *
+CTxnExecutor::newDBConnection(CBrokerageHouse *pBrokerageHouse, bool bWorker)
+{
+	CDBConnection *pDBConnection;
+
+	char szApplicationName[32];
+	snprintf(szApplicationName, sizeof(szApplicationName), "dbt5-bh-%d",
+			(int) syscall(SYS_gettid));
+
+	if (pBrokerageHouse->m_pNullDB != NULL) {
+		pDBConnection = new CDBConnectionNull(
+				*pBrokerageHouse->m_pNullDB, pBrokerageHouse->verbose());
+	} else if (pBrokerageHouse->m_ClientSide == 1) {
+		pDBConnection = new CDBConnectionClientSide(pBrokerageHouse->m_szHost,
+				pBrokerageHouse->m_szDBName, pBrokerageHouse->m_szDBPort,
+				pBrokerageHouse->verbose(),
+				bWorker ? szApplicationName : NULL);
+	} else {
+		pDBConnection = new CDBConnectionServerSide(pBrokerageHouse->m_szHost,
+				pBrokerageHouse->m_szDBName, pBrokerageHouse->m_szDBPort,
+				pBrokerageHouse->verbose(),
+				bWorker ? szApplicationName : NULL);
+	}
+	pDBConnection->setBrokerageHouse(pBrokerageHouse);
+	return pDBConnection;
+}
+
+INT32
+CTxnExecutor::execute(PMsgDriverBrokerage pRequest, INT64 *piDBStart)
+{
+	INT32 iRet = 0; // transaction return code
+
+	m_pDBConnection->setTxnId(pRequest->iTxnId);
+
+	// The backend may change when the connection is reset.
+	CWaitEventSampler *pWaits = m_pBrokerageHouse->m_pWaitSampler;
+	int iBackendPid = 0;
+	if (pWaits != NULL) {
+		iBackendPid = m_pDBConnection->backendPid();
+		pWaits->running(iBackendPid, pRequest->TxnType);
+	}
+
+	if (piDBStart != NULL && pRequest->bSample)
+		*piDBStart = microsecondsNow();
+
+	// Serialization failures and deadlocks abort the whole
+	// transaction; retry it instead of counting it as the
+	// intentional TPC-E rollback.
+	bool bRetry;
+	int nRetries = 0;
+	do {
+		bRetry = false;
+		try {
+			//  Parse Txn type
+			switch (pRequest->TxnType) {
+			case BROKER_VOLUME:
+				iRet = m_pBrokerageHouse->RunBrokerVolume(
+						&(pRequest->TxnInput.BrokerVolumeTxnInput),
+						m_BrokerVolume);
+				break;
+			case CUSTOMER_POSITION:
+				iRet = m_pBrokerageHouse->RunCustomerPosition(
+						&(pRequest->TxnInput.CustomerPositionTxnInput),
+						m_CustomerPosition);
+				if (iRet != 0)
+					m_pDBConnection->rollback();
+				break;
+			case MARKET_FEED:
+				iRet = m_pBrokerageHouse->RunMarketFeed(
+						&(pRequest->TxnInput.MarketFeedTxnInput),
+						m_MarketFeed);
+				break;
+			case MARKET_WATCH:
+				iRet = m_pBrokerageHouse->RunMarketWatch(
+						&(pRequest->TxnInput.MarketWatchTxnInput),
+						m_MarketWatch);
+				break;
+			case SECURITY_DETAIL:
+				iRet = m_pBrokerageHouse->RunSecurityDetail(
+						&(pRequest->TxnInput.SecurityDetailTxnInput),
+						m_SecurityDetail);
+				break;
+			case TRADE_LOOKUP:
+				iRet = m_pBrokerageHouse->RunTradeLookup(
+						&(pRequest->TxnInput.TradeLookupTxnInput),
+						m_TradeLookup);
+				break;
+			case TRADE_ORDER:
+				iRet = m_pBrokerageHouse->RunTradeOrder(
+						&(pRequest->TxnInput.TradeOrderTxnInput),
+						m_TradeOrder);
+				break;
+			case TRADE_RESULT:
+				iRet = m_pBrokerageHouse->RunTradeResult(
+						&(pRequest->TxnInput.TradeResultTxnInput),
+						m_TradeResult);
+				if (iRet != 0)
+					m_pDBConnection->rollback();
+				break;
+			case TRADE_STATUS:
+				iRet = m_pBrokerageHouse->RunTradeStatus(
+						&(pRequest->TxnInput.TradeStatusTxnInput),
+						m_TradeStatus);
+				break;
+			case TRADE_UPDATE:
+				iRet = m_pBrokerageHouse->RunTradeUpdate(
+						&(pRequest->TxnInput.TradeUpdateTxnInput),
+						m_TradeUpdate);
+				break;
+			case DATA_MAINTENANCE:
+				iRet = m_pBrokerageHouse->RunDataMaintenance(
+						&(pRequest->TxnInput.DataMaintenanceTxnInput),
+						m_DataMaintenance);
+				break;
+			case TRADE_CLEANUP:
+				iRet = m_pBrokerageHouse->RunTradeCleanup(
+						&(pRequest->TxnInput.TradeCleanupTxnInput),
+						m_TradeCleanup);
+				break;
+			default:
+				cout << "wrong txn type" << endl;
+				iRet = ERR_TYPE_WRONGTXN;
+			}
+		} catch (CDBRetryableError &e) {
+			if (++nRetries <= iMaxRetries) {
+				DBT5_PROBE3(bh__txn__retry, pRequest->iTxnId,
+						pRequest->TxnType, nRetries);
+				bRetry = true;
+			} else {
+				pid_t pid = syscall(SYS_gettid);
+				ostringstream msg;
+				msg << time(NULL) << " " << pid << " "
+					<< szTransactionName[pRequest->TxnType]
+					<< " giving up after " << iMaxRetries
+					<< " retries " << e << endl;
+				m_pBrokerageHouse->logErrorMessage(msg.str());
+				iRet = CBaseTxnErr::EXPECTED_ROLLBACK;
+			}
+		} catch (std::string const &e) {
+			pid_t pid = syscall(SYS_gettid);
+			ostringstream msg;
+			msg << time(NULL) << " " << pid << " "
+				<< szTransactionName[pRequest->TxnType] << " " << e
+				<< endl;
+			m_pBrokerageHouse->logErrorMessage(msg.str());
+			iRet = CBaseTxnErr::EXPECTED_ROLLBACK;
+		}
+	} while (bRetry);
+
+	if (pWaits != NULL)
+		pWaits->finished(iBackendPid);
+
+	if (iRet < 0)
+		cerr << "INVALID RUN : see " << m_pBrokerageHouse->errorLogFilename()
+			 << " for transaction details" << endl;
+
+	return iRet;
+}
@@ -0,0 +1,220 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include "WaitEventSampler.h"
+#include "CThreadErr.h"
+
+#define WAITEVENTQ                                                            \
+	"SELECT pid\n"                                                            \
+	"     , coalesce(wait_event_type, 'CPU')\n"                               \
+	"     , coalesce(wait_event, 'CPU')\n"                                    \
+	"FROM pg_stat_activity\n"                                                 \
+	"WHERE application_name LIKE 'dbt5-bh-%'\n"                               \
+	"  AND (state = 'active' OR wait_event IS NOT NULL)"
+
+static string
+txnName(int iTxnType)
+{
+	string name(szTransactionName[iTxnType]);
+	for (size_t i = 0; i < name.length(); i++)
+		name[i] = tolower(name[i]);
+	return name;
+}
+
+void *
+waitEventSamplerThread(void *data)
+{
+	reinterpret_cast<CWaitEventSampler *>(data)->run();
+	return NULL;
+}
+
+CWaitEventSampler::CWaitEventSampler(CBrokerageHouse *pBrokerageHouse,
+		CDBConnection *pDBConnection, const char *outputDirectory,
+		int iInterval)
+: m_pBrokerageHouse(pBrokerageHouse), m_pDBConnection(pDBConnection),
+  m_iInterval(iInterval), m_bFailing(false), m_iLastConnect(0),
+  m_StopCond(m_StopLock), m_bStop(false)
+{
+	strncpy(m_szOutputDirectory, outputDirectory, iMaxPath);
+	m_szOutputDirectory[iMaxPath] = '\0';
+
+	char filename[iMaxPath + 1];
+	snprintf(filename, sizeof(filename), "%s/waits-timeline.csv",
+			outputDirectory);
+	m_fTimeline.open(filename, ios::out);
+	m_fTimeline << "time,txn,wait_event_type,wait_event,samples" << endl;
+
+	if (pthread_create(&m_ThreadId, NULL, &waitEventSamplerThread, this)
+			!= 0) {
+		throw CThreadErr(
+				CThreadErr::ERR_THREAD_CREATE, "CWaitEventSampler::ctor");
+	}
+}
+
+CWaitEventSampler::~CWaitEventSampler()
+{
+	m_StopCond.lock();
+	m_bStop = true;
+	m_StopCond.signal();
+	m_StopCond.unlock();
+	pthread_join(m_ThreadId, NULL);
+
+	delete m_pDBConnection;
+}
+
+void
+CWaitEventSampler::running(int iBackendPid, int iTxnType)
+{
+	if (iTxnType < 0 || iTxnType > TRADE_CLEANUP)
+		return;
+
+	Locker<CMutex> locker(m_BackendLock);
+	m_backends[iBackendPid] = iTxnType;
+}
+
+void
+CWaitEventSampler::finished(int iBackendPid)
+{
+	Locker<CMutex> locker(m_BackendLock);
+	m_backends.erase(iBackendPid);
+}
+
+void
+CWaitEventSampler::run()
+{
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	long iSecond = (long) time(NULL);
+
+	m_StopCond.lock();
+	while (!m_bStop) {
+		m_StopCond.unlock();
+		long iNow = (long) time(NULL);
+		if (iNow != iSecond) {
+			writeSecond(iSecond);
+			writeProfile();
+			iSecond = iNow;
+		}
+		sample();
+		m_StopCond.lock();
+
+		next.tv_nsec += (long) m_iInterval * 1000000;
+		next.tv_sec += next.tv_nsec / 1000000000;
+		next.tv_nsec %= 1000000000;
+		while (!m_bStop) {
+			struct timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			long wait = (long) (next.tv_sec - now.tv_sec) * 1000000
+					+ (next.tv_nsec - now.tv_nsec) / 1000;
+			if (wait <= 0)
+				break;
+			m_StopCond.timedwait(wait);
+		}
+	}
+	m_StopCond.unlock();
+
+	writeSecond(iSecond);
+	writeProfile();
+}
+
+// Count the wait event of every backend that is running a transaction.
+void
+CWaitEventSampler::sample()
+{
+	if (!m_pDBConnection->connected()) {
+		long iNow = (long) time(NULL);
+		if (iNow == m_iLastConnect)
+			return;
+		m_iLastConnect = iNow;
+		m_pDBConnection->reconnect();
+		if (!m_pDBConnection->connected())
+			return;
+	}
+
+	PGresult *res;
+	try {
+		res = m_pDBConnection->exec(WAITEVENTQ);
+	} catch (const string &e) {
+		if (!m_bFailing) {
+			ostringstream msg;
+			msg << "Could not sample wait events, retrying:" << endl << e;
+			m_pBrokerageHouse->logErrorMessage(msg.str());
+			m_bFailing = true;
+		}
+		return;
+	}
+	PGresultHolder holder(res);
+	if (m_bFailing) {
+		m_pBrokerageHouse->logErrorMessage("Sampling wait events again\n");
+		m_bFailing = false;
+	}
+
+	int iRows = PQntuples(res);
+	Locker<CMutex> locker(m_BackendLock);
+	for (int i = 0; i < iRows; i++) {
+		map<int, int>::const_iterator it
+				= m_backends.find(atoi(PQgetvalue(res, i, 0)));
+		if (it == m_backends.end())
+			continue;
+
+		TWaitKey key;
+		key.iTxnType = it->second;
+		key.type = PQgetvalue(res, i, 1);
+		key.event = PQgetvalue(res, i, 2);
+		++m_second[key];
+	}
+}
+
+void
+CWaitEventSampler::writeSecond(long iSecond)
+{
+	for (TWaitCounts::const_iterator it = m_second.begin();
+			it != m_second.end(); ++it) {
+		m_fTimeline << iSecond << "," << txnName(it->first.iTxnType) << ","
+					<< it->first.type << "," << it->first.event << ","
+					<< it->second << "\n";
+		m_run[it->first] += it->second;
+	}
+	m_fTimeline.flush();
+	m_second.clear();
+}
+
+// Replace the profile of the run, like the latency histograms, so it is
+// current even if the Brokerage House is killed.
+void
+CWaitEventSampler::writeProfile()
+{
+	INT64 totals[TRADE_CLEANUP + 1];
+	memset(totals, 0, sizeof(totals));
+	for (TWaitCounts::const_iterator it = m_run.begin(); it != m_run.end();
+			++it)
+		totals[it->first.iTxnType] += it->second;
+
+	char filename[iMaxPath + 1];
+	char tmpname[iMaxPath + 1];
+	snprintf(filename, sizeof(filename), "%s/waits-profile.csv",
+			m_szOutputDirectory);
+	snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename);
+
+	ofstream f(tmpname, ios::out);
+	f << "txn,wait_event_type,wait_event,samples,percent" << endl;
+	for (TWaitCounts::const_iterator it = m_run.begin(); it != m_run.end();
+			++it) {
+		char percent[16];
+		snprintf(percent, sizeof(percent), "%.2f",
+				100.0 * it->second / totals[it->first.iTxnType]);
+		f << txnName(it->first.iTxnType) << "," << it->first.type << ","
+		  << it->first.event << "," << it->second << "," << percent << "\n";
+	}
+	f.close();
+	rename(tmpname, filename);
+}
@@ -17,22 +17,41 @@
 // Constructor
 CCustomer::CCustomer(const DataFileManager &inputFiles, char *szInDir,
 		TIdent iConfiguredCustomerCount, TIdent iActiveCustomerCount,
-		INT32 iScaleFactor, INT32 iDaysOfInitialTrades, UINT32 iSeed,
+		TIdent iMyStartingCustomerId, TIdent iMyCustomerCount,
+		INT32 iPartitionPercent, INT32 iScaleFactor,
+		INT32 iDaysOfInitialTrades, UINT32 iSeed,
 		char *szBHaddr, int iBHlistenPort, UINT32 UniqueId, int iPacingDelay,
-		char *outputDirectory)
+		char *outputDirectory, pid_t id)
 : m_UniqueId(UniqueId), m_iPacingDelay(iPacingDelay)
 {
-	pid_t pid = syscall(SYS_gettid);
+	// Users sharing a thread need their own id to keep their logs apart.
+	pid_t pid = id != 0 ? id : syscall(SYS_gettid);
 	char filename[iMaxPath + 1];
 	snprintf(filename, sizeof(filename), "%s/Customer_%d.log", outputDirectory,
 			pid);
 	m_pLog = new CEGenLogger(eDriverEGenLoader, 0, filename, &m_fmt);
 
 	// initialize CESUT interface
-	m_pCCESUT = new CCESUT(outputDirectory, szBHaddr, iBHlistenPort);
+	m_pCCESUT = new CCESUT(outputDirectory, szBHaddr, iBHlistenPort, pid);
 
 	// initialize CE - Customer Emulator
-	if (iSeed == 0) {
+	if (iMyCustomerCount > 0) {
+		// Partitioned by C_ID: iPartitionPercent of the transactions use
+		// this driver's range of customers.
+		if (iSeed == 0) {
+			m_pCCE = new CCE(m_pCCESUT, m_pLog, inputFiles,
+					iConfiguredCustomerCount, iActiveCustomerCount,
+					iMyStartingCustomerId, iMyCustomerCount,
+					iPartitionPercent, iScaleFactor, iDaysOfInitialTrades,
+					UniqueId);
+		} else {
+			m_pCCE = new CCE(m_pCCESUT, m_pLog, inputFiles,
+					iConfiguredCustomerCount, iActiveCustomerCount,
+					iMyStartingCustomerId, iMyCustomerCount,
+					iPartitionPercent, iScaleFactor, iDaysOfInitialTrades,
+					UniqueId, iSeed, iSeed);
+		}
+	} else if (iSeed == 0) {
 		m_pCCE = new CCE(m_pCCESUT, m_pLog, inputFiles,
 				iConfiguredCustomerCount, iActiveCustomerCount, iScaleFactor,
 				iDaysOfInitialTrades, UniqueId);
@@ -65,3 +84,15 @@ CCustomer::LogStopTime()
 {
 	m_pCCESUT->logStopTime();
 }
+
+void
+CCustomer::SetIntendedStart(const struct timespec &ts)
+{
+	m_pCCESUT->setIntendedStart(ts);
+}
+
+void
+CCustomer::StartTrace()
+{
+	m_pCCESUT->startTrace((INT32) m_UniqueId);
+}
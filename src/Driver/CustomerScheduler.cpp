@@ -0,0 +1,241 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CustomerScheduler.h"
+#include "Driver.h"
+
+extern int stop_time;
+
+void
+addMilliseconds(struct timespec &ts, long ms)
+{
+	ts.tv_sec += ms / 1000;
+	ts.tv_nsec += (ms % 1000) * 1000000;
+	if (ts.tv_nsec >= 1000000000) {
+		++ts.tv_sec;
+		ts.tv_nsec -= 1000000000;
+	}
+}
+
+void
+addNanoseconds(struct timespec &ts, INT64 ns)
+{
+	ts.tv_sec += ns / 1000000000;
+	ts.tv_nsec += ns % 1000000000;
+	if (ts.tv_nsec >= 1000000000) {
+		++ts.tv_sec;
+		ts.tv_nsec -= 1000000000;
+	}
+}
+
+int
+sleepUntil(const struct timespec &ts)
+{
+	// clock_nanosleep() returns the error instead of setting errno.
+	int rc;
+	while ((rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL))
+			== EINTR)
+		;
+	return rc;
+}
+
+void
+TArrivalLag::add(double dLag)
+{
+	++iArrivals;
+	if (dLag > 0.001)
+		++iLate;
+	dTotal += dLag;
+	if (dLag > dMax)
+		dMax = dLag;
+}
+
+void
+TArrivalLag::add(const TArrivalLag &other)
+{
+	iArrivals += other.iArrivals;
+	iLate += other.iLate;
+	dTotal += other.dTotal;
+	if (other.dMax > dMax)
+		dMax = other.dMax;
+}
+
+CArrivalSchedule::CArrivalSchedule(
+		const struct timespec &start, bool bPoisson, UINT32 iSeed)
+: m_next(start), m_bPoisson(bPoisson)
+{
+	m_xsubi[0] = 0x330e;
+	m_xsubi[1] = (unsigned short) iSeed;
+	m_xsubi[2] = (unsigned short) (iSeed >> 16);
+}
+
+// Schedule the next arrival, dInterval nanoseconds later on average.
+void
+CArrivalSchedule::advance(double dInterval)
+{
+	if (m_bPoisson) {
+		// Exponentially distributed gaps give Poisson arrivals.
+		dInterval *= -log(1.0 - erand48(m_xsubi));
+	}
+	addNanoseconds(m_next, (INT64) dInterval);
+}
+
+// Start the transaction that is due: note how late it is and have its
+// response time measured from the intended start, so that time spent
+// queued behind a slow SUT is counted.
+void
+CArrivalSchedule::arrive(CCustomer *pCustomer, TArrivalLag &lag) const
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	double dLag = (double) (now.tv_sec - m_next.tv_sec)
+			+ (double) (now.tv_nsec - m_next.tv_nsec) / 1000000000.0;
+	lag.add(dLag > 0.0 ? dLag : 0.0);
+
+	pCustomer->SetIntendedStart(m_next);
+}
+
+CCustomerScheduler::CCustomerScheduler(CDriver *pDriver): m_pDriver(pDriver)
+{
+}
+
+CCustomerScheduler::~CCustomerScheduler()
+{
+	for (size_t i = 0; i < m_users.size(); i++) {
+		delete m_users[i]->pCustomer;
+		delete m_users[i]->pSchedule;
+		delete m_users[i];
+	}
+}
+
+// Schedule a user's first transaction.  The user connects to the Brokerage
+// House when that time comes so the ramp-up behaves as with one thread per
+// user.
+void
+CCustomerScheduler::addUser(UINT32 UniqueId, const struct timespec &start)
+{
+	PScheduledUser pUser = new TScheduledUser;
+	pUser->UniqueId = UniqueId;
+	pUser->pCustomer = NULL;
+	pUser->pSchedule = m_pDriver->newArrivalSchedule(UniqueId, start);
+	pUser->due = start;
+
+	m_users.push_back(pUser);
+	m_queue.push(pUser);
+}
+
+// Run one transaction for a user, creating the user first if this is its
+// first turn.  Returns false if the user has to be dropped.
+bool
+CCustomerScheduler::doTxn(PScheduledUser pUser)
+{
+	ostringstream osErr;
+
+	try {
+		if (pUser->pCustomer == NULL) {
+			// The UniqueId keeps the log files of users sharing this
+			// thread apart.
+			pUser->pCustomer = new CCustomer(m_pDriver->m_inputFiles,
+					m_pDriver->szInDir, m_pDriver->iConfiguredCustomerCount,
+					m_pDriver->iActiveCustomerCount,
+					m_pDriver->shard.iMyStartingCustomerId,
+					m_pDriver->shard.iMyCustomerCount,
+					m_pDriver->shard.iPartitionPercent, m_pDriver->iScaleFactor,
+					m_pDriver->iDaysOfInitialTrades, m_pDriver->iSeed,
+					m_pDriver->szBHaddr, m_pDriver->iBHlistenPort,
+					pUser->UniqueId, m_pDriver->iPacingDelay,
+					m_pDriver->outputDirectory, pUser->UniqueId);
+			if (m_pDriver->bTrace)
+				pUser->pCustomer->StartTrace();
+			m_pDriver->userStarted();
+		}
+		if (pUser->pSchedule != NULL)
+			pUser->pSchedule->arrive(pUser->pCustomer, m_lag);
+		pUser->pCustomer->DoTxn();
+		return true;
+	} catch (CBaseErr *pErr) {
+		osErr << "user " << pUser->UniqueId << " error: " << pErr->ErrorText()
+			  << endl;
+		m_pDriver->logErrorMessage(osErr.str());
+		delete pErr;
+	} catch (std::exception &e) {
+		osErr << "user " << pUser->UniqueId << " error: " << e.what() << endl;
+		m_pDriver->logErrorMessage(osErr.str());
+	}
+
+	// Stop the user like a failed user thread would.
+	delete pUser->pCustomer;
+	pUser->pCustomer = NULL;
+	return false;
+}
+
+void
+CCustomerScheduler::run()
+{
+	while (!m_queue.empty()) {
+		PScheduledUser pUser = m_queue.top();
+		m_queue.pop();
+
+		int rc = sleepUntil(pUser->due);
+		if (rc != 0) {
+			ostringstream osErr;
+			osErr << "scheduler sleep failed for user " << pUser->UniqueId
+				  << ": " << strerror(rc) << endl;
+			m_pDriver->logErrorMessage(osErr.str());
+		}
+
+		// A user that started runs at least one transaction, as with one
+		// thread per user; one that never started is not created at all.
+		bool bActive = m_pDriver->userActive(pUser->UniqueId);
+		if (time(NULL) >= stop_time
+				&& (pUser->pCustomer == NULL || !bActive))
+			continue;
+
+		if (!bActive) {
+			// The load profile has parked this user; look again shortly
+			// and start from a fresh schedule once it may run again.
+			clock_gettime(CLOCK_MONOTONIC, &pUser->due);
+			addMilliseconds(pUser->due, iIdleUserDelay);
+			if (pUser->pSchedule != NULL)
+				pUser->pSchedule->reset(pUser->due);
+			m_queue.push(pUser);
+			continue;
+		}
+
+		if (!doTxn(pUser))
+			continue;
+
+		if (time(NULL) >= stop_time)
+			continue;
+
+		if (pUser->pSchedule != NULL) {
+			// Stay on schedule even if this transaction ran late.
+			pUser->pSchedule->advance(m_pDriver->arrivalInterval());
+			pUser->due = pUser->pSchedule->next();
+		} else {
+			// The pacing delay is counted from the end of the
+			// transaction.
+			clock_gettime(CLOCK_MONOTONIC, &pUser->due);
+			addMilliseconds(pUser->due, m_pDriver->iPacingDelay);
+		}
+		m_queue.push(pUser);
+	}
+
+	if (m_pDriver->dArrivalRate > 0.0)
+		m_pDriver->addArrivalLag(m_lag);
+
+	for (size_t i = 0; i < m_users.size(); i++) {
+		if (m_users[i]->pCustomer != NULL)
+			m_users[i]->pCustomer->LogStopTime();
+	}
+}
@@ -14,17 +14,37 @@
 
 #include "Driver.h"
 #include "Customer.h"
+#include "CustomerScheduler.h"
+#include "CSocket.h"
 
 // global variables
 pthread_t *g_tid = NULL;
 int stop_time = 0;
 
+// Users that are connected and not parked by the load level.
+long
+activeUsersGauge(void *data)
+{
+	CDriver *pDriver = reinterpret_cast<CDriver *>(data);
+
+	pDriver->m_LoadLock.lock();
+	long iActive = pDriver->m_iStartedUsers < pDriver->m_iActiveUsers
+			? pDriver->m_iStartedUsers
+			: pDriver->m_iActiveUsers;
+	pDriver->m_LoadLock.unlock();
+	return iActive;
+}
+
 // Constructor
 CDriver::CDriver(const DataFileManager &inputFiles, char *szInDir,
 		TIdent iConfiguredCustomerCount, TIdent iActiveCustomerCount,
 		INT32 iScaleFactor, INT32 iDaysOfInitialTrades, UINT32 iSeed,
 		char *szBHaddr, int iBHlistenPort, int iUsers, int iPacingDelay,
-		char *outputDirectory)
+		int iWorkers, double dArrivalRate, bool bPoisson,
+		const char *szLoadProfile, int iControlPort, bool bTrace,
+		const TDriverShard &shard, char *outputDirectory)
+: m_inputFiles(inputFiles), m_pProfile(NULL), m_pCoordinator(NULL),
+  shard(shard), m_pCDMSUT(NULL), m_pCDM(NULL)
 {
 	strncpy(this->szInDir, szInDir, iMaxPath);
 	this->szInDir[iMaxPath] = '\0';
@@ -38,6 +58,19 @@ CDriver::CDriver(const DataFileManager &inputFiles, char *szInDir,
 	this->iBHlistenPort = iBHlistenPort;
 	this->iUsers = iUsers;
 	this->iPacingDelay = iPacingDelay;
+	// More schedulers than users would leave some of them idle.
+	this->iWorkers = iWorkers < iUsers ? iWorkers : iUsers;
+	this->dArrivalRate = dArrivalRate;
+	this->bPoisson = bPoisson;
+	this->iControlPort = iControlPort;
+	this->bTrace = bTrace;
+
+	m_iActiveUsers = iUsers;
+	m_iStartedUsers = 0;
+	m_dCurrentRate = dArrivalRate;
+	if (szLoadProfile != NULL && szLoadProfile[0] != '\0') {
+		m_pProfile = new CLoadProfile(szLoadProfile);
+	}
 	strncpy(this->outputDirectory, outputDirectory, iMaxPath);
 	this->outputDirectory[iMaxPath] = '\0';
 
@@ -51,7 +84,17 @@ CDriver::CDriver(const DataFileManager &inputFiles, char *szInDir,
 	m_fLog.open(filename, ios::out);
 	snprintf(filename, sizeof(filename), "%s/%s", outputDirectory,
 			CE_MIX_LOG_NAME);
-	m_fMix.open(filename, ios::out);
+	m_pMix = new CMixLogWriter(filename);
+	m_pLatency = CLatencyLog::attach(outputDirectory);
+	m_pLatency->addGauge("users", &activeUsersGauge, this);
+	if (m_pProfile != NULL || iControlPort > 0) {
+		snprintf(filename, sizeof(filename), "%s/load.log", outputDirectory);
+		m_fLoad.open(filename, ios::out);
+	}
+
+	// Another driver process of the same run does the Data-Maintenance.
+	if (!shard.bDataMaintenance)
+		return;
 
 	cout << "initializing data maintenance..." << endl;
 
@@ -71,12 +114,16 @@ CDriver::CDriver(const DataFileManager &inputFiles, char *szInDir,
 				iConfiguredCustomerCount, iActiveCustomerCount, iScaleFactor,
 				iDaysOfInitialTrades, pid, iSeed);
 	}
+	if (bTrace)
+		m_pCDMSUT->startTrace();
 }
 
 void *
 customerWorkerThread(void *data)
 {
 	CCustomer *customer;
+	CArrivalSchedule *pSchedule = NULL;
+	TArrivalLag lag;
 	PCustomerThreadParam pThrParam
 			= reinterpret_cast<PCustomerThreadParam>(data);
 
@@ -87,20 +134,53 @@ customerWorkerThread(void *data)
 	ts.tv_nsec = (long) (pThrParam->pDriver->iPacingDelay % 1000) * 1000000;
 
 	try {
-		const DataFileManager inputFiles(pThrParam->pDriver->szInDir,
-				pThrParam->pDriver->iConfiguredCustomerCount,
-				pThrParam->pDriver->iActiveCustomerCount,
-				TPCE::DataFileManager::IMMEDIATE_LOAD);
-		customer = new CCustomer(inputFiles, pThrParam->pDriver->szInDir,
+		// All users share the driver's DataFileManager.  The files were
+		// loaded with IMMEDIATE_LOAD so the const accessors only read and no
+		// locking is needed.
+		customer = new CCustomer(pThrParam->pDriver->m_inputFiles,
+				pThrParam->pDriver->szInDir,
 				pThrParam->pDriver->iConfiguredCustomerCount,
 				pThrParam->pDriver->iActiveCustomerCount,
+				pThrParam->pDriver->shard.iMyStartingCustomerId,
+				pThrParam->pDriver->shard.iMyCustomerCount,
+				pThrParam->pDriver->shard.iPartitionPercent,
 				pThrParam->pDriver->iScaleFactor,
 				pThrParam->pDriver->iDaysOfInitialTrades,
 				pThrParam->pDriver->iSeed, pThrParam->pDriver->szBHaddr,
 				pThrParam->pDriver->iBHlistenPort, pThrParam->UniqueId,
 				pThrParam->pDriver->iPacingDelay,
 				pThrParam->pDriver->outputDirectory);
+		if (pThrParam->pDriver->bTrace)
+			customer->StartTrace();
+		pThrParam->pDriver->userStarted();
+
+		struct timespec start;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		pSchedule = pThrParam->pDriver->newArrivalSchedule(
+				pThrParam->UniqueId, start);
+
 		do {
+			if (!pThrParam->pDriver->userActive(pThrParam->UniqueId)) {
+				// Parked by the load profile, start from a fresh schedule
+				// once it may run again.
+				usleep(iIdleUserDelay * 1000);
+				if (pSchedule != NULL) {
+					clock_gettime(CLOCK_MONOTONIC, &start);
+					pSchedule->reset(start);
+				}
+				continue;
+			}
+
+			if (pSchedule != NULL) {
+				// Open-loop: start on schedule, even when the previous
+				// transaction finished late.
+				sleepUntil(pSchedule->next());
+				pSchedule->arrive(customer, lag);
+				customer->DoTxn();
+				pSchedule->advance(pThrParam->pDriver->arrivalInterval());
+				continue;
+			}
+
 			customer->DoTxn();
 
 			// wait for pacing delay -- this delays happens after the mix
@@ -130,6 +210,11 @@ customerWorkerThread(void *data)
 		pThrParam->pDriver->logErrorMessage(osErr.str());
 	}
 
+	if (pSchedule != NULL) {
+		pThrParam->pDriver->addArrivalLag(lag);
+		delete pSchedule;
+	}
+
 	pid_t pid = syscall(SYS_gettid);
 	cout << "User thread # " << pid << " terminated." << endl;
 
@@ -152,8 +237,11 @@ entryCustomerWorkerThread(void *data)
 			throw CThreadErr(CThreadErr::ERR_THREAD_ATTR_INIT);
 		}
 
-		// create the thread in the joinable state
-		status = pthread_create(&g_tid[pThrParam->UniqueId], &threadAttribute,
+		// create the thread in the joinable state, g_tid is indexed from
+		// this driver's first user
+		UINT32 iThread
+				= pThrParam->UniqueId - pThrParam->pDriver->shard.iUserOffset;
+		status = pthread_create(&g_tid[iThread], &threadAttribute,
 				&customerWorkerThread, data);
 
 		if (status != 0) {
@@ -169,13 +257,34 @@ entryCustomerWorkerThread(void *data)
 	}
 }
 
+// scheduler thread running several users
+void *
+customerSchedulerThread(void *data)
+{
+	CCustomerScheduler *pScheduler
+			= reinterpret_cast<CCustomerScheduler *>(data);
+
+	pScheduler->run();
+
+	pid_t pid = syscall(SYS_gettid);
+	cout << "Scheduler thread # " << pid << " terminated." << endl;
+
+	return NULL;
+}
+
 // Destructor
 CDriver::~CDriver()
 {
+	for (size_t i = 0; i < m_schedulers.size(); i++)
+		delete m_schedulers[i];
+	delete m_pProfile;
+
 	delete m_pCDM;
 	delete m_pCDMSUT;
+	delete m_pCoordinator;
 
 	m_fLog.close();
+	delete m_pMix;
 
 	delete m_pDriverCETxnSettings;
 	delete m_pLog;
@@ -190,11 +299,39 @@ CDriver::runTest(int iSleep, int iTestDuration)
 	g_tid = (pthread_t *) malloc(sizeof(pthread_t) * (iUsers + 1));
 
 	// before starting the test run Trade-Cleanup transaction
-	cout << endl
-		 << "Running Trade-Cleanup transaction before starting the test..."
-		 << endl;
-	m_pCDM->DoCleanupTxn();
-	cout << "Trade-Cleanup transaction completed." << endl << endl;
+	if (shard.bDataMaintenance) {
+		cout << endl
+			 << "Running Trade-Cleanup transaction before starting the "
+				"test..."
+			 << endl;
+		m_pCDM->DoCleanupTxn();
+		cout << "Trade-Cleanup transaction completed." << endl << endl;
+	}
+
+	// Driver processes sharing a run start their users together, when the
+	// coordinator says so, after the Trade-Cleanup.  Without one they start
+	// at a wall clock time, and only the driver running the Trade-Cleanup
+	// waits for it.
+	if (shard.szCoordinatorAddr[0] != '\0') {
+		waitForCoordinator();
+	} else if (shard.tStart > 0) {
+		time_t now = time(NULL);
+		if (now < shard.tStart) {
+			cout << "Waiting " << shard.tStart - now
+				 << " seconds for the synchronized start..." << endl;
+			sleep(shard.tStart - now);
+		} else if (now > shard.tStart) {
+			ostringstream osErr;
+			osErr << "synchronized start missed by " << now - shard.tStart
+				  << " seconds";
+			if (shard.bDataMaintenance)
+				osErr << ", the other drivers started during the "
+						 "Trade-Cleanup";
+			osErr << endl;
+			cerr << "Warning: " << osErr.str();
+			logErrorMessage(osErr.str());
+		}
+	}
 
 	// time to sleep between thread creation, convert from millaseconds to
 	// nanoseconds.
@@ -219,45 +356,496 @@ CDriver::runTest(int iSleep, int iTestDuration)
 	cout << ">> Start of ramp-up." << endl;
 
 	// start thread that runs the Data Maintenance transaction
-	entryDMWorkerThread(this);
+	if (shard.bDataMaintenance)
+		entryDMWorkerThread(this);
 
-	for (int i = 1; i <= iUsers; i++) {
-		// parameter for the new thread
-		PCustomerThreadParam pThrParam = new TCustomerThreadParam;
+	startLoadController();
 
-		// zero the structure
-		pThrParam->UniqueId = i;
-		pThrParam->pDriver = this;
+	if (iWorkers > 0) {
+		startCustomerSchedulers(iSleep);
+	} else {
+		for (int i = 1; i <= iUsers; i++) {
+			// parameter for the new thread
+			PCustomerThreadParam pThrParam = new TCustomerThreadParam;
 
-		entryCustomerWorkerThread(reinterpret_cast<void *>(pThrParam));
+			// zero the structure
+			pThrParam->UniqueId = shard.iUserOffset + i;
+			pThrParam->pDriver = this;
 
-		// Sleep for between starting terminals
-		while (nanosleep(&ts, &rem) == -1) {
-			if (errno == EINTR) {
-				memcpy(&ts, &rem, sizeof(timespec));
-			} else {
-				ostringstream osErr;
-				osErr << "sleep time invalid " << ts.tv_sec << " s "
-					  << ts.tv_nsec << " ns" << endl;
-				logErrorMessage(osErr.str());
-				break;
+			entryCustomerWorkerThread(reinterpret_cast<void *>(pThrParam));
+
+			// Sleep for between starting terminals
+			while (nanosleep(&ts, &rem) == -1) {
+				if (errno == EINTR) {
+					memcpy(&ts, &rem, sizeof(timespec));
+				} else {
+					ostringstream osErr;
+					osErr << "sleep time invalid " << ts.tv_sec << " s "
+						  << ts.tv_nsec << " ns" << endl;
+					logErrorMessage(osErr.str());
+					break;
+				}
 			}
 		}
 	}
 
 	// mark end of ramp-up
 	pid_t pid = syscall(SYS_gettid);
-	m_fMix << (int) time(NULL) << ",START,,," << pid << endl;
+	m_pMix->logStart(pid);
+	m_pMix->flush();
 
 	cout << ">> End of ramp-up." << endl;
 
 	// wait until all threads quit
 	// 0 represents the Data-Maintenance thread
-	for (int i = 0; i <= iUsers; i++) {
+	int iThreads = iWorkers > 0 ? iWorkers : iUsers;
+	for (int i = shard.bDataMaintenance ? 0 : 1; i <= iThreads; i++) {
 		if (pthread_join(g_tid[i], NULL) != 0) {
 			throw CThreadErr(CThreadErr::ERR_THREAD_JOIN, "Driver::RunTest");
 		}
 	}
+
+	if (dArrivalRate > 0.0) {
+		// All threads have been joined, no need for m_LagLock.
+		cout << "Open-loop arrivals: " << m_arrivalLag.iArrivals << endl
+			 << "Arrivals started more than 1 ms late: "
+			 << m_arrivalLag.iLate << endl;
+		if (m_arrivalLag.iArrivals > 0) {
+			cout << "Mean arrival lag: "
+				 << m_arrivalLag.dTotal / m_arrivalLag.iArrivals * 1000.0
+				 << " ms" << endl
+				 << "Maximum arrival lag: " << m_arrivalLag.dMax * 1000.0
+				 << " ms" << endl;
+		}
+	}
+
+	// The users have stopped, the status lines end with the last of them.
+	m_pLatency->removeGauges(this);
+	if (m_pCoordinator != NULL)
+		leaveCoordinator();
+	CLatencyLog::detach();
+}
+
+void
+coordinatorIntervalReport(
+		void *data, const CHistogram *histograms, const INT64 *errors)
+{
+	reinterpret_cast<CDriver *>(data)->reportInterval(histograms, errors);
+}
+
+// Tell the coordinator this driver is ready and wait for it to start the
+// users.  The run cannot go on without it.
+void
+CDriver::waitForCoordinator()
+{
+	m_pCoordinator
+			= new CSocket(shard.szCoordinatorAddr, shard.iCoordinatorPort);
+	try {
+		m_pCoordinator->dbt5Connect();
+
+		ostringstream ready;
+		ready << "ready " << iUsers << endl;
+		string s = ready.str();
+		m_pCoordinator->dbt5Send(const_cast<char *>(s.c_str()), s.length());
+
+		cout << "Waiting for the coordinator at " << shard.szCoordinatorAddr
+			 << ":" << shard.iCoordinatorPort << " to start the users..."
+			 << endl;
+		string reply;
+		char c;
+		while (m_pCoordinator->dbt5Receive(&c, 1) == 1 && c != '\n')
+			reply += c;
+		if (reply != "start") {
+			cerr << "Error: unexpected reply from the coordinator: " << reply
+				 << endl;
+			exit(1);
+		}
+	} catch (CSocketErr *pErr) {
+		cerr << "Error: coordinator " << shard.szCoordinatorAddr << ":"
+			 << shard.iCoordinatorPort << ": " << pErr->ErrorText() << endl;
+		delete pErr;
+		exit(1);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &m_CoordinatorStart);
+	m_pLatency->setIntervalReport(&coordinatorIntervalReport, this);
+}
+
+// Called by the latency log thread.  The intervals are numbered by the
+// multiple of the interval length since the start they end before, so those
+// of all drivers line up without synchronized clocks.
+void
+CDriver::reportInterval(const CHistogram *histograms, const INT64 *errors)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	INT64 iElapsed = (INT64) (now.tv_sec - m_CoordinatorStart.tv_sec) * 1000000
+			+ (now.tv_nsec - m_CoordinatorStart.tv_nsec) / 1000;
+	INT64 iIntervalUs = (INT64) iLatencyInterval * 1000000;
+	if (iElapsed <= 0)
+		return;
+	int n = (int) ((iElapsed + iIntervalUs - 1) / iIntervalUs);
+
+	ostringstream message;
+	for (int i = 0; i < iLatencyTxnTypes; i++) {
+		if (histograms[i].count() == 0 && errors[i] == 0)
+			continue;
+		message << "interval " << n << " " << i << " " << errors[i] << " ";
+		histograms[i].write(message);
+		message << endl;
+	}
+	message << "end " << n << endl;
+	sendCoordinator(message.str());
+}
+
+// The run goes on without the coordinator if it goes away, the mix logs
+// still have the results.
+void
+CDriver::sendCoordinator(const string &message)
+{
+	Locker<CMutex> locker(m_CoordinatorLock);
+	if (m_pCoordinator == NULL)
+		return;
+
+	try {
+		m_pCoordinator->dbt5Send(
+				const_cast<char *>(message.c_str()), message.length());
+	} catch (CSocketErr *pErr) {
+		ostringstream osErr;
+		osErr << "coordinator connection lost: " << pErr->ErrorText()
+			  << endl;
+		logErrorMessage(osErr.str());
+		delete pErr;
+		delete m_pCoordinator;
+		m_pCoordinator = NULL;
+	}
+}
+
+// Report the last interval, which the users ended, and disconnect.
+void
+CDriver::leaveCoordinator()
+{
+	m_pLatency->finish();
+	m_pLatency->setIntervalReport(NULL, NULL);
+	sendCoordinator("done\n");
+
+	Locker<CMutex> locker(m_CoordinatorLock);
+	delete m_pCoordinator;
+	m_pCoordinator = NULL;
+}
+
+// Start the pool of scheduler threads the users are spread over, then wait
+// out the ramp-up.  User i still starts (i - 1) * iSleep milliseconds into the
+// ramp-up, the same as when each user has its own thread.
+void
+CDriver::startCustomerSchedulers(int iSleep)
+{
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	for (int i = 0; i < iWorkers; i++) {
+		m_schedulers.push_back(new CCustomerScheduler(this));
+	}
+	for (int i = 1; i <= iUsers; i++) {
+		struct timespec due = start;
+		addMilliseconds(due, (long) iSleep * (i - 1));
+		m_schedulers[(i - 1) % iWorkers]->addUser(
+				shard.iUserOffset + i, due);
+	}
+
+	pthread_attr_t threadAttribute; // thread attribute
+	for (int i = 0; i < iWorkers; i++) {
+		try {
+			if (pthread_attr_init(&threadAttribute) != 0) {
+				throw CThreadErr(CThreadErr::ERR_THREAD_ATTR_INIT);
+			}
+
+			// g_tid[0] is the Data-Maintenance thread
+			if (pthread_create(&g_tid[i + 1], &threadAttribute,
+						&customerSchedulerThread,
+						reinterpret_cast<void *>(m_schedulers[i]))
+					!= 0) {
+				throw CThreadErr(CThreadErr::ERR_THREAD_CREATE);
+			}
+		} catch (const CThreadErr &pErr) {
+			cerr << "Scheduler thread " << i + 1 << " didn't spawn correctly"
+				 << endl
+				 << endl
+				 << "Error: " << pErr.ErrorText()
+				 << " at CDriver::startCustomerSchedulers" << endl;
+			exit(1);
+		}
+	}
+	cout << ">> " << iWorkers << " scheduler thread(s) running " << iUsers
+		 << " user(s)." << endl;
+
+	end = start;
+	addMilliseconds(end, (long) iSleep * iUsers);
+	sleepUntil(end);
+}
+
+// Each user offers an equal share of the open-loop arrival rate, starting at
+// the given time.  Returns NULL for the closed-loop mode.
+CArrivalSchedule *
+CDriver::newArrivalSchedule(UINT32 UniqueId, const struct timespec &start)
+{
+	if (dArrivalRate <= 0.0)
+		return NULL;
+
+	UINT32 iArrivalSeed = iSeed != 0 ? iSeed : (UINT32) time(NULL);
+	return new CArrivalSchedule(start, bPoisson, iArrivalSeed + UniqueId);
+}
+
+// Users above the active count, and all users while the open-loop rate is
+// 0, sit idle.  The count is of this driver's users, whatever their
+// UniqueIds.
+bool
+CDriver::userActive(UINT32 UniqueId)
+{
+	m_LoadLock.lock();
+	bool bActive = (int) (UniqueId - shard.iUserOffset) <= m_iActiveUsers
+			&& (dArrivalRate <= 0.0 || m_dCurrentRate > 0.0);
+	m_LoadLock.unlock();
+	return bActive;
+}
+
+void
+CDriver::userStarted()
+{
+	m_LoadLock.lock();
+	++m_iStartedUsers;
+	m_LoadLock.unlock();
+}
+
+// Mean nanoseconds between one user's open-loop arrivals: the active users
+// share the current rate.
+double
+CDriver::arrivalInterval()
+{
+	m_LoadLock.lock();
+	double dInterval = m_dCurrentRate > 0.0
+			? 1000000000.0 * m_iActiveUsers / m_dCurrentRate
+			: 1000000000.0;
+	m_LoadLock.unlock();
+	return dInterval;
+}
+
+// Set the load level, m_LoadLock must be held.
+void
+CDriver::setLoad(int iActiveUsers, double dRate)
+{
+	if (iActiveUsers < 0)
+		iActiveUsers = 0;
+	else if (iActiveUsers > iUsers)
+		iActiveUsers = iUsers;
+
+	if (iActiveUsers == m_iActiveUsers && dRate == m_dCurrentRate)
+		return;
+
+	m_iActiveUsers = iActiveUsers;
+	m_dCurrentRate = dRate;
+	m_fLoad << (long long) time(NULL) << "," << m_iActiveUsers << ","
+			<< m_dCurrentRate << endl;
+}
+
+// Replace the load profile and restart its clock, m_LoadLock must be held.
+void
+CDriver::setProfile(CLoadProfile *pProfile)
+{
+	delete m_pProfile;
+	m_pProfile = pProfile;
+	clock_gettime(CLOCK_MONOTONIC, &m_ProfileStart);
+}
+
+// The profile sets the open-loop rate, or the number of active users in
+// the closed-loop mode.
+void
+CDriver::applyLoadProfile()
+{
+	m_LoadLock.lock();
+	if (m_pProfile != NULL) {
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		double t = (double) (now.tv_sec - m_ProfileStart.tv_sec)
+				+ (double) (now.tv_nsec - m_ProfileStart.tv_nsec)
+						/ 1000000000.0;
+		double dValue = m_pProfile->valueAt(t);
+
+		if (dArrivalRate > 0.0)
+			setLoad(m_iActiveUsers, dValue);
+		else
+			setLoad((int) (dValue + 0.5), m_dCurrentRate);
+	}
+	m_LoadLock.unlock();
+}
+
+// Handle the text commands of one control connection, one per line:
+//
+//   users N         run N users, dropping any load profile
+//   rate TPS        set the open-loop rate, dropping any load profile
+//   profile SPEC    follow a new load profile from now on
+//   status          report the current load
+//   quit            close the connection
+void
+CDriver::serveControlConnection(int fd)
+{
+	FILE *in = fdopen(fd, "r");
+	if (in == NULL) {
+		close(fd);
+		return;
+	}
+
+	char line[iMaxPath + 1];
+	while (fgets(line, sizeof(line), in) != NULL) {
+		istringstream command(line);
+		string verb, arg;
+		ostringstream reply;
+
+		command >> verb;
+		getline(command >> ws, arg);
+		arg.erase(arg.find_last_not_of(" \t\r") + 1);
+
+		m_LoadLock.lock();
+		if (verb == "users" && !arg.empty()) {
+			setProfile(NULL);
+			setLoad(atoi(arg.c_str()), m_dCurrentRate);
+			reply << "ok users " << m_iActiveUsers;
+		} else if (verb == "rate" && !arg.empty()) {
+			if (dArrivalRate <= 0.0) {
+				reply << "error: not running open-loop";
+			} else {
+				setProfile(NULL);
+				setLoad(m_iActiveUsers, atof(arg.c_str()));
+				reply << "ok rate " << m_dCurrentRate;
+			}
+		} else if (verb == "profile" && !arg.empty()) {
+			try {
+				setProfile(new CLoadProfile(arg));
+				reply << "ok profile " << arg;
+			} catch (std::exception &e) {
+				reply << "error: " << e.what();
+			}
+		} else if (verb == "status") {
+			reply << "users " << m_iActiveUsers << "/" << iUsers << " rate "
+				  << m_dCurrentRate << " profile "
+				  << (m_pProfile != NULL ? m_pProfile->spec() : "none");
+		} else if (verb == "quit") {
+			m_LoadLock.unlock();
+			break;
+		} else {
+			reply << "error: unknown command: " << verb;
+		}
+		m_LoadLock.unlock();
+
+		// Apply a new profile right away instead of on the next tick.
+		applyLoadProfile();
+
+		reply << endl;
+		string s = reply.str();
+		if (send(fd, s.c_str(), s.length(), MSG_NOSIGNAL) == -1)
+			break;
+	}
+
+	// Also closes fd.
+	fclose(in);
+}
+
+// Follow the load profile once a second.
+void *
+loadControllerThread(void *data)
+{
+	CDriver *pDriver = reinterpret_cast<CDriver *>(data);
+
+	while (time(NULL) < stop_time) {
+		pDriver->applyLoadProfile();
+		sleep(1);
+	}
+
+	return NULL;
+}
+
+// Accept one control connection at a time.
+void *
+controlSocketThread(void *data)
+{
+	CDriver *pDriver = reinterpret_cast<CDriver *>(data);
+	CSocket sock;
+
+	try {
+		sock.dbt5Listen(pDriver->iControlPort);
+	} catch (CSocketErr *pErr) {
+		ostringstream osErr;
+		osErr << "control socket error: " << pErr->ErrorText() << endl;
+		pDriver->logErrorMessage(osErr.str());
+		delete pErr;
+		return NULL;
+	}
+	cout << ">> Listening for control commands on port "
+		 << pDriver->iControlPort << endl;
+
+	while (time(NULL) < stop_time) {
+		try {
+			pDriver->serveControlConnection(sock.dbt5Accept());
+		} catch (CSocketErr *pErr) {
+			ostringstream osErr;
+			osErr << "control socket error: " << pErr->ErrorText() << endl;
+			pDriver->logErrorMessage(osErr.str());
+			delete pErr;
+		}
+	}
+
+	return NULL;
+}
+
+// Start the threads that follow the load profile and listen for control
+// commands.  They are detached and simply end with the driver.
+void
+CDriver::startLoadController()
+{
+	if (m_pProfile == NULL && iControlPort == 0)
+		return;
+
+	m_LoadLock.lock();
+	clock_gettime(CLOCK_MONOTONIC, &m_ProfileStart);
+	m_fLoad << (long long) time(NULL) << "," << m_iActiveUsers << ","
+			<< m_dCurrentRate << endl;
+	m_LoadLock.unlock();
+	applyLoadProfile();
+
+	pthread_attr_t threadAttribute; // thread attribute
+	pthread_t tid;
+	try {
+		if (pthread_attr_init(&threadAttribute) != 0) {
+			throw CThreadErr(CThreadErr::ERR_THREAD_ATTR_INIT);
+		}
+		pthread_attr_setdetachstate(&threadAttribute, PTHREAD_CREATE_DETACHED);
+
+		if (pthread_create(&tid, &threadAttribute, &loadControllerThread,
+					reinterpret_cast<void *>(this))
+				!= 0) {
+			throw CThreadErr(CThreadErr::ERR_THREAD_CREATE);
+		}
+		if (iControlPort > 0) {
+			if (pthread_create(&tid, &threadAttribute, &controlSocketThread,
+						reinterpret_cast<void *>(this))
+					!= 0) {
+				throw CThreadErr(CThreadErr::ERR_THREAD_CREATE);
+			}
+		}
+	} catch (const CThreadErr &pErr) {
+		cerr << "Load controller thread not created successfully, exiting..."
+			 << endl
+			 << "Error: " << pErr.ErrorText() << endl;
+		exit(1);
+	}
+}
+
+void
+CDriver::addArrivalLag(const TArrivalLag &lag)
+{
+	m_LagLock.lock();
+	m_arrivalLag.add(lag);
+	m_LagLock.unlock();
 }
 
 // DM worker thread
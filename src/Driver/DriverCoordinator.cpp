@@ -0,0 +1,305 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "DriverCoordinator.h"
+#include "CSocket.h"
+#include "DBT5Consts.h"
+
+void *
+driverConnectionThread(void *data)
+{
+	CDriverCoordinator::PDriverConnection pDriver
+			= reinterpret_cast<CDriverCoordinator::PDriverConnection>(data);
+	pDriver->pCoordinator->serve(pDriver);
+	return NULL;
+}
+
+// A whole line, however long the histograms make it.
+static bool
+readLine(FILE *in, string &line)
+{
+	line.clear();
+	char buffer[4096];
+	while (fgets(buffer, sizeof(buffer), in) != NULL) {
+		line += buffer;
+		if (line[line.length() - 1] == '\n')
+			return true;
+	}
+	return !line.empty();
+}
+
+CDriverCoordinator::CDriverCoordinator(
+		int iDrivers, int iPort, const char *outputDirectory)
+: m_iDrivers(iDrivers), m_iPort(iPort), m_Cond(m_Lock), m_iReady(0),
+  m_iDone(0), m_tStart(0), m_iWritten(0)
+{
+	strncpy(m_szOutputDirectory, outputDirectory, iMaxPath);
+	m_szOutputDirectory[iMaxPath] = '\0';
+	memset(m_runErrors, 0, sizeof(m_runErrors));
+
+	char filename[iMaxPath + 1];
+	snprintf(filename, sizeof(filename), "%s/latency.log", outputDirectory);
+	m_fLog.open(filename, ios::out);
+	m_fLog << "time,txn,count,min,mean,p50,p90,p99,max,errors" << endl;
+}
+
+CDriverCoordinator::~CDriverCoordinator()
+{
+	for (size_t i = 0; i < m_drivers.size(); i++)
+		delete m_drivers[i];
+	for (map<int, PMergedInterval>::iterator it = m_intervals.begin();
+			it != m_intervals.end(); ++it)
+		delete it->second;
+}
+
+bool
+CDriverCoordinator::run()
+{
+	CSocket sock;
+	sock.dbt5Listen(m_iPort);
+	cout << ">> Waiting for " << m_iDrivers << " drivers on port " << m_iPort
+		 << endl;
+
+	for (int i = 0; i < m_iDrivers; i++) {
+		int fd = sock.dbt5Accept();
+
+		PDriverConnection pDriver = new TDriverConnection;
+		pDriver->pCoordinator = this;
+		pDriver->iDriver = i + 1;
+		pDriver->fd = fd;
+		pDriver->iUsers = 0;
+		pDriver->bReady = false;
+		pDriver->bDone = false;
+		pDriver->iLastInterval = 0;
+
+		m_Cond.lock();
+		m_drivers.push_back(pDriver);
+		m_Cond.unlock();
+
+		if (pthread_create(&pDriver->threadId, NULL, &driverConnectionThread,
+					pDriver)
+				!= 0) {
+			throw CThreadErr(
+					CThreadErr::ERR_THREAD_CREATE, "CDriverCoordinator::run");
+		}
+	}
+	sock.closeListenerSocket();
+
+	m_Cond.lock();
+	while (m_iReady < m_iDrivers && m_iDone == 0)
+		m_Cond.wait();
+
+	bool bStarted = m_iDone == 0;
+	if (bStarted) {
+		m_tStart = time(NULL);
+		int iUsers = 0;
+		for (size_t i = 0; i < m_drivers.size(); i++) {
+			iUsers += m_drivers[i]->iUsers;
+			if (send(m_drivers[i]->fd, "start\n", 6, MSG_NOSIGNAL) == -1)
+				cerr << "Warning: could not start driver "
+					 << m_drivers[i]->iDriver << endl;
+		}
+		cout << ">> Started " << m_iDrivers << " drivers with " << iUsers
+			 << " users" << endl;
+	} else {
+		cerr << "Error: a driver disconnected before the start, not starting "
+				"the others"
+			 << endl;
+		// The other drivers see their connection close and stop.
+		for (size_t i = 0; i < m_drivers.size(); i++)
+			shutdown(m_drivers[i]->fd, SHUT_RDWR);
+	}
+	m_Cond.unlock();
+
+	for (size_t i = 0; i < m_drivers.size(); i++)
+		pthread_join(m_drivers[i]->threadId, NULL);
+
+	if (bStarted)
+		writeRun();
+	return bStarted;
+}
+
+void
+CDriverCoordinator::serve(PDriverConnection pDriver)
+{
+	FILE *in = fdopen(pDriver->fd, "r");
+	if (in == NULL) {
+		close(pDriver->fd);
+	} else {
+		string line;
+		while (readLine(in, line)) {
+			istringstream message(line);
+			string verb;
+			message >> verb;
+
+			if (verb == "done")
+				break;
+
+			Locker<CMutex> locker(m_Lock);
+			if (verb == "ready") {
+				message >> pDriver->iUsers;
+				if (!pDriver->bReady) {
+					pDriver->bReady = true;
+					++m_iReady;
+					cout << "Driver " << pDriver->iDriver << " ready with "
+						 << pDriver->iUsers << " users (" << m_iReady << "/"
+						 << m_iDrivers << ")" << endl;
+					m_Cond.signal();
+				}
+			} else if (verb == "interval") {
+				merge(pDriver, message);
+			} else if (verb == "end") {
+				int n;
+				if (message >> n && n > pDriver->iLastInterval) {
+					pDriver->iLastInterval = n;
+					writeIntervals();
+				}
+			} else {
+				cerr << "Warning: driver " << pDriver->iDriver
+					 << " sent an unknown message: " << verb << endl;
+			}
+		}
+		// Also closes the socket.
+		fclose(in);
+	}
+
+	// The driver no longer holds back the intervals others ended.
+	Locker<CMutex> locker(m_Lock);
+	pDriver->bDone = true;
+	++m_iDone;
+	cout << "Driver " << pDriver->iDriver << " done" << endl;
+	m_Cond.signal();
+	writeIntervals();
+}
+
+// interval <n> <txn> <errors> <histogram>, called locked.
+void
+CDriverCoordinator::merge(PDriverConnection pDriver, istringstream &message)
+{
+	int n, iTxn;
+	long long iErrors;
+	if (!(message >> n >> iTxn >> iErrors) || iTxn < 0
+			|| iTxn >= iLatencyTxnTypes) {
+		cerr << "Warning: driver " << pDriver->iDriver
+			 << " sent a malformed interval" << endl;
+		return;
+	}
+	if (n <= m_iWritten) {
+		cerr << "Warning: driver " << pDriver->iDriver << " sent interval "
+			 << n << " after it was written" << endl;
+		return;
+	}
+
+	PMergedInterval &pInterval = m_intervals[n];
+	if (pInterval == NULL)
+		pInterval = new TMergedInterval;
+	if (!pInterval->histograms[iTxn].read(message)) {
+		cerr << "Warning: driver " << pDriver->iDriver
+			 << " sent a malformed histogram" << endl;
+		return;
+	}
+	pInterval->errors[iTxn] += iErrors;
+}
+
+// Write out the intervals every connected driver ended, called locked.
+void
+CDriverCoordinator::writeIntervals()
+{
+	int iEnded = INT_MAX;
+	for (size_t i = 0; i < m_drivers.size(); i++) {
+		if (!m_drivers[i]->bDone && m_drivers[i]->iLastInterval < iEnded)
+			iEnded = m_drivers[i]->iLastInterval;
+	}
+
+	while (!m_intervals.empty() && m_intervals.begin()->first <= iEnded) {
+		int n = m_intervals.begin()->first;
+		PMergedInterval pInterval = m_intervals.begin()->second;
+		m_intervals.erase(m_intervals.begin());
+
+		writeInterval(n, pInterval);
+		m_iWritten = n;
+		delete pInterval;
+	}
+}
+
+// Log the merged interval like a driver's latency log, with its end as the
+// time, print a status line like a driver's and add it to the run.
+void
+CDriverCoordinator::writeInterval(int n, PMergedInterval pInterval)
+{
+	long iTime = (long) m_tStart + (long) n * iLatencyInterval;
+
+	CHistogram all;
+	INT64 iErrors = 0;
+	char line[256];
+	for (int i = 0; i < iLatencyTxnTypes; i++) {
+		const CHistogram &h = pInterval->histograms[i];
+		all.add(h);
+		iErrors += pInterval->errors[i];
+		m_run[i].add(h);
+		m_runErrors[i] += pInterval->errors[i];
+		if (h.count() == 0 && pInterval->errors[i] == 0)
+			continue;
+
+		snprintf(line, sizeof(line),
+				"%ld,%d,%lld,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%lld\n", iTime, i,
+				(long long) h.count(), h.min() / 1000000.0,
+				h.mean() / 1000000.0, h.valueAtPercentile(50.0) / 1000000.0,
+				h.valueAtPercentile(90.0) / 1000000.0,
+				h.valueAtPercentile(99.0) / 1000000.0, h.max() / 1000000.0,
+				(long long) pInterval->errors[i]);
+		m_fLog << line;
+	}
+	m_fLog.flush();
+
+	snprintf(line, sizeof(line),
+			"%ld status: tps %.0f tpsE %.0f errors %.0f p90 %.3f s interval "
+			"%d",
+			iTime, (double) all.count() / iLatencyInterval,
+			(double) pInterval->histograms[TRADE_RESULT].count()
+					/ iLatencyInterval,
+			(double) iErrors / iLatencyInterval,
+			all.valueAtPercentile(90.0) / 1000000.0, n);
+	cout << line << endl;
+}
+
+// The histograms of the whole run, values in milliseconds, and its totals.
+void
+CDriverCoordinator::writeRun()
+{
+	CHistogram all;
+	INT64 iErrors = 0;
+	for (int i = 0; i < iLatencyTxnTypes; i++) {
+		all.add(m_run[i]);
+		iErrors += m_runErrors[i];
+		if (m_run[i].count() == 0)
+			continue;
+
+		char name[sizeof(szTransactionName[i])];
+		for (size_t j = 0; j < sizeof(name); j++)
+			name[j] = tolower(szTransactionName[i][j]);
+
+		char filename[iMaxPath + 1];
+		snprintf(filename, sizeof(filename), "%s/latency-%s.hgrm",
+				m_szOutputDirectory, name);
+		ofstream f(filename, ios::out);
+		m_run[i].writePercentiles(f, 1000.0);
+	}
+
+	char line[256];
+	snprintf(line, sizeof(line),
+			">> Run of %d drivers: %lld transactions, %lld errors, p90 "
+			"%.3f s",
+			m_iDrivers, (long long) all.count(), (long long) iErrors,
+			all.valueAtPercentile(90.0) / 1000000.0);
+	cout << line << endl;
+}
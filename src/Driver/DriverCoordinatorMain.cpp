@@ -0,0 +1,108 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Starts the driver processes of a run together and merges their intervals,
+ * see DriverCoordinator.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "DriverCoordinator.h"
+#include "DBT5Consts.h"
+
+// Establish defaults for command line options
+int iDrivers = 0; // # of drivers to start together
+int iListenPort = iDriverCoordinatorPort; // socket port to listen
+// path to output files
+char outputDirectory[iMaxPath + 1] = ".";
+
+// shows program usage
+void
+usage()
+{
+	cout << "Usage: DriverCoordinatorMain [options]" << endl << endl;
+	cout << "   Option      Default     Description" << endl;
+	cout << "   ==========  ==========  =============================" << endl;
+	cout << "   -d integer              # of drivers to start together"
+		 << endl;
+	printf("   -l integer  %-10d  Socket listen port\n", iListenPort);
+	printf("   -o string   %-10s  directory for output files\n",
+			outputDirectory);
+}
+
+// Parse command line
+void
+parse_command_line(int argc, char *argv[])
+{
+	int ch;
+
+	while ((ch = getopt(argc, argv, "d:l:o:")) != -1) {
+		switch (ch) {
+		case 'd':
+			iDrivers = atoi(optarg);
+			break;
+		case 'l':
+			iListenPort = atoi(optarg);
+			if (iListenPort < 1 || iListenPort > 65535) {
+				cerr << "Error: invalid port for -l: " << optarg << endl;
+				exit(1);
+			}
+			break;
+		case 'o':
+			strncpy(outputDirectory, optarg, iMaxPath);
+			outputDirectory[iMaxPath] = '\0';
+			break;
+		default:
+			usage();
+			exit(1);
+		}
+	}
+
+	if (optind < argc) {
+		usage();
+		cout << endl << "Error: unexpected argument: " << argv[optind]
+			 << endl;
+		exit(1);
+	}
+	if (iDrivers < 1) {
+		usage();
+		cout << endl << "Error: the number of drivers (-d) must be given"
+			 << endl;
+		exit(1);
+	}
+}
+
+int
+main(int argc, char *argv[])
+{
+	cout << "dbt5 - Driver Coordinator Main" << endl;
+
+	parse_command_line(argc, argv);
+
+	try {
+		CDriverCoordinator coordinator(iDrivers, iListenPort, outputDirectory);
+		if (!coordinator.run())
+			return 1;
+	} catch (CBaseErr *pErr) {
+		cout << "Error " << pErr->ErrorNum() << ": " << pErr->ErrorText();
+		if (pErr->ErrorLoc()) {
+			cout << " at " << pErr->ErrorLoc();
+		}
+		cout << endl;
+		return 1;
+	} catch (CBaseErr &err) {
+		cout << "Error " << err.ErrorNum() << ": " << err.ErrorText();
+		if (err.ErrorLoc()) {
+			cout << " at " << err.ErrorLoc();
+		}
+		cout << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -7,13 +7,12 @@
  * 12 August 2006
  */
 
-// TODO Partitioning by C_ID: This should be done by using the apropriate CCE's
-// constructor.
-
 #include <unistd.h>
+#include <stdexcept>
 
 #include "Driver.h"
 #include "DBT5Consts.h"
+#include "LoadProfile.h"
 
 // Establish defaults for command line options
 char szBHaddr[iMaxHostname + 1] = "localhost"; // Brokerage House address
@@ -28,6 +27,13 @@ int iTestDuration = 0;
 int iSleep = 1000; // msec between thread creation
 int iUsers = 0; // # users
 int iPacingDelay = 0;
+int iWorkers = 0; // # threads in the user pool, 0 for one per user
+double dArrivalRate = 0.0; // open-loop txn/s, 0 for closed-loop
+bool bPoisson = false;
+char szLoadProfile[iMaxPath + 1] = ""; // see LoadProfile.h
+int iControlPort = 0; // 0 for no control socket
+bool bTrace = false;
+TDriverShard shard; // this driver's part of a multi-process run
 
 char szInDir[iMaxPath + 1]; // path to EGen input files
 char outputDirectory[iMaxPath + 1] = "."; // path to output files
@@ -43,25 +49,56 @@ usage()
 		 << "   Option      Default    Description" << endl
 		 << "   ==========  =========  ==============================="
 		 << endl;
+	printf("   -a string              Coordinator address, to start the\n");
+	printf("                          users when it says so\n");
+	printf("   -A integer  %-9d  Coordinator port\n", shard.iCoordinatorPort);
+	printf("   -B integer             Start users at this Unix time\n");
 	printf("   -c integer  %-9ld  Active customer count\n",
 			iActiveCustomerCount);
+	printf("   -C integer             Control socket port\n");
 	printf("   -d integer             Duration of the test (seconds)\n");
+	printf("   -D                     Leave Trade-Cleanup and\n");
+	printf("                          Data-Maintenance to another driver\n");
 	printf("   -f integer  %-9d  # of customers per 1 TRTPS\n", iScaleFactor);
 	printf("   -h string   %-9s  Brokerage House address\n", szBHaddr);
 	printf("   -i string   %-9s  Path to EGen flat_in directory\n", szInDir);
+	printf("   -L string              Load profile of active users, or of\n");
+	printf("                          the open-loop rate with -R:\n");
+	printf("                          step:FROM:TO:STEP:SECONDS\n");
+	printf("                          linear:FROM:TO:SECONDS\n");
+	printf("                          sine:MEAN:AMPLITUDE:PERIOD\n");
+	printf("                          file:PATH\n");
 	printf("   -n integer  %-9d  millisecond delay between transactions\n",
 			iPacingDelay);
 	printf("   -o string   %-9s  # directory for output files\n",
 			outputDirectory);
 	printf("   -p integer  %-9d  Brokerage House listener port\n",
 			iBHListenerPort);
+	printf("   -P                     Poisson open-loop arrivals\n");
+	printf("   -R number   %-9g  Open-loop transactions per second\n",
+			dArrivalRate);
+	printf("                          0 waits for each reply and the\n");
+	printf("                          pacing delay (closed-loop)\n");
 	printf("   -r integer             Random number generator seed\n");
 	printf("                          Invalidates run if used\n");
+	printf("   -s integer  %-9ld  First customer of this driver's\n",
+			shard.iMyStartingCustomerId);
+	printf("                          partition\n");
+	printf("   -S integer             # of customers in this driver's\n");
+	printf("                          partition, 0 for no partitioning\n");
+	printf("   -T                     Capture the requests in trace files\n");
 	printf("   -t integer  %-9ld  Configured customer count\n",
 			iConfiguredCustomerCount);
 	printf("   -u integer             # of Users\n");
+	printf("   -U integer  %-9u  UniqueId offset of this driver's users\n",
+			shard.iUserOffset);
 	printf("   -w integer  %-9d  # of Days of Initial Trades\n",
 			iDaysOfInitialTrades);
+	printf("   -W integer  %-9d  # of threads in the user pool\n",
+			iWorkers);
+	printf("                          0 runs each user on its own thread\n");
+	printf("   -X integer  %-9d  %% of transactions in the partition\n",
+			shard.iPartitionPercent);
 	printf("   -y integer  %-9d  millisecond delay between thread creation\n",
 			iSleep);
 }
@@ -74,14 +111,40 @@ parse_command_line(int argc, char *argv[])
 
 	// getopt reports missing option arguments and unknown options,
 	// unlike the old hand rolled parser, which silently accepted them.
-	while ((ch = getopt(argc, argv, "c:d:f:h:i:n:o:p:r:t:u:w:y:")) != -1) {
+	while ((ch = getopt(argc, argv,
+					"a:A:B:c:C:d:Df:h:i:L:n:o:p:Pr:R:s:S:t:Tu:U:w:W:X:y:"))
+			!= -1) {
 		switch (ch) {
+		case 'a':
+			strncpy(shard.szCoordinatorAddr, optarg, iMaxHostname);
+			shard.szCoordinatorAddr[iMaxHostname] = '\0';
+			break;
+		case 'A':
+			shard.iCoordinatorPort = atoi(optarg);
+			if (shard.iCoordinatorPort < 1 || shard.iCoordinatorPort > 65535) {
+				cerr << "Error: invalid port for -A: " << optarg << endl;
+				exit(1);
+			}
+			break;
+		case 'B':
+			shard.tStart = (time_t) atol(optarg);
+			break;
 		case 'c':
 			iActiveCustomerCount = atol(optarg);
 			break;
+		case 'C':
+			iControlPort = atoi(optarg);
+			if (iControlPort < 1 || iControlPort > 65535) {
+				cerr << "Error: invalid port for -C: " << optarg << endl;
+				exit(1);
+			}
+			break;
 		case 'd':
 			iTestDuration = atoi(optarg);
 			break;
+		case 'D':
+			shard.bDataMaintenance = false;
+			break;
 		case 'f':
 			iScaleFactor = atoi(optarg);
 			break;
@@ -93,6 +156,17 @@ parse_command_line(int argc, char *argv[])
 			strncpy(szInDir, optarg, iMaxPath);
 			szInDir[iMaxPath] = '\0';
 			break;
+		case 'L':
+			strncpy(szLoadProfile, optarg, iMaxPath);
+			szLoadProfile[iMaxPath] = '\0';
+			// Fail before the minutes spent loading the flat_in files.
+			try {
+				CLoadProfile profile(szLoadProfile);
+			} catch (std::runtime_error &e) {
+				cerr << "Error: " << e.what() << endl;
+				exit(1);
+			}
+			break;
 		case 'n':
 			iPacingDelay = atoi(optarg);
 			break;
@@ -107,18 +181,42 @@ parse_command_line(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'P':
+			bPoisson = true;
+			break;
 		case 'r':
 			iSeed = atoi(optarg);
 			break;
+		case 'R':
+			dArrivalRate = atof(optarg);
+			break;
+		case 's':
+			shard.iMyStartingCustomerId = atol(optarg);
+			break;
+		case 'S':
+			shard.iMyCustomerCount = atol(optarg);
+			break;
 		case 't':
 			iConfiguredCustomerCount = atol(optarg);
 			break;
+		case 'T':
+			bTrace = true;
+			break;
 		case 'w':
 			iDaysOfInitialTrades = atoi(optarg);
 			break;
+		case 'W':
+			iWorkers = atoi(optarg);
+			break;
 		case 'u':
 			iUsers = atoi(optarg);
 			break;
+		case 'U':
+			shard.iUserOffset = (UINT32) atol(optarg);
+			break;
+		case 'X':
+			shard.iPartitionPercent = atoi(optarg);
+			break;
 		case 'y':
 			iSleep = atoi(optarg);
 			break;
@@ -204,6 +302,44 @@ ValidateParameters()
 		bRet = false;
 	}
 
+	if (iWorkers < 0) {
+		cerr << "The number of scheduler threads (-W " << iWorkers
+			 << ") must not be negative." << endl;
+		bRet = false;
+	}
+
+	if (dArrivalRate < 0.0) {
+		cerr << "The open-loop transaction rate (-R " << dArrivalRate
+			 << ") must not be negative." << endl;
+		bRet = false;
+	} else if (dArrivalRate > 0.0 && iPacingDelay > 0) {
+		cerr << "Warning: the pacing delay (-n) is ignored with an "
+				"open-loop transaction rate (-R)."
+			 << endl;
+	}
+
+	// EGen partitions customers in whole load units.
+	if (shard.iMyCustomerCount != 0) {
+		if (shard.iMyCustomerCount < 0
+				|| shard.iMyCustomerCount % iDefaultLoadUnitSize != 0
+				|| (shard.iMyStartingCustomerId - 1) % iDefaultLoadUnitSize
+						!= 0
+				|| shard.iMyStartingCustomerId < 1
+				|| shard.iMyStartingCustomerId - 1 + shard.iMyCustomerCount
+						> iActiveCustomerCount) {
+			cerr << "The partition (-s " << shard.iMyStartingCustomerId
+				 << " -S " << shard.iMyCustomerCount
+				 << ") must be whole load units (" << iDefaultLoadUnitSize
+				 << ") within the active customers." << endl;
+			bRet = false;
+		}
+		if (shard.iPartitionPercent < 0 || shard.iPartitionPercent > 100) {
+			cerr << "The partition percentage (-X "
+				 << shard.iPartitionPercent << ") must be 0 to 100." << endl;
+			bRet = false;
+		}
+	}
+
 	// iTestDuration must be assigned
 	if (iTestDuration == 0) {
 		cerr << "The duration of the test must be specified." << endl;
@@ -255,11 +391,38 @@ main(int argc, char *argv[])
 	cout << "Scale Factor: " << iScaleFactor << endl << endl;
 
 	cout << "User Threads: " << iUsers << endl;
+	if (iWorkers > 0)
+		cout << "Scheduler Threads: " << iWorkers << endl;
 	cout << "Sleep between creating users: " << iSleep << endl << endl;
 
 	cout << "Test duration (sec): " << iTestDuration << endl;
 	cout << "Pacing Delay (msec): " << iPacingDelay << endl << endl;
+	if (dArrivalRate > 0.0) {
+		cout << "Open-loop rate (txn/sec): " << dArrivalRate
+			 << (bPoisson ? " Poisson" : " fixed") << endl
+			 << endl;
+	}
 	cout << "Unique ID (seed): " << iSeed << endl;
+	if (szLoadProfile[0] != '\0')
+		cout << "Load profile: " << szLoadProfile << endl;
+	if (iControlPort > 0)
+		cout << "Control port: " << iControlPort << endl;
+	if (shard.iUserOffset > 0)
+		cout << "UniqueId offset: " << shard.iUserOffset << endl;
+	if (shard.iMyCustomerCount > 0) {
+		cout << "Customer partition: " << shard.iMyStartingCustomerId << " to "
+			 << shard.iMyStartingCustomerId + shard.iMyCustomerCount - 1
+			 << " (" << shard.iPartitionPercent << "%)" << endl;
+	}
+	if (!shard.bDataMaintenance)
+		cout << "Data-Maintenance: left to another driver" << endl;
+	if (shard.szCoordinatorAddr[0] != '\0')
+		cout << "Coordinator: " << shard.szCoordinatorAddr << ":"
+			 << shard.iCoordinatorPort << endl;
+	else if (shard.tStart > 0)
+		cout << "Synchronized start: " << (long) shard.tStart << endl;
+	if (bTrace)
+		cout << "Capturing requests in trace files" << endl;
 
 	try {
 		const DataFileManager inputFiles(szInDir, iConfiguredCustomerCount,
@@ -267,7 +430,8 @@ main(int argc, char *argv[])
 		CDriver Driver(inputFiles, szInDir, iConfiguredCustomerCount,
 				iActiveCustomerCount, iScaleFactor, iDaysOfInitialTrades,
 				iSeed, szBHaddr, iBHListenerPort, iUsers, iPacingDelay,
-				outputDirectory);
+				iWorkers, dArrivalRate, bPoisson, szLoadProfile, iControlPort,
+				bTrace, shard, outputDirectory);
 		Driver.runTest(iSleep, iTestDuration);
 
 	} catch (CBaseErr *pErr) {
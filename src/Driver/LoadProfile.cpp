@@ -0,0 +1,139 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "LoadProfile.h"
+
+static const double dPi = 3.14159265358979323846;
+
+CLoadProfile::CLoadProfile(const string &spec): m_spec(spec)
+{
+	string::size_type colon = spec.find(':');
+	if (colon == string::npos) {
+		throw std::runtime_error("load profile needs a shape: " + spec);
+	}
+
+	string shape = spec.substr(0, colon);
+	string args = spec.substr(colon + 1);
+
+	if (shape == "file") {
+		m_eShape = FILE_DRIVEN;
+		loadFile(args);
+		return;
+	}
+
+	size_t nargs;
+	if (shape == "step") {
+		m_eShape = STEP;
+		nargs = 4;
+	} else if (shape == "linear") {
+		m_eShape = LINEAR;
+		nargs = 3;
+	} else if (shape == "sine") {
+		m_eShape = SINE;
+		nargs = 3;
+	} else {
+		throw std::runtime_error("unknown load profile shape: " + shape);
+	}
+
+	// Numbers separated by colons.
+	istringstream in(args);
+	string field;
+	size_t i = 0;
+	while (getline(in, field, ':')) {
+		char *end;
+		if (i == nargs) {
+			throw std::runtime_error("too many load profile values: " + spec);
+		}
+		m_dArgs[i] = strtod(field.c_str(), &end);
+		if (field.empty() || *end != '\0') {
+			throw std::runtime_error("invalid load profile value: " + field);
+		}
+		++i;
+	}
+	if (i != nargs) {
+		throw std::runtime_error("too few load profile values: " + spec);
+	}
+
+	if (m_eShape == STEP && (m_dArgs[2] == 0.0 || m_dArgs[3] <= 0.0)) {
+		throw std::runtime_error(
+				"load profile step and interval must not be 0: " + spec);
+	}
+	if (m_eShape == SINE && m_dArgs[2] <= 0.0) {
+		throw std::runtime_error(
+				"load profile period must be positive: " + spec);
+	}
+}
+
+void
+CLoadProfile::loadFile(const string &filename)
+{
+	ifstream file(filename.c_str());
+	if (!file) {
+		throw std::runtime_error("cannot open load profile " + filename);
+	}
+
+	string line;
+	while (getline(file, line)) {
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		istringstream in(line);
+		double seconds, value;
+		if (!(in >> seconds >> value)) {
+			throw std::runtime_error(
+					"invalid line in load profile " + filename + ": " + line);
+		}
+		if (!m_points.empty() && seconds < m_points.back().first) {
+			throw std::runtime_error(
+					"load profile times must not decrease: " + line);
+		}
+		m_points.push_back(make_pair(seconds, value));
+	}
+	if (m_points.empty()) {
+		throw std::runtime_error("empty load profile " + filename);
+	}
+}
+
+// Load level the given number of seconds into the profile, never negative.
+double
+CLoadProfile::valueAt(double t) const
+{
+	double value = 0.0;
+
+	switch (m_eShape) {
+	case STEP: {
+		double from = m_dArgs[0], to = m_dArgs[1], step = m_dArgs[2];
+		value = from + step * floor(t / m_dArgs[3]);
+		if ((step > 0.0 && value > to) || (step < 0.0 && value < to))
+			value = to;
+		break;
+	}
+	case LINEAR:
+		if (m_dArgs[2] <= 0.0 || t >= m_dArgs[2])
+			value = m_dArgs[1];
+		else
+			value = m_dArgs[0] + (m_dArgs[1] - m_dArgs[0]) * t / m_dArgs[2];
+		break;
+	case SINE:
+		value = m_dArgs[0] + m_dArgs[1] * sin(2.0 * dPi * t / m_dArgs[2]);
+		break;
+	case FILE_DRIVEN:
+		// Before the first point the first value applies.
+		value = m_points[0].second;
+		for (size_t i = 1; i < m_points.size() && m_points[i].first <= t; i++)
+			value = m_points[i].second;
+		break;
+	}
+
+	return value > 0.0 ? value : 0.0;
+}
@@ -0,0 +1,794 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Summarize mix logs like dbt5-post-process does, in one pass and without
+ * loading them into a database.  Reader threads, each with a share of the
+ * files, read every file ahead in batches of records, which the main thread
+ * merges by time.  The read-ahead of all the files together is bounded, so a
+ * run with a mix log per user gets smaller batches.  The response times of
+ * the run are kept, 8 bytes per transaction, for the 90th percentiles to be
+ * exactly those of dbt5-post-process.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include "CThreadErr.h"
+#include "MixLog.h"
+
+const int iTxnTypes = TRADE_CLEANUP + 1;
+
+// Establish defaults for command line options
+char szCustomers[32] = "Unspecified";
+int iInterval = 60; // seconds compared to find the steady state
+bool bSteadyState = false; // measure from the start of the steady state
+double dTolerance = 10.0; // percent
+char szRatesFile[iMaxPath + 1] = ""; // per minute throughput
+int iReaders = 0; // reader threads, 0 for one per processor
+
+// Records read ahead of the merge, of all the files together.
+const size_t iReadAheadBytes = 64 * 1024 * 1024;
+const size_t iBatchesAhead = 2; // per file
+const size_t iMinBatchRecords = 64;
+const size_t iMaxBatchRecords = 4096;
+
+static const char *szTxnName[iTxnTypes] = { "Security Detail",
+	"Broker Volume", "Customer Position", "Market Watch", "Trade Status",
+	"Trade Lookup", "Trade Order", "Trade Update", "Market Feed",
+	"Trade Result", "Data Maintenance", "Trade Cleanup" };
+
+// One mix log, binary or CSV.
+class CMixSource
+{
+private:
+	string m_filename;
+	CMixLogReader *m_pReader; // binary
+	FILE *m_pFile; // CSV
+
+	bool nextCSV(TMixLogRecord &);
+
+public:
+	// Throws std::runtime_error if the file cannot be read.
+	CMixSource(const char *);
+	~CMixSource();
+
+	// Returns false at the end of the log.
+	bool next(TMixLogRecord &);
+};
+
+CMixSource::CMixSource(const char *filename)
+: m_filename(filename), m_pReader(NULL), m_pFile(NULL)
+{
+	if (m_filename.size() > 4
+			&& m_filename.compare(m_filename.size() - 4, 4, ".bin") == 0) {
+		m_pReader = new CMixLogReader(filename);
+	} else {
+		m_pFile = fopen(filename, "r");
+		if (m_pFile == NULL) {
+			throw std::runtime_error("cannot open " + m_filename);
+		}
+	}
+}
+
+CMixSource::~CMixSource()
+{
+	delete m_pReader;
+	if (m_pFile != NULL)
+		fclose(m_pFile);
+}
+
+bool
+CMixSource::next(TMixLogRecord &record)
+{
+	if (m_pFile != NULL)
+		return nextCSV(record);
+
+	if (m_pReader->next(record))
+		return true;
+	if (!m_pReader->complete()) {
+		cerr << "Warning: " << m_filename << " is incomplete" << endl;
+	}
+	return false;
+}
+
+// time,txn,status,response,id with START and STOP lines as time,START,,,id
+bool
+CMixSource::nextCSV(TMixLogRecord &record)
+{
+	char line[256];
+	while (fgets(line, sizeof(line), m_pFile) != NULL) {
+		memset(&record, 0, sizeof(record));
+
+		char *p;
+		record.iTime = (INT64) floor(strtod(line, &p) * 1000000.0 + 0.5);
+		if (*p != ',')
+			continue;
+		++p;
+		if (strncmp(p, "START,", 6) == 0 || strncmp(p, "STOP,", 5) == 0) {
+			record.iTxn = p[2] == 'A' ? iMixLogStart : iMixLogStop;
+			p = strrchr(p, ',');
+			record.iId = atoi(p + 1);
+		} else {
+			record.iTxn = (INT32) strtol(p, &p, 10);
+			record.iStatus = (INT32) strtol(p + 1, &p, 10);
+			record.dRT = strtod(p + 1, &p);
+			record.iId = (INT32) strtol(p + 1, &p, 10);
+		}
+		return true;
+	}
+	return false;
+}
+
+typedef vector<TMixLogRecord> TMixBatch;
+
+// Reads the sources ahead of the merge on a pool of threads.
+class CMixReader
+{
+private:
+	typedef struct TSourceQueue
+	{
+		CMixSource *pSource;
+		deque<TMixBatch *> batches;
+		bool bEnd; // no more batches will be queued
+
+		// Only used by the merging thread.
+		TMixBatch *pCurrent;
+		size_t iNext;
+	} *PSourceQueue;
+
+	typedef struct TReaderParam
+	{
+		CMixReader *pReader;
+		int iReader;
+	} *PReaderParam;
+
+	vector<PSourceQueue> m_queues;
+	size_t m_iBatchRecords;
+	int m_iThreads;
+	vector<pthread_t> m_threads;
+
+	CMutex m_Lock;
+	CCondition m_Queued; // a batch was queued or a source ended
+	CCondition m_Taken; // a batch was taken, or stopping
+	bool m_bStop;
+
+	bool waiting(const vector<PSourceQueue> &);
+	void run(int);
+	void stop();
+
+	friend void *mixReaderThread(void *);
+
+public:
+	// Takes over the sources.  Throws CThreadErr if a reader thread cannot
+	// be started.
+	CMixReader(const vector<CMixSource *> &, int);
+	~CMixReader();
+
+	// The next record of a source, false at its end.
+	bool next(size_t, TMixLogRecord &);
+};
+
+void *
+mixReaderThread(void *data)
+{
+	CMixReader::PReaderParam pParam
+			= reinterpret_cast<CMixReader::PReaderParam>(data);
+	pParam->pReader->run(pParam->iReader);
+	delete pParam;
+	return NULL;
+}
+
+CMixReader::CMixReader(const vector<CMixSource *> &sources, int iThreads)
+: m_iThreads(iThreads), m_Queued(m_Lock), m_Taken(m_Lock), m_bStop(false)
+{
+	for (size_t i = 0; i < sources.size(); i++) {
+		PSourceQueue pQueue = new TSourceQueue;
+		pQueue->pSource = sources[i];
+		pQueue->bEnd = false;
+		pQueue->pCurrent = NULL;
+		pQueue->iNext = 0;
+		m_queues.push_back(pQueue);
+	}
+
+	m_iBatchRecords = iReadAheadBytes
+			/ (iBatchesAhead * sources.size() * sizeof(TMixLogRecord));
+	if (m_iBatchRecords < iMinBatchRecords)
+		m_iBatchRecords = iMinBatchRecords;
+	else if (m_iBatchRecords > iMaxBatchRecords)
+		m_iBatchRecords = iMaxBatchRecords;
+
+	if ((size_t) m_iThreads > sources.size())
+		m_iThreads = (int) sources.size();
+	for (int i = 0; i < m_iThreads; i++) {
+		PReaderParam pParam = new TReaderParam;
+		pParam->pReader = this;
+		pParam->iReader = i;
+
+		pthread_t threadId;
+		if (pthread_create(&threadId, NULL, &mixReaderThread, pParam) != 0) {
+			delete pParam;
+			stop();
+			throw CThreadErr(
+					CThreadErr::ERR_THREAD_CREATE, "CMixReader::ctor");
+		}
+		m_threads.push_back(threadId);
+	}
+}
+
+CMixReader::~CMixReader()
+{
+	stop();
+	for (size_t i = 0; i < m_queues.size(); i++) {
+		PSourceQueue pQueue = m_queues[i];
+		delete pQueue->pCurrent;
+		for (size_t j = 0; j < pQueue->batches.size(); j++)
+			delete pQueue->batches[j];
+		delete pQueue->pSource;
+		delete pQueue;
+	}
+}
+
+// The merge may end before the sources do, at the STOP marker.
+void
+CMixReader::stop()
+{
+	m_Taken.lock();
+	m_bStop = true;
+	m_Taken.broadcast();
+	m_Taken.unlock();
+	for (size_t i = 0; i < m_threads.size(); i++)
+		pthread_join(m_threads[i], NULL);
+	m_threads.clear();
+}
+
+// Whether none of the sources has room for another batch.  Called locked.
+bool
+CMixReader::waiting(const vector<PSourceQueue> &queues)
+{
+	for (size_t i = 0; i < queues.size(); i++) {
+		if (!queues[i]->bEnd && queues[i]->batches.size() < iBatchesAhead)
+			return false;
+	}
+	return true;
+}
+
+// Read batches of every iThreads-th source, starting with source iReader,
+// while they have room.
+void
+CMixReader::run(int iReader)
+{
+	vector<PSourceQueue> queues;
+	for (size_t i = iReader; i < m_queues.size(); i += m_iThreads)
+		queues.push_back(m_queues[i]);
+
+	size_t iOpen = queues.size();
+	while (iOpen > 0) {
+		m_Taken.lock();
+		while (!m_bStop && waiting(queues))
+			m_Taken.wait();
+		bool bStop = m_bStop;
+		m_Taken.unlock();
+		if (bStop)
+			break;
+
+		for (size_t i = 0; i < queues.size(); i++) {
+			PSourceQueue pQueue = queues[i];
+			// Only this thread queues batches of the source or ends it.
+			m_Queued.lock();
+			bool bRoom = !pQueue->bEnd
+					&& pQueue->batches.size() < iBatchesAhead;
+			m_Queued.unlock();
+			if (!bRoom)
+				continue;
+
+			TMixBatch *pBatch = new TMixBatch;
+			pBatch->reserve(m_iBatchRecords);
+			TMixLogRecord record;
+			while (pBatch->size() < m_iBatchRecords
+					&& pQueue->pSource->next(record))
+				pBatch->push_back(record);
+			bool bEnd = pBatch->size() < m_iBatchRecords;
+
+			m_Queued.lock();
+			if (pBatch->empty())
+				delete pBatch;
+			else
+				pQueue->batches.push_back(pBatch);
+			if (bEnd) {
+				pQueue->bEnd = true;
+				--iOpen;
+			}
+			m_Queued.signal();
+			m_Queued.unlock();
+		}
+	}
+}
+
+bool
+CMixReader::next(size_t iSource, TMixLogRecord &record)
+{
+	PSourceQueue pQueue = m_queues[iSource];
+	if (pQueue->pCurrent == NULL
+			|| pQueue->iNext == pQueue->pCurrent->size()) {
+		delete pQueue->pCurrent;
+		pQueue->pCurrent = NULL;
+
+		m_Queued.lock();
+		while (pQueue->batches.empty() && !pQueue->bEnd)
+			m_Queued.wait();
+		if (!pQueue->batches.empty()) {
+			pQueue->pCurrent = pQueue->batches.front();
+			pQueue->batches.pop_front();
+			pQueue->iNext = 0;
+			m_Taken.broadcast();
+		}
+		m_Queued.unlock();
+
+		if (pQueue->pCurrent == NULL)
+			return false;
+	}
+
+	record = (*pQueue->pCurrent)[pQueue->iNext++];
+	return true;
+}
+
+// Counts and response times of one transaction type.
+typedef struct TTxnStats
+{
+	INT64 iCount;
+	INT64 iRollbacks; // status 1
+	INT64 iWarnings; // status above 1
+	INT64 iInvalid; // negative status
+	double dSum;
+	double dMin;
+	double dMax;
+
+	TTxnStats()
+	: iCount(0), iRollbacks(0), iWarnings(0), iInvalid(0), dSum(0.0),
+	  dMin(0.0), dMax(0.0)
+	{
+	}
+
+	void
+	add(const TMixLogRecord &record)
+	{
+		if (iCount == 0 || record.dRT < dMin)
+			dMin = record.dRT;
+		if (iCount == 0 || record.dRT > dMax)
+			dMax = record.dRT;
+		dSum += record.dRT;
+		++iCount;
+		if (record.iStatus == 1)
+			++iRollbacks;
+		else if (record.iStatus > 1)
+			++iWarnings;
+		else if (record.iStatus < 0)
+			++iInvalid;
+	}
+
+	void
+	add(const TTxnStats &other)
+	{
+		if (other.iCount == 0)
+			return;
+		if (iCount == 0 || other.dMin < dMin)
+			dMin = other.dMin;
+		if (iCount == 0 || other.dMax > dMax)
+			dMax = other.dMax;
+		dSum += other.dSum;
+		iCount += other.iCount;
+		iRollbacks += other.iRollbacks;
+		iWarnings += other.iWarnings;
+		iInvalid += other.iInvalid;
+	}
+} *PTxnStats;
+
+// What is kept of one steady state interval.
+typedef struct TIntervalStats
+{
+	TTxnStats stats[iTxnTypes];
+	vector<double> responses[iTxnTypes];
+} *PIntervalStats;
+
+// The 90th percentile as dbt5-post-process takes it, the response at offset
+// count * 9 / 10 in ascending order.  Reorders the responses.
+double
+p90(vector<double> &responses)
+{
+	if (responses.empty())
+		return 0.0;
+	vector<double>::iterator k = responses.begin() + responses.size() * 9 / 10;
+	nth_element(responses.begin(), k, responses.end());
+	return *k;
+}
+
+void
+usage()
+{
+	cout << "Usage: MixLogAnalyzeMain {options} mixlog..." << endl
+		 << endl
+		 << "   Option      Default    Description" << endl
+		 << "   ==========  =========  ==============================="
+		 << endl;
+	printf("   -c string   %-9s  Total number of customers\n", szCustomers);
+	printf("   -i integer  %-9d  Seconds in the intervals compared to\n",
+			iInterval);
+	printf("                          find the steady state\n");
+	printf("   -j integer             Reader threads, default one per\n");
+	printf("                          processor\n");
+	printf("   -r string              Write the throughput per minute\n");
+	printf("                          to this CSV file\n");
+	printf("   -s                     Measure from the start of the\n");
+	printf("                          steady state\n");
+	printf("   -t number   %-9g  Tolerance of the steady state, in %%\n",
+			dTolerance);
+	printf("\n");
+	printf("Binary mix logs end in .bin, others are read as CSV.\n");
+}
+
+void
+parse_command_line(int argc, char *argv[])
+{
+	int ch;
+
+	while ((ch = getopt(argc, argv, "c:i:j:r:st:")) != -1) {
+		switch (ch) {
+		case 'c':
+			strncpy(szCustomers, optarg, sizeof(szCustomers) - 1);
+			szCustomers[sizeof(szCustomers) - 1] = '\0';
+			break;
+		case 'i':
+			iInterval = atoi(optarg);
+			if (iInterval < 1) {
+				cerr << "Error: invalid interval for -i: " << optarg << endl;
+				exit(1);
+			}
+			break;
+		case 'j':
+			iReaders = atoi(optarg);
+			if (iReaders < 1) {
+				cerr << "Error: invalid number of threads for -j: " << optarg
+					 << endl;
+				exit(1);
+			}
+			break;
+		case 'r':
+			strncpy(szRatesFile, optarg, iMaxPath);
+			szRatesFile[iMaxPath] = '\0';
+			break;
+		case 's':
+			bSteadyState = true;
+			break;
+		case 't':
+			dTolerance = atof(optarg);
+			break;
+		default:
+			usage();
+			exit(1);
+		}
+	}
+
+	if (optind == argc) {
+		usage();
+		cerr << endl << "Error: no mix logs given" << endl;
+		exit(1);
+	}
+}
+
+// Whether the relative standard deviation and drift of x[from] to the end
+// are within the limit, as dbt5-post-process decides it.
+bool
+stable(const vector<double> &x, size_t from, double limit)
+{
+	double m = (double) (x.size() - from);
+	double mean = 0.0;
+	for (size_t i = from; i < x.size(); i++)
+		mean += x[i];
+	mean /= m;
+	if (mean <= 0.0)
+		return false;
+
+	double sd = 0.0, sx = 0.0, sxx = 0.0, sxy = 0.0;
+	for (size_t i = from; i < x.size(); i++) {
+		double d = (double) (i - from);
+		sd += (x[i] - mean) * (x[i] - mean);
+		sx += d;
+		sxx += d * d;
+		sxy += d * x[i];
+	}
+	sd = sqrt(sd / m);
+	double slope = fabs((m * sxy - sx * m * mean) / (m * sxx - sx * sx));
+
+	return sd / mean <= limit && slope * (m - 1.0) / mean <= limit;
+}
+
+int
+main(int argc, char *argv[])
+{
+	parse_command_line(argc, argv);
+
+	vector<CMixSource *> sources;
+	try {
+		for (int i = optind; i < argc; i++)
+			sources.push_back(new CMixSource(argv[i]));
+	} catch (std::exception &e) {
+		cerr << "Error: " << e.what() << endl;
+		for (size_t i = 0; i < sources.size(); i++)
+			delete sources[i];
+		return 1;
+	}
+
+	if (iReaders == 0) {
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		iReaders = n > 0 ? (int) n : 1;
+	}
+	CMixReader *pReader;
+	try {
+		pReader = new CMixReader(sources, iReaders);
+	} catch (CThreadErr &e) {
+		cerr << "Error: " << e.ErrorText() << endl;
+		return 1;
+	}
+	size_t iSources = sources.size();
+
+	// Merge by time, markers before transactions of the same time so that
+	// only transactions after the start and before the end are counted.
+	typedef pair<pair<INT64, int>, size_t> THead;
+	priority_queue<THead, vector<THead>, greater<THead> > heads;
+	vector<TMixLogRecord> current(iSources);
+	for (size_t i = 0; i < iSources; i++) {
+		if (pReader->next(i, current[i]))
+			heads.push(THead(make_pair(current[i].iTime,
+									 current[i].iTxn < 0 ? 0 : 1),
+					i));
+	}
+
+	INT64 iTime0 = heads.empty() ? 0 : heads.top().first.first;
+	INT64 iStart = -1;
+	INT64 iEnd = -1;
+	INT64 iLast = iTime0;
+	INT64 iIntervalUs = (INT64) iInterval * 1000000;
+
+	TTxnStats run[iTxnTypes];
+	vector<PIntervalStats> intervals;
+	vector<INT64> minutes; // counts per minute and transaction type
+
+	while (!heads.empty()) {
+		size_t i = heads.top().second;
+		heads.pop();
+		TMixLogRecord record = current[i];
+		if (pReader->next(i, current[i]))
+			heads.push(THead(make_pair(current[i].iTime,
+									 current[i].iTxn < 0 ? 0 : 1),
+					i));
+
+		iLast = record.iTime;
+		if (record.iTxn == iMixLogStart) {
+			// The last start marker ends the ramp-up, everything before it
+			// does not count.
+			iStart = record.iTime;
+			for (int j = 0; j < iTxnTypes; j++)
+				run[j] = TTxnStats();
+			for (size_t j = 0; j < intervals.size(); j++)
+				delete intervals[j];
+			intervals.clear();
+			minutes.clear();
+			continue;
+		}
+		if (record.iTxn == iMixLogStop) {
+			iEnd = record.iTime;
+			break;
+		}
+		if (iStart < 0 || record.iTime <= iStart || record.iTxn >= iTxnTypes)
+			continue;
+
+		int iTxn = record.iTxn;
+		run[iTxn].add(record);
+
+		size_t k = (size_t) ((record.iTime - iStart) / iIntervalUs);
+		while (intervals.size() <= k)
+			intervals.push_back(new TIntervalStats);
+		PIntervalStats pInterval = intervals[k];
+		pInterval->stats[iTxn].add(record);
+		pInterval->responses[iTxn].push_back(record.dRT);
+
+		size_t m = (size_t) ((record.iTime - iStart) / 60000000);
+		if (minutes.size() < (m + 1) * iTxnTypes)
+			minutes.resize((m + 1) * iTxnTypes, 0);
+		++minutes[m * iTxnTypes + iTxn];
+	}
+
+	delete pReader;
+	if (iStart < 0) {
+		cerr << "Error: no START marker, the ramp-up never ended" << endl;
+		return 1;
+	}
+	if (iEnd < 0) {
+		cerr << "Warning: no STOP marker, measuring to the last transaction"
+			 << endl;
+		iEnd = iLast + 1;
+	}
+
+	// Find the steady state in the whole intervals of the run.
+	size_t n = (size_t) ((iEnd - iStart) / iIntervalUs);
+	vector<double> tps(n, 0.0), q90(n, 0.0);
+	for (size_t i = 0; i < n && i < intervals.size(); i++) {
+		tps[i] = (double) intervals[i]->stats[TRADE_RESULT].iCount / iInterval;
+		q90[i] = p90(intervals[i]->responses[TRADE_RESULT]);
+	}
+	int iSteady = -1;
+	for (size_t i = 0; i + 5 <= n; i++) {
+		if (stable(tps, i, dTolerance / 100.0)
+				&& stable(q90, i, dTolerance / 100.0)) {
+			iSteady = (int) i;
+			break;
+		}
+	}
+
+	INT64 iMeasureStart = iStart;
+	size_t iFirstInterval = 0;
+	if (iSteady < 0) {
+		fprintf(stderr,
+				"WARNING: no steady state within %g%% found in %d second "
+				"intervals\n",
+				dTolerance, iInterval);
+	} else if (bSteadyState) {
+		iMeasureStart = iStart + (INT64) iSteady * iIntervalUs;
+		iFirstInterval = (size_t) iSteady;
+		for (int j = 0; j < iTxnTypes; j++) {
+			run[j] = TTxnStats();
+			for (size_t i = iFirstInterval; i < intervals.size(); i++)
+				run[j].add(intervals[i]->stats[j]);
+		}
+	}
+
+	double dDuration = (double) (iEnd - iMeasureStart) / 60000000.0;
+	INT64 iTotal = 0;
+	for (int j = 0; j < iTxnTypes; j++)
+		iTotal += run[j].iCount;
+
+	// The same report as dbt5-post-process.
+	cout << "==========================================  "
+			"=================================="
+		 << endl;
+	if (run[TRADE_RESULT].iCount == 0)
+		printf("%s: %15s trtps  %s: %12s\n", "Reported Throughput", "N/A",
+				"Configured Customers", szCustomers);
+	else
+		printf("%s: %15.2f trtps  %s: %12s\n", "Reported Throughput",
+				(double) run[TRADE_RESULT].iCount / (dDuration * 60.0),
+				"Configured Customers", szCustomers);
+	cout << "==========================================  "
+			"=================================="
+		 << endl
+		 << endl;
+
+	static const int order[] = { 1, 2, 8, 3, 0, 5, 6, 9, 4, 7, 10 };
+	const int iOrder = sizeof(order) / sizeof(order[0]);
+
+	cout << "==================  ==========  ==========  ==========  "
+			"=========="
+		 << endl
+		 << "Response Times (s)     Minimum     Average  90th %tile     "
+			"Maximum"
+		 << endl
+		 << "==================  ==========  ==========  ==========  "
+			"=========="
+		 << endl;
+	for (int i = 0; i < iOrder; i++) {
+		const TTxnStats &s = run[order[i]];
+		double dAvg = s.iCount == 0 ? 0.0 : s.dSum / (double) s.iCount;
+		if (order[i] == DATA_MAINTENANCE) {
+			printf("%18s  %10.6f  %10.6f  %10s  %10.6f\n", szTxnName[order[i]],
+					s.dMin, dAvg, "N/A", s.dMax);
+			continue;
+		}
+
+		// One type at a time, to keep a single copy of the responses.
+		vector<double> responses;
+		responses.reserve((size_t) s.iCount);
+		for (size_t j = iFirstInterval; j < intervals.size(); j++) {
+			vector<double> &r = intervals[j]->responses[order[i]];
+			responses.insert(responses.end(), r.begin(), r.end());
+			vector<double>().swap(r);
+		}
+		printf("%18s  %10.6f  %10.6f  %10.6f  %10.6f\n", szTxnName[order[i]],
+				s.dMin, dAvg, p90(responses), s.dMax);
+	}
+	cout << "==================  ==========  ==========  ==========  "
+			"=========="
+		 << endl
+		 << endl;
+
+	cout << "==================  ==========  ==========  ==========  "
+			"==========  =========="
+		 << endl
+		 << "   Transaction Mix   Txn Count   Mix %tile  Rollbacks     "
+			"Warnings     Invalid"
+		 << endl
+		 << "==================  ==========  ==========  ==========  "
+			"==========  =========="
+		 << endl;
+	for (int i = 0; i < iOrder; i++) {
+		const TTxnStats &s = run[order[i]];
+		if (order[i] == DATA_MAINTENANCE) {
+			printf("%18s  %10lld  %10s  %10lld  %10lld  %10lld\n",
+					szTxnName[order[i]], (long long) s.iCount, "N/A",
+					(long long) s.iRollbacks, (long long) s.iWarnings,
+					(long long) s.iInvalid);
+		} else {
+			printf("%18s  %10lld  %10.3f  %10lld  %10lld  %10lld\n",
+					szTxnName[order[i]], (long long) s.iCount,
+					iTotal == 0 ? 0.0 : 100.0 * s.iCount / iTotal,
+					(long long) s.iRollbacks, (long long) s.iWarnings,
+					(long long) s.iInvalid);
+		}
+	}
+	cout << "==================  ==========  ==========  ==========  "
+			"==========  =========="
+		 << endl
+		 << endl;
+
+	cout << "=================================================================="
+			"  =========="
+		 << endl
+		 << "Test Duration and Timings" << endl
+		 << "=================================================================="
+			"  =========="
+		 << endl;
+	printf("%66s  %10.1f\n", "Ramp-up Time (minutes)",
+			(double) (iStart - iTime0) / 60000000.0);
+	if (iSteady < 0) {
+		printf("%66s  %10s\n", "Steady State Reached After Ramp-up (minutes)",
+				"N/A");
+	} else {
+		printf("%66s  %10.1f\n",
+				"Steady State Reached After Ramp-up (minutes)",
+				(double) iSteady * iInterval / 60.0);
+	}
+	printf("%66s  %10.1f\n", "Measurement Interval (minutes)", dDuration);
+	printf("%66s  %10lld\n",
+			"Total Number of Transactions Completed in Measurement Interval",
+			(long long) iTotal);
+	cout << "=================================================================="
+			"  =========="
+		 << endl;
+
+	if (iSteady < 0) {
+		printf("\nThe Trade-Result throughput and response times did not "
+			   "settle within\n%g%% over the last 5 or more %d second "
+			   "intervals of the run.\n",
+				dTolerance, iInterval);
+	} else if (bSteadyState) {
+		printf("\nThe measurement interval starts when the steady state was "
+			   "reached.\n");
+	}
+
+	if (szRatesFile[0] != '\0') {
+		ofstream fRates(szRatesFile, ios::out);
+		fRates << "minute,txn,tps" << endl;
+		for (size_t i = 0; i < minutes.size(); i++) {
+			if (minutes[i] == 0)
+				continue;
+			fRates << i / iTxnTypes << "," << i % iTxnTypes << ","
+				   << (double) minutes[i] / 60.0 << endl;
+		}
+	}
+
+	for (size_t i = 0; i < intervals.size(); i++)
+		delete intervals[i];
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Convert binary mix logs into the CSV mix logs read by dbt5-post-process.
+ * mix-ce-123.bin is written to mix-ce-123.log next to it.
+ */
+
+#include <stdio.h>
+#include <stdexcept>
+
+#include "MixLog.h"
+
+void
+usage()
+{
+	cout << "Usage: MixLogConvertMain mixlog.bin..." << endl;
+}
+
+// Returns false if the log could not be converted.
+bool
+convert(const char *szFilename)
+{
+	string csv(szFilename);
+	if (csv.size() > 4 && csv.compare(csv.size() - 4, 4, ".bin") == 0)
+		csv.erase(csv.size() - 4);
+	csv += ".log";
+
+	try {
+		CMixLogReader reader(szFilename);
+		ofstream fMix(csv.c_str(), ios::out);
+		if (!fMix) {
+			cerr << "Error: cannot create " << csv << endl;
+			return false;
+		}
+
+		// Times and response times in seconds with microseconds.
+		TMixLogRecord record;
+		char line[128];
+		while (reader.next(record)) {
+			int n = snprintf(line, sizeof(line), "%lld.%06d,",
+					(long long) (record.iTime / 1000000),
+					(int) (record.iTime % 1000000));
+			if (record.iTxn == iMixLogStart)
+				snprintf(line + n, sizeof(line) - n, "START,,,%d\n",
+						record.iId);
+			else if (record.iTxn == iMixLogStop)
+				snprintf(line + n, sizeof(line) - n, "STOP,,,%d\n",
+						record.iId);
+			else
+				snprintf(line + n, sizeof(line) - n, "%d,%d,%.6f,%d\n",
+						record.iTxn, record.iStatus, record.dRT, record.iId);
+			fMix << line;
+		}
+
+		// The writer was killed or the disk filled up, what was written
+		// out is still usable.
+		if (!reader.complete()) {
+			cerr << "Warning: " << szFilename << " is incomplete, converted "
+				 << reader.records() << " records" << endl;
+		}
+	} catch (std::exception &e) {
+		cerr << "Error: " << e.what() << endl;
+		return false;
+	}
+
+	return true;
+}
+
+int
+main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		usage();
+		return 1;
+	}
+
+	int iErrors = 0;
+	for (int i = 1; i < argc; i++) {
+		if (!convert(argv[i]))
+			++iErrors;
+	}
+
+	return iErrors == 0 ? 0 : 1;
+}
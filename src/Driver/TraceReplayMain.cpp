@@ -0,0 +1,272 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Send the requests captured by DriverMain -T to a Brokerage House again,
+ * at the pace they were captured, faster, or as fast as possible.
+ */
+
+#include <errno.h>
+#include <unistd.h>
+#include <vector>
+
+#include "BaseInterface.h"
+#include "DBT5Consts.h"
+#include "TxnTrace.h"
+
+// Establish defaults for command line options
+char szBHaddr[iMaxHostname + 1] = "localhost"; // Brokerage House address
+int iBHListenerPort = iBrokerageHousePort;
+int iConnections = 1;
+double dSpeed = 1.0; // multiple of the captured pace, 0 for no pacing
+char outputDirectory[iMaxPath + 1] = "."; // path to output files
+
+// One connection to the Brokerage House, logging like a driver user.
+class CReplayInterface: public CBaseInterface
+{
+public:
+	CReplayInterface(char *outputDirectory, char *addr, int iListenPort,
+			pid_t id)
+	: CBaseInterface("rp", outputDirectory, addr, iListenPort, id)
+	{
+	}
+
+	bool
+	send(PMsgDriverBrokerage pRequest)
+	{
+		return talkToSUT(pRequest);
+	}
+};
+
+// The trace files of one connection and the next request of each.
+typedef struct TReplayThreadParam
+{
+	int iConnection;
+	std::vector<CTxnTraceReader *> readers;
+	std::vector<TTraceRecord> records;
+	std::vector<TMsgDriverBrokerage> requests;
+	std::vector<bool> pending;
+	INT64 iFirstTime; // microseconds, earliest request of all traces
+	struct timespec start; // CLOCK_MONOTONIC
+	UINT64 iSent;
+} *PReplayThreadParam;
+
+void
+usage()
+{
+	cout << "Usage: TraceReplayMain {options} trace..." << endl
+		 << endl
+		 << "   Option      Default    Description" << endl
+		 << "   ==========  =========  ==============================="
+		 << endl;
+	printf("   -h string   %-9s  Brokerage House address\n", szBHaddr);
+	printf("   -n integer  %-9d  # of connections\n", iConnections);
+	printf("   -o string   %-9s  # directory for output files\n",
+			outputDirectory);
+	printf("   -p integer  %-9d  Brokerage House listener port\n",
+			iBHListenerPort);
+	printf("   -s number   %-9g  Multiple of the captured pace\n", dSpeed);
+	printf("                          0 sends as fast as possible\n");
+}
+
+void
+parse_command_line(int argc, char *argv[])
+{
+	int ch;
+
+	while ((ch = getopt(argc, argv, "h:n:o:p:s:")) != -1) {
+		switch (ch) {
+		case 'h':
+			strncpy(szBHaddr, optarg, iMaxHostname);
+			szBHaddr[iMaxHostname] = '\0';
+			break;
+		case 'n':
+			iConnections = atoi(optarg);
+			break;
+		case 'o':
+			strncpy(outputDirectory, optarg, iMaxPath);
+			outputDirectory[iMaxPath] = '\0';
+			break;
+		case 'p':
+			iBHListenerPort = atoi(optarg);
+			if (iBHListenerPort < 1 || iBHListenerPort > 65535) {
+				cerr << "Error: invalid port for -p: " << optarg << endl;
+				exit(1);
+			}
+			break;
+		case 's':
+			dSpeed = atof(optarg);
+			break;
+		default:
+			usage();
+			exit(1);
+		}
+	}
+
+	if (optind == argc) {
+		usage();
+		cerr << endl << "Error: no trace files given" << endl;
+		exit(1);
+	}
+	if (iConnections < 1 || dSpeed < 0.0) {
+		cerr << "Error: -n must be positive and -s must not be negative"
+			 << endl;
+		exit(1);
+	}
+}
+
+void *
+replayThread(void *data)
+{
+	PReplayThreadParam pParam = reinterpret_cast<PReplayThreadParam>(data);
+
+	try {
+		CReplayInterface bh(outputDirectory, szBHaddr, iBHListenerPort,
+				pParam->iConnection);
+
+		while (true) {
+			// Merge the traces of this connection by time, so each
+			// user's requests keep their order.
+			int next = -1;
+			for (size_t i = 0; i < pParam->readers.size(); i++) {
+				if (pParam->pending[i]
+						&& (next == -1
+								|| pParam->records[i].iTime
+										< pParam->records[next].iTime))
+					next = i;
+			}
+			if (next == -1)
+				break;
+
+			if (dSpeed > 0.0) {
+				INT64 iOffset = (INT64) ((double) (pParam->records[next].iTime
+												  - pParam->iFirstTime)
+						* 1000.0 / dSpeed);
+				struct timespec due = pParam->start;
+				due.tv_sec += iOffset / 1000000000;
+				due.tv_nsec += iOffset % 1000000000;
+				if (due.tv_nsec >= 1000000000) {
+					++due.tv_sec;
+					due.tv_nsec -= 1000000000;
+				}
+				while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due,
+							   NULL)
+						== EINTR)
+					;
+				// Count any time spent behind schedule, as in open-loop
+				// mode.
+				bh.setIntendedStart(due);
+			}
+
+			bh.send(&pParam->requests[next]);
+			++pParam->iSent;
+
+			pParam->pending[next] = pParam->readers[next]->next(
+					pParam->records[next], pParam->requests[next]);
+		}
+
+		bh.logStopTime();
+	} catch (CBaseErr *pErr) {
+		cerr << "connection " << pParam->iConnection
+			 << " error: " << pErr->ErrorText() << endl;
+		delete pErr;
+	} catch (std::exception &e) {
+		cerr << "connection " << pParam->iConnection << " error: " << e.what()
+			 << endl;
+	}
+
+	return NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+	cout << "dbt5 - Trace Replay Main" << endl;
+
+	parse_command_line(argc, argv);
+
+	int iTraces = argc - optind;
+	if (iConnections > iTraces) {
+		// Each trace goes over one connection to keep its order.
+		cout << "Using " << iTraces << " connection(s), one per trace file"
+			 << endl;
+		iConnections = iTraces;
+	}
+
+	std::vector<TReplayThreadParam> params(iConnections);
+	INT64 iFirstTime = 0;
+	UINT64 iSent = 0;
+
+	try {
+		// Trace i is replayed over connection i modulo the connections.
+		for (int i = 0; i < iTraces; i++) {
+			PReplayThreadParam pParam = &params[i % iConnections];
+			CTxnTraceReader *pReader
+					= new CTxnTraceReader(argv[optind + i]);
+			TTraceRecord record;
+			TMsgDriverBrokerage request;
+			bool bPending = pReader->next(record, request);
+
+			pParam->readers.push_back(pReader);
+			pParam->records.push_back(record);
+			pParam->requests.push_back(request);
+			pParam->pending.push_back(bPending);
+			if (bPending && (iFirstTime == 0 || record.iTime < iFirstTime))
+				iFirstTime = record.iTime;
+		}
+	} catch (std::exception &e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+
+	cout << "Replaying " << iTraces << " trace file(s) over " << iConnections
+		 << " connection(s) ";
+	if (dSpeed > 0.0)
+		cout << "at " << dSpeed << " times the captured pace" << endl;
+	else
+		cout << "as fast as possible" << endl;
+
+	// Mark the start for dbt5-post-process like DriverMain does.
+	char filename[iMaxPath + 1];
+	snprintf(filename, sizeof(filename), "%s/%s", outputDirectory,
+			CE_MIX_LOG_NAME);
+	CMixLogWriter mix(filename);
+	mix.logStart(getpid());
+	mix.flush();
+
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	CDateTime StartReplay;
+
+	std::vector<pthread_t> tids(iConnections);
+	for (int i = 0; i < iConnections; i++) {
+		params[i].iConnection = i + 1;
+		params[i].iFirstTime = iFirstTime;
+		params[i].start = start;
+		params[i].iSent = 0;
+		if (pthread_create(&tids[i], NULL, &replayThread,
+					reinterpret_cast<void *>(&params[i]))
+				!= 0) {
+			cerr << "Error: cannot create connection thread " << i + 1
+				 << endl;
+			return 1;
+		}
+	}
+	for (int i = 0; i < iConnections; i++) {
+		pthread_join(tids[i], NULL);
+		iSent += params[i].iSent;
+		for (size_t j = 0; j < params[i].readers.size(); j++)
+			delete params[i].readers[j];
+	}
+
+	CDateTime EndReplay;
+	double dElapsed = EndReplay - StartReplay;
+	cout << iSent << " request(s) replayed in " << dElapsed << " seconds";
+	if (dElapsed > 0.0)
+		cout << ", " << (double) iSent / dElapsed << " per second";
+	cout << endl;
+
+	return 0;
+}
@@ -7,60 +7,186 @@
  * 30 July 2006
  */
 
+#include <time.h>
+
 #include "MarketExchange.h"
+#include "Probes.h"
+
+static INT64
+monotonicNanoseconds()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (INT64) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
 
 // Fire expired MEE timers.  SubmitTradeRequest and GenerateTradeResult
 // return the number of milliseconds until the next pending timer, and
 // GenerateTradeResult must be called when that time elapses or pending
 // Trade-Result and triggered Market-Feed transactions are never sent.
+// GenerateTradeResult processes every timer that has expired, so one call
+// per tick covers all the timers of that tick.
 void *
 MarketTimerThread(void *data)
 {
-	CMarketExchange *pMarketExchange
-			= reinterpret_cast<CMarketExchange *>(data);
+	CMEEShard *pShard = reinterpret_cast<CMEEShard *>(data);
 
-	pMarketExchange->m_TimerCond.lock();
-	while (!pMarketExchange->m_TimerShutdown) {
-		if (pMarketExchange->m_NextTimerDelay < 0) {
+	pShard->m_TimerCond.lock();
+	while (!pShard->m_TimerShutdown) {
+		if (!pShard->m_bTimerPending) {
 			// No outstanding timers; wait for a trade request to start
 			// one.
-			pMarketExchange->m_TimerCond.wait();
+			pShard->m_TimerCond.wait();
 			continue;
 		}
 
-		unsigned int generation = pMarketExchange->m_TimerGeneration;
-		pMarketExchange->m_TimerCond.timedwait(
-				(long) pMarketExchange->m_NextTimerDelay * 1000);
-		if (pMarketExchange->m_TimerShutdown) {
-			break;
-		}
-		if (generation != pMarketExchange->m_TimerGeneration) {
-			// A trade request rescheduled the next timer; reevaluate.
+		INT64 now = monotonicNanoseconds();
+		if (now < pShard->m_iTimerWake) {
+			// A trade request signals if it needs an earlier tick.
+			pShard->m_TimerCond.timedwait(
+					(long) ((pShard->m_iTimerWake - now + 999) / 1000));
 			continue;
 		}
 
-		pMarketExchange->m_TimerCond.unlock();
-		INT32 next = pMarketExchange->m_pCMEE->GenerateTradeResult();
-		pMarketExchange->m_TimerCond.lock();
-		if (generation == pMarketExchange->m_TimerGeneration) {
-			pMarketExchange->m_NextTimerDelay = next;
-		}
+		pShard->addTimerLateness(now - pShard->m_iTimerDue);
+		pShard->m_bTimerPending = false;
+
+		pShard->m_TimerCond.unlock();
+		DBT5_PROBE1(mee__timer, now - pShard->m_iTimerDue);
+		INT32 next = pShard->m_pCMEE->GenerateTradeResult();
+		pShard->m_TimerCond.lock();
+		pShard->scheduleTimer(next);
 	}
-	pMarketExchange->m_TimerCond.unlock();
+	pShard->m_TimerCond.unlock();
 
 	return NULL;
 }
 
+CMEEShard::CMEEShard(const DataFileManager &inputFiles, CBaseLogger *pLog,
+		UINT32 UniqueId, char *outputDirectory, char *szBHaddr,
+		int iBHlistenPort, pid_t id, int iTimerTick)
+: m_TimerCond(m_TimerLock), m_iTimerTick((INT64) iTimerTick * 1000000),
+  m_bTimerPending(false), m_iTimerDue(0), m_iTimerWake(0),
+  m_TimerShutdown(false), m_iTimersFired(0), m_iTimersLate(0),
+  m_dTimerLateTotal(0.0), m_dTimerLateMax(0.0), m_tTimerReport(time(NULL))
+{
+	char filename[iMaxPath + 1];
+	snprintf(filename, sizeof(filename), "%s/mee-timer-%d.log",
+			outputDirectory, id);
+	m_fTimerLog.open(filename, ios::out);
+
+	// Initialize MEESUT
+	m_pCMEESUT = new CMEESUT(outputDirectory, szBHaddr, iBHlistenPort, id);
+
+	// Initialize MEE
+	m_pCMEE = new CMEE(0, m_pCMEESUT, pLog, inputFiles, UniqueId);
+	m_pCMEE->SetBaseTime();
+
+	// Fire deferred trade processing when its timers expire.
+	if (pthread_create(&m_TimerThreadId, NULL, &MarketTimerThread, this)
+			!= 0) {
+		throw CThreadErr(CThreadErr::ERR_THREAD_CREATE, "CMEEShard::ctor");
+	}
+}
+
+CMEEShard::~CMEEShard()
+{
+	// Stop the timer thread before tearing down the MEE it uses.
+	m_TimerCond.lock();
+	m_TimerShutdown = true;
+	m_TimerCond.broadcast();
+	m_TimerCond.unlock();
+	pthread_join(m_TimerThreadId, NULL);
+
+	delete m_pCMEE;
+	delete m_pCMEESUT;
+}
+
+// Called with m_TimerLock held by the timer thread.  Writes a line of
+// time,fired,late,mean ms,max ms every iTimerReportInterval seconds.
+void
+CMEEShard::addTimerLateness(INT64 iLateness)
+{
+	double dLate = iLateness > 0 ? (double) iLateness / 1000000000.0 : 0.0;
+
+	++m_iTimersFired;
+	if (iLateness > m_iTimerTick)
+		++m_iTimersLate;
+	m_dTimerLateTotal += dLate;
+	if (dLate > m_dTimerLateMax)
+		m_dTimerLateMax = dLate;
+
+	time_t now = time(NULL);
+	if (now - m_tTimerReport < iTimerReportInterval)
+		return;
+
+	m_fTimerLog << now << "," << m_iTimersFired << "," << m_iTimersLate
+				<< "," << m_dTimerLateTotal / m_iTimersFired * 1000.0 << ","
+				<< m_dTimerLateMax * 1000.0 << endl;
+	m_iTimersFired = 0;
+	m_iTimersLate = 0;
+	m_dTimerLateTotal = 0.0;
+	m_dTimerLateMax = 0.0;
+	m_tTimerReport = now;
+}
+
+// The Trade-Result of a trade sent by a sampled request is sampled too.
 void
-CMarketExchange::updateNextTimer(INT32 delay)
+CMEEShard::submitTradeRequest(PTradeRequest pTradeRequest, INT64 iTxnId)
 {
+	if (iTxnId != 0)
+		m_pCMEESUT->setParentTxnId(pTradeRequest->trade_id, iTxnId);
+
+	DBT5_PROBE2(mee__submit, pTradeRequest->trade_id, iTxnId);
+	INT32 delay = m_pCMEE->SubmitTradeRequest(pTradeRequest);
+
 	m_TimerCond.lock();
-	m_NextTimerDelay = delay;
-	++m_TimerGeneration;
-	m_TimerCond.signal();
+	scheduleTimer(delay);
 	m_TimerCond.unlock();
 }
 
+// The transactions the MEE has sent to the Brokerage House that are still
+// running.
+int
+CMEEShard::queueDepth()
+{
+	return m_pCMEESUT->outstanding();
+}
+
+// Called with m_TimerLock held.  The MEE reports the delay to its earliest
+// timer, so a later one than already scheduled needs nothing.
+void
+CMEEShard::scheduleTimer(INT32 delay)
+{
+	if (delay < 0)
+		return;
+
+	INT64 due = monotonicNanoseconds() + (INT64) delay * 1000000;
+	if (m_bTimerPending && due >= m_iTimerDue)
+		return;
+
+	INT64 wake = (due + m_iTimerTick - 1) / m_iTimerTick * m_iTimerTick;
+	bool bSooner = !m_bTimerPending || wake < m_iTimerWake;
+
+	m_bTimerPending = true;
+	m_iTimerDue = due;
+	m_iTimerWake = wake;
+	if (bSooner)
+		m_TimerCond.signal();
+}
+
+long
+queueDepthGauge(void *data)
+{
+	CMarketExchange *pMarketExchange
+			= reinterpret_cast<CMarketExchange *>(data);
+
+	long iDepth = 0;
+	for (size_t i = 0; i < pMarketExchange->m_shards.size(); i++)
+		iDepth += pMarketExchange->m_shards[i]->queueDepth();
+	return iDepth;
+}
+
 // worker thread
 void *
 MarketWorkerThread(void *data)
@@ -70,28 +196,30 @@ MarketWorkerThread(void *data)
 	CSocket sockDrv;
 	sockDrv.setSocketFd(pThrParam->iSockfd); // client socket
 
-	PTradeRequest pMessage = new TTradeRequest;
-	memset(pMessage, 0, sizeof(TTradeRequest)); // zero the structure
+	PMsgBrokerageMarket pMessage = new TMsgBrokerageMarket;
+	memset(pMessage, 0, sizeof(TMsgBrokerageMarket)); // zero the structure
+	PTradeRequest pTradeRequest = &pMessage->TradeRequest;
 
 	do {
 		try {
-			sockDrv.dbt5Receive(
-					reinterpret_cast<void *>(pMessage), sizeof(TTradeRequest));
+			sockDrv.dbt5Receive(reinterpret_cast<void *>(pMessage),
+					sizeof(TMsgBrokerageMarket));
 
 			if (pThrParam->pMarketExchange->verbose()) {
 				cout << "TTradeRequest" << endl
-					 << "  price_quote: " << pMessage->price_quote << endl
-					 << "  trade_id: " << pMessage->trade_id << endl
-					 << "  trade_qty: " << pMessage->trade_qty << endl
-					 << "  eAction: " << pMessage->eAction << endl
-					 << "  symbol: " << pMessage->symbol << endl
-					 << "  trade_type_id: " << pMessage->trade_type_id << endl;
+					 << "  txn_id: " << pMessage->iTxnId << endl
+					 << "  price_quote: " << pTradeRequest->price_quote << endl
+					 << "  trade_id: " << pTradeRequest->trade_id << endl
+					 << "  trade_qty: " << pTradeRequest->trade_qty << endl
+					 << "  eAction: " << pTradeRequest->eAction << endl
+					 << "  symbol: " << pTradeRequest->symbol << endl
+					 << "  trade_type_id: " << pTradeRequest->trade_type_id
+					 << endl;
 			}
 
-			// submit trade request
-			pThrParam->pMarketExchange->updateNextTimer(
-					pThrParam->pMarketExchange->m_pCMEE->SubmitTradeRequest(
-							pMessage));
+			// submit trade request to the shard of its security
+			pThrParam->pMarketExchange->shardFor(pTradeRequest)
+					->submitTradeRequest(pTradeRequest, pMessage->iTxnId);
 		} catch (CSocketErr *pErr) {
 			sockDrv.dbt5Disconnect(); // close connection
 
@@ -159,46 +287,58 @@ EntryMarketWorkerThread(void *data)
 CMarketExchange::CMarketExchange(const DataFileManager &inputFiles,
 		char *szFileLoc, UINT32 UniqueId, TIdent iConfiguredCustomerCount,
 		TIdent iActiveCustomerCount, int iListenPort, char *szBHaddr,
-		int iBHlistenPort, char *outputDirectory, bool verbose = false)
-: m_UniqueId(UniqueId), m_iListenPort(iListenPort), m_Verbose(verbose),
-  m_TimerCond(m_TimerLock), m_NextTimerDelay(-1), m_TimerGeneration(0),
-  m_TimerShutdown(false)
+		int iBHlistenPort, int iShards, int iTimerTick, char *outputDirectory,
+		bool verbose = false)
+: m_UniqueId(UniqueId), m_iListenPort(iListenPort), m_Verbose(verbose)
 {
 	char filename[iMaxPath + 1];
 	snprintf(filename, sizeof(filename), "%s/MarketExchange.log",
 			outputDirectory);
 	m_pLog = new CEGenLogger(eDriverEGenLoader, 0, filename, &m_fmt);
 
-	// Initialize MEESUT
-	m_pCMEESUT = new CMEESUT(outputDirectory, szBHaddr, iBHlistenPort);
-
-	// Initialize MEE
-	m_pCMEE = new CMEE(0, m_pCMEESUT, m_pLog, inputFiles, UniqueId);
-	m_pCMEE->SetBaseTime();
-
-	// Fire deferred trade processing when its timers expire.
-	if (pthread_create(&m_TimerThreadId, NULL, &MarketTimerThread, this)
-			!= 0) {
-		throw CThreadErr(
-				CThreadErr::ERR_THREAD_CREATE, "CMarketExchange::ctor");
+	if (iShards == 1) {
+		m_shards.push_back(new CMEEShard(inputFiles, m_pLog, UniqueId,
+				outputDirectory, szBHaddr, iBHlistenPort, 0, iTimerTick));
+	} else {
+		// Each shard needs its own id for the MEE's random numbers and its
+		// log file names.
+		for (int i = 0; i < iShards; i++) {
+			m_shards.push_back(new CMEEShard(inputFiles, m_pLog,
+					(UniqueId - 1) * iShards + i + 1, outputDirectory,
+					szBHaddr, iBHlistenPort, i + 1, iTimerTick));
+		}
 	}
+
+	m_pLatency = CLatencyLog::attach(outputDirectory);
+	m_pLatency->addGauge("queue", &queueDepthGauge, this);
 }
 
 // Destructor
 CMarketExchange::~CMarketExchange()
 {
-	// Stop the timer thread before tearing down the MEE it uses.
-	m_TimerCond.lock();
-	m_TimerShutdown = true;
-	m_TimerCond.broadcast();
-	m_TimerCond.unlock();
-	pthread_join(m_TimerThreadId, NULL);
+	m_pLatency->removeGauges(this);
+	CLatencyLog::detach();
 
-	delete m_pCMEE;
-	delete m_pCMEESUT;
+	for (size_t i = 0; i < m_shards.size(); i++)
+		delete m_shards[i];
 	delete m_pLog;
 }
 
+// The shard for the security of a trade request.
+CMEEShard *
+CMarketExchange::shardFor(const TTradeRequest *pTradeRequest)
+{
+	if (m_shards.size() == 1)
+		return m_shards[0];
+
+	unsigned int hash = 0;
+	for (size_t i = 0; i < sizeof(pTradeRequest->symbol)
+			&& pTradeRequest->symbol[i] != '\0';
+			i++)
+		hash = hash * 31 + (unsigned char) pTradeRequest->symbol[i];
+	return m_shards[hash % m_shards.size()];
+}
+
 void
 CMarketExchange::startListener(void)
 {
@@ -22,6 +22,8 @@ TIdent iConfiguredCustomerCount = iDefaultCustomerCount;
 // total number of customers in the database
 TIdent iActiveCustomerCount = iDefaultCustomerCount;
 
+int iShards = 1; // # of MEE instances sharing the securities
+int iTimerTick = iDefaultTimerTick; // ms
 bool verbose = false;
 
 // EGen flat_ing directory location
@@ -40,6 +42,8 @@ usage()
 			iActiveCustomerCount);
 	cout << "   -i string               Location of EGen flat_in directory"
 		 << endl;
+	printf("   -k integer  %-10d  MEE timer tick in milliseconds\n",
+			iTimerTick);
 	printf("   -l integer  %-10d  Socket listen port\n", iListenPort);
 	printf("   -h string   %-10s  Brokerage House address\n", szBHaddr);
 	printf("   -o string   %-10s  directory for output files\n",
@@ -48,6 +52,8 @@ usage()
 			iConfiguredCustomerCount);
 	printf("   -p integer  %-10d  Brokerage House listen port\n",
 			iBHlistenPort);
+	printf("   -s integer  %-10d  # of MEE instances, sharded by symbol\n",
+			iShards);
 	cout << "   -v                      Verbose output" << endl;
 }
 
@@ -59,7 +65,7 @@ parse_command_line(int argc, char *argv[])
 
 	// getopt reports missing option arguments and unknown options,
 	// unlike the old hand rolled parser, which silently accepted them.
-	while ((ch = getopt(argc, argv, "c:h:i:l:o:p:t:v")) != -1) {
+	while ((ch = getopt(argc, argv, "c:h:i:k:l:o:p:s:t:v")) != -1) {
 		switch (ch) {
 		case 'c':
 			iActiveCustomerCount = atol(optarg);
@@ -72,6 +78,13 @@ parse_command_line(int argc, char *argv[])
 			strncpy(szFileLoc, optarg, iMaxPath);
 			szFileLoc[iMaxPath] = '\0';
 			break;
+		case 'k':
+			iTimerTick = atoi(optarg);
+			if (iTimerTick < 1) {
+				cerr << "Error: invalid timer tick for -k: " << optarg << endl;
+				exit(1);
+			}
+			break;
 		case 'l':
 			iListenPort = atoi(optarg);
 			if (iListenPort < 1 || iListenPort > 65535) {
@@ -90,6 +103,14 @@ parse_command_line(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 's':
+			iShards = atoi(optarg);
+			if (iShards < 1) {
+				cerr << "Error: invalid number of MEE instances for -s: "
+					 << optarg << endl;
+				exit(1);
+			}
+			break;
 		case 't':
 			iConfiguredCustomerCount = atol(optarg);
 			break;
@@ -141,13 +162,16 @@ main(int argc, char *argv[])
 	cout << "Active customer count: " << iActiveCustomerCount << endl;
 	cout << "Brokerage House address: " << szBHaddr << endl;
 	cout << "Brokerage House port: " << iBHlistenPort << endl;
+	cout << "MEE instances: " << iShards << endl;
+	cout << "MEE timer tick: " << iTimerTick << " ms" << endl;
 
 	try {
 		const DataFileManager inputFiles(szFileLoc, iConfiguredCustomerCount,
 				iActiveCustomerCount, TPCE::DataFileManager::IMMEDIATE_LOAD);
 		CMarketExchange MarketExchange(inputFiles, szFileLoc, 1,
 				iConfiguredCustomerCount, iActiveCustomerCount, iListenPort,
-				szBHaddr, iBHlistenPort, outputDirectory, verbose);
+				szBHaddr, iBHlistenPort, iShards, iTimerTick, outputDirectory,
+				verbose);
 		cout << "Market Exchange started, waiting for trade requests..."
 			 << endl;
 
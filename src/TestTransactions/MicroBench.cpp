@@ -0,0 +1,729 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Microbenchmarks of the code between EGen and the database that runs for
+ * every transaction or every loaded row: parsing the array and composite
+ * literals of the server side frames, the PostgreSQL epoch conversions, the
+ * COPY row formatting of the loaders, and the driver's messages to the
+ * Brokerage House over loopback.  Every benchmark reports nanoseconds and
+ * operator new calls per operation, optionally as JSON that a later run
+ * compares itself to.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+
+#include "EGenBaseLoader_stdafx.h"
+#include "custom/pgsql/PGSQLHoldingHistoryLoad.h"
+#include "custom/pgsql/PGSQLTradeHistoryLoad.h"
+#include "custom/pgsql/PGSQLTradeLoad.h"
+
+#include "CESUT.h"
+#include "CSocket.h"
+#include "DBConnectionServerSide.h"
+
+// Establish defaults for command line options
+char szFilter[iMaxPath + 1] = ""; // run the benchmarks containing this
+char szBaseline[iMaxPath + 1] = ""; // compare with this earlier output
+char szJSON[iMaxPath + 1] = ""; // write the results here
+char szLabel[iMaxPath + 1] = ""; // e.g. the commit measured
+char szOutputDirectory[iMaxPath + 1] = "."; // logs of CCESUT
+INT64 iIterations = 0; // 0 to pick them from iMinTime
+int iMinTime = 200; // milliseconds per repetition
+int iRepetitions = 5;
+double dThreshold = 10.0; // percent slower that is a regression
+
+// operator new calls by the thread, so that the echo and latency log
+// threads are not counted.
+static __thread INT64 iAllocations = 0;
+
+void *
+operator new(size_t size) throw(std::bad_alloc)
+{
+	++iAllocations;
+	void *p = malloc(size == 0 ? 1 : size);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+
+void *
+operator new[](size_t size) throw(std::bad_alloc)
+{
+	return operator new(size);
+}
+
+void
+operator delete(void *p) throw()
+{
+	free(p);
+}
+
+void
+operator delete[](void *p) throw()
+{
+	free(p);
+}
+
+// Keeps the compiler from dropping the work.
+volatile INT64 iSink;
+
+//
+// Array and composite literals, as the server side frame functions return
+// them.
+//
+
+static string sArray;
+static string sComposite;
+static string sCompositeArray;
+
+void
+benchTokenizeSmart(INT64 n)
+{
+	INT64 sum = 0;
+	for (INT64 i = 0; i < n; i++) {
+		vector<string> tokens;
+		TokenizeSmart(sArray, tokens);
+		sum += tokens.size();
+	}
+	iSink = sum;
+}
+
+void
+benchTokenizeComposite(INT64 n)
+{
+	INT64 sum = 0;
+	for (INT64 i = 0; i < n; i++) {
+		vector<string> fields;
+		TokenizeComposite(sComposite, fields);
+		sum += fields.size();
+	}
+	iSink = sum;
+}
+
+// An array of composites, like the daily market history of
+// Security-Detail.
+void
+benchTokenizeCompositeArray(INT64 n)
+{
+	INT64 sum = 0;
+	for (INT64 i = 0; i < n; i++) {
+		vector<string> rows;
+		TokenizeSmart(sCompositeArray, rows);
+		for (size_t j = 0; j < rows.size(); j++) {
+			vector<string> fields;
+			TokenizeComposite(rows[j], fields);
+			sum += fields.size();
+		}
+	}
+	iSink = sum;
+}
+
+//
+// Binary DATE and TIMESTAMP parameters.
+//
+
+void
+benchDaysFromPgEpoch(INT64 n)
+{
+	INT64 sum = 0;
+	int year = 1990, month = 1, day = 1;
+	for (INT64 i = 0; i < n; i++) {
+		sum += daysFromPgEpoch(year, month, day);
+		if (++day > 28) {
+			day = 1;
+			if (++month > 12) {
+				month = 1;
+				if (++year > 2030)
+					year = 1990;
+			}
+		}
+	}
+	iSink = sum;
+}
+
+void
+benchUsecFromPgEpoch(INT64 n)
+{
+	TIMESTAMP_STRUCT ts;
+	memset(&ts, 0, sizeof(ts));
+	ts.year = 2006;
+	ts.month = 3;
+	ts.day = 1;
+	ts.hour = 9;
+
+	INT64 sum = 0;
+	for (INT64 i = 0; i < n; i++) {
+		sum += (INT64) usecFromPgEpoch(&ts);
+		if (++ts.second > 59) {
+			ts.second = 0;
+			if (++ts.minute > 59)
+				ts.minute = 0;
+		}
+	}
+	iSink = sum;
+}
+
+//
+// COPY rows of the loaders, formatted and then dropped.
+//
+
+template <typename TLoad> class CFormatOnly: public TLoad
+{
+public:
+	INT64 m_iBytes;
+
+	CFormatOnly(): TLoad(""), m_iBytes(0) {}
+
+protected:
+	void
+	PutRecord(const char *szRecord, int len)
+	{
+		m_iBytes += len;
+	}
+};
+
+template <size_t N>
+void
+setField(char (&field)[N], const char *value)
+{
+	strncpy(field, value, N - 1);
+	field[N - 1] = '\0';
+}
+
+void
+benchCopyTradeRow(INT64 n)
+{
+	CFormatOnly<CPGSQLTradeLoad> loader;
+	TRADE_ROW row;
+	row.T_DTS = CDateTime(2006, 3, 1, 9, 30, 15, 250);
+	setField(row.T_ST_ID, "CMPT");
+	setField(row.T_TT_ID, "TMB");
+	row.T_IS_CASH = true;
+	setField(row.T_S_SYMB, "ZICA");
+	row.T_QTY = 400;
+	row.T_BID_PRICE = 27.33;
+	row.T_CA_ID = 43000012345LL;
+	setField(row.T_EXEC_NAME, "Willie Quinones");
+	row.T_TRADE_PRICE = 27.31;
+	row.T_CHRG = 5.0;
+	row.T_COMM = 9.95;
+	row.T_TAX = 1.2;
+	row.T_LIFO = false;
+
+	for (INT64 i = 0; i < n; i++) {
+		row.T_ID = 200000000000000LL + i;
+		loader.WriteNextRecord(row);
+	}
+	iSink = loader.m_iBytes;
+}
+
+void
+benchCopyTradeHistoryRow(INT64 n)
+{
+	CFormatOnly<CPGSQLTradeHistoryLoad> loader;
+	TRADE_HISTORY_ROW row;
+	row.TH_DTS = CDateTime(2006, 3, 1, 9, 30, 15, 250);
+	setField(row.TH_ST_ID, "SBMT");
+
+	for (INT64 i = 0; i < n; i++) {
+		row.TH_T_ID = 200000000000000LL + i;
+		loader.WriteNextRecord(row);
+	}
+	iSink = loader.m_iBytes;
+}
+
+void
+benchCopyHoldingHistoryRow(INT64 n)
+{
+	CFormatOnly<CPGSQLHoldingHistoryLoad> loader;
+	HOLDING_HISTORY_ROW row;
+	row.HH_H_T_ID = 200000000000000LL;
+	row.HH_BEFORE_QTY = 0;
+
+	for (INT64 i = 0; i < n; i++) {
+		row.HH_T_ID = 200000000000000LL + i;
+		row.HH_AFTER_QTY = (int) (i % 800) + 100;
+		loader.WriteNextRecord(row);
+	}
+	iSink = loader.m_iBytes;
+}
+
+//
+// Requests to a Brokerage House on loopback that answers every one
+// immediately.
+//
+
+class CEchoServer
+{
+private:
+	int m_listenfd;
+	int m_iPort;
+	pthread_t m_ThreadId;
+
+	friend void *echoServerThread(void *);
+
+public:
+	CEchoServer();
+	~CEchoServer();
+
+	int
+	port() const
+	{
+		return m_iPort;
+	}
+};
+
+// Answers the connections one after the other, until the listening socket
+// is shut down.
+void *
+echoServerThread(void *data)
+{
+	CEchoServer *pServer = reinterpret_cast<CEchoServer *>(data);
+
+	TMsgDriverBrokerage request;
+	TMsgBrokerageDriver reply;
+	memset(&reply, 0, sizeof(reply));
+	reply.iStatus = CBaseTxnErr::SUCCESS;
+
+	while (true) {
+		int sockfd = accept(pServer->m_listenfd, NULL, NULL);
+		if (sockfd == -1) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		CSocket sock;
+		sock.setSocketFd(sockfd);
+		try {
+			while (true) {
+				sock.dbt5Receive(&request, sizeof(request));
+				sock.dbt5Send(&reply, sizeof(reply));
+			}
+		} catch (CSocketErr *pErr) {
+			delete pErr;
+		}
+	}
+	return NULL;
+}
+
+CEchoServer::CEchoServer()
+{
+	m_listenfd = socket(AF_INET, SOCK_STREAM, 0);
+	if (m_listenfd == -1)
+		throw new CSocketErr(CSocketErr::ERR_SOCKET_CREATE);
+
+	struct sockaddr_in sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sin_family = AF_INET;
+	sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	sa.sin_port = 0;
+	socklen_t len = sizeof(sa);
+	if (bind(m_listenfd, (struct sockaddr *) &sa, sizeof(sa)) == -1
+			|| listen(m_listenfd, 1) == -1
+			|| getsockname(m_listenfd, (struct sockaddr *) &sa, &len) == -1)
+		throw new CSocketErr(CSocketErr::ERR_SOCKET_BIND);
+	m_iPort = ntohs(sa.sin_port);
+
+	if (pthread_create(&m_ThreadId, NULL, &echoServerThread, this) != 0) {
+		throw CThreadErr(CThreadErr::ERR_THREAD_CREATE, "CEchoServer::ctor");
+	}
+}
+
+CEchoServer::~CEchoServer()
+{
+	shutdown(m_listenfd, SHUT_RDWR);
+	pthread_join(m_ThreadId, NULL);
+	close(m_listenfd);
+}
+
+static CEchoServer *pEchoServer = NULL;
+static char szLoopback[] = "127.0.0.1";
+static CSocket *pSocket = NULL;
+static CCESUT *pCESUT = NULL;
+
+void
+connectSocket()
+{
+	pSocket = new CSocket(szLoopback, pEchoServer->port());
+	pSocket->dbt5Connect();
+}
+
+void
+disconnectSocket()
+{
+	delete pSocket;
+	pSocket = NULL;
+}
+
+// The socket calls alone, for what CCESUT adds to them.
+void
+benchSocketRoundTrip(INT64 n)
+{
+	TMsgDriverBrokerage request;
+	TMsgBrokerageDriver reply;
+	memset(&request, 0, sizeof(request));
+	request.TxnType = TRADE_ORDER;
+
+	for (INT64 i = 0; i < n; i++) {
+		pSocket->dbt5Send(&request, sizeof(request));
+		pSocket->dbt5Receive(&reply, sizeof(reply));
+	}
+	iSink = reply.iStatus;
+}
+
+void
+connectCESUT()
+{
+	pCESUT = new CCESUT(szOutputDirectory, szLoopback, pEchoServer->port());
+}
+
+void
+disconnectCESUT()
+{
+	pCESUT->logStopTime();
+	delete pCESUT;
+	pCESUT = NULL;
+}
+
+// Packing the request, the round trip, and logging the response time.
+void
+benchCESUTTradeOrder(INT64 n)
+{
+	TTradeOrderTxnInput input;
+	memset(&input, 0, sizeof(input));
+	input.acct_id = 43000012345LL;
+	input.trade_qty = 400;
+	input.requested_price = 27.33;
+	strncpy(input.symbol, "ZICA", sizeof(input.symbol) - 1);
+	strncpy(input.trade_type_id, "TMB", sizeof(input.trade_type_id) - 1);
+
+	INT64 ok = 0;
+	for (INT64 i = 0; i < n; i++) {
+		if (pCESUT->TradeOrder(&input, 0, true))
+			++ok;
+	}
+	iSink = ok;
+}
+
+//
+// The harness.
+//
+
+typedef struct TBenchmark
+{
+	const char *szName;
+	void (*pRun)(INT64);
+	void (*pSetUp)(); // outside of the timing, or NULL
+	void (*pTearDown)();
+} *PBenchmark;
+
+static TBenchmark benchmarks[] = {
+	{ "tokenize_smart", &benchTokenizeSmart, NULL, NULL },
+	{ "tokenize_composite", &benchTokenizeComposite, NULL, NULL },
+	{ "tokenize_composite_array", &benchTokenizeCompositeArray, NULL,
+			NULL },
+	{ "days_from_pg_epoch", &benchDaysFromPgEpoch, NULL, NULL },
+	{ "usec_from_pg_epoch", &benchUsecFromPgEpoch, NULL, NULL },
+	{ "copy_trade_row", &benchCopyTradeRow, NULL, NULL },
+	{ "copy_trade_history_row", &benchCopyTradeHistoryRow, NULL, NULL },
+	{ "copy_holding_history_row", &benchCopyHoldingHistoryRow, NULL, NULL },
+	{ "socket_round_trip", &benchSocketRoundTrip, &connectSocket,
+			&disconnectSocket },
+	{ "cesut_trade_order", &benchCESUTTradeOrder, &connectCESUT,
+			&disconnectCESUT },
+};
+
+typedef struct TResult
+{
+	string name;
+	INT64 iIterations;
+	double dNsPerOp; // the fastest repetition
+	double dAllocsPerOp;
+} *PResult;
+
+// Nanoseconds n operations take, and the allocations they make.
+double
+timeRun(PBenchmark pBenchmark, INT64 n, INT64 &iAllocs)
+{
+	struct timespec start, end;
+	INT64 iBefore = iAllocations;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	pBenchmark->pRun(n);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	iAllocs = iAllocations - iBefore;
+	return (double) (end.tv_sec - start.tv_sec) * 1000000000.0
+			+ (double) (end.tv_nsec - start.tv_nsec);
+}
+
+TResult
+runBenchmark(PBenchmark pBenchmark)
+{
+	if (pBenchmark->pSetUp != NULL)
+		pBenchmark->pSetUp();
+
+	INT64 iAllocs;
+	INT64 n = iIterations;
+	if (n == 0) {
+		// Grow the count until a repetition takes long enough.
+		double dTarget = (double) iMinTime * 1000000.0;
+		n = 1;
+		while (true) {
+			double ns = timeRun(pBenchmark, n, iAllocs);
+			if (ns >= dTarget)
+				break;
+			INT64 next = ns <= 0.0 ? n * 100 : (INT64) (n * dTarget * 1.2 / ns);
+			n = next > n * 100 ? n * 100 : (next <= n ? n * 2 : next);
+		}
+	}
+
+	TResult result;
+	result.name = pBenchmark->szName;
+	result.iIterations = n;
+	result.dNsPerOp = -1.0;
+	result.dAllocsPerOp = 0.0;
+	for (int i = 0; i < iRepetitions; i++) {
+		double ns = timeRun(pBenchmark, n, iAllocs) / (double) n;
+		if (result.dNsPerOp < 0.0 || ns < result.dNsPerOp) {
+			result.dNsPerOp = ns;
+			result.dAllocsPerOp = (double) iAllocs / (double) n;
+		}
+	}
+
+	if (pBenchmark->pTearDown != NULL)
+		pBenchmark->pTearDown();
+	return result;
+}
+
+// The ns_per_op of every benchmark in an earlier JSON output.
+bool
+readBaseline(const char *filename, map<string, double> &baseline)
+{
+	ifstream f(filename);
+	if (!f.is_open())
+		return false;
+
+	string line;
+	while (getline(f, line)) {
+		string::size_type name = line.find("\"name\": \"");
+		string::size_type ns = line.find("\"ns_per_op\": ");
+		if (name == string::npos || ns == string::npos)
+			continue;
+		name += 9;
+		string::size_type end = line.find('"', name);
+		if (end == string::npos)
+			continue;
+		baseline[line.substr(name, end - name)]
+				= atof(line.c_str() + ns + 13);
+	}
+	return true;
+}
+
+void
+writeJSON(ostream &out, const vector<TResult> &results)
+{
+	char line[256];
+	out << "{" << endl;
+	out << "  \"label\": \"" << szLabel << "\"," << endl;
+	out << "  \"benchmarks\": [" << endl;
+	for (size_t i = 0; i < results.size(); i++) {
+		// One benchmark per line, which readBaseline() relies on.
+		snprintf(line, sizeof(line),
+				"    {\"name\": \"%s\", \"iterations\": %lld, "
+				"\"ns_per_op\": %.2f, \"allocs_per_op\": %.2f}%s",
+				results[i].name.c_str(), (long long) results[i].iIterations,
+				results[i].dNsPerOp, results[i].dAllocsPerOp,
+				i + 1 < results.size() ? "," : "");
+		out << line << endl;
+	}
+	out << "  ]" << endl;
+	out << "}" << endl;
+}
+
+void
+usage()
+{
+	cout << "Usage: MicroBench {options}" << endl
+		 << endl
+		 << "   Option      Default    Description" << endl
+		 << "   ==========  =========  ==============================="
+		 << endl;
+	printf("   -b string              Only run the benchmarks whose names\n");
+	printf("                          contain this\n");
+	printf("   -c string              Compare with this earlier JSON\n");
+	printf("                          output\n");
+	printf("   -i integer             Iterations per repetition, chosen\n");
+	printf("                          from -t if not given\n");
+	printf("   -j string              Write the results as JSON to this\n");
+	printf("                          file, - for stdout\n");
+	printf("   -l string              Label of the results, e.g. the\n");
+	printf("                          commit measured\n");
+	printf("   -o string   %-9s  Directory of the logs of CCESUT\n",
+			szOutputDirectory);
+	printf("   -r integer  %-9d  Repetitions, the fastest is reported\n",
+			iRepetitions);
+	printf("   -t integer  %-9d  Milliseconds per repetition\n", iMinTime);
+	printf("   -T number   %-9g  Percent slower than the -c results\n",
+			dThreshold);
+	printf("                          that is a regression\n");
+	printf("\n");
+	printf("Exits with 2 when a benchmark regressed.\n");
+}
+
+void
+parse_command_line(int argc, char *argv[])
+{
+	int ch;
+
+	while ((ch = getopt(argc, argv, "b:c:i:j:l:o:r:t:T:")) != -1) {
+		switch (ch) {
+		case 'b':
+			strncpy(szFilter, optarg, iMaxPath);
+			szFilter[iMaxPath] = '\0';
+			break;
+		case 'c':
+			strncpy(szBaseline, optarg, iMaxPath);
+			szBaseline[iMaxPath] = '\0';
+			break;
+		case 'i':
+			iIterations = atoll(optarg);
+			if (iIterations < 1) {
+				cerr << "Error: invalid iterations for -i: " << optarg
+					 << endl;
+				exit(1);
+			}
+			break;
+		case 'j':
+			strncpy(szJSON, optarg, iMaxPath);
+			szJSON[iMaxPath] = '\0';
+			break;
+		case 'l':
+			strncpy(szLabel, optarg, iMaxPath);
+			szLabel[iMaxPath] = '\0';
+			break;
+		case 'o':
+			strncpy(szOutputDirectory, optarg, iMaxPath);
+			szOutputDirectory[iMaxPath] = '\0';
+			break;
+		case 'r':
+			iRepetitions = atoi(optarg);
+			if (iRepetitions < 1) {
+				cerr << "Error: invalid repetitions for -r: " << optarg
+					 << endl;
+				exit(1);
+			}
+			break;
+		case 't':
+			iMinTime = atoi(optarg);
+			if (iMinTime < 1) {
+				cerr << "Error: invalid time for -t: " << optarg << endl;
+				exit(1);
+			}
+			break;
+		case 'T':
+			dThreshold = atof(optarg);
+			break;
+		default:
+			usage();
+			exit(1);
+		}
+	}
+}
+
+int
+main(int argc, char *argv[])
+{
+	parse_command_line(argc, argv);
+
+	map<string, double> baseline;
+	if (szBaseline[0] != '\0' && !readBaseline(szBaseline, baseline)) {
+		cerr << "Error: cannot read " << szBaseline << endl;
+		return 1;
+	}
+
+	sArray = "{200000000000001,200000000000002,NULL,\"TMB\",\"CMPT\","
+			 "\"Willie Quinones\",27.33,400,\"2006-03-01 09:30:15.25\","
+			 "\"a \\\"quoted\\\" name\",200000000000003,200000000000004,"
+			 "200000000000005,NULL,\"SBMT\",9.95,5.00,1.20,t,f}";
+	sComposite = "(2006-03-01,27.31,27.90,26.85,\"Zica \"\"Z\"\" Inc\","
+				 ",1241100)";
+	ostringstream osArray;
+	osArray << "{";
+	for (int i = 0; i < 20; i++)
+		osArray << (i > 0 ? "," : "") << "\"(2006-03-" << 10 + i
+				<< ",27.31,27.90,26.85," << 1241100 + i << ")\"";
+	osArray << "}";
+	sCompositeArray = osArray.str();
+
+	try {
+		pEchoServer = new CEchoServer();
+	} catch (CSocketErr *pErr) {
+		cerr << "Error: " << pErr->ErrorText() << endl;
+		delete pErr;
+		return 1;
+	}
+
+	vector<TResult> results;
+	int iRegressions = 0;
+	printf("%-26s %12s %12s %10s %8s\n", "benchmark", "iterations",
+			"ns/op", "allocs/op", "change");
+	for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+		if (strstr(benchmarks[i].szName, szFilter) == NULL)
+			continue;
+
+		TResult result;
+		try {
+			result = runBenchmark(&benchmarks[i]);
+		} catch (CSocketErr *pErr) {
+			cerr << "Error: " << benchmarks[i].szName << ": "
+				 << pErr->ErrorText() << endl;
+			delete pErr;
+			return 1;
+		}
+		results.push_back(result);
+
+		char szChange[16] = "";
+		map<string, double>::const_iterator it = baseline.find(result.name);
+		if (it != baseline.end() && it->second > 0.0) {
+			double dChange = 100.0 * (result.dNsPerOp - it->second)
+					/ it->second;
+			snprintf(szChange, sizeof(szChange), "%+.1f%%", dChange);
+			if (dChange > dThreshold)
+				++iRegressions;
+		}
+		printf("%-26s %12lld %12.2f %10.2f %8s\n", result.name.c_str(),
+				(long long) result.iIterations, result.dNsPerOp,
+				result.dAllocsPerOp, szChange);
+		fflush(stdout);
+	}
+	delete pEchoServer;
+
+	if (strcmp(szJSON, "-") == 0) {
+		writeJSON(cout, results);
+	} else if (szJSON[0] != '\0') {
+		ofstream f(szJSON);
+		writeJSON(f, results);
+		if (!f.good()) {
+			cerr << "Error: cannot write " << szJSON << endl;
+			return 1;
+		}
+	}
+
+	if (iRegressions > 0) {
+		cerr << iRegressions << " benchmark(s) more than " << dThreshold
+			 << "% slower than " << szBaseline << endl;
+		return 2;
+	}
+	return 0;
+}
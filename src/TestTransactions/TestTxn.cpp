@@ -6,18 +6,24 @@
  */
 
 #include <cstdlib>
+#include <stdio.h>
+#include <time.h>
 using namespace std;
 
 #include "DBConnectionClientSide.h"
+#include "DBConnectionNull.h"
 #include "DBConnectionServerSide.h"
 #include "CETxnInputGenerator.h"
 #include "TxnHarnessSendToMarketTest.h"
 #include "DMSUTtest.h"
 #include "CESUT.h"
 #include "locking.h"
+#include "DBT5Consts.h"
+#include "Histogram.h"
 
-// BrokerageHouseMain variables;
-CCESUT *m_pCCESUT = NULL;
+// BrokerageHouseMain variables; every benchmark thread has its own
+// connection to the Brokerage House.
+__thread CCESUT *m_pCCESUT = NULL;
 char szBHaddr[iMaxHostname + 1] = "";
 int iBHlistenPort = iBrokerageHousePort;
 
@@ -42,6 +48,22 @@ int iClientSide = 0;
 
 eTxnType TxnType = NULL_TXN;
 RNGSEED Seed = 0;
+INT32 iFrame = 0; // Trade-Lookup and Trade-Update frame, 0 for any
+bool bNullDB = false;
+TNullDBSettings NullDBSettings;
+bool bVerbose = true;
+
+// Benchmark mode, when any of the threads, iterations, duration or mix is
+// given.
+const int iTestTxnTypes = TRADE_CLEANUP + 1;
+int iThreads = 0;
+INT64 iIterations = 0; // after the warm-up, of all threads together
+int iDuration = 0; // seconds after the warm-up
+int iWarmUp = 0; // seconds
+int iMix[iTestTxnTypes]; // weight of every transaction type
+int iMixTotal = 0;
+bool bSameInput = false;
+char szOutputDirectory[iMaxPath + 1] = ".";
 
 // shows program usage
 void
@@ -56,17 +78,42 @@ Usage()
 	cout << "                        Connect to database directly if not used."
 		 << endl;
 	cout << "   -c number            Customer count (default 5000)" << endl;
+	cout << "   -d number            Benchmark for this many seconds after the"
+		 << endl;
+	cout << "                        warm-up (default 10 without -I)" << endl;
 	cout << "   -f number            Number of customers for 1 TRTPS (default "
 			"500)"
 		 << endl;
+	cout << "   -F number            Trade-Lookup (1-4) or Trade-Update (1-3) "
+			"frame"
+		 << endl;
+	cout << "                        to execute (default any)" << endl;
 	cout << "   -h host              Hostname of database server" << endl;
 	cout << "   -i path              full path to EGen flat_in directory"
 		 << endl;
+	cout << "   -I number            Benchmark this many transactions after"
+		 << endl;
+	cout << "                        the warm-up" << endl;
 	cout << "   -g dbname            Database name" << endl;
 	cout << "                        Optional if testing BrokerageHouseMain"
 		 << endl;
+	cout << "   -m mix               Benchmark a weighted mix of transaction "
+			"types,"
+		 << endl;
+	cout << "                        e.g. C:3,E:1 for 3 Trade-Lookups to 1"
+		 << endl;
+	cout << "                        Trade-Status" << endl;
+	cout << "   -n usec              Use no database, every frame takes usec"
+		 << endl;
+	cout << "   -N name=value        Setting of no database: customer, broker,"
+		 << endl;
+	cout << "                        first-trade, trades or symbols" << endl;
+	cout << "   -o path              Benchmark output directory (default .)"
+		 << endl;
 	cout << "   -p number            database listener port" << endl;
 	cout << "   -r number            seed random number generator" << endl;
+	cout << "   -s                   Benchmark the same inputs over and over"
+		 << endl;
 	cout << "   -t letter            Transaction type" << endl;
 	cout << "                        A - TRADE_ORDER" << endl;
 	cout << "                            TRADE_RESULT" << endl;
@@ -80,12 +127,88 @@ Usage()
 	cout << "                        J - MARKET_WATCH" << endl;
 	cout << "                        K - DATA_MAINTENANCE" << endl;
 	cout << "                        L - TRADE_CLEANUP" << endl;
+	cout << "   -T number            Benchmark with this many threads "
+			"(default 1)"
+		 << endl;
 	cout << "   -w number            Days of initial trades (default 300)"
 		 << endl;
+	cout << "   -W number            Seconds of benchmark warm-up (default 0)"
+		 << endl;
 	cout << endl;
 	cout << "Note: Trade Order triggers Trade Result and Market Feed" << endl;
 	cout << "      when the type of trade is Market (type_is_market=1)"
 		 << endl;
+	cout << "      except in a benchmark." << endl;
+}
+
+// Transaction type of a -t letter.
+bool
+TxnTypeFromLetter(char letter, eTxnType &type)
+{
+	switch (letter) {
+	case 'A':
+		type = TRADE_ORDER;
+		break;
+	case 'C':
+		type = TRADE_LOOKUP;
+		break;
+	case 'D':
+		type = TRADE_UPDATE;
+		break;
+	case 'E':
+		type = TRADE_STATUS;
+		break;
+	case 'F':
+		type = CUSTOMER_POSITION;
+		break;
+	case 'G':
+		type = BROKER_VOLUME;
+		break;
+	case 'H':
+		type = SECURITY_DETAIL;
+		break;
+	case 'J':
+		type = MARKET_WATCH;
+		break;
+	case 'K':
+		type = DATA_MAINTENANCE;
+		break;
+	case 'L':
+		type = TRADE_CLEANUP;
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+// Parse a mix of -t letters with optional weights, e.g. "C:3,E".
+bool
+ParseMix(const char *mix)
+{
+	const char *p = mix;
+	while (*p != '\0') {
+		eTxnType type;
+		if (!TxnTypeFromLetter(*p++, type))
+			return false;
+
+		int iWeight = 1;
+		if (*p == ':') {
+			char *end;
+			iWeight = (int) strtol(p + 1, &end, 10);
+			if (end == p + 1 || iWeight < 0)
+				return false;
+			p = end;
+		}
+		iMix[type] += iWeight;
+		iMixTotal += iWeight;
+
+		if (*p == ',')
+			++p;
+		else if (*p != '\0')
+			return false;
+	}
+	return iMixTotal > 0;
 }
 
 // parse command line
@@ -162,40 +285,8 @@ ParseCommandLine(int argc, char *argv[])
 			szPort[iPortLen] = '\0';
 			break;
 		case 't':
-			switch (*vp) {
-			case 'A':
-				TxnType = TRADE_ORDER;
-				break;
-			case 'C':
-				TxnType = TRADE_LOOKUP;
-				break;
-			case 'D':
-				TxnType = TRADE_UPDATE;
-				break;
-			case 'E':
-				TxnType = TRADE_STATUS;
-				break;
-			case 'F':
-				TxnType = CUSTOMER_POSITION;
-				break;
-			case 'G':
-				TxnType = BROKER_VOLUME;
-				break;
-			case 'H':
-				TxnType = SECURITY_DETAIL;
-				break;
-			case 'J':
-				TxnType = MARKET_WATCH;
-				break;
-			case 'K':
-				TxnType = DATA_MAINTENANCE;
-				break;
-			case 'L':
-				TxnType = TRADE_CLEANUP;
-				break;
-			default:
+			if (!TxnTypeFromLetter(*vp, TxnType))
 				return (false);
-			}
 			break;
 		case 'r':
 			sscanf(vp, "%" PRIu64, &Seed);
@@ -203,6 +294,42 @@ ParseCommandLine(int argc, char *argv[])
 		case 'w':
 			iDaysOfInitialTrades = atoi(vp);
 			break;
+		case 'd':
+			iDuration = atoi(vp);
+			break;
+		case 'F':
+			iFrame = atoi(vp);
+			break;
+		case 'I':
+			sscanf(vp, "%" PRId64, &iIterations);
+			break;
+		case 'm':
+			if (!ParseMix(vp))
+				return (false);
+			break;
+		case 'n':
+			bNullDB = true;
+			NullDBSettings.iLatency = atoi(vp);
+			if (NullDBSettings.iLatency < 0)
+				return (false);
+			break;
+		case 'N':
+			if (!NullDBSettings.set(vp))
+				return (false);
+			break;
+		case 'o':
+			strncpy(szOutputDirectory, vp, iMaxPath);
+			szOutputDirectory[iMaxPath] = '\0';
+			break;
+		case 's':
+			bSameInput = true;
+			break;
+		case 'T':
+			iThreads = atoi(vp);
+			break;
+		case 'W':
+			iWarmUp = atoi(vp);
+			break;
 		default:
 			return (false);
 		}
@@ -210,9 +337,22 @@ ParseCommandLine(int argc, char *argv[])
 	return (true);
 }
 
+// Drops the trade requests of Trade-Order, so that a benchmark measures the
+// Trade-Order frames alone.
+class CSendToMarketNone: public CSendToMarketInterface
+{
+public:
+	bool
+	SendToMarket(TTradeRequest &)
+	{
+		return true;
+	}
+};
+
 // Trade Order
 INT32
-TradeOrder(CDBConnection *pConn, CCETxnInputGenerator *pTxnInputGenerator)
+TradeOrder(CDBConnection *pConn, CCETxnInputGenerator *pTxnInputGenerator,
+		CSendToMarketInterface *pSendToMarket = NULL)
 {
 	// SendToMarket test class that can call Trade-Result and Market-Feed
 	// via the MEE - Market Exchange Emulator when type_is_market = 1.
@@ -222,8 +362,9 @@ TradeOrder(CDBConnection *pConn, CCETxnInputGenerator *pTxnInputGenerator)
 
 	// trade order harness code (TPC provided)
 	// this class uses our implementation of CTradeOrderDB class
-	CTradeOrderDB m_TradeOrderDB(pConn, true);
-	CTradeOrder m_TradeOrder(&m_TradeOrderDB, &m_pSendToMarket);
+	CTradeOrderDB m_TradeOrderDB(pConn, bVerbose);
+	CTradeOrder m_TradeOrder(&m_TradeOrderDB,
+			pSendToMarket != NULL ? pSendToMarket : &m_pSendToMarket);
 
 	// trade order input/output parameters
 	TTradeOrderTxnInput m_TradeOrderTxnInput;
@@ -255,7 +396,7 @@ TradeStatus(CDBConnection *pConn, CCETxnInputGenerator *pTxnInputGenerator)
 {
 	// trade status harness code (TPC provided)
 	// this class uses our implementation of CTradeStatusDB class
-	CTradeStatusDB m_TradeStatusDB(pConn, true);
+	CTradeStatusDB m_TradeStatusDB(pConn, bVerbose);
 	CTradeStatus m_TradeStatus(&m_TradeStatusDB);
 
 	// trade status input/output parameters
@@ -284,7 +425,7 @@ TradeLookup(CDBConnection *pConn, CCETxnInputGenerator *pTxnInputGenerator)
 {
 	// trade lookup harness code (TPC provided)
 	// this class uses our implementation of CTradeLookupDB class
-	CTradeLookupDB m_TradeLookupDB(pConn, true);
+	CTradeLookupDB m_TradeLookupDB(pConn, bVerbose);
 	CTradeLookup m_TradeLookup(&m_TradeLookupDB);
 
 	// trade lookup input/output parameters
@@ -313,7 +454,7 @@ TradeUpdate(CDBConnection *pConn, CCETxnInputGenerator *pTxnInputGenerator)
 {
 	// trade update harness code (TPC provided)
 	// this class uses our implementation of CTradeUpdateDB class
-	CTradeUpdateDB m_TradeUpdateDB(pConn, true);
+	CTradeUpdateDB m_TradeUpdateDB(pConn, bVerbose);
 	CTradeUpdate m_TradeUpdate(&m_TradeUpdateDB);
 
 	// trade update input/output parameters
@@ -343,7 +484,7 @@ CustomerPosition(
 {
 	// customer position harness code (TPC provided)
 	// this class uses our implementation of CCustomerPositionDB class
-	CCustomerPositionDB m_CustomerPositionDB(pConn, true);
+	CCustomerPositionDB m_CustomerPositionDB(pConn, bVerbose);
 	CCustomerPosition m_CustomerPosition(&m_CustomerPositionDB);
 
 	// customer position input/output parameters
@@ -375,7 +516,7 @@ BrokerVolume(CDBConnection *pConn, CCETxnInputGenerator *pTxnInputGenerator)
 {
 	// Broker Volume harness code (TPC provided)
 	// this class uses our implementation of CBrokerVolumeDB class
-	CBrokerVolumeDB m_BrokerVolumeDB(pConn, true);
+	CBrokerVolumeDB m_BrokerVolumeDB(pConn, bVerbose);
 	CBrokerVolume m_BrokerVolume(&m_BrokerVolumeDB);
 
 	// broker volume input/output parameters
@@ -405,7 +546,7 @@ SecurityDetail(CDBConnection *pConn, CCETxnInputGenerator *pTxnInputGenerator)
 {
 	// Security Detail harness code (TPC provided)
 	// this class uses our implementation of CSecurityDetailDB class
-	CSecurityDetailDB m_SecurityDetailDB(pConn, true);
+	CSecurityDetailDB m_SecurityDetailDB(pConn, bVerbose);
 	CSecurityDetail m_SecurityDetail(&m_SecurityDetailDB);
 
 	// security detail input/output parameters
@@ -435,7 +576,7 @@ MarketWatch(CDBConnection *pConn, CCETxnInputGenerator *pTxnInputGenerator)
 {
 	// Market Watch harness code (TPC provided)
 	// this class uses our implementation of CMarketWatchDB class
-	CMarketWatchDB m_MarketWatchDB(pConn, true);
+	CMarketWatchDB m_MarketWatchDB(pConn, bVerbose);
 	CMarketWatch m_MarketWatch(&m_MarketWatchDB);
 
 	// Market Watch input/output parameters
@@ -477,6 +618,318 @@ TradeCleanup(CDM *pCDM)
 	pCDM->DoCleanupTxn();
 }
 
+// Connection to the database, or to none with -n.
+CDBConnection *
+NewConnection()
+{
+	if (bNullDB)
+		return new CDBConnectionNull(NullDBSettings, bVerbose);
+	if (iClientSide == 1)
+		return new CDBConnectionClientSide(
+				szDBHost, szDBName, szPort, bVerbose);
+	return new CDBConnectionServerSide(szDBHost, szDBName, szPort, bVerbose);
+}
+
+// Have the input generator choose only the -F frame of Trade-Lookup and
+// Trade-Update.
+void
+SetFrame(TDriverCETxnSettings &settings)
+{
+	if (iFrame == 0)
+		return;
+
+	settings.TL_settings.cur.do_frame1 = iFrame == 1 ? 100 : 0;
+	settings.TL_settings.cur.do_frame2 = iFrame == 2 ? 100 : 0;
+	settings.TL_settings.cur.do_frame3 = iFrame == 3 ? 100 : 0;
+	settings.TL_settings.cur.do_frame4 = iFrame == 4 ? 100 : 0;
+	settings.TU_settings.cur.do_frame1 = iFrame == 1 ? 100 : 0;
+	settings.TU_settings.cur.do_frame2 = iFrame == 2 ? 100 : 0;
+	settings.TU_settings.cur.do_frame3 = iFrame == 3 ? 100 : 0;
+}
+
+// A benchmark thread and what it measured after the warm-up.
+typedef struct TBenchmarkThread
+{
+	pthread_t tid;
+	int iThread;
+	const DataFileManager *pInputFiles;
+	bool bFailed;
+	CHistogram histograms[iTestTxnTypes]; // microseconds
+	INT64 errors[iTestTxnTypes];
+} *PBenchmarkThread;
+
+CMutex BenchmarkLock;
+CCondition BenchmarkCond(BenchmarkLock);
+int iBenchmarkReady = 0; // threads set up, or failed to
+bool bBenchmarkStarted = false;
+struct timespec BenchmarkStart; // when the threads were started
+INT64 iBenchmarkRemaining = 0; // iterations not yet started
+
+double
+SecondsSince(const struct timespec &start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) (now.tv_sec - start.tv_sec)
+			+ (double) (now.tv_nsec - start.tv_nsec) / 1000000000.0;
+}
+
+// Count the thread as set up and wait for the others to be.
+void
+BenchmarkReady(bool bWait)
+{
+	BenchmarkCond.lock();
+	++iBenchmarkReady;
+	BenchmarkCond.broadcast();
+	while (bWait && !bBenchmarkStarted)
+		BenchmarkCond.wait();
+	BenchmarkCond.unlock();
+}
+
+INT32
+RunTxn(eTxnType type, CDBConnection *pConn,
+		CCETxnInputGenerator *pTxnInputGenerator, CDM *pCDM,
+		CSendToMarketInterface *pSendToMarket)
+{
+	switch (type) {
+	case TRADE_ORDER:
+		return TradeOrder(pConn, pTxnInputGenerator, pSendToMarket);
+	case TRADE_LOOKUP:
+		return TradeLookup(pConn, pTxnInputGenerator);
+	case TRADE_UPDATE:
+		return TradeUpdate(pConn, pTxnInputGenerator);
+	case TRADE_STATUS:
+		return TradeStatus(pConn, pTxnInputGenerator);
+	case CUSTOMER_POSITION:
+		return CustomerPosition(pConn, pTxnInputGenerator);
+	case BROKER_VOLUME:
+		return BrokerVolume(pConn, pTxnInputGenerator);
+	case SECURITY_DETAIL:
+		return SecurityDetail(pConn, pTxnInputGenerator);
+	case MARKET_WATCH:
+		return MarketWatch(pConn, pTxnInputGenerator);
+	case DATA_MAINTENANCE:
+		// One table at a time, as the Driver does.
+		pCDM->DoTxn();
+		return 0;
+	case TRADE_CLEANUP:
+		TradeCleanup(pCDM);
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+void *
+benchmarkThread(void *data)
+{
+	PBenchmarkThread pThread = reinterpret_cast<PBenchmarkThread>(data);
+	CDBConnection *pConn = NULL;
+	bool bReady = false;
+
+	try {
+		pConn = NewConnection();
+		if (strlen(szBHaddr) != 0)
+			m_pCCESUT = new CCESUT(
+					szOutputDirectory, szBHaddr, iBHlistenPort);
+
+		char filename[iMaxPath + 1];
+		snprintf(filename, sizeof(filename), "%s/TestTxn-%d.log",
+				szOutputDirectory, pThread->iThread);
+		CLogFormatTab fmt;
+		CEGenLogger log(eDriverEGenLoader, 0, filename, &fmt);
+
+		TDriverCETxnSettings m_DriverCETxnSettings;
+		SetFrame(m_DriverCETxnSettings);
+		CCETxnInputGenerator m_TxnInputGenerator(*pThread->pInputFiles,
+				iConfiguredCustomerCount, iActiveCustomerCount, iScaleFactor,
+				iDaysOfInitialTrades * HoursPerWorkDay, &log,
+				&m_DriverCETxnSettings);
+		m_TxnInputGenerator.UpdateTunables();
+
+		// The first thread generates the inputs of a single run with the
+		// same seed, the others their own.
+		RNGSEED ThreadSeed = Seed + pThread->iThread;
+		m_TxnInputGenerator.SetRNGSeed(ThreadSeed);
+
+		CDMSUTtest m_CDMSUT(pConn, false);
+		CDM m_CDM(&m_CDMSUT, &log, *pThread->pInputFiles,
+				iConfiguredCustomerCount, iActiveCustomerCount, iScaleFactor,
+				iDaysOfInitialTrades, pThread->iThread + 1, ThreadSeed);
+
+		CSendToMarketNone m_SendToMarket;
+		unsigned int iMixSeed = (unsigned int) ThreadSeed;
+		INT64 iErrors = 0;
+
+		BenchmarkReady(true);
+		bReady = true;
+
+		while (true) {
+			double dElapsed = SecondsSince(BenchmarkStart);
+			bool bMeasure = dElapsed >= iWarmUp;
+			if (bMeasure && iDuration > 0 && dElapsed >= iWarmUp + iDuration)
+				break;
+			if (bMeasure && iIterations > 0) {
+				Locker<CMutex> locker(BenchmarkLock);
+				if (iBenchmarkRemaining == 0)
+					break;
+				--iBenchmarkRemaining;
+			}
+
+			int r = rand_r(&iMixSeed) % iMixTotal;
+			int type = 0;
+			while (r >= iMix[type])
+				r -= iMix[type++];
+
+			// Restarting the generator from the same seed makes it
+			// generate the same inputs again.
+			if (bSameInput)
+				m_TxnInputGenerator.SetRNGSeed(ThreadSeed);
+
+			struct timespec start;
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			INT32 status;
+			string error;
+			try {
+				status = RunTxn((eTxnType) type, pConn, &m_TxnInputGenerator,
+						&m_CDM, &m_SendToMarket);
+			} catch (CBaseErr *pErr) {
+				error = pErr->ErrorText();
+				delete pErr;
+				status = -1;
+			} catch (const string &e) {
+				error = e;
+				status = -1;
+			}
+			INT64 iResponseTime = (INT64) (SecondsSince(start) * 1000000.0);
+
+			// Only the first error of a thread is shown, the rest are
+			// counted.
+			if (status < 0 && ++iErrors == 1) {
+				cerr << "thread " << pThread->iThread << ": "
+					 << szTransactionName[type] << " failed, status "
+					 << status << endl;
+				if (!error.empty())
+					cerr << error << endl;
+			}
+
+			if (!bMeasure)
+				continue;
+			if (status < 0)
+				++pThread->errors[type];
+			else
+				pThread->histograms[type].record(iResponseTime);
+		}
+	} catch (CBaseErr *pErr) {
+		cerr << "thread " << pThread->iThread << ": Error "
+			 << pErr->ErrorNum() << ": " << pErr->ErrorText() << endl;
+		delete pErr;
+		pThread->bFailed = true;
+	} catch (const string &e) {
+		cerr << "thread " << pThread->iThread << ": " << e << endl;
+		pThread->bFailed = true;
+	}
+	if (!bReady)
+		BenchmarkReady(false);
+
+	delete m_pCCESUT;
+	m_pCCESUT = NULL;
+	delete pConn;
+	return NULL;
+}
+
+// Run the benchmark threads, then report the response times of every
+// transaction type in milliseconds, and write their percentile
+// distributions to the output directory.
+int
+Benchmark(const DataFileManager &inputFiles)
+{
+	PBenchmarkThread pThreads = new TBenchmarkThread[iThreads];
+	iBenchmarkRemaining = iIterations;
+
+	cout << "=== Benchmarking";
+	for (int i = 0; i < iTestTxnTypes; i++)
+		if (iMix[i] > 0)
+			cout << " " << szTransactionName[i] << ":" << iMix[i];
+	cout << " with " << iThreads << " thread(s) ===" << endl << endl;
+
+	int iStarted = 0;
+	for (; iStarted < iThreads; iStarted++) {
+		PBenchmarkThread pThread = &pThreads[iStarted];
+		pThread->iThread = iStarted;
+		pThread->pInputFiles = &inputFiles;
+		pThread->bFailed = false;
+		memset(pThread->errors, 0, sizeof(pThread->errors));
+		if (pthread_create(&pThread->tid, NULL, &benchmarkThread, pThread)
+				!= 0) {
+			cerr << "error creating thread " << iStarted << endl;
+			break;
+		}
+	}
+
+	BenchmarkCond.lock();
+	while (iBenchmarkReady < iStarted)
+		BenchmarkCond.wait();
+	clock_gettime(CLOCK_MONOTONIC, &BenchmarkStart);
+	bBenchmarkStarted = true;
+	BenchmarkCond.broadcast();
+	BenchmarkCond.unlock();
+
+	bool bFailed = iStarted < iThreads;
+	for (int i = 0; i < iStarted; i++) {
+		pthread_join(pThreads[i].tid, NULL);
+		bFailed = bFailed || pThreads[i].bFailed;
+	}
+	double dSeconds = SecondsSince(BenchmarkStart) - iWarmUp;
+
+	char line[256];
+	snprintf(line, sizeof(line), "%-17s %10s %8s %10s %9s %9s %9s %9s %9s",
+			"Transaction", "Count", "Errors", "TPS", "Mean", "50%", "90%",
+			"99%", "Max");
+	cout << line << endl;
+
+	for (int i = 0; i < iTestTxnTypes; i++) {
+		if (iMix[i] == 0)
+			continue;
+
+		CHistogram h;
+		INT64 iErrors = 0;
+		for (int j = 0; j < iStarted; j++) {
+			h.add(pThreads[j].histograms[i]);
+			iErrors += pThreads[j].errors[i];
+		}
+
+		snprintf(line, sizeof(line),
+				"%-17s %10lld %8lld %10.1f %9.3f %9.3f %9.3f %9.3f %9.3f",
+				szTransactionName[i], (long long) h.count(),
+				(long long) iErrors,
+				dSeconds > 0.0 ? h.count() / dSeconds : 0.0,
+				h.mean() / 1000.0, h.valueAtPercentile(50.0) / 1000.0,
+				h.valueAtPercentile(90.0) / 1000.0,
+				h.valueAtPercentile(99.0) / 1000.0, h.max() / 1000.0);
+		cout << line << endl;
+
+		if (h.count() == 0)
+			continue;
+
+		char name[sizeof(szTransactionName[i])];
+		for (size_t j = 0; j < sizeof(name); j++)
+			name[j] = tolower(szTransactionName[i][j]);
+
+		char filename[iMaxPath + 1];
+		snprintf(filename, sizeof(filename), "%s/testtxn-%s.hgrm",
+				szOutputDirectory, name);
+		ofstream f(filename, ios::out);
+		h.writePercentiles(f, 1000.0);
+	}
+	cout << endl
+		 << "Response times in milliseconds over " << dSeconds
+		 << " seconds after the warm-up." << endl;
+
+	delete[] pThreads;
+	return bFailed ? 1 : 0;
+}
+
 // main
 int
 main(int argc, char *argv[])
@@ -499,12 +952,33 @@ main(int argc, char *argv[])
 		exit(1);
 	}
 
-	if (TxnType == NULL_TXN) {
-		cout << "Use -t to specify which transaction to test." << endl;
+	if (TxnType == NULL_TXN && iMixTotal == 0) {
+		cout << "Use -t or -m to specify which transaction to test." << endl;
 		exit(1);
 	}
 
-	if (strlen(szBHaddr) != 0) {
+	bool bBenchmark = iThreads > 0 || iIterations > 0 || iDuration > 0
+			|| iMixTotal > 0;
+	if (bBenchmark) {
+		if (iThreads < 1)
+			iThreads = 1;
+		if (iIterations == 0 && iDuration == 0)
+			iDuration = 10;
+		if (iMixTotal == 0) {
+			iMix[TxnType] = 1;
+			iMixTotal = 1;
+		}
+		bVerbose = false;
+	}
+
+	bool bTradeUpdate
+			= bBenchmark ? iMix[TRADE_UPDATE] > 0 : TxnType == TRADE_UPDATE;
+	if (iFrame < 0 || iFrame > 4 || (iFrame == 4 && bTradeUpdate)) {
+		cout << "Trade-Lookup has frames 1 to 4, Trade-Update 1 to 3." << endl;
+		exit(1);
+	}
+
+	if (strlen(szBHaddr) != 0 && !bBenchmark) {
 		m_fLog.open("test.log", ios::out);
 		m_fMix.open("test-mix.log", ios::out);
 		m_pCCESUT = new CCESUT(outputDirectory, szBHaddr, iBHlistenPort);
@@ -514,13 +988,9 @@ main(int argc, char *argv[])
 	CDBConnection *m_Conn = NULL;
 
 	try {
-		if (iClientSide == 1) {
-			m_Conn = new CDBConnectionClientSide(
-					szDBHost, szDBName, szPort, true);
-		} else {
-			m_Conn = new CDBConnectionServerSide(
-					szDBHost, szDBName, szPort, true);
-		}
+		// Every benchmark thread connects on its own.
+		if (!bBenchmark)
+			m_Conn = NewConnection();
 
 		// initialize Input Generator
 		//
@@ -531,6 +1001,7 @@ main(int argc, char *argv[])
 				iActiveCustomerCount, TPCE::DataFileManager::IMMEDIATE_LOAD);
 
 		TDriverCETxnSettings m_DriverCETxnSettings;
+		SetFrame(m_DriverCETxnSettings);
 
 		CCETxnInputGenerator m_TxnInputGenerator(inputFiles,
 				iConfiguredCustomerCount, iActiveCustomerCount, iScaleFactor,
@@ -550,6 +1021,9 @@ main(int argc, char *argv[])
 			m_TxnInputGenerator.SetRNGSeed(Seed);
 		cout << "Seed: " << Seed << endl << endl;
 
+		if (bBenchmark)
+			return Benchmark(inputFiles);
+
 		// Initialize DM - Data Maintenance class
 		// DM is used by Data-Maintenance and Trade-Cleanup transactions
 		// Data-Maintenance SUT interface (provided by us)
@@ -15,6 +15,9 @@
 
 #include "CommonStructs.h"
 #include "CSocket.h"
+#include "LatencyLog.h"
+#include "MixLog.h"
+#include "TxnTrace.h"
 using namespace TPCE;
 
 class CBaseInterface
@@ -29,18 +32,36 @@ protected:
 private:
 	CSocket *sock;
 	pid_t m_pid;
+	UINT32 m_iSeq; // requests sent, the low bits of their transaction ids
+	// Open-loop start time of the next transaction, CLOCK_MONOTONIC
+	bool m_bIntendedStart;
+	struct timespec m_IntendedStart;
 	ofstream m_fLog; // error log file
-	ofstream m_fMix; // mix log file
+	CMixLogWriter *m_pMix;
+	bool m_bStopped; // logStopTime was called
+	char m_szTraceFile[iMaxPath + 1];
+	CTxnTraceWriter *m_pTrace; // NULL unless capturing requests
+	INT32 m_iTraceUser; // emulated user the trace records are of
+
+	// Shared by the interfaces of the process, finished by the last one
+	// to stop.
+	CLatencyLog *m_pLatency;
 
 	void logResponseTime(int, int, double);
 
 public:
-	CBaseInterface(const char *, char *, char *, const int);
+	// The last argument identifies the emulated user in the log file names
+	// and the mix log; 0 uses the id of the calling thread.
+	CBaseInterface(const char *, char *, char *, const int, pid_t = 0);
 	~CBaseInterface(void);
 	bool biConnect();
 	bool biDisconnect();
 
 	void logStopTime();
+	void setIntendedStart(const struct timespec &);
+	// Record every request as one of the given emulated user, 0 for the
+	// Data-Maintenance.
+	void startTrace(INT32 = 0);
 };
 
 #endif // BASE_INTERFACE_H
@@ -33,6 +33,12 @@ using namespace std;
 #include "CSocket.h"
 using namespace TPCE;
 
+class CDBStatsSampler;
+class CInProcessMarket;
+class CPlanCapture;
+class CWaitEventSampler;
+struct TNullDBSettings;
+
 class CBrokerageHouse
 {
 private:
@@ -51,9 +57,16 @@ private:
 	char m_errorLogFilename[iMaxPath + 1];
 
 	int m_ClientSide;
+	TNullDBSettings *m_pNullDB; // NULL unless using no database
 
 	bool m_Verbose;
 
+	CInProcessMarket *m_pMarket; // NULL unless the MEE runs in this process
+	CDBStatsSampler *m_pStatsSampler; // NULL unless sampling
+	CWaitEventSampler *m_pWaitSampler; // NULL unless sampling
+	CPlanCapture *m_pPlanCapture; // NULL unless capturing plans
+
+	friend class CTxnExecutor;
 	friend void entryWorkerThread(void *); // entry point for worker thread
 
 	void dumpInputData(PBrokerVolumeTxnInput);
@@ -104,6 +117,28 @@ public:
 	void logErrorMessage(const string sErr, bool bScreen = true);
 	char *errorLogFilename();
 
+	// Run the Market Exchange Emulator in this process instead of sending
+	// trade requests to MarketExchangeMain.
+	void startInProcessMarket(const char *, TIdent, TIdent, int, char *);
+
+	// Answer every frame with made up rows, as the settings say, instead of
+	// connecting to the database.  Only connections made after this are
+	// affected.
+	void useNullDatabase(const TNullDBSettings &);
+
+	// Sample the statistics views of the database every given number of
+	// seconds, into files in the given directory.
+	void startStatsSampler(int, char *);
+
+	// Sample the wait events of the transactions every given number of
+	// milliseconds, into files in the given directory.
+	void startWaitEventSampler(int, char *);
+
+	// Capture the plans of statements slower than the given number of
+	// milliseconds, into a file in the given directory.  Only connections
+	// made after this are watched.
+	void startPlanCapture(int, char *);
+
 	void startListener(void);
 	bool verbose();
 };
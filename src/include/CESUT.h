@@ -21,7 +21,7 @@ using namespace TPCE;
 class CCESUT: public CCESUTInterface, public CBaseInterface
 {
 public:
-	CCESUT(char *, char *, const int);
+	CCESUT(char *, char *, const int, pid_t = 0);
 	~CCESUT(void);
 
 	bool BrokerVolume(PBrokerVolumeTxnInput);
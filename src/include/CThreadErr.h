@@ -19,7 +19,7 @@ using namespace TPCE;
 #define ERR_TYPE_THREAD 14 // thread error
 #define ERR_TYPE_PQXX 15 // libpqxx error
 #define ERR_TYPE_WRONGTXN 16 // wrong txn type
-#define CE_MIX_LOG_NAME "mix-dr.log"
+#define CE_MIX_LOG_NAME "mix-dr.bin"
 
 class CSocketErr: public CBaseErr
 {
@@ -35,6 +35,14 @@ enum eTxnType
 typedef struct TMsgDriverBrokerage
 {
 	eTxnType TxnType;
+	// Sampled requests are timed by the Brokerage House.
+	INT32 bSample;
+	// Identifies the request in the logs of every process and in the
+	// comments of its SQL: the emulated user in the high 32 bits and its
+	// count of requests in the low ones.
+	INT64 iTxnId;
+	// The sampled request whose trade request led to this Trade-Result.
+	INT64 iParentTxnId;
 
 	union
 	{
@@ -57,6 +65,18 @@ typedef struct TMsgDriverBrokerage
 typedef struct TMsgBrokerageDriver
 {
 	int iStatus;
+	// Microseconds since the Unix epoch on the Brokerage House's clock, 0
+	// unless the request was sampled.
+	INT64 iReceived;
+	INT64 iDBStart;
+	INT64 iDBEnd;
 } *PMsgBrokerageDriver;
 
+// structure of the message Brokerage House --> Market Exchange
+typedef struct TMsgBrokerageMarket
+{
+	INT64 iTxnId; // the sampled request sending the trade, or 0
+	TTradeRequest TradeRequest;
+} *PMsgBrokerageMarket;
+
 #endif // COMMON_STRUCTS_H
@@ -35,16 +35,21 @@ private:
 	friend void EntryDMWorkerThread(CCustomer *);
 
 public:
+	// iMyCustomerCount 0 means the customers are not partitioned.
 	CCustomer(const DataFileManager &, char *szInDir,
 			TIdent iConfiguredCustomerCount, TIdent iActiveCustomerCount,
-			INT32 iScaleFactor, INT32 iDaysOfInitialTrades, UINT32 iSeed,
-			char *szBHaddr, int iBHlistenPort, UINT32 UniqueId,
-			int iPacingDelay, char *outputDirectory);
+			TIdent iMyStartingCustomerId, TIdent iMyCustomerCount,
+			INT32 iPartitionPercent, INT32 iScaleFactor,
+			INT32 iDaysOfInitialTrades, UINT32 iSeed, char *szBHaddr,
+			int iBHlistenPort, UINT32 UniqueId, int iPacingDelay,
+			char *outputDirectory, pid_t id = 0);
 	~CCustomer();
 
 	void DoTxn();
 	void RunTest(int, int);
 	void LogStopTime();
+	void SetIntendedStart(const struct timespec &);
+	void StartTrace();
 };
 
 #endif // CUSTOMER_H
@@ -0,0 +1,129 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * One worker of the driver's thread pool.  The driver gives each worker a
+ * share of the users, and a worker runs its users one transaction at a time.
+ * Each user is a CCustomer that waits in a queue, ordered by the time its
+ * next transaction is due, instead of sleeping in a thread of its own.
+ *
+ * This is a thread pool with blocking I/O, not an event loop.  CCE::DoTxn()
+ * blocks on the socket until the Brokerage House replies, so a worker has
+ * one transaction in flight at a time.  Users whose transaction is due while
+ * another one is running start late.  Size the pool so that it can cover
+ * users * response time / (response time + pacing delay).
+ *
+ * In open-loop mode each user gets a CArrivalSchedule and its transactions
+ * start at the times it sets, whether or not the previous one has finished
+ * in time.
+ */
+
+#ifndef CUSTOMER_SCHEDULER_H
+#define CUSTOMER_SCHEDULER_H
+
+#include <time.h>
+#include <queue>
+#include <vector>
+
+#include "Customer.h"
+
+class CDriver;
+
+// Milliseconds between checks whether an idle user may run again.
+const int iIdleUserDelay = 100;
+
+// How late transactions started compared with the open-loop schedule.
+typedef struct TArrivalLag
+{
+	UINT64 iArrivals;
+	UINT64 iLate; // started more than 1 ms late
+	double dTotal; // seconds
+	double dMax; // seconds
+
+	TArrivalLag(): iArrivals(0), iLate(0), dTotal(0.0), dMax(0.0) {}
+
+	void add(double);
+	void add(const TArrivalLag &);
+} *PArrivalLag;
+
+// Intended start times of one user's transactions in open-loop mode.  The
+// next start follows the previous intended start, not the end of the
+// previous transaction, so a slow SUT does not lower the offered load.  The
+// mean interval is passed to advance() as the load profile may change it.
+class CArrivalSchedule
+{
+private:
+	struct timespec m_next; // CLOCK_MONOTONIC
+	bool m_bPoisson;
+	unsigned short m_xsubi[3]; // erand48() state
+
+public:
+	CArrivalSchedule(const struct timespec &, bool, UINT32);
+
+	const struct timespec &
+	next() const
+	{
+		return m_next;
+	}
+
+	void advance(double);
+	void arrive(CCustomer *, TArrivalLag &) const;
+
+	// Start over from the given time, e.g. after the user was idle.
+	void
+	reset(const struct timespec &start)
+	{
+		m_next = start;
+	}
+};
+
+class CCustomerScheduler
+{
+private:
+	typedef struct TScheduledUser
+	{
+		UINT32 UniqueId;
+		CCustomer *pCustomer;
+		CArrivalSchedule *pSchedule; // NULL unless open-loop
+		struct timespec due; // CLOCK_MONOTONIC
+	} *PScheduledUser;
+
+	// Orders the queue so that the earliest due user is on top.
+	struct TDueLater
+	{
+		bool
+		operator()(const PScheduledUser a, const PScheduledUser b) const
+		{
+			if (a->due.tv_sec != b->due.tv_sec)
+				return a->due.tv_sec > b->due.tv_sec;
+			return a->due.tv_nsec > b->due.tv_nsec;
+		}
+	};
+
+	CDriver *m_pDriver;
+	TArrivalLag m_lag;
+	std::vector<PScheduledUser> m_users;
+	std::priority_queue<PScheduledUser, std::vector<PScheduledUser>,
+			TDueLater>
+			m_queue;
+
+	bool doTxn(PScheduledUser);
+
+public:
+	CCustomerScheduler(CDriver *);
+	~CCustomerScheduler();
+
+	void addUser(UINT32, const struct timespec &);
+	void run();
+};
+
+// Add milliseconds or nanoseconds to a timespec.
+void addMilliseconds(struct timespec &, long);
+void addNanoseconds(struct timespec &, INT64);
+
+// Sleep until a CLOCK_MONOTONIC time, returns 0 or the error number.
+int sleepUntil(const struct timespec &);
+
+#endif // CUSTOMER_SCHEDULER_H
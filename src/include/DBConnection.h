@@ -20,6 +20,7 @@
 
 #include "BrokerageHouse.h"
 #include "DBT5Consts.h"
+#include "PlanCapture.h"
 using namespace TPCE;
 
 /*
@@ -42,6 +43,16 @@ public:
 	explicit CDBRetryableError(const string &msg): string(msg) {}
 };
 
+/*
+ * Thrown when a statement names a table or column the server does not have,
+ * SQLSTATE 42P01 or 42703, such as a statistics view of a newer release.
+ */
+class CDBUndefinedError: public string
+{
+public:
+	explicit CDBUndefinedError(const string &msg): string(msg) {}
+};
+
 /*
  * Clears a PGresult when leaving scope so a result held across other
  * exec() calls is not leaked when one of them throws.
@@ -71,21 +82,38 @@ class CDBConnection
 
 	TTradeRequest m_TriggeredLimitOrders;
 
+	// Comment identifying the transaction, put before each statement.
+	char m_szTxnComment[40];
+	INT64 m_iTxnId;
+	string m_sql;
+
+	CPlanCapture *m_pPlanCapture; // NULL unless capturing plans
+
 protected:
 	PGconn *m_Conn;
 	bool m_bVerbose;
 
+	// For connections that do not use a database, m_Conn stays NULL.
+	explicit CDBConnection(bool bVerbose);
+
 public:
+	// The application name shows in pg_stat_activity, unset if NULL.
 	CDBConnection(const char *szHost, const char *szDBName,
-			const char *szDBPort, bool bVerbose = false);
+			const char *szDBPort, bool bVerbose = false,
+			const char *szApplicationName = NULL);
 	virtual ~CDBConnection();
 
-	void begin();
-	void commit();
+	virtual void begin();
+	virtual void commit();
 	void connect();
-	string escape(string);
+	// False once the connection to the server is lost.
+	bool connected();
+	virtual string escape(string);
 	void disconnect();
 
+	// The process id of the backend serving this connection.
+	virtual int backendPid();
+
 	PGresult *exec(const char *);
 	PGresult *exec(const char *, int, const Oid *, const char *const *,
 			const int *, const int *, int);
@@ -103,8 +131,8 @@ public:
 
 	virtual void execute(const TDataMaintenanceFrame1Input *) = 0;
 
-	void execute(const TMarketFeedFrame1Input *, TMarketFeedFrame1Output *,
-			CSendToMarketInterface *);
+	virtual void execute(const TMarketFeedFrame1Input *,
+			TMarketFeedFrame1Output *, CSendToMarketInterface *);
 
 	virtual void execute(
 			const TMarketWatchFrame1Input *, TMarketWatchFrame1Output *)
@@ -175,14 +203,23 @@ public:
 
 	void reconnect();
 
-	void rollback();
+	virtual void rollback();
 
 	void setBrokerageHouse(CBrokerageHouse *);
 
-	void setReadCommitted();
-	void setReadUncommitted();
-	void setRepeatableRead();
-	void setSerializable();
+	// Statements slower than the threshold of the capture get their plans
+	// captured.
+	void setPlanCapture(CPlanCapture *);
+
+	void setNoticeProcessor(PQnoticeProcessor, void *);
+
+	// The transaction id of the request run next, 0 for none.
+	void setTxnId(INT64);
+
+	virtual void setReadCommitted();
+	virtual void setReadUncommitted();
+	virtual void setRepeatableRead();
+	virtual void setSerializable();
 };
 
 #endif // DB_CONNECTION_H
@@ -28,7 +28,8 @@ class CDBConnectionClientSide: public CDBConnection
 {
 public:
 	CDBConnectionClientSide(const char *szHost, const char *szDBName,
-			const char *szDBPort, bool bVerbose = false);
+			const char *szDBPort, bool bVerbose = false,
+			const char *szApplicationName = NULL);
 	~CDBConnectionClientSide();
 
 	void execute(
@@ -0,0 +1,146 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * A connection to no database, for measuring how fast the Driver, Brokerage
+ * House and Market Exchange Emulator can go without one.  Every frame
+ * succeeds after the given latency with rows made up from its inputs, enough
+ * of them to pass the checks of the transaction harness.
+ *
+ * The trades that Trade-Order creates are remembered, in every connection,
+ * until Trade-Result completes them, so the trade requests that go through
+ * the Market Exchange Emulator find their trades.  Trade-Order inputs that
+ * name a company instead of a security get one of the symbols seen in
+ * earlier inputs, before any has been seen they fail.
+ *
+ * The latency, the ids made up and the limits of what is remembered are
+ * settings, the ones below by default.  The trades and symbols are shared by
+ * every connection of the process, which must use the same settings.
+ */
+
+#ifndef DB_CONNECTION_NULL_H
+#define DB_CONNECTION_NULL_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "locking.h"
+
+#include "DBConnection.h"
+
+// Customer-Position inputs by tax id get this customer, every account
+// gets this broker.
+const TIdent iNullCustomerId = 4300000001LL;
+const TIdent iNullBrokerId = 4300000001LL;
+// Trade ids above those of any loaded database.
+const TTrade iNullFirstTradeId = 900000000000000LL;
+// Trades waiting for their Trade-Result, the oldest are forgotten first.
+const size_t iNullMaxTrades = 1000000;
+// Symbols remembered for Trade-Order inputs that only name a company.
+const size_t iNullMaxSymbols = 1024;
+
+typedef struct TNullDBSettings
+{
+	int iLatency; // microseconds each frame takes
+	TIdent iCustomerId;
+	TIdent iBrokerId;
+	TTrade iFirstTradeId;
+	size_t iMaxTrades;
+	size_t iMaxSymbols;
+
+	TNullDBSettings();
+
+	// Set one of latency, customer, broker, first-trade, trades or symbols
+	// from NAME=VALUE, false if either is invalid.
+	bool set(const char *);
+} *PNullDBSettings;
+
+class CDBConnectionNull: public CDBConnection
+{
+private:
+	typedef struct TNullTrade
+	{
+		TIdent acct_id;
+		char symbol[cSYMBOL_len + 1];
+		char type_id[cTT_ID_len + 1];
+		INT32 trade_qty;
+		double charge;
+		bool is_cash;
+		bool is_lifo;
+	} *PNullTrade;
+
+	static CMutex s_Lock;
+	static TTrade s_iNextTradeId;
+	static map<TTrade, TNullTrade> s_Trades;
+	static vector<string> s_Symbols;
+
+	TNullDBSettings m_Settings;
+	TTrade m_iNewTradeId; // created in this transaction, 0 for none
+
+	void learnSymbol(const char *);
+	bool findSymbol(const char *, char *);
+	void delay();
+
+public:
+	CDBConnectionNull(const TNullDBSettings &, bool bVerbose = false);
+	~CDBConnectionNull();
+
+	void begin();
+	void commit();
+	string escape(string);
+	int backendPid();
+	void rollback();
+
+	void setReadCommitted();
+	void setReadUncommitted();
+	void setRepeatableRead();
+	void setSerializable();
+
+	void execute(
+			const TBrokerVolumeFrame1Input *, TBrokerVolumeFrame1Output *);
+
+	void execute(const TCustomerPositionFrame1Input *,
+			TCustomerPositionFrame1Output *);
+	void execute(const TCustomerPositionFrame2Input *,
+			TCustomerPositionFrame2Output *);
+
+	void execute(const TDataMaintenanceFrame1Input *);
+
+	void execute(const TMarketFeedFrame1Input *, TMarketFeedFrame1Output *,
+			CSendToMarketInterface *);
+
+	void execute(const TMarketWatchFrame1Input *, TMarketWatchFrame1Output *);
+
+	void execute(
+			const TSecurityDetailFrame1Input *, TSecurityDetailFrame1Output *);
+
+	void execute(const TTradeCleanupFrame1Input *);
+
+	void execute(const TTradeLookupFrame1Input *, TTradeLookupFrame1Output *);
+	void execute(const TTradeLookupFrame2Input *, TTradeLookupFrame2Output *);
+	void execute(const TTradeLookupFrame3Input *, TTradeLookupFrame3Output *);
+	void execute(const TTradeLookupFrame4Input *, TTradeLookupFrame4Output *);
+
+	void execute(const TTradeOrderFrame1Input *, TTradeOrderFrame1Output *);
+	void execute(const TTradeOrderFrame2Input *, TTradeOrderFrame2Output *);
+	void execute(const TTradeOrderFrame3Input *, TTradeOrderFrame3Output *);
+	void execute(const TTradeOrderFrame4Input *, TTradeOrderFrame4Output *);
+
+	void execute(const TTradeResultFrame1Input *, TTradeResultFrame1Output *);
+	void execute(const TTradeResultFrame2Input *, TTradeResultFrame2Output *);
+	void execute(const TTradeResultFrame3Input *, TTradeResultFrame3Output *);
+	void execute(const TTradeResultFrame4Input *, TTradeResultFrame4Output *);
+	void execute(const TTradeResultFrame5Input *);
+	void execute(const TTradeResultFrame6Input *, TTradeResultFrame6Output *);
+
+	void execute(const TTradeStatusFrame1Input *, TTradeStatusFrame1Output *);
+
+	void execute(const TTradeUpdateFrame1Input *, TTradeUpdateFrame1Output *);
+	void execute(const TTradeUpdateFrame2Input *, TTradeUpdateFrame2Output *);
+	void execute(const TTradeUpdateFrame3Input *, TTradeUpdateFrame3Output *);
+};
+
+#endif // DB_CONNECTION_NULL_H
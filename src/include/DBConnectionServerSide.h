@@ -24,7 +24,8 @@ class CDBConnectionServerSide: public CDBConnection
 {
 public:
 	CDBConnectionServerSide(const char *szHost, const char *szDBName,
-			const char *szDBPort, bool bVerbose = false);
+			const char *szDBPort, bool bVerbose = false,
+			const char *szApplicationName = NULL);
 	~CDBConnectionServerSide();
 
 	void execute(
@@ -66,4 +67,89 @@ public:
 	void execute(const TTradeUpdateFrame3Input *, TTradeUpdateFrame3Output *);
 };
 
+/*
+ * Split a PostgreSQL array literal into its elements.  Quoted elements
+ * have the quotes stripped and backslash escapes resolved, so an element
+ * that is itself a composite literal comes out as valid composite text.
+ * An unquoted NULL element becomes an empty string.
+ */
+inline void
+TokenizeSmart(const string &str, vector<string> &tokens)
+{
+	string::size_type i = 1;
+
+	// This is essentially an empty array. i.e. '{}'
+	if (str.size() < 3 || str[0] != '{')
+		return;
+
+	while (i < str.size() && str[i] != '}') {
+		string token;
+
+		if (str[i] == '"') {
+			++i;
+			while (i < str.size() && str[i] != '"') {
+				if (str[i] == '\\' && i + 1 < str.size())
+					++i;
+				token += str[i++];
+			}
+			++i;
+		} else {
+			while (i < str.size() && str[i] != ',' && str[i] != '}')
+				token += str[i++];
+			if (token == "NULL")
+				token.clear();
+		}
+		tokens.push_back(token);
+		if (i < str.size() && str[i] == ',')
+			++i;
+	}
+}
+
+/*
+ * Split a PostgreSQL composite literal '(f1,f2,...)' into its fields.
+ * Quoted fields have the quotes stripped, doubled quotes and backslash
+ * escapes resolved.  Unquoted empty fields (SQL NULL) become empty
+ * strings.
+ */
+inline void
+TokenizeComposite(const string &str, vector<string> &fields)
+{
+	string::size_type i = 1;
+	bool more;
+
+	if (str.size() < 2 || str[0] != '(')
+		return;
+
+	more = str[1] != ')';
+	while (more) {
+		string field;
+
+		if (str[i] == '"') {
+			++i;
+			while (i < str.size()) {
+				if (str[i] == '"') {
+					if (i + 1 < str.size() && str[i + 1] == '"') {
+						field += '"';
+						i += 2;
+						continue;
+					}
+					break;
+				}
+				if (str[i] == '\\' && i + 1 < str.size())
+					++i;
+				field += str[i++];
+			}
+			++i;
+		} else {
+			while (i < str.size() && str[i] != ',' && str[i] != ')')
+				field += str[i++];
+		}
+		fields.push_back(field);
+		if (i < str.size() && str[i] == ',')
+			++i;
+		else
+			more = false;
+	}
+}
+
 #endif // DB_CONNECTION_SERVER_SIDE_H
@@ -0,0 +1,58 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Samples the statistics views of the database from the Brokerage House, over
+ * a connection of its own, so the database counters of a run are collected
+ * the same way on every system, with or without the touchstone tools.  Every
+ * interval each view is appended to dbstat-<view>.csv, one line per row led
+ * by the time in seconds since the Unix epoch, the clock of the mix logs.
+ * The counters are cumulative, as the views report them.  A view the server
+ * does not have, such as pg_stat_io before PostgreSQL 16, is logged once and
+ * no longer sampled.  Other errors are logged and the view sampled again the
+ * next interval, after reconnecting if the connection was lost.
+ */
+
+#ifndef DB_STATS_SAMPLER_H
+#define DB_STATS_SAMPLER_H
+
+#include <fstream>
+#include <vector>
+
+#include "locking.h"
+#include "condition.h"
+
+#include "BrokerageHouse.h"
+#include "DBConnection.h"
+
+class CDBStatsSampler
+{
+private:
+	CBrokerageHouse *m_pBrokerageHouse;
+	CDBConnection *m_pDBConnection;
+	int m_iInterval;
+
+	// One per view, NULL once the server turned out not to have it.
+	vector<ofstream *> m_files;
+	vector<bool> m_headers;
+
+	CMutex m_StopLock;
+	CCondition m_StopCond;
+	bool m_bStop;
+	pthread_t m_ThreadId;
+
+	void run();
+	void sample();
+
+	friend void *dbStatsSamplerThread(void *);
+
+public:
+	// Takes over the connection.  Throws CThreadErr if the sampler thread
+	// cannot be started.
+	CDBStatsSampler(CBrokerageHouse *, CDBConnection *, const char *, int);
+	~CDBStatsSampler();
+};
+
+#endif // DB_STATS_SAMPLER_H
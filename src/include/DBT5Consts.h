@@ -19,6 +19,7 @@ const int iMaxConnectString = 256;
 
 const int iBrokerageHousePort = 30000;
 const int iMarketExchangePort = 30010;
+const int iDriverCoordinatorPort = 30020;
 
 // Transaction Names
 static const char szTransactionName[12][18] = { "SECURITY_DETAIL",
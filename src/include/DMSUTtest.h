@@ -48,9 +48,10 @@ class CDMSUTtest: public CDMSUTInterface
 {
 protected:
 	CDBConnection *m_pDBConnection;
+	bool m_bVerbose;
 
 public:
-	CDMSUTtest(CDBConnection *);
+	CDMSUTtest(CDBConnection *, bool = true);
 	~CDMSUTtest();
 
 	bool DataMaintenance(PDataMaintenanceTxnInput);
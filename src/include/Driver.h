@@ -14,10 +14,42 @@
 #include "EGenLogFormatterTab.h"
 #include "EGenLogger.h"
 #include "DMSUT.h"
+#include "LatencyLog.h"
+#include "MixLog.h"
 #include "locking.h"
 
+#include <vector>
+
+#include "CSocket.h"
+#include "CustomerScheduler.h"
+#include "DBT5Consts.h"
+#include "LoadProfile.h"
+
 using namespace TPCE;
 
+// This driver's share of a run split over several driver processes.  The
+// defaults describe a driver that runs the whole test on its own.
+typedef struct TDriverShard
+{
+	UINT32 iUserOffset; // user UniqueIds start after this
+	TIdent iMyStartingCustomerId; // first customer of this driver's range
+	TIdent iMyCustomerCount; // 0 to use all active customers
+	INT32 iPartitionPercent; // % of transactions within the range
+	bool bDataMaintenance; // run Trade-Cleanup and Data-Maintenance
+	time_t tStart; // wall clock time to start the users, 0 for now
+	// The coordinator that starts the users, "" to start on its own.
+	char szCoordinatorAddr[iMaxHostname + 1];
+	int iCoordinatorPort;
+
+	TDriverShard()
+	: iUserOffset(0), iMyStartingCustomerId(1), iMyCustomerCount(0),
+	  iPartitionPercent(100), bDataMaintenance(true), tStart(0),
+	  iCoordinatorPort(iDriverCoordinatorPort)
+	{
+		szCoordinatorAddr[0] = '\0';
+	}
+} *PDriverShard;
+
 class CDriver
 {
 private:
@@ -26,7 +58,9 @@ private:
 	PDriverCETxnSettings m_pDriverCETxnSettings;
 	CMutex m_LogLock;
 	ofstream m_fLog; // error log file
-	ofstream m_fMix; // mix log file
+	// EGen input files, loaded once and shared read-only by every user
+	const DataFileManager &m_inputFiles;
+	CMixLogWriter *m_pMix;
 
 	void logErrorMessage(const string);
 
@@ -37,6 +71,54 @@ private:
 	friend void *dmWorkerThread(void *);
 	friend void entryDMWorkerThread(CDriver *);
 
+	friend class CCustomerScheduler;
+
+	std::vector<CCustomerScheduler *> m_schedulers;
+	CMutex m_LagLock;
+	TArrivalLag m_arrivalLag;
+
+	void startCustomerSchedulers(int);
+	CArrivalSchedule *newArrivalSchedule(UINT32, const struct timespec &);
+	void addArrivalLag(const TArrivalLag &);
+
+	// Current load level, set by the load profile or the control socket.
+	CMutex m_LoadLock;
+	int m_iActiveUsers;
+	int m_iStartedUsers; // users connected to the Brokerage House
+	double m_dCurrentRate;
+	CLoadProfile *m_pProfile;
+	struct timespec m_ProfileStart; // CLOCK_MONOTONIC
+	ofstream m_fLoad; // load level changes
+
+	friend void *loadControllerThread(void *);
+	friend void *controlSocketThread(void *);
+	friend long activeUsersGauge(void *);
+
+	// Reports the active users on the status lines until the test ends.
+	CLatencyLog *m_pLatency;
+
+	// Receives the intervals of the latency log once it started the users.
+	CMutex m_CoordinatorLock;
+	CSocket *m_pCoordinator;
+	struct timespec m_CoordinatorStart; // CLOCK_MONOTONIC
+
+	friend void coordinatorIntervalReport(
+			void *, const CHistogram *, const INT64 *);
+
+	void waitForCoordinator();
+	void reportInterval(const CHistogram *, const INT64 *);
+	void sendCoordinator(const string &);
+	void leaveCoordinator();
+
+	bool userActive(UINT32);
+	void userStarted();
+	double arrivalInterval();
+	void setLoad(int, double);
+	void setProfile(CLoadProfile *);
+	void applyLoadProfile();
+	void serveControlConnection(int);
+	void startLoadController();
+
 public:
 	char szInDir[iMaxPath + 1];
 	TIdent iConfiguredCustomerCount;
@@ -48,12 +130,19 @@ public:
 	int iBHlistenPort;
 	int iUsers;
 	int iPacingDelay;
+	int iWorkers; // 0 runs each user on its own thread
+	double dArrivalRate; // open-loop transactions per second, 0 if closed
+	bool bPoisson; // open-loop arrivals are Poisson instead of fixed
+	int iControlPort; // 0 for no control socket
+	bool bTrace; // capture every request in a trace file
+	TDriverShard shard;
 	char outputDirectory[iMaxPath + 1];
 	CDMSUT *m_pCDMSUT;
 	CDM *m_pCDM;
 
 	CDriver(const DataFileManager &, char *, TIdent, TIdent, INT32, INT32,
-			UINT32, char *, int, int, int, char *);
+			UINT32, char *, int, int, int, int, double, bool, const char *,
+			int, bool, const TDriverShard &, char *);
 	~CDriver();
 
 	void runTest(int, int);
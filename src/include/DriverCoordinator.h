@@ -0,0 +1,100 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Coordinator of a run split over several driver processes, on one or more
+ * systems.  Each driver connects and reports ready once it could start its
+ * users, the one running the Trade-Cleanup after it.  When all of them are
+ * ready the coordinator starts them together.  The drivers then send the
+ * histograms of every interval of their latency logs, numbered from their
+ * start so that no synchronized clocks are needed, and the coordinator
+ * merges each interval once every driver sent it.
+ *
+ * The messages are lines of text:
+ *
+ *   ready <users>                             driver, when it may start
+ *   start                                     coordinator, to every driver
+ *   interval <n> <txn> <errors> <histogram>   driver, per transaction type
+ *   end <n>                                   driver, after its interval n
+ *   done                                      driver, after its last one
+ */
+
+#ifndef DRIVER_COORDINATOR_H
+#define DRIVER_COORDINATOR_H
+
+#include <string.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "locking.h"
+#include "condition.h"
+
+#include "LatencyLog.h"
+using namespace TPCE;
+
+class CDriverCoordinator
+{
+private:
+	typedef struct TDriverConnection
+	{
+		CDriverCoordinator *pCoordinator;
+		int iDriver;
+		int fd;
+		pthread_t threadId;
+		int iUsers;
+		bool bReady;
+		bool bDone; // disconnected, no more intervals will come
+		int iLastInterval; // the last interval the driver ended
+	} *PDriverConnection;
+
+	typedef struct TMergedInterval
+	{
+		CHistogram histograms[iLatencyTxnTypes];
+		INT64 errors[iLatencyTxnTypes];
+
+		TMergedInterval()
+		{
+			memset(errors, 0, sizeof(errors));
+		}
+	} *PMergedInterval;
+
+	int m_iDrivers;
+	int m_iPort;
+	char m_szOutputDirectory[iMaxPath + 1];
+	ofstream m_fLog;
+
+	CMutex m_Lock;
+	CCondition m_Cond; // a driver is ready or disconnected
+	vector<PDriverConnection> m_drivers;
+	int m_iReady;
+	int m_iDone;
+	time_t m_tStart;
+	// Intervals some driver did not end yet, by number.
+	map<int, PMergedInterval> m_intervals;
+	int m_iWritten; // the last interval written
+	CHistogram m_run[iLatencyTxnTypes];
+	INT64 m_runErrors[iLatencyTxnTypes];
+
+	void serve(PDriverConnection);
+	void merge(PDriverConnection, istringstream &);
+	void writeIntervals();
+	void writeInterval(int, PMergedInterval);
+	void writeRun();
+
+	friend void *driverConnectionThread(void *);
+
+public:
+	CDriverCoordinator(int, int, const char *);
+	~CDriverCoordinator();
+
+	// Start the drivers together once all of them are ready and merge their
+	// intervals until all of them disconnect.  False if a driver
+	// disconnected before the start, the others are then not started.
+	bool run();
+};
+
+#endif // DRIVER_COORDINATOR_H
@@ -0,0 +1,72 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * High Dynamic Range histogram of response times in microseconds, after
+ * HdrHistogram: buckets of doubling width, each split into linear
+ * sub-buckets, so every value is kept to 2 significant digits between 1
+ * microsecond and an hour with a fixed amount of memory.
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <iostream>
+#include <vector>
+
+#include "CommonStructs.h"
+
+using namespace std;
+
+// Largest value that is tracked, larger ones are counted as this.
+const INT64 iHistogramHighest = 3600000000LL;
+// log2 of the sub-buckets per bucket, enough for 2 significant digits.
+const int iHistogramSubBucketMagnitude = 8;
+
+class CHistogram
+{
+private:
+	int m_iBuckets;
+	vector<INT64> m_counts;
+	INT64 m_iTotal;
+	INT64 m_iMin;
+	INT64 m_iMax;
+	double m_dSum;
+
+	int countsIndex(INT64) const;
+	INT64 valueFromIndex(int) const;
+	INT64 highestEquivalentValue(INT64) const;
+
+public:
+	CHistogram();
+
+	void record(INT64);
+	void add(const CHistogram &);
+	void reset();
+
+	INT64
+	count() const
+	{
+		return m_iTotal;
+	}
+
+	INT64 min() const;
+	INT64 max() const;
+	double mean() const;
+	double stddev() const;
+	INT64 valueAtPercentile(double) const;
+
+	// The percentile distribution in HdrHistogram's .hgrm format, values
+	// divided by the given ratio.
+	void writePercentiles(ostream &, double) const;
+
+	// The histogram as text without line breaks, to pass it to another
+	// process, and adding one back.  read() returns false and adds nothing
+	// if the text is not a histogram.
+	void write(ostream &) const;
+	bool read(istream &);
+};
+
+#endif // HISTOGRAM_H
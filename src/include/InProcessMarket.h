@@ -0,0 +1,142 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * The Market Exchange Emulator running inside the Brokerage House.
+ *
+ * Trade-Order and Market-Feed put their trade requests on a queue instead of
+ * sending them to MarketExchangeMain.  One market thread owns the CMEE: it
+ * submits the queued requests and fires the MEE timers.  The Trade-Result and
+ * Market-Feed transactions the MEE generates go on a second queue, run by a
+ * fixed number of executor threads with their own database connections, and
+ * are logged in mix-ime-<thread id>.bin files.
+ *
+ * Each Brokerage House worker queues its trade requests through a
+ * CInProcessMarketClient, which carries the id of the sampled request it is
+ * running, so that the Trade-Result of the trade is sampled with that id as
+ * its parent, as MarketExchangeMain does.  The executors time the stages of
+ * the sampled transactions in the latency log of the process.
+ */
+
+#ifndef IN_PROCESS_MARKET_H
+#define IN_PROCESS_MARKET_H
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "EGenLogFormatterTab.h"
+#include "EGenLogger.h"
+#include "MEE.h"
+#include "MEESUTInterface.h"
+#include "TxnHarnessSendToMarketInterface.h"
+#include "locking.h"
+#include "condition.h"
+
+#include "BrokerageHouse.h"
+#include "CommonStructs.h"
+#include "LatencyLog.h"
+#include "MixLog.h"
+using namespace TPCE;
+
+// Default number of threads running Trade-Result and Market-Feed.
+const int iDefaultMarketExecutors = 8;
+
+class CInProcessMarket
+: public CSendToMarketInterface, public CMEESUTInterface
+{
+private:
+	// A trade request and the sampled request sending it, or 0.
+	typedef struct TMarketOrder
+	{
+		TTradeRequest request;
+		INT64 iTxnId;
+	} *PMarketOrder;
+
+	// A Trade-Result or Market-Feed generated by the MEE.
+	typedef struct TMarketWork
+	{
+		TMsgDriverBrokerage request;
+		INT64 iQueued; // CLOCK_MONOTONIC nanoseconds
+		INT64 iGenerated; // microseconds since the Unix epoch, if sampled
+	} *PMarketWork;
+
+	typedef struct TExecutorParam
+	{
+		CInProcessMarket *pMarket;
+		int iExecutor;
+	} *PExecutorParam;
+
+	CBrokerageHouse *m_pBrokerageHouse;
+	char m_szOutputDirectory[iMaxPath + 1];
+
+	DataFileManager *m_pInputFiles;
+	CLogFormatTab m_fmt;
+	CEGenLogger *m_pLog;
+	CMEE *m_pCMEE;
+	CLatencyLog *m_pLatency;
+
+	// Trade requests waiting for the market thread.
+	CMutex m_OrderLock;
+	CCondition m_OrderCond;
+	std::deque<TMarketOrder> m_orders;
+	bool m_bMarketShutdown;
+
+	// Generated transactions waiting for an executor.
+	CMutex m_WorkLock;
+	CCondition m_WorkCond;
+	std::deque<PMarketWork> m_work;
+	bool m_bExecutorShutdown;
+
+	// Only used by the market thread.
+	bool m_bTimerPending;
+	INT64 m_iTimerDue; // CLOCK_MONOTONIC nanoseconds
+	std::map<TTrade, INT64> m_parents; // sampled ids by trade
+
+	pthread_t m_MarketThreadId;
+	std::vector<pthread_t> m_ExecutorThreadIds;
+
+	bool queueWork(const TMsgDriverBrokerage &);
+	void runMarket();
+	void runExecutor(int);
+	void scheduleTimer(INT32);
+
+	friend void *inProcessMarketThread(void *);
+	friend void *inProcessExecutorThread(void *);
+
+public:
+	// Throws CThreadErr if the threads cannot be started.
+	CInProcessMarket(CBrokerageHouse *, const char *, TIdent, TIdent, int,
+			char *);
+	~CInProcessMarket();
+
+	// CSendToMarketInterface, called by Trade-Order and Market-Feed.
+	bool SendToMarket(TTradeRequest &);
+	// The same, for the sampled request with the given id.
+	bool SendToMarket(TTradeRequest &, INT64);
+
+	// CMEESUTInterface, called by the MEE on the market thread.
+	bool TradeResult(PTradeResultTxnInput);
+	bool MarketFeed(PMarketFeedTxnInput);
+};
+
+// The in-process market as seen by one Brokerage House worker, like the
+// CSendToMarket connection each worker has to MarketExchangeMain.
+class CInProcessMarketClient: public CSendToMarketInterface
+{
+private:
+	CInProcessMarket *m_pMarket;
+	INT64 m_iTxnId;
+
+public:
+	explicit CInProcessMarketClient(CInProcessMarket *);
+
+	bool SendToMarket(TTradeRequest &);
+
+	// The sampled request whose trade requests are sent next, or 0.
+	void setTxnId(INT64);
+};
+
+#endif // IN_PROCESS_MARKET_H
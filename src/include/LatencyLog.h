@@ -0,0 +1,132 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Response time histograms per transaction type of all the interfaces in a
+ * process.  The interfaces record into one of a few stripes, each with its
+ * own lock, that a thread merges every second.  It prints a status line of
+ * that second to stdout and appends it to status-<pid>.csv.  Every interval
+ * it appends a summary to latency-<pid>.log and rewrites the histograms of
+ * the whole run as latency-<pid>-<transaction>.hgrm, so they are current
+ * even if the process is killed.  The stage timestamps of sampled requests
+ * go to stages-<pid>.csv.  The histograms and errors of every interval can
+ * also be passed on, as a driver does to the coordinator of its run.
+ */
+
+#ifndef LATENCY_LOG_H
+#define LATENCY_LOG_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "locking.h"
+#include "condition.h"
+
+#include "CommonStructs.h"
+#include "Histogram.h"
+
+// Seconds between status lines.
+const int iStatusInterval = 1;
+// Seconds between snapshots.
+const int iLatencyInterval = 10;
+// Independently locked sets of histograms the interfaces record into.
+const int iLatencyStripes = 8;
+const int iLatencyTxnTypes = TRADE_CLEANUP + 1;
+// One in this many requests of an interface has its stages timed.
+const UINT32 iStageSampleInterval = 100;
+
+// A value added to every status line, such as the number of active users.
+typedef long (*TStatusGauge)(void *);
+// Receives the histograms and error counts of each transaction type of an
+// interval.
+typedef void (*TIntervalReport)(void *, const CHistogram *, const INT64 *);
+
+class CLatencyLog
+{
+private:
+	typedef struct TLatencyStripe
+	{
+		CMutex lock;
+		CHistogram histograms[iLatencyTxnTypes];
+		INT64 errors[iLatencyTxnTypes];
+	} *PLatencyStripe;
+
+	typedef struct TStatusGaugeEntry
+	{
+		string name;
+		TStatusGauge gauge;
+		void *data;
+	} *PStatusGaugeEntry;
+
+	char m_szOutputDirectory[iMaxPath + 1];
+	ofstream m_fLog;
+	ofstream m_fStatus;
+	CMutex m_StageLock;
+	ofstream m_fStages;
+	TLatencyStripe m_stripes[iLatencyStripes];
+	// Only used by the snapshot thread, or after it stopped.
+	CHistogram m_second[iLatencyTxnTypes];
+	INT64 m_errors[iLatencyTxnTypes];
+	CHistogram m_interval[iLatencyTxnTypes];
+	INT64 m_intervalErrors[iLatencyTxnTypes];
+	CHistogram m_run[iLatencyTxnTypes];
+	int m_iTicks;
+
+	CMutex m_GaugeLock; // also guards the interval report
+	vector<TStatusGaugeEntry> m_gauges;
+	bool m_bHeader; // the gauges are fixed once the header is written
+	TIntervalReport m_report;
+	void *m_pReportData;
+
+	CMutex m_StopLock;
+	CCondition m_StopCond;
+	bool m_bStop;
+	pthread_t m_ThreadId;
+
+	// The log shared by the process, finished by the last user to detach.
+	static CMutex s_Lock;
+	static CLatencyLog *s_pInstance;
+	static int s_iUsers;
+
+	void run();
+	void tick(bool);
+	void status(double);
+	void snapshot();
+	void writeRun();
+
+	friend void *latencyLogThread(void *);
+
+public:
+	// Throws CThreadErr if the snapshot thread cannot be started.
+	CLatencyLog(const char *);
+	~CLatencyLog();
+
+	// The log of the process, created in the given directory by the first
+	// call.
+	static CLatencyLog *attach(const char *);
+	static void detach();
+
+	// Record a response time in seconds and the transaction status, the id
+	// picks the stripe.
+	void record(int, int, double, int);
+
+	// Log the stages of a sampled request, with the microseconds since the
+	// Unix epoch it was sent and answered.
+	void stages(const TMsgDriverBrokerage *, const TMsgBrokerageDriver *,
+			INT64, INT64);
+
+	// Gauges added after the first status line are not reported.
+	void addGauge(const char *, TStatusGauge, void *);
+	void removeGauges(void *);
+
+	// Pass every interval on from now on, NULL to stop.
+	void setIntervalReport(TIntervalReport, void *);
+
+	// Stop the snapshot thread and write out what is left.
+	void finish();
+};
+
+#endif // LATENCY_LOG_H
@@ -0,0 +1,57 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Load level over time: the number of active users, or the open-loop
+ * transaction rate.  A profile is given as one of:
+ *
+ *   step:FROM:TO:STEP:SECONDS  start at FROM, change by STEP every SECONDS
+ *                              until TO is reached
+ *   linear:FROM:TO:SECONDS     go from FROM to TO over SECONDS, then hold
+ *   sine:MEAN:AMPLITUDE:PERIOD MEAN + AMPLITUDE * sin(2 pi t / PERIOD)
+ *   file:PATH                  lines of "SECONDS VALUE", each VALUE holds
+ *                              from its time until the next line's
+ */
+
+#ifndef LOAD_PROFILE_H
+#define LOAD_PROFILE_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class CLoadProfile
+{
+private:
+	enum eShape
+	{
+		STEP,
+		LINEAR,
+		SINE,
+		FILE_DRIVEN
+	};
+
+	eShape m_eShape;
+	string m_spec;
+	double m_dArgs[4];
+	vector<pair<double, double> > m_points; // file: seconds, value
+
+	void loadFile(const string &);
+
+public:
+	// Throws std::runtime_error if the specification is not valid.
+	CLoadProfile(const string &);
+
+	const string &
+	spec() const
+	{
+		return m_spec;
+	}
+
+	double valueAt(double) const;
+};
+
+#endif // LOAD_PROFILE_H
@@ -11,6 +11,8 @@
 #ifndef MEE_SUT_H
 #define MEE_SUT_H
 
+#include <map>
+
 #include "MEESUTInterface.h"
 #include "locking.h"
 #include "condition.h"
@@ -32,12 +34,18 @@ private:
 	CCondition m_ThreadCountCond;
 	int m_OutstandingThreads;
 
+	// Transaction ids of the sampled requests that sent the trades still
+	// waiting for their Trade-Result.
+	CMutex m_ParentLock;
+	std::map<TTrade, INT64> m_parents;
+
 	void threadStarted();
 	void threadFinished();
 
 public:
-	CMEESUT(char *outputDirectory, char *addr, const int iListenPort)
-	: CBaseInterface("me", outputDirectory, addr, iListenPort),
+	CMEESUT(char *outputDirectory, char *addr, const int iListenPort,
+			pid_t id = 0)
+	: CBaseInterface("me", outputDirectory, addr, iListenPort, id),
 	  m_ThreadCountCond(m_ThreadCountLock), m_OutstandingThreads(0),
 	  m_SocketLock(){};
 	~CMEESUT();
@@ -47,6 +55,11 @@ public:
 	bool TradeResult(PTradeResultTxnInput);
 	bool MarketFeed(PMarketFeedTxnInput);
 
+	// Trade-Result and Market-Feed transactions sent and not yet answered.
+	int outstanding();
+
+	void setParentTxnId(TTrade, INT64);
+
 	friend void *TradeResultAsync(void *);
 	friend bool RunTradeResultAsync(void *);
 
@@ -58,6 +71,7 @@ public:
 typedef struct TMEESUTThreadParam
 {
 	CMEESUT *pCMEESUT;
+	INT64 iParentTxnId;
 
 	union
 	{
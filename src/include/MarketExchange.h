@@ -16,44 +16,89 @@
 #include "locking.h"
 #include "condition.h"
 
+#include <fstream>
+#include <vector>
+
 #include "CSocket.h"
+#include "LatencyLog.h"
 #include "MEESUT.h"
 using namespace TPCE;
 
-class CMarketExchange
+// Default milliseconds per MEE timer tick.
+const int iDefaultTimerTick = 1;
+// Seconds between the timer lateness lines in mee-timer-*.log.
+const int iTimerReportInterval = 60;
+
+// One CMEE with its own connection to the Brokerage House and its own timer
+// thread.  All trade requests for a security go to the same shard, so its
+// ticker state stays in one place.
+class CMEEShard
 {
 private:
-	UINT32 m_UniqueId;
-	int m_iListenPort;
-	CSocket m_Socket;
-	CLogFormatTab m_fmt;
-	CEGenLogger *m_pLog;
 	CMEESUT *m_pCMEESUT;
-	CSecurityFile *m_pSecurities;
-	bool m_Verbose;
+	CMEE *m_pCMEE;
 
 	// Fire pending MEE timers (deferred Trade-Result and triggered
 	// Market-Feed processing) when they expire without another trade
-	// request arriving.
+	// request arriving.  Expiry times are rounded up to a tick, so timers
+	// expiring within the same tick fire with a single wake-up, and the
+	// timer thread is only woken when a timer expires before the tick it
+	// is sleeping to.
 	CMutex m_TimerLock;
 	CCondition m_TimerCond;
-	INT32 m_NextTimerDelay; // ms until the next MEE timer, < 0 if none
-	unsigned int m_TimerGeneration;
+	INT64 m_iTimerTick; // nanoseconds
+	bool m_bTimerPending;
+	INT64 m_iTimerDue; // CLOCK_MONOTONIC nanoseconds of the next MEE timer
+	INT64 m_iTimerWake; // m_iTimerDue rounded up to a tick
 	bool m_TimerShutdown;
 	pthread_t m_TimerThreadId;
 
-	void updateNextTimer(INT32 delay);
+	// How late timers fired since the last report.
+	UINT64 m_iTimersFired;
+	UINT64 m_iTimersLate; // fired more than a tick late
+	double m_dTimerLateTotal; // seconds
+	double m_dTimerLateMax; // seconds
+	time_t m_tTimerReport;
+	ofstream m_fTimerLog;
+
+	void scheduleTimer(INT32 delay);
+	void addTimerLateness(INT64);
+
+	friend void *MarketTimerThread(void *);
+
+public:
+	CMEEShard(const DataFileManager &, CBaseLogger *, UINT32, char *, char *,
+			int, pid_t, int);
+	~CMEEShard();
+
+	void submitTradeRequest(PTradeRequest, INT64);
+	int queueDepth();
+};
+
+class CMarketExchange
+{
+private:
+	UINT32 m_UniqueId;
+	int m_iListenPort;
+	CSocket m_Socket;
+	CLogFormatTab m_fmt;
+	CEGenLogger *m_pLog;
+	bool m_Verbose;
+	std::vector<CMEEShard *> m_shards;
+
+	CMEEShard *shardFor(const TTradeRequest *);
 
+	// Reports the queue depth on the status lines.
+	CLatencyLog *m_pLatency;
+
+	friend long queueDepthGauge(void *);
 	friend void *MarketWorkerThread(void *);
 	// entry point for driver worker thread
 	friend void EntryMarketWorkerThread(void *);
-	friend void *MarketTimerThread(void *);
 
 public:
-	CMEE *m_pCMEE;
-
 	CMarketExchange(const DataFileManager &, char *, UINT32, TIdent, TIdent,
-			int, char *, int, char *, bool);
+			int, char *, int, int, int, char *, bool);
 	~CMarketExchange();
 
 	void startListener(void);
@@ -0,0 +1,143 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Binary mix log of the transactions an interface sent to the Brokerage
+ * House.  Records are collected in a buffer that is written out when it is
+ * full or a second after the last write, instead of writing and flushing a
+ * CSV line per transaction.  A thread shared by the writers of the process
+ * writes out the buffers of writers that went idle.
+ *
+ * A mix log starts with a TMixLogHeader, followed by one TMixLogRecord per
+ * transaction or marker.  A finished log ends with a footer record that
+ * holds the number of records before it.  Only whole records are written,
+ * so the log of a process that was killed can still be read up to its last
+ * write, the reader just finds no footer.
+ *
+ * MixLogConvertMain turns binary mix logs into the CSV mix logs that
+ * dbt5-post-process reads.
+ */
+
+#ifndef MIX_LOG_H
+#define MIX_LOG_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "locking.h"
+#include "condition.h"
+
+#include "CommonStructs.h"
+
+using namespace std;
+
+#define MIX_LOG_MAGIC "DBT5MIX1"
+
+// Values of TMixLogRecord::iTxn that are not transaction types.
+const INT32 iMixLogStart = -1;
+const INT32 iMixLogStop = -2;
+const INT32 iMixLogFooter = -3;
+
+// Bytes of records buffered before they are written out.
+const int iMixLogBufferSize = 8192;
+// Seconds that records may stay in the buffer.
+const int iMixLogFlushInterval = 1;
+
+typedef struct TMixLogHeader
+{
+	char szMagic[8];
+	UINT32 iRecordSize; // sizeof(TMixLogRecord) of the writer
+	UINT32 iReserved;
+} *PMixLogHeader;
+
+typedef struct TMixLogRecord
+{
+	INT64 iTime; // microseconds since the Unix epoch, records in the footer
+	double dRT; // response time in seconds
+	INT32 iTxn; // transaction type or marker
+	INT32 iStatus;
+	INT32 iId; // emulated user
+	INT32 iSeq; // low 32 bits of the transaction id, 0 for markers
+} *PMixLogRecord;
+
+class CMixLogWriter
+{
+private:
+	CMutex m_Lock; // the logging thread and the flush thread
+	int m_fd;
+	string m_filename;
+	char *m_pBuffer;
+	int m_iUsed;
+	INT64 m_iRecords;
+	INT64 m_iLastWrite; // microseconds since the Unix epoch
+	bool m_bFinished;
+	bool m_bWriteFailed; // reported once
+
+	// The writers whose buffers the flush thread checks, which runs while
+	// there are any.
+	static CMutex s_Lock;
+	static CCondition s_Cond;
+	static vector<CMixLogWriter *> s_writers;
+	static bool s_bFlushing;
+
+	void append(INT64, INT32, INT32, double, INT32, INT32);
+	void write(const char *, size_t);
+	void writeBuffer();
+	void flushIdle(INT64);
+
+	static void runFlush();
+
+	friend void *mixLogFlushThread(void *);
+
+public:
+	// Throws std::runtime_error if the file cannot be created or the flush
+	// thread cannot be started.
+	CMixLogWriter(const char *);
+	~CMixLogWriter();
+
+	void log(INT32, INT32, double, INT32, INT32 = 0);
+	void logStart(INT32);
+	void logStop(INT32);
+
+	// Write out the buffered records.
+	void flush();
+	// Write the footer; nothing more is logged after this.
+	void finish();
+};
+
+class CMixLogReader
+{
+private:
+	ifstream m_file;
+	string m_filename;
+	INT64 m_iRecords;
+	bool m_bComplete;
+
+public:
+	// Throws std::runtime_error if the file is not a mix log of this build.
+	CMixLogReader(const char *);
+
+	// Returns false at the end of the log or at a footer.
+	bool next(TMixLogRecord &);
+
+	// After next() returned false: whether the log ended with a footer that
+	// matches the number of records read.
+	bool complete() const;
+
+	INT64
+	records() const
+	{
+		return m_iRecords;
+	}
+
+	const string &
+	filename() const
+	{
+		return m_filename;
+	}
+};
+
+#endif // MIX_LOG_H
@@ -0,0 +1,108 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Captures the plans of slow statements in the Brokerage House.  A statement
+ * that takes longer than the threshold is kept with the parameters it was
+ * run with until its transaction ends, then a thread with a connection of
+ * its own runs it again under EXPLAIN (ANALYZE, BUFFERS) in a read only
+ * transaction that is rolled back.  A statement that modifies data or locks
+ * rows fails there and is only explained, without running.  With the server
+ * side logic the statements are frame function calls, so that thread also
+ * loads auto_explain, if it may, and has it send the plans of the
+ * statements in the functions back as notices.  The plans are appended to
+ * plans.txt with the transaction id, time and parameters.
+ *
+ * The plan is of the database as it is when the statement runs again, not
+ * as it was.  Short lock and statement timeouts keep the statements run
+ * again from waiting on, or slowing down, the transactions being measured.
+ */
+
+#ifndef PLAN_CAPTURE_H
+#define PLAN_CAPTURE_H
+
+#include <deque>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+
+#include <libpq-fe.h>
+
+#include "locking.h"
+#include "condition.h"
+
+#include "BrokerageHouse.h"
+
+class CDBConnection;
+
+// Slow statements waiting for their plans, more are dropped.
+const size_t iPlanQueueMax = 16;
+// Timeouts of the statements run again, in milliseconds.
+const int iPlanLockTimeout = 100;
+const int iPlanStatementTimeout = 10000;
+
+class CPlanCapture
+{
+private:
+	typedef struct TSlowStatement
+	{
+		INT64 iTxnId;
+		struct timeval tv; // when it finished
+		double dElapsed; // milliseconds
+		string sql;
+		vector<Oid> types; // empty if the server inferred them
+		vector<string> values;
+		vector<bool> nulls;
+		vector<int> formats;
+	} *PSlowStatement;
+
+	CBrokerageHouse *m_pBrokerageHouse;
+	CDBConnection *m_pDBConnection;
+	double m_dThreshold; // milliseconds
+	ofstream m_fPlans;
+	string m_notices;
+
+	CMutex m_QueueLock;
+	CCondition m_QueueCond;
+	// Slow statements of the transactions still open on each connection.
+	map<const CDBConnection *, vector<PSlowStatement> > m_held;
+	deque<PSlowStatement> m_queue;
+	INT64 m_iDropped;
+	bool m_bStop;
+	pthread_t m_ThreadId;
+
+	void run();
+	void explain(PSlowStatement);
+	PGresult *explain(PSlowStatement, const char *, bool,
+			const vector<const char *> &, const vector<int> &, string &);
+
+	friend void *planCaptureThread(void *);
+	friend void planCaptureNotice(void *, const char *);
+
+public:
+	// Takes over the connection.  Throws CThreadErr if the capture thread
+	// cannot be started.
+	CPlanCapture(CBrokerageHouse *, CDBConnection *, const char *, int);
+	~CPlanCapture();
+
+	double
+	threshold() const
+	{
+		return m_dThreshold;
+	}
+
+	// Keep a statement of the connection's transaction that took the
+	// given milliseconds, with the arguments it was passed to
+	// PQexecParams.
+	void capture(const CDBConnection *, INT64, double, const char *, int,
+			const Oid *, const char *const *, const int *, const int *);
+	// Queue the statements kept for the connection, once its transaction
+	// has ended.
+	void release(const CDBConnection *);
+};
+
+#endif // PLAN_CAPTURE_H
@@ -0,0 +1,42 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * USDT probes of the dbt5 provider, for perf and bpftrace.  A probe is a nop
+ * until a tracer attaches to it.  dbt5-build-egen defines HAVE_SYS_SDT_H when
+ * the systemtap headers are installed, without them the probes are compiled
+ * out.  The scripts in scripts/bpftrace use them.
+ *
+ *   txn__send(txn_id, txn_type, user)          driver or MEE sends a request
+ *   txn__receive(txn_id, txn_type, status)     and receives its reply
+ *   bh__request__start(txn_id, txn_type)       Brokerage House runs a request
+ *   bh__request__done(txn_id, txn_type, status)
+ *   bh__txn__retry(txn_id, txn_type, retry)    serialization failure
+ *   query__start(txn_id, sql)                  statement sent to the database
+ *   query__done(txn_id, ok)                    and its result received
+ *   mee__submit(trade_id, txn_id)              trade request given to the MEE
+ *   mee__timer(late_ns)                        MEE timers fire
+ *   mee__trade__result(trade_id)               MEE generates a Trade-Result
+ *   mee__market__feed()                        and a Market-Feed
+ */
+
+#ifndef PROBES_H
+#define PROBES_H
+
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+
+#define DBT5_PROBE(name) DTRACE_PROBE(dbt5, name)
+#define DBT5_PROBE1(name, a) DTRACE_PROBE1(dbt5, name, a)
+#define DBT5_PROBE2(name, a, b) DTRACE_PROBE2(dbt5, name, a, b)
+#define DBT5_PROBE3(name, a, b, c) DTRACE_PROBE3(dbt5, name, a, b, c)
+#else
+#define DBT5_PROBE(name)
+#define DBT5_PROBE1(name, a)
+#define DBT5_PROBE2(name, a, b)
+#define DBT5_PROBE3(name, a, b, c)
+#endif
+
+#endif // PROBES_H
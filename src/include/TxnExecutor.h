@@ -0,0 +1,82 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * The database connection and transaction harnesses of one Brokerage House
+ * thread, used both for the requests of a driver connection and for the
+ * Trade-Result and Market-Feed work of the in-process market.
+ */
+
+#ifndef TXN_EXECUTOR_H
+#define TXN_EXECUTOR_H
+
+#include "BrokerageHouse.h"
+#include "CommonStructs.h"
+#include "DBConnection.h"
+
+#include "BrokerVolumeDB.h"
+#include "CustomerPositionDB.h"
+#include "DataMaintenanceDB.h"
+#include "MarketFeedDB.h"
+#include "MarketWatchDB.h"
+#include "SecurityDetailDB.h"
+#include "TradeCleanupDB.h"
+#include "TradeLookupDB.h"
+#include "TradeOrderDB.h"
+#include "TradeResultDB.h"
+#include "TradeStatusDB.h"
+#include "TradeUpdateDB.h"
+
+class CTxnExecutor
+{
+private:
+	CBrokerageHouse *m_pBrokerageHouse;
+	CDBConnection *m_pDBConnection;
+
+	CBrokerVolumeDB m_BrokerVolumeDB;
+	CCustomerPositionDB m_CustomerPositionDB;
+	CDataMaintenanceDB m_DataMaintenanceDB;
+	CMarketFeedDB m_MarketFeedDB;
+	CMarketWatchDB m_MarketWatchDB;
+	CSecurityDetailDB m_SecurityDetailDB;
+	CTradeCleanupDB m_TradeCleanupDB;
+	CTradeLookupDB m_TradeLookupDB;
+	CTradeOrderDB m_TradeOrderDB;
+	CTradeResultDB m_TradeResultDB;
+	CTradeStatusDB m_TradeStatusDB;
+	CTradeUpdateDB m_TradeUpdateDB;
+
+	CBrokerVolume m_BrokerVolume;
+	CCustomerPosition m_CustomerPosition;
+	CDataMaintenance m_DataMaintenance;
+	CMarketFeed m_MarketFeed;
+	CMarketWatch m_MarketWatch;
+	CSecurityDetail m_SecurityDetail;
+	CTradeCleanup m_TradeCleanup;
+	CTradeLookup m_TradeLookup;
+	CTradeOrder m_TradeOrder;
+	CTradeResult m_TradeResult;
+	CTradeStatus m_TradeStatus;
+	CTradeUpdate m_TradeUpdate;
+
+public:
+	// A connection of the kind the Brokerage House is configured for.  The
+	// connections of the threads running transactions are named
+	// dbt5-bh-<thread id> in pg_stat_activity.
+	static CDBConnection *newDBConnection(
+			CBrokerageHouse *, bool bWorker = false);
+
+	// Trade-Order and Market-Feed send their trade requests to the given
+	// market.
+	CTxnExecutor(CBrokerageHouse *, CSendToMarketInterface *);
+	~CTxnExecutor();
+
+	// Run a request, retrying serialization failures and deadlocks, and
+	// return its status.  For a sampled request, the microseconds since the
+	// Unix epoch its database work began are stored in piDBStart.
+	INT32 execute(PMsgDriverBrokerage, INT64 *piDBStart = NULL);
+};
+
+#endif // TXN_EXECUTOR_H
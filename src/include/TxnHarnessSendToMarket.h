@@ -13,6 +13,7 @@
 #include "TxnHarnessSendToMarketInterface.h"
 #include "locking.h"
 
+#include "CommonStructs.h"
 #include "DBT5Consts.h"
 #include "CSocket.h"
 
@@ -22,6 +23,7 @@ class CSendToMarket: public CSendToMarketInterface
 	int m_MEport;
 	CSocket *m_Socket;
 	CMutex m_LogLock;
+	INT64 m_iTxnId;
 
 public:
 	void LogErrorMessage(const string);
@@ -30,6 +32,9 @@ public:
 	~CSendToMarket();
 
 	bool SendToMarket(TTradeRequest &);
+
+	// The sampled request whose trade requests are sent next, or 0.
+	void setTxnId(INT64);
 };
 
 #endif // TXN_HARNESS_SENDTOMARKET_H
@@ -0,0 +1,79 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Binary trace of the requests sent to the Brokerage House, so that a run's
+ * transaction inputs can be sent again unchanged.
+ *
+ * A trace file starts with a TTraceFileHeader, followed by one TTraceRecord
+ * per request and the request itself.  Requests are zeroed before EGen fills
+ * them in, so only the bytes up to the last non-zero one are stored and the
+ * reader pads the rest with zeros.
+ */
+
+#ifndef TXN_TRACE_H
+#define TXN_TRACE_H
+
+#include <fstream>
+
+#include "CommonStructs.h"
+
+using namespace std;
+
+#define TRACE_MAGIC "DBT5TRC1"
+
+typedef struct TTraceFileHeader
+{
+	char szMagic[8];
+	UINT32 iMessageSize; // sizeof(TMsgDriverBrokerage) of the writer
+	UINT32 iReserved;
+} *PTraceFileHeader;
+
+typedef struct TTraceRecord
+{
+	INT64 iTime; // microseconds since the Unix epoch when sent
+	INT32 iUser; // UniqueId of the emulated user, 0 for Data-Maintenance
+	UINT32 iLength; // bytes of the request that follow
+} *PTraceRecord;
+
+class CTxnTraceWriter
+{
+private:
+	ofstream m_file;
+
+public:
+	// Throws std::runtime_error if the file cannot be created.
+	CTxnTraceWriter(const char *);
+
+	void write(INT32, const TMsgDriverBrokerage *);
+
+	void
+	flush()
+	{
+		m_file.flush();
+	}
+};
+
+class CTxnTraceReader
+{
+private:
+	ifstream m_file;
+	string m_filename;
+
+public:
+	// Throws std::runtime_error if the file is not a trace of this build.
+	CTxnTraceReader(const char *);
+
+	// Returns false at the end of the trace.
+	bool next(TTraceRecord &, TMsgDriverBrokerage &);
+
+	const string &
+	filename() const
+	{
+		return m_filename;
+	}
+};
+
+#endif // TXN_TRACE_H
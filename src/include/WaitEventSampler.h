@@ -0,0 +1,93 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ *
+ * Samples the wait events of the Brokerage House backends in pg_stat_activity
+ * many times a second, over a connection of its own, and counts them by the
+ * transaction type each backend is running, which the executors register
+ * around every transaction.  A backend that is active and not waiting is
+ * counted as CPU.  The counts of every second are appended to
+ * waits-timeline.csv and the counts of the whole run rewritten to
+ * waits-profile.csv, with the share of each wait event in the samples of its
+ * transaction type.  A failed sample is logged and sampling goes on,
+ * reconnecting at most once a second while the connection is lost.
+ */
+
+#ifndef WAIT_EVENT_SAMPLER_H
+#define WAIT_EVENT_SAMPLER_H
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "locking.h"
+#include "condition.h"
+
+#include "BrokerageHouse.h"
+#include "DBConnection.h"
+
+class CWaitEventSampler
+{
+private:
+	typedef struct TWaitKey
+	{
+		int iTxnType;
+		string type;
+		string event;
+
+		bool
+		operator<(const TWaitKey &other) const
+		{
+			if (iTxnType != other.iTxnType)
+				return iTxnType < other.iTxnType;
+			if (type != other.type)
+				return type < other.type;
+			return event < other.event;
+		}
+	} *PWaitKey;
+
+	typedef map<TWaitKey, INT64> TWaitCounts;
+
+	CBrokerageHouse *m_pBrokerageHouse;
+	CDBConnection *m_pDBConnection;
+	int m_iInterval; // milliseconds
+	char m_szOutputDirectory[iMaxPath + 1];
+
+	// The transaction type each backend is running.
+	CMutex m_BackendLock;
+	map<int, int> m_backends;
+
+	// Only used by the sampler thread.
+	ofstream m_fTimeline;
+	TWaitCounts m_second;
+	TWaitCounts m_run;
+	bool m_bFailing; // the last sample failed, logged once
+	long m_iLastConnect; // second of the last reconnection attempt
+
+	CMutex m_StopLock;
+	CCondition m_StopCond;
+	bool m_bStop;
+	pthread_t m_ThreadId;
+
+	void run();
+	void sample();
+	void writeSecond(long);
+	void writeProfile();
+
+	friend void *waitEventSamplerThread(void *);
+
+public:
+	// Takes over the connection.  Throws CThreadErr if the sampler thread
+	// cannot be started.
+	CWaitEventSampler(CBrokerageHouse *, CDBConnection *, const char *, int);
+	~CWaitEventSampler();
+
+	// A backend, by its process id, starts or finishes a transaction of the
+	// given type.
+	void running(int, int);
+	void finished(int);
+};
+
+#endif // WAIT_EVENT_SAMPLER_H
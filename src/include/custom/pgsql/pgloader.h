@@ -85,10 +85,18 @@ protected:
 			len = iCopyBufSize - 1;
 		}
 
-		if (PQputCopyData(m_Conn, m_szCopyBuf, len) != 1) {
+		PutRecord(m_szCopyBuf, len);
+	}
+
+	// Send a formatted row to the COPY in progress.  MicroBench overrides
+	// it to time the formatting alone.
+	virtual void
+	PutRecord(const char *szRecord, int len)
+	{
+		if (PQputCopyData(m_Conn, szRecord, len) != 1) {
 			cout << "PQputCopyData failed: " << PQerrorMessage(m_Conn) << endl;
 			throw CSystemErr(
-					CSystemErr::eWriteFile, "CPGSQLLoader::CopyRecord");
+					CSystemErr::eWriteFile, "CPGSQLLoader::PutRecord");
 		}
 	}
 
@@ -7,17 +7,30 @@
  * 13 August 2006
  */
 
+#include <time.h>
 #include <unistd.h>
 #include <sys/syscall.h>
+#include <sys/time.h>
 
 #include "BaseInterface.h"
 #include "DBT5Consts.h"
+#include "Probes.h"
+
+static INT64
+microsecondsNow()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (INT64) tv.tv_sec * 1000000 + tv.tv_usec;
+}
 
 CBaseInterface::CBaseInterface(const char type[3], char *outputDirectory,
-		char *addr, const int iListenPort)
-: m_szBHAddress(addr), m_iBHlistenPort(iListenPort)
+		char *addr, const int iListenPort, pid_t id)
+: m_szBHAddress(addr), m_iBHlistenPort(iListenPort),
+  m_iSeq(0), m_bIntendedStart(false), m_bStopped(false), m_pTrace(NULL),
+  m_iTraceUser(0)
 {
-	m_pid = syscall(SYS_gettid);
+	m_pid = id != 0 ? id : syscall(SYS_gettid);
 
 	sock = new CSocket(m_szBHAddress, m_iBHlistenPort);
 	biConnect();
@@ -25,14 +38,19 @@ CBaseInterface::CBaseInterface(const char type[3], char *outputDirectory,
 	char filename[iMaxPath + 1];
 
 	memset(filename, 0, sizeof(filename));
-	snprintf(filename, sizeof(filename), "%s/mix-%s-%d.log", outputDirectory,
+	snprintf(filename, sizeof(filename), "%s/mix-%s-%d.bin", outputDirectory,
 			type, m_pid);
-	m_fMix.open(filename, ios::out);
+	m_pMix = new CMixLogWriter(filename);
 
 	memset(filename, 0, sizeof(filename));
 	snprintf(filename, sizeof(filename), "%s/error-%s-%d.log", outputDirectory,
 			type, m_pid);
 	m_fLog.open(filename, ios::out);
+
+	snprintf(m_szTraceFile, sizeof(m_szTraceFile), "%s/trace-%s-%d.bin",
+			outputDirectory, type, m_pid);
+
+	m_pLatency = CLatencyLog::attach(outputDirectory);
 }
 
 // destructor
@@ -40,8 +58,8 @@ CBaseInterface::~CBaseInterface()
 {
 	biDisconnect();
 	delete sock;
-
-	m_fMix.close();
+	delete m_pTrace;
+	delete m_pMix;
 }
 
 // connect to BrokerageHouse
@@ -87,9 +105,21 @@ CBaseInterface::talkToSUT(PMsgDriverBrokerage pRequest)
 	TMsgBrokerageDriver Reply; // reply message from BrokerageHouse
 	memset(&Reply, 0, sizeof(Reply));
 
+	// A Trade-Result is sampled when the request that led to it was.
+	pRequest->iTxnId = ((INT64) m_pid << 32) | ++m_iSeq;
+	pRequest->bSample = pRequest->iParentTxnId != 0
+			|| m_iSeq % iStageSampleInterval == 0;
+
 	// record txn start time -- please, see TPC-E specification clause
 	// 6.2.1.3
-	CDateTime StartTime; // to time the transaction
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	INT64 iSent = pRequest->bSample ? microsecondsNow() : 0;
+
+	if (m_pTrace != NULL)
+		m_pTrace->write(m_iTraceUser, pRequest);
+
+	DBT5_PROBE3(txn__send, pRequest->iTxnId, pRequest->TxnType, m_pid);
 
 	// send and wait for response
 	try {
@@ -131,15 +161,27 @@ CBaseInterface::talkToSUT(PMsgDriverBrokerage pRequest)
 	}
 
 	// record txn end time
-	CDateTime EndTime;
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	DBT5_PROBE3(txn__receive, pRequest->iTxnId, pRequest->TxnType,
+			Reply.iStatus);
+
+	// In open-loop mode measure from when the transaction was meant to
+	// start so that any time spent waiting behind earlier transactions is
+	// part of the response time.
+	if (m_bIntendedStart) {
+		start = m_IntendedStart;
+		m_bIntendedStart = false;
+	}
 
-	// calculate txn response time
-	CDateTime TxnTime;
-	TxnTime.Set(0); // clear time
-	TxnTime.Add(0, (int) ((EndTime - StartTime) * MsPerSecond)); // add ms
+	// calculate txn response time, in seconds with nanosecond resolution
+	double dRT = (double) (end.tv_sec - start.tv_sec)
+			+ (double) (end.tv_nsec - start.tv_nsec) / 1000000000.0;
 
 	// log response time
-	logResponseTime(Reply.iStatus, pRequest->TxnType, TxnTime.MSec() / 1000.0);
+	logResponseTime(Reply.iStatus, pRequest->TxnType, dRT);
+	if (pRequest->bSample)
+		m_pLatency->stages(pRequest, &Reply, iSent, microsecondsNow());
 
 	if (Reply.iStatus == CBaseTxnErr::SUCCESS)
 		return true;
@@ -150,9 +192,8 @@ CBaseInterface::talkToSUT(PMsgDriverBrokerage pRequest)
 void
 CBaseInterface::logResponseTime(int iStatus, int iTxnType, double dRT)
 {
-	m_fMix << (long long) time(NULL) << "," << iTxnType << "," << iStatus
-		   << "," << dRT << "," << m_pid << endl;
-	m_fMix.flush();
+	m_pMix->log(iTxnType, iStatus, dRT, m_pid, (INT32) m_iSeq);
+	m_pLatency->record(iTxnType, iStatus, dRT, m_pid);
 }
 
 // logErrorMessage
@@ -164,9 +205,34 @@ CBaseInterface::logErrorMessage(const string sErr)
 	m_fLog.flush();
 }
 
+void
+CBaseInterface::setIntendedStart(const struct timespec &ts)
+{
+	m_IntendedStart = ts;
+	m_bIntendedStart = true;
+}
+
 void
 CBaseInterface::logStopTime()
 {
-	m_fMix << time(NULL) << ",STOP,,," << m_pid << endl;
-	m_fMix.flush();
+	// Not every interface is deleted before the driver exits.
+	m_pMix->logStop(m_pid);
+	m_pMix->finish();
+
+	if (m_pTrace != NULL)
+		m_pTrace->flush();
+
+	if (!m_bStopped) {
+		m_bStopped = true;
+		CLatencyLog::detach();
+	}
+}
+
+// Record every request from now on, for TraceReplayMain.
+void
+CBaseInterface::startTrace(INT32 iUser)
+{
+	m_iTraceUser = iUser;
+	if (m_pTrace == NULL)
+		m_pTrace = new CTxnTraceWriter(m_szTraceFile);
 }
@@ -10,8 +10,9 @@
 #include "CESUT.h"
 
 // Constructor
-CCESUT::CCESUT(char *outputDirectory, char *addr, const int iListenPort)
-: CBaseInterface("ce", outputDirectory, addr, iListenPort)
+CCESUT::CCESUT(
+		char *outputDirectory, char *addr, const int iListenPort, pid_t id)
+: CBaseInterface("ce", outputDirectory, addr, iListenPort, id)
 {
 }
 
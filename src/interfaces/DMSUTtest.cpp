@@ -9,7 +9,10 @@
 
 #include "DMSUTtest.h"
 
-CDMSUTtest::CDMSUTtest(CDBConnection *pDBConn): m_pDBConnection(pDBConn) {}
+CDMSUTtest::CDMSUTtest(CDBConnection *pDBConn, bool bVerbose)
+: m_pDBConnection(pDBConn), m_bVerbose(bVerbose)
+{
+}
 
 CDMSUTtest::~CDMSUTtest() {}
 
@@ -18,7 +21,7 @@ CDMSUTtest::DataMaintenance(PDataMaintenanceTxnInput pTxnInput)
 {
 	// Data Maintenance harness code (TPC provided)
 	// this class uses our implementation of CDataMaintenanceDB class
-	CDataMaintenanceDB m_DataMaintenanceDB(m_pDBConnection, true);
+	CDataMaintenanceDB m_DataMaintenanceDB(m_pDBConnection, m_bVerbose);
 	CDataMaintenance m_DataMaintenance(&m_DataMaintenanceDB);
 
 	// Data Maintenance output parameters
@@ -35,7 +38,7 @@ CDMSUTtest::TradeCleanup(PTradeCleanupTxnInput pTxnInput)
 {
 	// Data Maintenance harness code (TPC provided)
 	// this class uses our implementation of CTradeCleanupDB class
-	CTradeCleanupDB m_TradeCleanupDB(m_pDBConnection, true);
+	CTradeCleanupDB m_TradeCleanupDB(m_pDBConnection, m_bVerbose);
 	CTradeCleanup m_TradeCleanup(&m_TradeCleanupDB);
 
 	// Data Maintenance output parameters
@@ -0,0 +1,262 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+
+#include "Histogram.h"
+
+static const int iSubBuckets = 1 << iHistogramSubBucketMagnitude;
+static const int iSubBucketHalf = iSubBuckets / 2;
+static const INT64 iSubBucketMask = iSubBuckets - 1;
+
+CHistogram::CHistogram()
+: m_iTotal(0), m_iMin(0), m_iMax(0), m_dSum(0.0)
+{
+	// Buckets until the largest value can be tracked.
+	INT64 smallestUntrackable = iSubBuckets;
+	m_iBuckets = 1;
+	while (smallestUntrackable <= iHistogramHighest) {
+		smallestUntrackable <<= 1;
+		++m_iBuckets;
+	}
+	m_counts.resize((m_iBuckets + 1) * iSubBucketHalf, 0);
+}
+
+int
+CHistogram::countsIndex(INT64 value) const
+{
+	int pow2ceiling = 64 - __builtin_clzll((UINT64) (value | iSubBucketMask));
+	int bucket = pow2ceiling - iHistogramSubBucketMagnitude;
+	int subBucket = (int) (value >> bucket);
+	return ((bucket + 1) << (iHistogramSubBucketMagnitude - 1))
+			+ (subBucket - iSubBucketHalf);
+}
+
+INT64
+CHistogram::valueFromIndex(int index) const
+{
+	int bucket = (index >> (iHistogramSubBucketMagnitude - 1)) - 1;
+	int subBucket = (index & (iSubBucketHalf - 1)) + iSubBucketHalf;
+	if (bucket < 0) {
+		subBucket -= iSubBucketHalf;
+		bucket = 0;
+	}
+	return (INT64) subBucket << bucket;
+}
+
+INT64
+CHistogram::highestEquivalentValue(INT64 value) const
+{
+	int pow2ceiling = 64 - __builtin_clzll((UINT64) (value | iSubBucketMask));
+	int bucket = pow2ceiling - iHistogramSubBucketMagnitude;
+	return value + ((INT64) 1 << bucket) - 1;
+}
+
+void
+CHistogram::record(INT64 value)
+{
+	if (value < 0)
+		value = 0;
+	else if (value > iHistogramHighest)
+		value = iHistogramHighest;
+
+	++m_counts[countsIndex(value)];
+	if (m_iTotal == 0 || value < m_iMin)
+		m_iMin = value;
+	if (value > m_iMax)
+		m_iMax = value;
+	m_dSum += (double) value;
+	++m_iTotal;
+}
+
+void
+CHistogram::add(const CHistogram &other)
+{
+	if (other.m_iTotal == 0)
+		return;
+
+	for (size_t i = 0; i < m_counts.size(); i++)
+		m_counts[i] += other.m_counts[i];
+	if (m_iTotal == 0 || other.m_iMin < m_iMin)
+		m_iMin = other.m_iMin;
+	if (other.m_iMax > m_iMax)
+		m_iMax = other.m_iMax;
+	m_dSum += other.m_dSum;
+	m_iTotal += other.m_iTotal;
+}
+
+void
+CHistogram::reset()
+{
+	if (m_iTotal == 0)
+		return;
+
+	fill(m_counts.begin(), m_counts.end(), 0);
+	m_iTotal = 0;
+	m_iMin = 0;
+	m_iMax = 0;
+	m_dSum = 0.0;
+}
+
+INT64
+CHistogram::min() const
+{
+	return m_iMin;
+}
+
+INT64
+CHistogram::max() const
+{
+	return m_iMax;
+}
+
+double
+CHistogram::mean() const
+{
+	return m_iTotal == 0 ? 0.0 : m_dSum / (double) m_iTotal;
+}
+
+double
+CHistogram::stddev() const
+{
+	if (m_iTotal == 0)
+		return 0.0;
+
+	double dMean = mean();
+	double dSquares = 0.0;
+	for (size_t i = 0; i < m_counts.size(); i++) {
+		if (m_counts[i] == 0)
+			continue;
+		double d = (double) valueFromIndex((int) i) - dMean;
+		dSquares += d * d * (double) m_counts[i];
+	}
+	return sqrt(dSquares / (double) m_iTotal);
+}
+
+// The highest value equivalent to the one at the percentile, so that the
+// true percentile is never reported too low.
+INT64
+CHistogram::valueAtPercentile(double percentile) const
+{
+	if (m_iTotal == 0)
+		return 0;
+
+	INT64 iCountAt = (INT64) (percentile / 100.0 * (double) m_iTotal + 0.5);
+	if (iCountAt < 1)
+		iCountAt = 1;
+
+	INT64 iRunning = 0;
+	for (size_t i = 0; i < m_counts.size(); i++) {
+		iRunning += m_counts[i];
+		if (iRunning >= iCountAt) {
+			INT64 value = highestEquivalentValue(valueFromIndex((int) i));
+			return value < m_iMax ? value : m_iMax;
+		}
+	}
+	return m_iMax;
+}
+
+// Report the percentiles in steps that halve with every halving of the
+// distance to 100%, 5 steps each, like HdrHistogram does.
+void
+CHistogram::writePercentiles(ostream &out, double dRatio) const
+{
+	char line[256];
+
+	snprintf(line, sizeof(line), "%12s %14s %10s %14s\n\n", "Value",
+			"Percentile", "TotalCount", "1/(1-Percentile)");
+	out << line;
+
+	double dPercentile = 0.0;
+	while (m_iTotal > 0) {
+		INT64 value = valueAtPercentile(dPercentile);
+		INT64 iRunning = 0;
+		for (int i = 0; i <= countsIndex(value); i++)
+			iRunning += m_counts[i];
+
+		if (iRunning >= m_iTotal || dPercentile >= 100.0) {
+			snprintf(line, sizeof(line), "%12.3f %14.12f %10lld\n",
+					(double) m_iMax / dRatio, 1.0, (long long) m_iTotal);
+			out << line;
+			break;
+		}
+
+		snprintf(line, sizeof(line), "%12.3f %14.12f %10lld %14.2f\n",
+				(double) value / dRatio, dPercentile / 100.0,
+				(long long) iRunning, 100.0 / (100.0 - dPercentile));
+		out << line;
+
+		double dHalfDistance
+				= pow(2.0, floor(log(100.0 / (100.0 - dPercentile)) / log(2.0))
+								+ 1.0);
+		dPercentile += 100.0 / (5.0 * dHalfDistance);
+	}
+
+	snprintf(line, sizeof(line),
+			"#[Mean    = %12.3f, StdDeviation   = %12.3f]\n"
+			"#[Max     = %12.3f, Total count    = %12lld]\n"
+			"#[Buckets = %12d, SubBuckets     = %12d]\n",
+			mean() / dRatio, stddev() / dRatio, (double) m_iMax / dRatio,
+			(long long) m_iTotal, m_iBuckets, iSubBuckets);
+	out << line;
+}
+
+// The total, minimum, maximum and sum, then the number of counts that are
+// not 0 followed by their indexes and counts.
+void
+CHistogram::write(ostream &out) const
+{
+	int iUsed = 0;
+	for (size_t i = 0; i < m_counts.size(); i++) {
+		if (m_counts[i] != 0)
+			++iUsed;
+	}
+
+	char number[64];
+	snprintf(number, sizeof(number), "%lld %lld %lld %.17g %d",
+			(long long) m_iTotal, (long long) m_iMin, (long long) m_iMax,
+			m_dSum, iUsed);
+	out << number;
+	for (size_t i = 0; i < m_counts.size(); i++) {
+		if (m_counts[i] == 0)
+			continue;
+		snprintf(number, sizeof(number), " %d %lld", (int) i,
+				(long long) m_counts[i]);
+		out << number;
+	}
+}
+
+bool
+CHistogram::read(istream &in)
+{
+	CHistogram other;
+	long long iTotal, iMin, iMax;
+	int iUsed;
+	if (!(in >> iTotal >> iMin >> iMax >> other.m_dSum >> iUsed) || iUsed < 0)
+		return false;
+
+	INT64 iCounted = 0;
+	for (int i = 0; i < iUsed; i++) {
+		int index;
+		long long iCount;
+		if (!(in >> index >> iCount) || index < 0
+				|| (size_t) index >= other.m_counts.size() || iCount < 0)
+			return false;
+		other.m_counts[index] += iCount;
+		iCounted += iCount;
+	}
+	if (iCounted != iTotal)
+		return false;
+
+	other.m_iTotal = iTotal;
+	other.m_iMin = iMin;
+	other.m_iMax = iMax;
+	add(other);
+	return true;
+}
@@ -0,0 +1,357 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sstream>
+
+#include "LatencyLog.h"
+#include "CThreadErr.h"
+#include "DBT5Consts.h"
+
+void *
+latencyLogThread(void *data)
+{
+	reinterpret_cast<CLatencyLog *>(data)->run();
+	return NULL;
+}
+
+CMutex CLatencyLog::s_Lock;
+CLatencyLog *CLatencyLog::s_pInstance = NULL;
+int CLatencyLog::s_iUsers = 0;
+
+CLatencyLog::CLatencyLog(const char *outputDirectory)
+: m_iTicks(0), m_bHeader(false), m_report(NULL), m_pReportData(NULL),
+  m_StopCond(m_StopLock), m_bStop(false)
+{
+	strncpy(m_szOutputDirectory, outputDirectory, iMaxPath);
+	m_szOutputDirectory[iMaxPath] = '\0';
+
+	for (int i = 0; i < iLatencyStripes; i++)
+		memset(m_stripes[i].errors, 0, sizeof(m_stripes[i].errors));
+	memset(m_errors, 0, sizeof(m_errors));
+	memset(m_intervalErrors, 0, sizeof(m_intervalErrors));
+
+	char filename[iMaxPath + 1];
+	snprintf(filename, sizeof(filename), "%s/latency-%d.log",
+			outputDirectory, (int) getpid());
+	m_fLog.open(filename, ios::out);
+	m_fLog << "time,txn,count,min,mean,p50,p90,p99,max" << endl;
+
+	snprintf(filename, sizeof(filename), "%s/status-%d.csv", outputDirectory,
+			(int) getpid());
+	m_fStatus.open(filename, ios::out);
+
+	snprintf(filename, sizeof(filename), "%s/stages-%d.csv", outputDirectory,
+			(int) getpid());
+	m_fStages.open(filename, ios::out);
+	m_fStages << "txn_id,parent_id,txn,status,sent,received,db_start,db_end,"
+				 "answered"
+			  << endl;
+
+	if (pthread_create(&m_ThreadId, NULL, &latencyLogThread, this) != 0) {
+		throw CThreadErr(CThreadErr::ERR_THREAD_CREATE, "CLatencyLog::ctor");
+	}
+}
+
+CLatencyLog::~CLatencyLog()
+{
+	finish();
+}
+
+CLatencyLog *
+CLatencyLog::attach(const char *outputDirectory)
+{
+	Locker<CMutex> locker(s_Lock);
+	if (s_pInstance == NULL)
+		s_pInstance = new CLatencyLog(outputDirectory);
+	++s_iUsers;
+	return s_pInstance;
+}
+
+void
+CLatencyLog::detach()
+{
+	Locker<CMutex> locker(s_Lock);
+	if (--s_iUsers == 0)
+		s_pInstance->finish();
+}
+
+void
+CLatencyLog::record(int iTxnType, int iStatus, double dRT, int iId)
+{
+	if (iTxnType < 0 || iTxnType >= iLatencyTxnTypes)
+		return;
+
+	PLatencyStripe pStripe = &m_stripes[(unsigned int) iId % iLatencyStripes];
+	Locker<CMutex> locker(pStripe->lock);
+	if (iStatus < 0)
+		++pStripe->errors[iTxnType];
+	// Failed requests are logged with a negative response time.
+	if (dRT >= 0.0)
+		pStripe->histograms[iTxnType].record((INT64) (dRT * 1000000.0 + 0.5));
+}
+
+// Sampled requests are few, one lock is enough.
+void
+CLatencyLog::stages(const TMsgDriverBrokerage *pRequest,
+		const TMsgBrokerageDriver *pReply, INT64 iSent, INT64 iAnswered)
+{
+	char line[256];
+	snprintf(line, sizeof(line),
+			"%lld,%lld,%d,%d,%lld,%lld,%lld,%lld,%lld\n",
+			(long long) pRequest->iTxnId, (long long) pRequest->iParentTxnId,
+			(int) pRequest->TxnType, pReply->iStatus, (long long) iSent,
+			(long long) pReply->iReceived, (long long) pReply->iDBStart,
+			(long long) pReply->iDBEnd, (long long) iAnswered);
+
+	Locker<CMutex> locker(m_StageLock);
+	m_fStages << line;
+	m_fStages.flush();
+}
+
+void
+CLatencyLog::addGauge(const char *name, TStatusGauge gauge, void *data)
+{
+	Locker<CMutex> locker(m_GaugeLock);
+	if (m_bHeader)
+		return;
+
+	TStatusGaugeEntry entry;
+	entry.name = name;
+	entry.gauge = gauge;
+	entry.data = data;
+	m_gauges.push_back(entry);
+}
+
+// The columns of the removed gauges stay empty.
+void
+CLatencyLog::removeGauges(void *data)
+{
+	Locker<CMutex> locker(m_GaugeLock);
+	for (size_t i = 0; i < m_gauges.size(); i++) {
+		if (m_gauges[i].data == data)
+			m_gauges[i].gauge = NULL;
+	}
+}
+
+void
+CLatencyLog::setIntervalReport(TIntervalReport report, void *data)
+{
+	Locker<CMutex> locker(m_GaugeLock);
+	m_report = report;
+	m_pReportData = data;
+}
+
+void
+CLatencyLog::run()
+{
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	m_StopCond.lock();
+	while (!m_bStop) {
+		next.tv_sec += iStatusInterval;
+		while (!m_bStop) {
+			struct timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			long wait = (long) (next.tv_sec - now.tv_sec) * 1000000
+					+ (next.tv_nsec - now.tv_nsec) / 1000;
+			if (wait <= 0)
+				break;
+			m_StopCond.timedwait(wait);
+		}
+		if (m_bStop)
+			break;
+
+		m_StopCond.unlock();
+		tick(true);
+		if (++m_iTicks * iStatusInterval >= iLatencyInterval) {
+			m_iTicks = 0;
+			snapshot();
+			writeRun();
+		}
+		m_StopCond.lock();
+	}
+	m_StopCond.unlock();
+}
+
+// Merge the stripes into the histograms of the second, report it and add it
+// to the interval.
+void
+CLatencyLog::tick(bool bStatus)
+{
+	for (int i = 0; i < iLatencyStripes; i++) {
+		Locker<CMutex> locker(m_stripes[i].lock);
+		for (int j = 0; j < iLatencyTxnTypes; j++) {
+			m_second[j].add(m_stripes[i].histograms[j]);
+			m_stripes[i].histograms[j].reset();
+			m_errors[j] += m_stripes[i].errors[j];
+			m_stripes[i].errors[j] = 0;
+		}
+	}
+
+	if (bStatus)
+		status((double) iStatusInterval);
+
+	for (int i = 0; i < iLatencyTxnTypes; i++) {
+		m_interval[i].add(m_second[i]);
+		m_second[i].reset();
+		m_intervalErrors[i] += m_errors[i];
+		m_errors[i] = 0;
+	}
+}
+
+// Write time,tps,tpse,errors,p90 and the tps of each transaction type,
+// followed by the gauges, to the status file, and a shorter line to stdout,
+// from the first transaction on.  tpsE is the Trade-Result rate, so it is
+// only seen where the Market Exchange runs.
+void
+CLatencyLog::status(double dSeconds)
+{
+	CHistogram all;
+	INT64 iErrors = 0;
+	for (int i = 0; i < iLatencyTxnTypes; i++) {
+		all.add(m_second[i]);
+		iErrors += m_errors[i];
+	}
+
+	Locker<CMutex> locker(m_GaugeLock);
+
+	if (!m_bHeader) {
+		// Nothing to report until the first transaction.
+		if (all.count() == 0 && iErrors == 0)
+			return;
+
+		m_bHeader = true;
+		m_fStatus << "time,tps,tpse,errors,p90";
+		for (int i = 0; i < iLatencyTxnTypes; i++) {
+			char name[sizeof(szTransactionName[i])];
+			for (size_t j = 0; j < sizeof(name); j++)
+				name[j] = tolower(szTransactionName[i][j]);
+			m_fStatus << "," << name;
+		}
+		for (size_t i = 0; i < m_gauges.size(); i++)
+			m_fStatus << "," << m_gauges[i].name;
+		m_fStatus << endl;
+	}
+
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	char line[128];
+	snprintf(line, sizeof(line), "%ld,%.2f,%.2f,%.2f,%.6f", (long) tv.tv_sec,
+			all.count() / dSeconds, m_second[TRADE_RESULT].count() / dSeconds,
+			iErrors / dSeconds, all.valueAtPercentile(90.0) / 1000000.0);
+	m_fStatus << line;
+	for (int i = 0; i < iLatencyTxnTypes; i++) {
+		snprintf(line, sizeof(line), ",%.2f", m_second[i].count() / dSeconds);
+		m_fStatus << line;
+	}
+
+	ostringstream gauges;
+	for (size_t i = 0; i < m_gauges.size(); i++) {
+		m_fStatus << ",";
+		if (m_gauges[i].gauge == NULL)
+			continue;
+		long value = m_gauges[i].gauge(m_gauges[i].data);
+		m_fStatus << value;
+		gauges << " " << m_gauges[i].name << " " << value;
+	}
+	m_fStatus << endl;
+
+	snprintf(line, sizeof(line),
+			"%ld status: tps %.0f tpsE %.0f errors %.0f p90 %.3f s",
+			(long) tv.tv_sec, all.count() / dSeconds,
+			m_second[TRADE_RESULT].count() / dSeconds, iErrors / dSeconds,
+			all.valueAtPercentile(90.0) / 1000000.0);
+	cout << line << gauges.str() << endl;
+}
+
+// Log the summary of the interval, pass it on and add it to the run.
+void
+CLatencyLog::snapshot()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	// Response times in seconds, like the mix log.
+	char line[256];
+	for (int i = 0; i < iLatencyTxnTypes; i++) {
+		const CHistogram &h = m_interval[i];
+		if (h.count() == 0)
+			continue;
+
+		snprintf(line, sizeof(line),
+				"%ld.%06ld,%d,%lld,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+				(long) tv.tv_sec, (long) tv.tv_usec, i, (long long) h.count(),
+				h.min() / 1000000.0, h.mean() / 1000000.0,
+				h.valueAtPercentile(50.0) / 1000000.0,
+				h.valueAtPercentile(90.0) / 1000000.0,
+				h.valueAtPercentile(99.0) / 1000000.0, h.max() / 1000000.0);
+		m_fLog << line;
+	}
+	m_fLog.flush();
+
+	m_GaugeLock.lock();
+	if (m_report != NULL)
+		m_report(m_pReportData, m_interval, m_intervalErrors);
+	m_GaugeLock.unlock();
+
+	for (int i = 0; i < iLatencyTxnTypes; i++) {
+		m_run[i].add(m_interval[i]);
+		m_interval[i].reset();
+		m_intervalErrors[i] = 0;
+	}
+}
+
+// Replace the histograms of the run, values in milliseconds.
+void
+CLatencyLog::writeRun()
+{
+	for (int i = 0; i < iLatencyTxnTypes; i++) {
+		if (m_run[i].count() == 0)
+			continue;
+
+		char name[sizeof(szTransactionName[i])];
+		for (size_t j = 0; j < sizeof(name); j++)
+			name[j] = tolower(szTransactionName[i][j]);
+
+		char filename[iMaxPath + 1];
+		char tmpname[iMaxPath + 1];
+		snprintf(filename, sizeof(filename), "%s/latency-%d-%s.hgrm",
+				m_szOutputDirectory, (int) getpid(), name);
+		snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename);
+
+		ofstream f(tmpname, ios::out);
+		m_run[i].writePercentiles(f, 1000.0);
+		f.close();
+		rename(tmpname, filename);
+	}
+}
+
+void
+CLatencyLog::finish()
+{
+	m_StopCond.lock();
+	if (m_bStop) {
+		m_StopCond.unlock();
+		return;
+	}
+	m_bStop = true;
+	m_StopCond.signal();
+	m_StopCond.unlock();
+	pthread_join(m_ThreadId, NULL);
+
+	// No status line for what is left of the last second.
+	tick(false);
+	snapshot();
+	writeRun();
+}
@@ -8,6 +8,7 @@
  */
 
 #include "MEESUT.h"
+#include "Probes.h"
 
 CMEESUT::~CMEESUT()
 {
@@ -36,6 +37,20 @@ CMEESUT::threadFinished()
 	}
 }
 
+int
+CMEESUT::outstanding()
+{
+	Locker<CMutex> locker(m_ThreadCountLock);
+	return m_OutstandingThreads;
+}
+
+void
+CMEESUT::setParentTxnId(TTrade trade_id, INT64 iTxnId)
+{
+	Locker<CMutex> locker(m_ParentLock);
+	m_parents[trade_id] = iTxnId;
+}
+
 void *
 TradeResultAsync(void *data)
 {
@@ -45,6 +60,7 @@ TradeResultAsync(void *data)
 	memset(&request, 0, sizeof(TMsgDriverBrokerage));
 
 	request.TxnType = TRADE_RESULT;
+	request.iParentTxnId = pThrParam->iParentTxnId;
 	memcpy(&(request.TxnInput.TradeResultTxnInput),
 			&(pThrParam->TxnInput.m_TradeResultTxnInput),
 			sizeof(request.TxnInput.TradeResultTxnInput));
@@ -117,6 +133,8 @@ RunTradeResultAsync(void *data)
 bool
 CMEESUT::TradeResult(PTradeResultTxnInput pTxnInput)
 {
+	DBT5_PROBE1(mee__trade__result, pTxnInput->trade_id);
+
 	PMEESUTThreadParam pThrParam = new TMEESUTThreadParam;
 	memset(pThrParam, 0, sizeof(TMEESUTThreadParam));
 
@@ -124,6 +142,16 @@ CMEESUT::TradeResult(PTradeResultTxnInput pTxnInput)
 	memcpy(&(pThrParam->TxnInput.m_TradeResultTxnInput), pTxnInput,
 			sizeof(TTradeResultTxnInput));
 
+	{
+		Locker<CMutex> locker(m_ParentLock);
+		std::map<TTrade, INT64>::iterator it
+				= m_parents.find(pTxnInput->trade_id);
+		if (it != m_parents.end()) {
+			pThrParam->iParentTxnId = it->second;
+			m_parents.erase(it);
+		}
+	}
+
 	return (RunTradeResultAsync(reinterpret_cast<void *>(pThrParam)));
 }
 
@@ -210,6 +238,8 @@ RunMarketFeedAsync(void *data)
 bool
 CMEESUT::MarketFeed(PMarketFeedTxnInput pTxnInput)
 {
+	DBT5_PROBE(mee__market__feed);
+
 	PMEESUTThreadParam pThrParam = new TMEESUTThreadParam;
 	memset(pThrParam, 0, sizeof(TMEESUTThreadParam));
 
@@ -0,0 +1,263 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <iostream>
+#include <stdexcept>
+
+#include "MixLog.h"
+
+static INT64
+microsecondsNow()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (INT64) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// Write all of a buffer, returns false on an error.
+static bool
+writeAll(int fd, const char *data, size_t length)
+{
+	while (length > 0) {
+		ssize_t n = write(fd, data, length);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		data += n;
+		length -= n;
+	}
+	return true;
+}
+
+void *
+mixLogFlushThread(void *)
+{
+	CMixLogWriter::runFlush();
+	return NULL;
+}
+
+CMutex CMixLogWriter::s_Lock;
+CCondition CMixLogWriter::s_Cond(CMixLogWriter::s_Lock);
+vector<CMixLogWriter *> CMixLogWriter::s_writers;
+bool CMixLogWriter::s_bFlushing = false;
+
+CMixLogWriter::CMixLogWriter(const char *filename)
+: m_filename(filename), m_iUsed(0), m_iRecords(0), m_bFinished(false),
+  m_bWriteFailed(false)
+{
+	m_fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (m_fd == -1) {
+		throw std::runtime_error(
+				string("cannot create mix log ") + filename + ": "
+				+ strerror(errno));
+	}
+
+	TMixLogHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.szMagic, MIX_LOG_MAGIC, sizeof(header.szMagic));
+	header.iRecordSize = sizeof(TMixLogRecord);
+	write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	m_pBuffer = new char[iMixLogBufferSize];
+	m_iLastWrite = microsecondsNow();
+
+	s_Cond.lock();
+	s_writers.push_back(this);
+	if (!s_bFlushing) {
+		pthread_t tid;
+		if (pthread_create(&tid, NULL, &mixLogFlushThread, NULL) != 0) {
+			s_writers.pop_back();
+			s_Cond.unlock();
+			close(m_fd);
+			delete[] m_pBuffer;
+			throw std::runtime_error(
+					"cannot start the mix log flush thread");
+		}
+		pthread_detach(tid);
+		s_bFlushing = true;
+	}
+	s_Cond.unlock();
+}
+
+CMixLogWriter::~CMixLogWriter()
+{
+	s_Cond.lock();
+	for (size_t i = 0; i < s_writers.size(); i++) {
+		if (s_writers[i] == this) {
+			s_writers.erase(s_writers.begin() + i);
+			break;
+		}
+	}
+	// Let the flush thread end.
+	if (s_writers.empty())
+		s_Cond.signal();
+	s_Cond.unlock();
+
+	finish();
+	close(m_fd);
+	delete[] m_pBuffer;
+}
+
+void
+CMixLogWriter::append(INT64 iTime, INT32 iTxn, INT32 iStatus, double dRT,
+		INT32 iId, INT32 iSeq)
+{
+	TMixLogRecord record;
+	memset(&record, 0, sizeof(record));
+	record.iTime = iTime;
+	record.dRT = dRT;
+	record.iTxn = iTxn;
+	record.iStatus = iStatus;
+	record.iId = iId;
+	record.iSeq = iSeq;
+
+	if (m_iUsed + (int) sizeof(record) > iMixLogBufferSize)
+		writeBuffer();
+	memcpy(m_pBuffer + m_iUsed, &record, sizeof(record));
+	m_iUsed += sizeof(record);
+}
+
+void
+CMixLogWriter::log(
+		INT32 iTxn, INT32 iStatus, double dRT, INT32 iId, INT32 iSeq)
+{
+	Locker<CMutex> locker(m_Lock);
+	if (m_bFinished)
+		return;
+
+	INT64 now = microsecondsNow();
+	append(now, iTxn, iStatus, dRT, iId, iSeq);
+	++m_iRecords;
+	if (now - m_iLastWrite >= (INT64) iMixLogFlushInterval * 1000000)
+		writeBuffer();
+}
+
+void
+CMixLogWriter::logStart(INT32 iId)
+{
+	log(iMixLogStart, 0, 0.0, iId);
+}
+
+void
+CMixLogWriter::logStop(INT32 iId)
+{
+	log(iMixLogStop, 0, 0.0, iId);
+}
+
+// Nothing more sensible can be done about a failed write in the middle of a
+// test than to report it; the reader stops at the last whole record.
+void
+CMixLogWriter::write(const char *data, size_t length)
+{
+	if (!writeAll(m_fd, data, length) && !m_bWriteFailed) {
+		m_bWriteFailed = true;
+		cerr << "Warning: cannot write mix log " << m_filename << ": "
+			 << strerror(errno) << endl;
+	}
+}
+
+void
+CMixLogWriter::writeBuffer()
+{
+	if (m_iUsed > 0) {
+		write(m_pBuffer, m_iUsed);
+		m_iUsed = 0;
+	}
+	m_iLastWrite = microsecondsNow();
+}
+
+void
+CMixLogWriter::flush()
+{
+	Locker<CMutex> locker(m_Lock);
+	writeBuffer();
+}
+
+// Called by the flush thread, with the time it woke up.
+void
+CMixLogWriter::flushIdle(INT64 now)
+{
+	Locker<CMutex> locker(m_Lock);
+	if (m_iUsed > 0
+			&& now - m_iLastWrite >= (INT64) iMixLogFlushInterval * 1000000)
+		writeBuffer();
+}
+
+void
+CMixLogWriter::runFlush()
+{
+	s_Cond.lock();
+	while (!s_writers.empty()) {
+		s_Cond.timedwait((long) iMixLogFlushInterval * 1000000);
+		INT64 now = microsecondsNow();
+		for (size_t i = 0; i < s_writers.size(); i++)
+			s_writers[i]->flushIdle(now);
+	}
+	s_bFlushing = false;
+	s_Cond.unlock();
+}
+
+void
+CMixLogWriter::finish()
+{
+	Locker<CMutex> locker(m_Lock);
+	if (m_bFinished)
+		return;
+
+	append(m_iRecords, iMixLogFooter, 0, 0.0, 0, 0);
+	writeBuffer();
+	m_bFinished = true;
+}
+
+CMixLogReader::CMixLogReader(const char *filename)
+: m_filename(filename), m_iRecords(0), m_bComplete(false)
+{
+	m_file.open(filename, ios::in | ios::binary);
+	if (!m_file) {
+		throw std::runtime_error(string("cannot open mix log ") + filename);
+	}
+
+	TMixLogHeader header;
+	if (!m_file.read(reinterpret_cast<char *>(&header), sizeof(header))
+			|| memcmp(header.szMagic, MIX_LOG_MAGIC, sizeof(header.szMagic))
+					!= 0) {
+		throw std::runtime_error(string("not a mix log: ") + filename);
+	}
+	if (header.iRecordSize != sizeof(TMixLogRecord)) {
+		throw std::runtime_error(
+				string("mix log from a different build: ") + filename);
+	}
+}
+
+bool
+CMixLogReader::next(TMixLogRecord &record)
+{
+	// A partial record at the end is where the writer was killed.
+	if (!m_file.read(reinterpret_cast<char *>(&record), sizeof(record)))
+		return false;
+
+	if (record.iTxn == iMixLogFooter) {
+		m_bComplete = record.iTime == m_iRecords;
+		return false;
+	}
+
+	++m_iRecords;
+	return true;
+}
+
+bool
+CMixLogReader::complete() const
+{
+	return m_bComplete;
+}
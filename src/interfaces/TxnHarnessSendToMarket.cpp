@@ -11,7 +11,7 @@
 
 CSendToMarket::CSendToMarket(
 		ofstream *pfile, char *addr, int MEport = iMarketExchangePort)
-: m_pfLog(pfile), m_MEport(MEport)
+: m_pfLog(pfile), m_MEport(MEport), m_iTxnId(0)
 {
 	if (addr != NULL)
 		m_Socket = new CSocket(addr, m_MEport);
@@ -29,10 +29,14 @@ CSendToMarket::~CSendToMarket()
 bool
 CSendToMarket::SendToMarket(TTradeRequest &trade_mes)
 {
+	TMsgBrokerageMarket message;
+	message.iTxnId = m_iTxnId;
+	message.TradeRequest = trade_mes;
+
 	try {
 		// send Trade Request to MEE
 		m_Socket->dbt5Send(
-				reinterpret_cast<void *>(&trade_mes), sizeof(TTradeRequest));
+				reinterpret_cast<void *>(&message), sizeof(message));
 	} catch (CSocketErr *pErr) {
 		ostringstream osErr;
 		osErr << "Cannot send to market" << endl
@@ -47,8 +51,8 @@ CSendToMarket::SendToMarket(TTradeRequest &trade_mes)
 		// this reconnect path.
 		try {
 			m_Socket->dbt5Reconnect();
-			m_Socket->dbt5Send(reinterpret_cast<void *>(&trade_mes),
-					sizeof(TTradeRequest));
+			m_Socket->dbt5Send(
+					reinterpret_cast<void *>(&message), sizeof(message));
 		} catch (CSocketErr *pErr2) {
 			m_Socket->dbt5Disconnect(); // close connection
 
@@ -65,6 +69,12 @@ CSendToMarket::SendToMarket(TTradeRequest &trade_mes)
 	return true;
 }
 
+void
+CSendToMarket::setTxnId(INT64 iTxnId)
+{
+	m_iTxnId = iTxnId;
+}
+
 // LogErrorMessage
 void
 CSendToMarket::LogErrorMessage(const string sErr)
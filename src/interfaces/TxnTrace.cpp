@@ -0,0 +1,87 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <string.h>
+#include <sys/time.h>
+#include <stdexcept>
+
+#include "TxnTrace.h"
+
+CTxnTraceWriter::CTxnTraceWriter(const char *filename)
+{
+	m_file.open(filename, ios::out | ios::binary);
+	if (!m_file) {
+		throw std::runtime_error(string("cannot create trace file ")
+				+ filename);
+	}
+
+	TTraceFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.szMagic, TRACE_MAGIC, sizeof(header.szMagic));
+	header.iMessageSize = sizeof(TMsgDriverBrokerage);
+	m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+void
+CTxnTraceWriter::write(INT32 iUser, const TMsgDriverBrokerage *pRequest)
+{
+	const char *data = reinterpret_cast<const char *>(pRequest);
+
+	// Leave out the zeros at the end.
+	UINT32 iLength = sizeof(*pRequest);
+	while (iLength > 0 && data[iLength - 1] == '\0')
+		--iLength;
+
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	TTraceRecord record;
+	record.iTime = (INT64) tv.tv_sec * 1000000 + tv.tv_usec;
+	record.iUser = iUser;
+	record.iLength = iLength;
+	m_file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+	m_file.write(data, iLength);
+}
+
+CTxnTraceReader::CTxnTraceReader(const char *filename): m_filename(filename)
+{
+	m_file.open(filename, ios::in | ios::binary);
+	if (!m_file) {
+		throw std::runtime_error(string("cannot open trace file ") + filename);
+	}
+
+	TTraceFileHeader header;
+	if (!m_file.read(reinterpret_cast<char *>(&header), sizeof(header))
+			|| memcmp(header.szMagic, TRACE_MAGIC, sizeof(header.szMagic))
+					!= 0) {
+		throw std::runtime_error(string("not a trace file: ") + filename);
+	}
+	if (header.iMessageSize != sizeof(TMsgDriverBrokerage)) {
+		throw std::runtime_error(
+				string("trace file from a different build: ") + filename);
+	}
+}
+
+bool
+CTxnTraceReader::next(TTraceRecord &record, TMsgDriverBrokerage &request)
+{
+	if (!m_file.read(reinterpret_cast<char *>(&record), sizeof(record)))
+		return false;
+	if (record.iLength > sizeof(request)) {
+		throw std::runtime_error("corrupt trace file: " + m_filename);
+	}
+
+	// A driver that was killed may have left the last request incomplete,
+	// treat that as the end of the trace.
+	memset(&request, 0, sizeof(request));
+	if (!m_file.read(reinterpret_cast<char *>(&request), record.iLength))
+		return false;
+
+	// The ids of the traced run mean nothing to the replay.
+	request.iParentTxnId = 0;
+	return true;
+}
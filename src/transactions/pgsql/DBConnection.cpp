@@ -11,14 +11,17 @@
  * 13 June 2006
  */
 
+#include <time.h>
+
 #include <catalog/pg_type_d.h>
 
 #include "DBConnection.h"
+#include "Probes.h"
 
 // Constructor: Creates PgSQL connection
 CDBConnection::CDBConnection(const char *szHost, const char *szDBName,
-		const char *szDBPort, bool bVerbose)
-: m_bVerbose(bVerbose)
+		const char *szDBPort, bool bVerbose, const char *szApplicationName)
+: m_iTxnId(0), m_pPlanCapture(NULL), m_bVerbose(bVerbose)
 {
 	size_t len = 0;
 
@@ -41,15 +44,34 @@ CDBConnection::CDBConnection(const char *szHost, const char *szDBName,
 
 	pid_t pid = syscall(SYS_gettid);
 	snprintf(name, sizeof(name), "%d", pid);
+	if (szApplicationName != NULL && len < sizeof(szConnectStr)) {
+		len += snprintf(szConnectStr + len, sizeof(szConnectStr) - len,
+				" application_name=%s", szApplicationName);
+	}
+	m_szTxnComment[0] = '\0';
 	connect();
 }
 
+CDBConnection::CDBConnection(bool bVerbose)
+: m_iTxnId(0), m_pPlanCapture(NULL), m_Conn(NULL), m_bVerbose(bVerbose)
+{
+	szConnectStr[0] = '\0';
+	snprintf(name, sizeof(name), "%d", (int) syscall(SYS_gettid));
+	m_szTxnComment[0] = '\0';
+}
+
 // Destructor: Disconnect from server
 CDBConnection::~CDBConnection()
 {
 	PQfinish(m_Conn);
 }
 
+int
+CDBConnection::backendPid()
+{
+	return PQbackendPID(m_Conn);
+}
+
 void
 CDBConnection::begin()
 {
@@ -69,10 +91,18 @@ CDBConnection::connect()
 	}
 }
 
+bool
+CDBConnection::connected()
+{
+	return PQstatus(m_Conn) == CONNECTION_OK;
+}
+
 void
 CDBConnection::commit()
 {
 	PGresult *res = PQexec(m_Conn, "COMMIT;");
+	if (m_pPlanCapture != NULL)
+		m_pPlanCapture->release(this);
 	if (PQresultStatus(res) != PGRES_COMMAND_OK) {
 		// A failed COMMIT has already rolled the transaction back;
 		// report the failure instead of returning as if it succeeded.
@@ -154,13 +184,37 @@ CDBConnection::exec(const char *sql, int nParams, const Oid *paramTypes,
 	// safe to retry; throw CDBRetryableError for them so the BrokerageHouse
 	// worker can rerun the whole transaction.
 
+	const char *szStatement = sql;
+	if (m_szTxnComment[0] != '\0') {
+		m_sql.assign(m_szTxnComment);
+		m_sql.append(sql);
+		sql = m_sql.c_str();
+	}
+
+	struct timespec start = { 0, 0 };
+	if (m_pPlanCapture != NULL)
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+	DBT5_PROBE2(query__start, m_iTxnId, szStatement);
 	PGresult *res = PQexecParams(m_Conn, sql, nParams, paramTypes, paramValues,
 			paramLengths, paramFormats, resultFormat);
 	ExecStatusType status = PQresultStatus(res);
+	DBT5_PROBE2(query__done, m_iTxnId,
+			status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK);
 
 	switch (status) {
 	case PGRES_COMMAND_OK:
 	case PGRES_TUPLES_OK:
+		if (m_pPlanCapture != NULL) {
+			struct timespec end;
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			double dElapsed = (end.tv_sec - start.tv_sec) * 1000.0
+							  + (end.tv_nsec - start.tv_nsec) / 1000000.0;
+			if (dElapsed >= m_pPlanCapture->threshold())
+				m_pPlanCapture->capture(this, m_iTxnId, dElapsed,
+						szStatement, nParams, paramTypes, paramValues,
+						paramLengths, paramFormats);
+		}
 		return res;
 	default:
 		break;
@@ -176,11 +230,17 @@ CDBConnection::exec(const char *sql, int nParams, const Oid *paramTypes,
 		bool bRetryable = sqlstate != NULL
 						  && (strcmp(sqlstate, "40001") == 0
 								  || strcmp(sqlstate, "40P01") == 0);
+		bool bUndefined = sqlstate != NULL
+						  && (strcmp(sqlstate, "42P01") == 0
+								  || strcmp(sqlstate, "42703") == 0);
 		PQclear(res);
 		rollback();
 		if (bRetryable) {
 			throw CDBRetryableError(msg.str());
 		}
+		if (bUndefined) {
+			throw CDBUndefinedError(msg.str());
+		}
 		throw msg.str();
 	}
 
@@ -583,6 +643,8 @@ CDBConnection::rollback()
 {
 	PGresult *res = PQexec(m_Conn, "ROLLBACK;");
 	PQclear(res);
+	if (m_pPlanCapture != NULL)
+		m_pPlanCapture->release(this);
 }
 
 void
@@ -591,6 +653,32 @@ CDBConnection::setBrokerageHouse(CBrokerageHouse *bh)
 	this->bh = bh;
 }
 
+void
+CDBConnection::setNoticeProcessor(PQnoticeProcessor proc, void *arg)
+{
+	PQsetNoticeProcessor(m_Conn, proc, arg);
+}
+
+void
+CDBConnection::setPlanCapture(CPlanCapture *pPlanCapture)
+{
+	m_pPlanCapture = pPlanCapture;
+}
+
+// The id shows in pg_stat_activity.query and in the server log as a
+// comment before each statement of the transaction.
+void
+CDBConnection::setTxnId(INT64 iTxnId)
+{
+	m_iTxnId = iTxnId;
+	if (iTxnId == 0) {
+		m_szTxnComment[0] = '\0';
+		return;
+	}
+	snprintf(m_szTxnComment, sizeof(m_szTxnComment), "/* dbt5 txn %lld */ ",
+			(long long) iTxnId);
+}
+
 void
 CDBConnection::setReadCommitted()
 {
@@ -16,8 +16,9 @@
 #define DATELEN 11
 
 CDBConnectionClientSide::CDBConnectionClientSide(const char *szHost,
-		const char *szDBName, const char *szDBPort, bool bVerbose)
-: CDBConnection(szHost, szDBName, szDBPort, bVerbose)
+		const char *szDBName, const char *szDBPort, bool bVerbose,
+		const char *szApplicationName)
+: CDBConnection(szHost, szDBName, szDBPort, bVerbose, szApplicationName)
 {
 }
 
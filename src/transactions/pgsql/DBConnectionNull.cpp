@@ -0,0 +1,685 @@
+/*
+ * This file is released under the terms of the Artistic License.  Please see
+ * the file LICENSE, included in this package, for details.
+ *
+ * Copyright The DBT-5 Authors
+ */
+
+#include <algorithm>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "DBConnectionNull.h"
+
+// Made up values of the rows the frames return.
+static const double fNullPrice = 25.0;
+static const double fNullCommissionRate = 0.5;
+static const double fNullCharge = 7.5;
+static const double fNullTaxRate = 0.2;
+static const double fNullBalance = 10000.0;
+
+CMutex CDBConnectionNull::s_Lock;
+TTrade CDBConnectionNull::s_iNextTradeId = 0; // the first setting
+map<TTrade, CDBConnectionNull::TNullTrade> CDBConnectionNull::s_Trades;
+vector<string> CDBConnectionNull::s_Symbols;
+
+static void
+copyString(char *dest, const char *src, size_t len)
+{
+	strncpy(dest, src, len);
+	dest[len] = '\0';
+}
+
+static bool
+typeIsMarket(const char *type_id)
+{
+	return strcmp(type_id, "TMB") == 0 || strcmp(type_id, "TMS") == 0;
+}
+
+static bool
+typeIsSell(const char *type_id)
+{
+	return strcmp(type_id, "TMS") == 0 || strcmp(type_id, "TLS") == 0
+		   || strcmp(type_id, "TSL") == 0;
+}
+
+static const char *
+typeName(const char *type_id)
+{
+	if (strcmp(type_id, "TMB") == 0)
+		return "Market-Buy";
+	if (strcmp(type_id, "TMS") == 0)
+		return "Market-Sell";
+	if (strcmp(type_id, "TLB") == 0)
+		return "Limit-Buy";
+	if (strcmp(type_id, "TLS") == 0)
+		return "Limit-Sell";
+	return "Stop-Loss";
+}
+
+TNullDBSettings::TNullDBSettings()
+: iLatency(0), iCustomerId(iNullCustomerId), iBrokerId(iNullBrokerId),
+  iFirstTradeId(iNullFirstTradeId), iMaxTrades(iNullMaxTrades),
+  iMaxSymbols(iNullMaxSymbols)
+{
+}
+
+bool
+TNullDBSettings::set(const char *setting)
+{
+	const char *value = strchr(setting, '=');
+	if (value == NULL)
+		return false;
+	string name(setting, value - setting);
+	++value;
+
+	char *end;
+	errno = 0;
+	long long n = strtoll(value, &end, 10);
+	if (*value == '\0' || *end != '\0' || errno != 0)
+		return false;
+
+	if (name == "latency" && n >= 0 && n <= INT_MAX)
+		iLatency = (int) n;
+	else if (name == "customer" && n > 0)
+		iCustomerId = (TIdent) n;
+	else if (name == "broker" && n > 0)
+		iBrokerId = (TIdent) n;
+	else if (name == "first-trade" && n > 0)
+		iFirstTradeId = (TTrade) n;
+	else if (name == "trades" && n > 0)
+		iMaxTrades = (size_t) n;
+	else if (name == "symbols" && n > 0)
+		iMaxSymbols = (size_t) n;
+	else
+		return false;
+	return true;
+}
+
+CDBConnectionNull::CDBConnectionNull(
+		const TNullDBSettings &settings, bool bVerbose)
+: CDBConnection(bVerbose), m_Settings(settings), m_iNewTradeId(0)
+{
+	Locker<CMutex> locker(s_Lock);
+	if (s_iNextTradeId == 0)
+		s_iNextTradeId = m_Settings.iFirstTradeId;
+}
+
+CDBConnectionNull::~CDBConnectionNull() {}
+
+void
+CDBConnectionNull::begin()
+{
+	m_iNewTradeId = 0;
+}
+
+void
+CDBConnectionNull::commit()
+{
+	m_iNewTradeId = 0;
+}
+
+// Only the Trade-Order that created a trade rolls it back, nothing else is
+// kept.
+void
+CDBConnectionNull::rollback()
+{
+	if (m_iNewTradeId == 0)
+		return;
+
+	Locker<CMutex> locker(s_Lock);
+	s_Trades.erase(m_iNewTradeId);
+	m_iNewTradeId = 0;
+}
+
+string
+CDBConnectionNull::escape(string s)
+{
+	return "'" + s + "'";
+}
+
+int
+CDBConnectionNull::backendPid()
+{
+	return 0;
+}
+
+void
+CDBConnectionNull::setReadCommitted()
+{
+}
+
+void
+CDBConnectionNull::setReadUncommitted()
+{
+}
+
+void
+CDBConnectionNull::setRepeatableRead()
+{
+}
+
+void
+CDBConnectionNull::setSerializable()
+{
+}
+
+void
+CDBConnectionNull::delay()
+{
+	if (m_Settings.iLatency > 0)
+		usleep(m_Settings.iLatency);
+}
+
+void
+CDBConnectionNull::learnSymbol(const char *symbol)
+{
+	if (symbol[0] == '\0')
+		return;
+
+	Locker<CMutex> locker(s_Lock);
+	if (s_Symbols.size() < m_Settings.iMaxSymbols
+			&& find(s_Symbols.begin(), s_Symbols.end(), string(symbol))
+					   == s_Symbols.end())
+		s_Symbols.push_back(symbol);
+}
+
+// The same company name gets the same symbol as long as no more symbols are
+// learned.
+bool
+CDBConnectionNull::findSymbol(const char *co_name, char *symbol)
+{
+	unsigned long hash = 5381;
+	for (const char *p = co_name; *p != '\0'; p++)
+		hash = hash * 33 + (unsigned char) *p;
+
+	Locker<CMutex> locker(s_Lock);
+	if (s_Symbols.empty())
+		return false;
+	copyString(symbol, s_Symbols[hash % s_Symbols.size()].c_str(),
+			cSYMBOL_len);
+	return true;
+}
+
+void
+CDBConnectionNull::execute(
+		const TBrokerVolumeFrame1Input *pIn, TBrokerVolumeFrame1Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	for (int i = 0;
+			i < max_broker_list_len && pIn->broker_list[i][0] != '\0'; i++) {
+		copyString(pOut->broker_name[i], pIn->broker_list[i], cB_NAME_len);
+		pOut->volume[i] = fNullPrice * 1000 * (i + 1);
+		++pOut->list_len;
+	}
+}
+
+void
+CDBConnectionNull::execute(const TCustomerPositionFrame1Input *pIn,
+		TCustomerPositionFrame1Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->cust_id = pIn->cust_id != 0 ? pIn->cust_id : m_Settings.iCustomerId;
+	copyString(pOut->c_st_id, "ACTV", cST_ID_len);
+	copyString(pOut->c_l_name, "Null", cL_NAME_len);
+	copyString(pOut->c_f_name, "Customer", cF_NAME_len);
+	pOut->c_tier = '1' + (char) (pOut->cust_id % 3);
+
+	// The input picks one of the accounts by its position.
+	pOut->acct_len = max_acct_len;
+	for (int i = 0; i < pOut->acct_len; i++) {
+		pOut->acct_id[i] = pOut->cust_id * max_acct_len + i;
+		pOut->cash_bal[i] = fNullBalance;
+		pOut->asset_total[i] = fNullBalance;
+	}
+}
+
+void
+CDBConnectionNull::execute(const TCustomerPositionFrame2Input *pIn,
+		TCustomerPositionFrame2Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	// The last 10 trades with 3 history rows each.
+	pOut->hist_len = max_hist_len;
+	for (int i = 0; i < pOut->hist_len; i++) {
+		pOut->trade_id[i] = m_Settings.iFirstTradeId + i / 3;
+		copyString(pOut->symbol[i], "NULL", cSYMBOL_len);
+		pOut->qty[i] = 100;
+		copyString(pOut->trade_status[i], "Completed", cST_NAME_len);
+	}
+}
+
+void
+CDBConnectionNull::execute(const TDataMaintenanceFrame1Input *pIn)
+{
+	delay();
+}
+
+// No limit orders are pending, so none are triggered.
+void
+CDBConnectionNull::execute(const TMarketFeedFrame1Input *pIn,
+		TMarketFeedFrame1Output *pOut,
+		CSendToMarketInterface *pMarketExchange)
+{
+	delay();
+
+	for (int i = 0; i < max_feed_len; i++)
+		learnSymbol(pIn->Entries[i].symbol);
+	pOut->num_updated = max_feed_len;
+	pOut->send_len = 0;
+}
+
+void
+CDBConnectionNull::execute(
+		const TMarketWatchFrame1Input *pIn, TMarketWatchFrame1Output *pOut)
+{
+	delay();
+	pOut->pct_change = 0.0;
+}
+
+void
+CDBConnectionNull::execute(const TSecurityDetailFrame1Input *pIn,
+		TSecurityDetailFrame1Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+	learnSymbol(pIn->symbol);
+
+	copyString(pOut->s_name, pIn->symbol, cS_NAME_len);
+	copyString(pOut->co_name, "Null Company", cCO_NAME_len);
+	copyString(pOut->ex_name, "NYSE", cEX_NAME_len);
+	pOut->last_price = fNullPrice;
+	pOut->last_open = fNullPrice;
+	pOut->last_vol = 1000;
+
+	for (int i = 0; i < max_comp_len; i++) {
+		copyString(pOut->cp_co_name[i], "Null Competitor", cCO_NAME_len);
+		copyString(pOut->cp_in_name[i], "Null Industry", cIN_NAME_len);
+	}
+
+	pOut->fin_len = max_fin_len;
+	for (int i = 0; i < pOut->fin_len; i++) {
+		pOut->fin[i].year = 2000 + i / 4;
+		pOut->fin[i].qtr = i % 4 + 1;
+		pOut->fin[i].rev = fNullBalance;
+	}
+
+	pOut->day_len = pIn->max_rows_to_return;
+	for (int i = 0; i < pOut->day_len; i++) {
+		pOut->day[i].close = fNullPrice;
+		pOut->day[i].high = fNullPrice;
+		pOut->day[i].low = fNullPrice;
+		pOut->day[i].vol = 1000;
+	}
+
+	pOut->news_len = max_news_len;
+	for (int i = 0; i < pOut->news_len; i++) {
+		copyString(pOut->news[i].headline, "Null News", cNI_HEADLINE_len);
+		copyString(pOut->news[i].src, "Null", cNI_SOURCE_len);
+	}
+}
+
+void
+CDBConnectionNull::execute(const TTradeCleanupFrame1Input *pIn)
+{
+	delay();
+
+	Locker<CMutex> locker(s_Lock);
+	s_Trades.clear();
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeLookupFrame1Input *pIn, TTradeLookupFrame1Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->num_found = pIn->max_trades;
+	for (int i = 0; i < pOut->num_found; i++) {
+		pOut->trade_info[i].bid_price = fNullPrice;
+		copyString(pOut->trade_info[i].exec_name, "Null", cEXEC_NAME_len);
+		pOut->trade_info[i].is_cash = true;
+		pOut->trade_info[i].trade_price = fNullPrice;
+		pOut->trade_info[i].settlement_amount = fNullPrice * 100;
+		copyString(pOut->trade_info[i].settlement_cash_type, "Cash Account",
+				cSE_CASH_TYPE_len);
+		pOut->trade_info[i].cash_transaction_amount = fNullPrice * 100;
+		copyString(pOut->trade_info[i].trade_history_status_id[0], "CMPT",
+				cTH_ST_ID_len);
+	}
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeLookupFrame2Input *pIn, TTradeLookupFrame2Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->num_found = pIn->max_trades;
+	for (int i = 0; i < pOut->num_found; i++) {
+		pOut->trade_info[i].trade_id = m_Settings.iFirstTradeId + i;
+		pOut->trade_info[i].bid_price = fNullPrice;
+		copyString(pOut->trade_info[i].exec_name, "Null", cEXEC_NAME_len);
+		pOut->trade_info[i].is_cash = true;
+		pOut->trade_info[i].trade_price = fNullPrice;
+		pOut->trade_info[i].settlement_amount = fNullPrice * 100;
+		copyString(pOut->trade_info[i].trade_history_status_id[0], "CMPT",
+				cTH_ST_ID_len);
+	}
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeLookupFrame3Input *pIn, TTradeLookupFrame3Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->num_found = pIn->max_trades;
+	for (int i = 0; i < pOut->num_found; i++) {
+		pOut->trade_info[i].trade_id = m_Settings.iFirstTradeId + i;
+		pOut->trade_info[i].acct_id = m_Settings.iCustomerId * max_acct_len;
+		copyString(pOut->trade_info[i].exec_name, "Null", cEXEC_NAME_len);
+		pOut->trade_info[i].is_cash = true;
+		pOut->trade_info[i].price = fNullPrice;
+		pOut->trade_info[i].quantity = 100;
+		copyString(pOut->trade_info[i].trade_type, "TMB", cTT_ID_len);
+		pOut->trade_info[i].settlement_amount = fNullPrice * 100;
+		copyString(pOut->trade_info[i].trade_history_status_id[0], "CMPT",
+				cTH_ST_ID_len);
+	}
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeLookupFrame4Input *pIn, TTradeLookupFrame4Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->num_trades_found = 1;
+	pOut->trade_id = m_Settings.iFirstTradeId;
+	pOut->num_found = 1;
+	pOut->trade_info[0].holding_history_id = m_Settings.iFirstTradeId;
+	pOut->trade_info[0].holding_history_trade_id = m_Settings.iFirstTradeId;
+	pOut->trade_info[0].quantity_before = 0;
+	pOut->trade_info[0].quantity_after = 100;
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeOrderFrame1Input *pIn, TTradeOrderFrame1Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->num_found = 1;
+	copyString(pOut->acct_name, "Null Account", cCA_NAME_len);
+	pOut->broker_id = m_Settings.iBrokerId;
+	pOut->cust_id = pIn->acct_id / max_acct_len;
+	pOut->tax_status = (INT32) (pIn->acct_id % 3);
+	pOut->cust_tier = (INT32) (pOut->cust_id % 3) + 1;
+	copyString(pOut->cust_f_name, "Null", cF_NAME_len);
+	copyString(pOut->cust_l_name, "Customer", cL_NAME_len);
+	copyString(pOut->tax_id, "000000000", cTAX_ID_len);
+	copyString(pOut->broker_name, "Null Broker", cB_NAME_len);
+}
+
+// Everyone may trade on every account.
+void
+CDBConnectionNull::execute(
+		const TTradeOrderFrame2Input *pIn, TTradeOrderFrame2Output *pOut)
+{
+	delay();
+	copyString(pOut->ap_acl, "0000", cACL_len);
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeOrderFrame3Input *pIn, TTradeOrderFrame3Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	if (pIn->symbol[0] != '\0') {
+		copyString(pOut->symbol, pIn->symbol, cSYMBOL_len);
+		learnSymbol(pIn->symbol);
+	} else if (!findSymbol(pIn->co_name, pOut->symbol)) {
+		ostringstream msg;
+		msg << "no security symbol seen yet for " << pIn->co_name;
+		throw msg.str();
+	}
+	copyString(pOut->s_name, pOut->symbol, cS_NAME_len);
+	copyString(pOut->co_name, pIn->co_name, cCO_NAME_len);
+
+	pOut->type_is_market = typeIsMarket(pIn->trade_type_id) ? 1 : 0;
+	pOut->type_is_sell = typeIsSell(pIn->trade_type_id) ? 1 : 0;
+	pOut->market_price
+			= pIn->requested_price > 0 ? pIn->requested_price : fNullPrice;
+	if (pOut->type_is_market == 1)
+		pOut->requested_price = pOut->market_price;
+	else
+		pOut->requested_price = pIn->requested_price;
+
+	// Sells are of holdings bought for less, buys close no short positions.
+	if (pOut->type_is_sell == 1) {
+		pOut->sell_value = pIn->trade_qty * pOut->requested_price;
+		pOut->buy_value = pOut->sell_value * 0.9;
+		if (pIn->tax_status == 1 || pIn->tax_status == 2)
+			pOut->tax_amount
+					= (pOut->sell_value - pOut->buy_value) * fNullTaxRate;
+	}
+
+	pOut->comm_rate = fNullCommissionRate;
+	pOut->charge_amount = fNullCharge;
+	pOut->acct_assets = fNullBalance;
+	if (pOut->type_is_market == 1)
+		copyString(pOut->status_id, pIn->st_submitted_id, cST_ID_len);
+	else
+		copyString(pOut->status_id, pIn->st_pending_id, cST_ID_len);
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeOrderFrame4Input *pIn, TTradeOrderFrame4Output *pOut)
+{
+	delay();
+
+	TNullTrade trade;
+	trade.acct_id = pIn->acct_id;
+	copyString(trade.symbol, pIn->symbol, cSYMBOL_len);
+	copyString(trade.type_id, pIn->trade_type_id, cTT_ID_len);
+	trade.trade_qty = pIn->trade_qty;
+	trade.charge = pIn->charge_amount;
+	trade.is_cash = pIn->is_cash;
+	trade.is_lifo = pIn->is_lifo;
+
+	Locker<CMutex> locker(s_Lock);
+	pOut->trade_id = s_iNextTradeId++;
+	s_Trades[pOut->trade_id] = trade;
+	// Trade ids only grow, so the first is the oldest.
+	if (s_Trades.size() > m_Settings.iMaxTrades)
+		s_Trades.erase(s_Trades.begin());
+	m_iNewTradeId = pOut->trade_id;
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeResultFrame1Input *pIn, TTradeResultFrame1Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	TNullTrade trade;
+	{
+		Locker<CMutex> locker(s_Lock);
+		map<TTrade, TNullTrade>::iterator it = s_Trades.find(pIn->trade_id);
+		if (it == s_Trades.end())
+			return;
+		trade = it->second;
+		s_Trades.erase(it);
+	}
+
+	pOut->num_found = 1;
+	pOut->acct_id = trade.acct_id;
+	copyString(pOut->type_id, trade.type_id, cTT_ID_len);
+	copyString(pOut->symbol, trade.symbol, cSYMBOL_len);
+	pOut->trade_qty = trade.trade_qty;
+	pOut->charge = trade.charge;
+	pOut->is_lifo = trade.is_lifo ? 1 : 0;
+	pOut->trade_is_cash = trade.is_cash ? 1 : 0;
+	copyString(pOut->type_name, typeName(trade.type_id), cTT_NAME_len);
+	pOut->type_is_sell = typeIsSell(trade.type_id) ? 1 : 0;
+	pOut->type_is_market = typeIsMarket(trade.type_id) ? 1 : 0;
+	// Sells are of holdings, buys close no short positions.
+	pOut->hs_qty = pOut->type_is_sell == 1 ? trade.trade_qty : 0;
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeResultFrame2Input *pIn, TTradeResultFrame2Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->broker_id = m_Settings.iBrokerId;
+	pOut->cust_id = pIn->acct_id / max_acct_len;
+	pOut->tax_status = (INT32) (pIn->acct_id % 3);
+	if (pIn->type_is_sell == 1) {
+		pOut->sell_value = pIn->trade_qty * pIn->trade_price;
+		pOut->buy_value = pOut->sell_value * 0.9;
+	}
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeResultFrame3Input *pIn, TTradeResultFrame3Output *pOut)
+{
+	delay();
+	pOut->tax_amount = floor(
+			(pIn->sell_value - pIn->buy_value) * fNullTaxRate * 100.0 + 0.5)
+					   / 100.0;
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeResultFrame4Input *pIn, TTradeResultFrame4Output *pOut)
+{
+	delay();
+	copyString(pOut->s_name, pIn->symbol, cS_NAME_len);
+	pOut->comm_rate = fNullCommissionRate;
+}
+
+void
+CDBConnectionNull::execute(const TTradeResultFrame5Input *pIn)
+{
+	delay();
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeResultFrame6Input *pIn, TTradeResultFrame6Output *pOut)
+{
+	delay();
+	pOut->acct_bal = fNullBalance;
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeStatusFrame1Input *pIn, TTradeStatusFrame1Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	copyString(pOut->cust_l_name, "Customer", cL_NAME_len);
+	copyString(pOut->cust_f_name, "Null", cF_NAME_len);
+	copyString(pOut->broker_name, "Null Broker", cB_NAME_len);
+	pOut->num_found = max_trade_status_len;
+	for (int i = 0; i < pOut->num_found; i++) {
+		pOut->trade_id[i] = m_Settings.iFirstTradeId + i;
+		copyString(pOut->status_name[i], "Completed", cST_NAME_len);
+		copyString(pOut->type_name[i], "Market-Buy", cTT_NAME_len);
+		copyString(pOut->symbol[i], "NULL", cSYMBOL_len);
+		pOut->trade_qty[i] = 100;
+		copyString(pOut->exec_name[i], "Null", cEXEC_NAME_len);
+		pOut->charge[i] = fNullCharge;
+		copyString(pOut->s_name[i], "Null Security", cS_NAME_len);
+		copyString(pOut->ex_name[i], "NYSE", cEX_NAME_len);
+	}
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeUpdateFrame1Input *pIn, TTradeUpdateFrame1Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->num_found = pIn->max_trades;
+	pOut->num_updated = pIn->max_updates;
+	for (int i = 0; i < pOut->num_found; i++) {
+		pOut->trade_info[i].bid_price = fNullPrice;
+		copyString(pOut->trade_info[i].exec_name, "Null", cEXEC_NAME_len);
+		pOut->trade_info[i].is_cash = true;
+		pOut->trade_info[i].trade_price = fNullPrice;
+		pOut->trade_info[i].settlement_amount = fNullPrice * 100;
+		copyString(pOut->trade_info[i].trade_history_status_id[0], "CMPT",
+				cTH_ST_ID_len);
+	}
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeUpdateFrame2Input *pIn, TTradeUpdateFrame2Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->num_found = pIn->max_trades;
+	pOut->num_updated = pOut->num_found;
+	for (int i = 0; i < pOut->num_found; i++) {
+		pOut->trade_info[i].trade_id = m_Settings.iFirstTradeId + i;
+		pOut->trade_info[i].bid_price = fNullPrice;
+		copyString(pOut->trade_info[i].exec_name, "Null", cEXEC_NAME_len);
+		pOut->trade_info[i].is_cash = true;
+		pOut->trade_info[i].trade_price = fNullPrice;
+		pOut->trade_info[i].settlement_amount = fNullPrice * 100;
+		copyString(pOut->trade_info[i].trade_history_status_id[0], "CMPT",
+				cTH_ST_ID_len);
+	}
+}
+
+void
+CDBConnectionNull::execute(
+		const TTradeUpdateFrame3Input *pIn, TTradeUpdateFrame3Output *pOut)
+{
+	delay();
+	memset(pOut, 0, sizeof(*pOut));
+
+	pOut->num_found = pIn->max_trades;
+	pOut->num_updated = pOut->num_found;
+	for (int i = 0; i < pOut->num_found; i++) {
+		pOut->trade_info[i].trade_id = m_Settings.iFirstTradeId + i;
+		pOut->trade_info[i].acct_id = m_Settings.iCustomerId * max_acct_len;
+		copyString(pOut->trade_info[i].exec_name, "Null", cEXEC_NAME_len);
+		pOut->trade_info[i].is_cash = true;
+		pOut->trade_info[i].price = fNullPrice;
+		pOut->trade_info[i].quantity = 100;
+		copyString(pOut->trade_info[i].s_name, "Null Security", cS_NAME_len);
+		copyString(pOut->trade_info[i].trade_type, "TMB", cTT_ID_len);
+		copyString(pOut->trade_info[i].type_name, "Market-Buy", cTT_NAME_len);
+		pOut->trade_info[i].settlement_amount = fNullPrice * 100;
+		copyString(pOut->trade_info[i].trade_history_status_id[0], "CMPT",
+				cTH_ST_ID_len);
+	}
+}
@@ -105,13 +105,12 @@ Datum
 BrokerVolumeFrame1(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i;
 
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -135,16 +134,8 @@ BrokerVolumeFrame1(PG_FUNCTION_ARGS)
 		Datum args[2];
 		char nulls[2] = { ' ', ' ' };
 
-		char *tmp;
-
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 3);
-		values[i_list_len]
-				= (char *) palloc((SMALLINT_LEN + 1) * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 #ifdef DEBUG
 		dump_bvf1_inputs(broker_list_p, sector_name_p);
@@ -173,117 +164,16 @@ BrokerVolumeFrame1(PG_FUNCTION_ARGS)
 		}
 		tupdesc = SPI_tuptable->tupdesc;
 		tuptable = SPI_tuptable;
-		tuple = tuptable->vals[0];
-
-		snprintf(values[i_list_len], SMALLINT_LEN + 1, "%" PRId64,
-				SPI_processed);
-
-		if (SPI_processed == 0) {
-			values[i_broker_name] = (char *) palloc(3 * sizeof(char));
-			values[i_volume] = (char *) palloc(3 * sizeof(char));
-
-			strncpy(values[i_broker_name], "{}", 3);
-			strncpy(values[i_volume], "{}", 3);
-		} else {
-			int length_bn, length_v;
-
-			length_bn = (B_NAME_LEN + 2) * (SPI_processed + 1) + 3;
-			values[i_broker_name]
-					= (char *) palloc(length_bn-- * sizeof(char));
-
-			length_v = FIN_AGG_T_LEN * (SPI_processed + 1) + 3;
-			values[i_volume] = (char *) palloc(length_v-- * sizeof(char));
-
-			values[i_broker_name][0] = '{';
-			values[i_broker_name][1] = '\0';
-
-			values[i_volume][0] = '{';
-			values[i_volume][1] = '\0';
-
-			if (SPI_processed > 0) {
-				strncat(values[i_broker_name], "\"", length_bn--);
-				if (length_bn < 0) {
-					FAIL_FRAME("broker_name values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_broker_name], tmp, length_bn);
-				length_bn -= strlen(tmp);
-				if (length_bn < 0) {
-					FAIL_FRAME("broker_name values needs to be increased");
-				}
-
-				strncat(values[i_broker_name], "\"", length_bn--);
-				if (length_bn < 0) {
-					FAIL_FRAME("broker_name values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_volume], tmp, length_v);
-				length_v -= strlen(tmp);
-				if (length_v < 0) {
-					FAIL_FRAME("volume values needs to be increased");
-				}
-			}
-			for (i = 1; i < SPI_processed; i++) {
-				tuple = tuptable->vals[i];
-
-				strncat(values[i_broker_name], ",\"", length_bn);
-				length_bn -= 2;
-				if (length_bn < 0) {
-					FAIL_FRAME("broker_name values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_broker_name], tmp, length_bn);
-				length_bn -= strlen(tmp);
-				if (length_bn < 0) {
-					FAIL_FRAME("broker_name values needs to be increased");
-				}
-
-				strncat(values[i_broker_name], "\"", length_bn--);
-				if (length_bn < 0) {
-					FAIL_FRAME("broker_name values needs to be increased");
-				}
-
-				strncat(values[i_volume], ",", length_v--);
-				if (length_v < 0) {
-					FAIL_FRAME("volume values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_volume], tmp, length_v);
-				length_v -= strlen(tmp);
-				if (length_v < 0) {
-					FAIL_FRAME("volume values needs to be increased");
-				}
-			}
-			strncat(values[i_broker_name], "}", length_bn--);
-			if (length_bn < 0) {
-				FAIL_FRAME("broker_name values needs to be increased");
-			}
-
-			strncat(values[i_volume], "}", length_v--);
-			if (length_v < 0) {
-				FAIL_FRAME("volume values needs to be increased");
-			}
-		}
 
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
+		set_frame_value(
+				&values, i_list_len, Int32GetDatum((int32) SPI_processed), false);
 
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
+		for (i = 0; i < SPI_processed; i++) {
+			tuple = tuptable->vals[i];
+
+			push_frame_spi(&values, i_broker_name, tuple, tupdesc, 1);
+			push_frame_spi(&values, i_volume, tuple, tupdesc, 2);
+		}
 
 		MemoryContextSwitchTo(oldcontext);
 	}
@@ -293,22 +183,19 @@ BrokerVolumeFrame1(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 3; i++) {
-			elog(DEBUG1, "BVF1 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("BVF1", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
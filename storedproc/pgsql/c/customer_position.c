@@ -154,7 +154,7 @@ CustomerPositionFrame1(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
 	int i;
-	char **values = NULL;
+	frame_result values;
 
 	int64 cust_id;
 
@@ -202,14 +202,8 @@ CustomerPositionFrame1(PG_FUNCTION_ARGS)
 		SPITupleTable *tuptable = NULL;
 		HeapTuple tuple;
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 27);
-		values[i_cust_id] = (char *) palloc((IDENT_T_LEN + 1) * sizeof(char));
-		values[i_acct_len] = (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 		/* Create a function context for cross-call persistence. */
 		funcctx = SRF_FIRSTCALL_INIT();
@@ -232,10 +226,13 @@ CustomerPositionFrame1(PG_FUNCTION_ARGS)
 			args[0] = PointerGetDatum(tax_id_p);
 			ret = SPI_execute_plan(CPF1_1, args, nulls, true, 0);
 			if (ret == SPI_OK_SELECT && SPI_processed > 0) {
+				bool isnull;
+
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				cust_id = atoll(SPI_getvalue(tuple, tupdesc, 1));
+				cust_id = DatumGetInt64(
+						SPI_getbinval(tuple, tupdesc, 1, &isnull));
 #ifdef DEBUG
 				elog(DEBUG1, "Got cust_id ok: %ld", cust_id);
 #endif /* DEBUG */
@@ -260,28 +257,28 @@ CustomerPositionFrame1(PG_FUNCTION_ARGS)
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
 
-			values[i_c_st_id] = SPI_getvalue(tuple, tupdesc, 1);
-			values[i_c_l_name] = SPI_getvalue(tuple, tupdesc, 2);
-			values[i_c_f_name] = SPI_getvalue(tuple, tupdesc, 3);
-			values[i_c_m_name] = SPI_getvalue(tuple, tupdesc, 4);
-			values[i_c_gndr] = SPI_getvalue(tuple, tupdesc, 5);
-			values[i_c_tier] = SPI_getvalue(tuple, tupdesc, 6);
-			values[i_c_dob] = SPI_getvalue(tuple, tupdesc, 7);
-			values[i_c_ad_id] = SPI_getvalue(tuple, tupdesc, 8);
-			values[i_c_ctry_1] = SPI_getvalue(tuple, tupdesc, 9);
-			values[i_c_area_1] = SPI_getvalue(tuple, tupdesc, 10);
-			values[i_c_local_1] = SPI_getvalue(tuple, tupdesc, 11);
-			values[i_c_ext_1] = SPI_getvalue(tuple, tupdesc, 12);
-			values[i_c_ctry_2] = SPI_getvalue(tuple, tupdesc, 13);
-			values[i_c_area_2] = SPI_getvalue(tuple, tupdesc, 14);
-			values[i_c_local_2] = SPI_getvalue(tuple, tupdesc, 15);
-			values[i_c_ext_2] = SPI_getvalue(tuple, tupdesc, 16);
-			values[i_c_ctry_3] = SPI_getvalue(tuple, tupdesc, 17);
-			values[i_c_area_3] = SPI_getvalue(tuple, tupdesc, 18);
-			values[i_c_local_3] = SPI_getvalue(tuple, tupdesc, 19);
-			values[i_c_ext_3] = SPI_getvalue(tuple, tupdesc, 20);
-			values[i_c_email_1] = SPI_getvalue(tuple, tupdesc, 21);
-			values[i_c_email_2] = SPI_getvalue(tuple, tupdesc, 22);
+			set_frame_spi(&values, i_c_st_id, tuple, tupdesc, 1);
+			set_frame_spi(&values, i_c_l_name, tuple, tupdesc, 2);
+			set_frame_spi(&values, i_c_f_name, tuple, tupdesc, 3);
+			set_frame_spi(&values, i_c_m_name, tuple, tupdesc, 4);
+			set_frame_spi(&values, i_c_gndr, tuple, tupdesc, 5);
+			set_frame_spi(&values, i_c_tier, tuple, tupdesc, 6);
+			set_frame_spi(&values, i_c_dob, tuple, tupdesc, 7);
+			set_frame_spi(&values, i_c_ad_id, tuple, tupdesc, 8);
+			set_frame_spi(&values, i_c_ctry_1, tuple, tupdesc, 9);
+			set_frame_spi(&values, i_c_area_1, tuple, tupdesc, 10);
+			set_frame_spi(&values, i_c_local_1, tuple, tupdesc, 11);
+			set_frame_spi(&values, i_c_ext_1, tuple, tupdesc, 12);
+			set_frame_spi(&values, i_c_ctry_2, tuple, tupdesc, 13);
+			set_frame_spi(&values, i_c_area_2, tuple, tupdesc, 14);
+			set_frame_spi(&values, i_c_local_2, tuple, tupdesc, 15);
+			set_frame_spi(&values, i_c_ext_2, tuple, tupdesc, 16);
+			set_frame_spi(&values, i_c_ctry_3, tuple, tupdesc, 17);
+			set_frame_spi(&values, i_c_area_3, tuple, tupdesc, 18);
+			set_frame_spi(&values, i_c_local_3, tuple, tupdesc, 19);
+			set_frame_spi(&values, i_c_ext_3, tuple, tupdesc, 20);
+			set_frame_spi(&values, i_c_email_1, tuple, tupdesc, 21);
+			set_frame_spi(&values, i_c_email_2, tuple, tupdesc, 22);
 		} else {
 			FAIL_FRAME_SET(&funcctx->max_calls, CPF1_statements[1].sql);
 			MemoryContextSwitchTo(oldcontext);
@@ -293,135 +290,29 @@ CustomerPositionFrame1(PG_FUNCTION_ARGS)
 #endif /* DEBUG */
 		args[0] = Int64GetDatum(cust_id);
 		ret = SPI_execute_plan(CPF1_3, args, nulls, true, 0);
-		snprintf(values[i_acct_len], INTEGER_LEN + 1, "%" PRId64,
-				SPI_processed);
+		set_frame_value(
+				&values, i_acct_len, Int32GetDatum((int32) SPI_processed), false);
 #ifdef DEBUG
 		elog(DEBUG1, "%ld row(s) returned from CPF1_3.", SPI_processed);
 #endif /* DEBUG */
 		if (ret == SPI_OK_SELECT && SPI_processed > 0) {
-			char *tmp;
-			int length_ai, length_at, length_cb;
-
 			/* Total number of tuples to be returned. */
 			funcctx->max_calls = 1;
 
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
-			tuple = tuptable->vals[0];
 
-			length_ai = (BIGINT_LEN + 1) * (SPI_processed + 1) + 2;
-			values[i_acct_id] = (char *) palloc(length_ai-- * sizeof(char));
-
-			length_cb = (BALANCE_T_LEN + 1) * (SPI_processed + 1) + 2;
-			values[i_cash_bal] = (char *) palloc(length_cb-- * sizeof(char));
-
-			length_at = (FIN_AGG_T_LEN + 1) * (SPI_processed + 1) + 2;
-			values[i_asset_total]
-					= (char *) palloc(length_at-- * sizeof(char));
-
-			values[i_acct_id][0] = '{';
-			values[i_acct_id][1] = '\0';
-
-			values[i_cash_bal][0] = '{';
-			values[i_cash_bal][1] = '\0';
-
-			values[i_asset_total][0] = '{';
-			values[i_asset_total][1] = '\0';
-
-			if (SPI_processed > 0) {
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_acct_id], tmp, length_ai);
-				length_ai -= strlen(tmp);
-				if (length_ai < 0) {
-					FAIL_FRAME("acct_id values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_cash_bal], tmp, length_cb);
-				length_cb -= strlen(tmp);
-				if (length_cb < 0) {
-					FAIL_FRAME("cash_bal values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 3);
-				strncat(values[i_asset_total], tmp, length_at);
-				length_at -= strlen(tmp);
-				if (length_at < 0) {
-					FAIL_FRAME("asset_total values needs to be increased");
-				}
-			}
-			for (i = 1; i < SPI_processed; i++) {
+			for (i = 0; i < SPI_processed; i++) {
 				tuple = tuptable->vals[i];
 
-				strncat(values[i_acct_id], ",", length_ai--);
-				if (length_ai < 0) {
-					FAIL_FRAME("acct_id values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_acct_id], tmp, length_ai);
-				length_ai -= strlen(tmp);
-				if (length_ai < 0) {
-					FAIL_FRAME("account_id values needs to be increased");
-				}
-
-				strncat(values[i_cash_bal], ",", length_cb--);
-				if (length_cb < 0) {
-					FAIL_FRAME("cash_bal values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_cash_bal], tmp, length_cb);
-				length_cb -= strlen(tmp);
-				if (length_cb < 0) {
-					FAIL_FRAME("cash_bal values needs to be increased");
-				}
-
-				strncat(values[i_asset_total], ",", length_at--);
-				if (length_at < 0) {
-					FAIL_FRAME("asset_total values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 3);
-				strncat(values[i_asset_total], tmp, length_at);
-				length_at -= strlen(tmp);
-				if (length_at < 0) {
-					FAIL_FRAME("asset_total values needs to be increased");
-				}
-			}
-			strncat(values[i_acct_id], "}", length_ai--);
-			if (length_ai < 0) {
-				FAIL_FRAME("account_id values needs to be increased");
-			}
-
-			strncat(values[i_cash_bal], "}", length_cb--);
-			if (length_cb < 0) {
-				FAIL_FRAME("cash_bal values needs to be increased");
-			}
-
-			strncat(values[i_asset_total], "}", length_at--);
-			if (length_at < 0) {
-				FAIL_FRAME("asset_total values needs to be increased");
+				push_frame_spi(&values, i_acct_id, tuple, tupdesc, 1);
+				push_frame_spi(&values, i_cash_bal, tuple, tupdesc, 2);
+				push_frame_spi(&values, i_asset_total, tuple, tupdesc, 3);
 			}
 		} else {
 			FAIL_FRAME_SET(&funcctx->max_calls, CPF1_statements[2].sql);
 		}
-		snprintf(values[i_cust_id], IDENT_T_LEN + 1, "%" PRId64, cust_id);
-
-		/* Build a tuple descriptor for our result type. */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * Generate attribute metadata needed later to produce tuples from raw
-		 * C strings.
-		 */
-		funcctx->attinmeta = TupleDescGetAttInMetadata(tupdesc);
+		set_frame_value(&values, i_cust_id, Int64GetDatum(cust_id), false);
 
 		/* save SPI data for use across calls */
 		funcctx->user_fctx = tuptable;
@@ -436,15 +327,13 @@ CustomerPositionFrame1(PG_FUNCTION_ARGS)
 		Datum result;
 		HeapTuple tuple;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 27; i++) {
-			elog(DEBUG1, "CPF1 OUT: %d '%s'", i, values[i]);
-		}
+		dump_frame_result("CPF1", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(funcctx->attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -460,7 +349,7 @@ Datum
 CustomerPositionFrame2(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	char **values = NULL;
+	frame_result values;
 	int i;
 
 	if (SRF_IS_FIRSTCALL()) {
@@ -489,13 +378,8 @@ CustomerPositionFrame2(PG_FUNCTION_ARGS)
 		dump_cpf2_inputs(acct_id);
 #endif /* DEBUG */
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 6);
-		values[i_hist_len] = (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 		/* Create a function context for cross-call persistence. */
 		funcctx = SRF_FIRSTCALL_INIT();
@@ -511,208 +395,27 @@ CustomerPositionFrame2(PG_FUNCTION_ARGS)
 #endif /* DEBUG */
 		args[0] = Int64GetDatum(acct_id);
 		ret = SPI_execute_plan(CPF2_1, args, nulls, true, 0);
-		snprintf(values[i_hist_len], INTEGER_LEN + 1, "%" PRId64,
-				SPI_processed);
+		set_frame_value(
+				&values, i_hist_len, Int32GetDatum((int32) SPI_processed), false);
 #ifdef DEBUG
 		elog(DEBUG1, "%ld row(s) returned.", SPI_processed);
 #endif /* DEBUG */
 		/* Should return 10 to 30 rows. */
 		if (ret == SPI_OK_SELECT && SPI_processed > 0) {
-			char *tmp;
-			int length_hd, length_q, length_s, length_ti, length_ts;
-
 			/* Total number of tuples to be returned. */
 			funcctx->max_calls = 1;
 
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
-			tuple = tuptable->vals[0];
-
-			length_hd = (MAXDATELEN + 1) * SPI_processed + 3;
-			values[i_hist_dts] = (char *) palloc(length_hd-- * sizeof(char));
-
-			length_q = (INTEGER_LEN + 1) * SPI_processed + 3;
-			values[i_qty] = (char *) palloc(length_q-- * sizeof(char));
-
-			length_s = (S_SYMB_LEN + 3) * SPI_processed + 3;
-			values[i_symbol] = (char *) palloc(length_s-- * sizeof(char));
-
-			length_ti = (IDENT_T_LEN + 1) * SPI_processed + 3;
-			values[i_trade_id] = (char *) palloc(length_ti-- * sizeof(char));
-
-			length_ts = (ST_NAME_LEN + 3) * SPI_processed + 3;
-			values[i_trade_status]
-					= (char *) palloc(length_ts-- * sizeof(char));
-
-			values[i_hist_dts][0] = '{';
-			values[i_hist_dts][1] = '\0';
-
-			values[i_qty][0] = '{';
-			values[i_qty][1] = '\0';
 
-			values[i_symbol][0] = '{';
-			values[i_symbol][1] = '\0';
-
-			values[i_trade_id][0] = '{';
-			values[i_trade_id][1] = '\0';
-
-			values[i_trade_status][0] = '{';
-			values[i_trade_status][1] = '\0';
-
-			tmp = SPI_getvalue(tuple, tupdesc, 5);
-			strncat(values[i_hist_dts], tmp, length_hd);
-			length_hd -= strlen(tmp);
-			if (length_hd < 0) {
-				FAIL_FRAME("hist_dts values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 3);
-			strncat(values[i_qty], tmp, length_q);
-			length_q -= strlen(tmp);
-			if (length_q < 0) {
-				FAIL_FRAME("qty values needs to be increased");
-			}
-
-			strncat(values[i_symbol], "\"", length_s--);
-			if (length_s < 0) {
-				FAIL_FRAME("symbol values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_symbol], tmp, length_s);
-			length_s -= strlen(tmp);
-			if (length_s < 0) {
-				FAIL_FRAME("symbol values needs to be increased");
-			}
-
-			strncat(values[i_symbol], "\"", length_s--);
-			if (length_s < 0) {
-				FAIL_FRAME("symbol values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_trade_id], tmp, length_ti);
-			length_ti -= strlen(tmp);
-			if (length_ti < 0) {
-				FAIL_FRAME("trade_id values needs to be increased");
-			}
-
-			strncat(values[i_trade_status], "\"", length_ts--);
-			if (length_ts < 0) {
-				FAIL_FRAME("trade_status values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 4);
-			strncat(values[i_trade_status], tmp, length_ts);
-			length_ts -= strlen(tmp);
-			if (length_ts < 0) {
-				FAIL_FRAME("trade_status values needs to be increased");
-			}
-
-			strncat(values[i_trade_status], "\"", length_ts--);
-			if (length_ts < 0) {
-				FAIL_FRAME("trade_status values needs to be increased");
-			}
-
-			for (i = 1; i < SPI_processed; i++) {
+			for (i = 0; i < SPI_processed; i++) {
 				tuple = tuptable->vals[i];
 
-				strncat(values[i_hist_dts], ",", length_hd--);
-				if (length_hd < 0) {
-					FAIL_FRAME("hist_dts values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 5);
-				strncat(values[i_hist_dts], tmp, length_hd);
-				length_hd -= strlen(tmp);
-				if (length_hd < 0) {
-					FAIL_FRAME("hist_dts values needs to be increased");
-				}
-
-				strncat(values[i_qty], ",", length_q--);
-				if (length_q < 0) {
-					FAIL_FRAME("qty values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 3);
-				strncat(values[i_qty], tmp, length_q);
-				length_q -= strlen(tmp);
-				if (length_q < 0) {
-					FAIL_FRAME("qty values needs to be increased");
-				}
-
-				strncat(values[i_symbol], ",\"", length_s);
-				length_s -= 2;
-				if (length_s < 0) {
-					FAIL_FRAME("symbol values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_symbol], tmp, length_s);
-				length_s -= strlen(tmp);
-				if (length_s < 0) {
-					FAIL_FRAME("symbol values needs to be increased");
-				}
-
-				strncat(values[i_symbol], "\"", length_s--);
-				if (length_s < 0) {
-					FAIL_FRAME("symbol values needs to be increased");
-				}
-
-				strncat(values[i_trade_id], ",", length_ti--);
-				if (length_ti < 0) {
-					FAIL_FRAME("trade_id values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_trade_id], tmp, length_ti);
-				length_ti -= strlen(tmp);
-				if (length_ti < 0) {
-					FAIL_FRAME("trade_id values needs to be increased");
-				}
-
-				strncat(values[i_trade_status], ",\"", length_ts);
-				length_ts -= 2;
-				if (length_ts < 0) {
-					FAIL_FRAME("trade_status values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 4);
-				strncat(values[i_trade_status], tmp, length_ts);
-				length_ts -= strlen(tmp);
-				if (length_ts < 0) {
-					FAIL_FRAME("trade_status values needs to be increased");
-				}
-
-				strncat(values[i_trade_status], "\"", length_ts--);
-				if (length_ts < 0) {
-					FAIL_FRAME("trade_status values needs to be increased");
-				}
-			}
-
-			strncat(values[i_hist_dts], "}", length_hd--);
-			if (length_hd < 0) {
-				FAIL_FRAME("hist_dts values needs to be increased");
-			}
-
-			strncat(values[i_qty], "}", length_q--);
-			if (length_q < 0) {
-				FAIL_FRAME("qty values needs to be increased");
-			}
-
-			strncat(values[i_symbol], "}", length_s--);
-			if (length_s < 0) {
-				FAIL_FRAME("symbol values needs to be increased");
-			}
-
-			strncat(values[i_trade_id], "}", length_ti--);
-			if (length_ti < 0) {
-				FAIL_FRAME("trade_id values needs to be increased");
-			}
-
-			strncat(values[i_trade_status], "}", length_ts--);
-			if (length_ts < 0) {
-				FAIL_FRAME("trade_status values needs to be increased");
+				push_frame_spi(&values, i_hist_dts, tuple, tupdesc, 5);
+				push_frame_spi(&values, i_qty, tuple, tupdesc, 3);
+				push_frame_spi(&values, i_symbol, tuple, tupdesc, 2);
+				push_frame_spi(&values, i_trade_id, tuple, tupdesc, 1);
+				push_frame_spi(&values, i_trade_status, tuple, tupdesc, 4);
 			}
 		} else {
 			if (ret == SPI_OK_SELECT && SPI_processed == 0) {
@@ -722,40 +425,8 @@ CustomerPositionFrame2(PG_FUNCTION_ARGS)
 			dump_cpf2_inputs(acct_id);
 #endif /* DEBUG */
 			FAIL_FRAME_SET(&funcctx->max_calls, CPF2_statements[0].sql);
-
-			/*
-			 * FIXME: Probably don't need to do this if we're not going to
-			 * return any rows, but if we do then we don't need to figure
-			 * out what pieces of memory we need to free later in the function.
-			 */
-			values[i_hist_dts] = (char *) palloc(3 * sizeof(char));
-			values[i_qty] = (char *) palloc(3 * sizeof(char));
-			values[i_symbol] = (char *) palloc(3 * sizeof(char));
-			values[i_trade_id] = (char *) palloc(3 * sizeof(char));
-			values[i_trade_status] = (char *) palloc(3 * sizeof(char));
-
-			strncpy(values[i_hist_dts], "{}", 3);
-			strncpy(values[i_qty], "{}", 3);
-			strncpy(values[i_symbol], "{}", 3);
-			strncpy(values[i_trade_id], "{}", 3);
-			strncpy(values[i_trade_status], "{}", 3);
 		}
 
-		/* Build a tuple descriptor for our result type. */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * Generate attribute metadata needed later to produce tuples from raw
-		 * C strings.
-		 */
-		funcctx->attinmeta = TupleDescGetAttInMetadata(tupdesc);
-
 		/* save SPI data for use across calls */
 		funcctx->user_fctx = tuptable;
 
@@ -769,15 +440,13 @@ CustomerPositionFrame2(PG_FUNCTION_ARGS)
 		Datum result;
 		HeapTuple tuple;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 6; i++) {
-			elog(DEBUG1, "CPF2 OUT: %d '%s'", i, values[i]);
-		}
+		dump_frame_result("CPF2", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(funcctx->attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -10,6 +10,14 @@
 #ifndef _DBT5COMMON_H_
 #define _DBT5COMMON_H_
 
+#include <funcapi.h>
+#include <catalog/pg_type.h>
+#include <parser/parse_coerce.h>
+#include <utils/array.h>
+#include <utils/builtins.h>
+#include <utils/lsyscache.h>
+#include <utils/typcache.h>
+
 #if PG_VERSION_NUM >= 90200
 #define EncodeDateTimeM(tm, fsec, tzn, dts)                                   \
 	EncodeDateTime(tm, fsec, false, 0, tzn, USE_ISO_DATES, dts);
@@ -23,6 +31,11 @@
 #define CStringGetTextDatum(s) DirectFunctionCall1(textin, PointerGetDatum(s))
 #endif
 
+/*  PostgreSQL < 10 didn't have this handy macro */
+#ifndef TupleDescAttr
+#define TupleDescAttr(tupdesc, i) ((tupdesc)->attrs[(i)])
+#endif
+
 /*
  * cached_statement encapsulates all we need to know about a query to prepare
  * it using SPI_prepare()
@@ -59,4 +72,303 @@ plan_queries(cached_statement *statements)
 		}
 	}
 }
+
+/*
+ * frame_result holds the output of a frame as Datums, so that no value needs
+ * to be formatted as a C string and then parsed again by the type's input
+ * function to build the returned tuple.  Array columns collect their elements
+ * one at a time and are turned into arrays when the tuple is built.
+ */
+typedef struct frame_result frame_result;
+
+typedef struct
+{
+	Oid type; /* column type, or element type for array columns */
+	bool isarray;
+	Oid srctype; /* last source type seen for this column */
+	CoercionPathType pathtype; /* how to convert from srctype */
+	Oid funcid; /* cast function for COERCION_PATH_FUNC */
+	Oid typoutput; /* srctype output function for COERCION_PATH_COERCEVIAIO */
+	Oid typinput; /* base type input function for COERCION_PATH_COERCEVIAIO */
+	Oid typioparam;
+	bool isdomain; /* type is a domain, whose constraints are checked */
+	void *domainextra; /* domain_check() cache */
+	ArrayBuildState *astate;
+	frame_result *record; /* fields of a composite element type */
+} frame_column;
+
+struct frame_result
+{
+	TupleDesc tupdesc;
+	Datum *values;
+	bool *nulls;
+	frame_column *columns;
+	MemoryContext mcxt;
+};
+
+/* Sets up the columns of 'result' for the row type described by 'tupdesc'. */
+static inline void
+init_frame_columns(frame_result *result, TupleDesc tupdesc)
+{
+	int i;
+
+	result->tupdesc = tupdesc;
+	result->values = (Datum *) palloc(sizeof(Datum) * tupdesc->natts);
+	result->nulls = (bool *) palloc(sizeof(bool) * tupdesc->natts);
+	result->columns
+			= (frame_column *) palloc(sizeof(frame_column) * tupdesc->natts);
+	result->mcxt = CurrentMemoryContext;
+
+	for (i = 0; i < tupdesc->natts; i++) {
+		frame_column *column = &result->columns[i];
+		Oid type = TupleDescAttr(tupdesc, i)->atttypid;
+		Oid elemtype = get_element_type(getBaseType(type));
+
+		column->isarray = OidIsValid(elemtype);
+		column->type = column->isarray ? elemtype : type;
+		column->srctype = InvalidOid;
+		column->isdomain = get_typtype(column->type) == TYPTYPE_DOMAIN;
+		column->domainextra = NULL;
+		column->astate = NULL;
+		column->record = NULL;
+
+		result->values[i] = (Datum) 0;
+		result->nulls[i] = true;
+	}
+}
+
+/*
+ * Prepares 'result' for the function's composite result type.  Every column
+ * starts out NULL and every array column starts out empty.  Anything built
+ * later is allocated in the current memory context.
+ */
+static inline void
+init_frame_result(FunctionCallInfo fcinfo, frame_result *result)
+{
+	TupleDesc tupdesc;
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE) {
+		ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+							   errmsg("function returning record called in "
+									  "context that cannot accept type "
+									  "record")));
+	}
+
+	init_frame_columns(result, BlessTupleDesc(tupdesc));
+}
+
+/*
+ * Converts 'value' of type 'srctype' to the type of column 'attnum', as an
+ * explicit cast would.  This is a no-op when the query already returns the
+ * column's type or one binary coercible to it, which is the common case.
+ * Otherwise use the cast function, or I/O conversion where the cast is
+ * defined that way.  A domain column converts to its base type, then has its
+ * constraints checked, NULLs included.  The conversion is looked up once per
+ * column.
+ */
+static inline Datum
+coerce_frame_value(frame_result *result, int attnum, Datum value,
+		bool isnull, Oid srctype)
+{
+	frame_column *column = &result->columns[attnum];
+	bool typisvarlena;
+
+	if (isnull) {
+		if (column->isdomain) {
+			domain_check(value, true, column->type, &column->domainextra,
+					result->mcxt);
+		}
+		return value;
+	}
+
+	if (column->srctype != srctype) {
+		if (srctype == column->type) {
+			column->pathtype = COERCION_PATH_RELABELTYPE;
+		} else {
+			column->pathtype = find_coercion_pathway(column->type, srctype,
+					COERCION_EXPLICIT, &column->funcid);
+		}
+		if (column->pathtype == COERCION_PATH_COERCEVIAIO) {
+			getTypeOutputInfo(srctype, &column->typoutput, &typisvarlena);
+			getTypeInputInfo(getBaseType(column->type), &column->typinput,
+					&column->typioparam);
+		}
+		column->srctype = srctype;
+	}
+
+	switch (column->pathtype) {
+	case COERCION_PATH_RELABELTYPE:
+		break;
+	case COERCION_PATH_FUNC:
+		value = OidFunctionCall1(column->funcid, value);
+		break;
+	case COERCION_PATH_COERCEVIAIO:
+		value = OidInputFunctionCall(column->typinput,
+				OidOutputFunctionCall(column->typoutput, value),
+				column->typioparam, -1);
+		break;
+	default:
+		ereport(ERROR,
+				(errcode(ERRCODE_CANNOT_COERCE),
+						errmsg("cannot cast type %s to %s for column %d",
+								format_type_be(srctype),
+								format_type_be(column->type), attnum + 1)));
+	}
+
+	/* A value already of the domain type has been checked. */
+	if (column->isdomain && srctype != column->type) {
+		domain_check(value, false, column->type, &column->domainextra,
+				result->mcxt);
+	}
+	return value;
+}
+
+/* Sets column 'attnum', where 'value' is already of the column's type. */
+static inline void
+set_frame_value(frame_result *result, int attnum, Datum value, bool isnull)
+{
+	result->values[attnum] = value;
+	result->nulls[attnum] = isnull;
+}
+
+/* Appends an element, already of the element type, to array column 'attnum'. */
+static inline void
+push_frame_value(frame_result *result, int attnum, Datum value, bool isnull)
+{
+	frame_column *column = &result->columns[attnum];
+
+	column->astate = accumArrayResult(
+			column->astate, value, isnull, column->type, result->mcxt);
+}
+
+/* Sets column 'attnum' from attribute 'fnumber' of an SPI result tuple. */
+static inline void
+set_frame_spi(frame_result *result, int attnum, HeapTuple tuple,
+		TupleDesc tupdesc, int fnumber)
+{
+	bool isnull;
+	Datum value = SPI_getbinval(tuple, tupdesc, fnumber, &isnull);
+
+	value = coerce_frame_value(result, attnum, value, isnull,
+			SPI_gettypeid(tupdesc, fnumber));
+	set_frame_value(result, attnum, value, isnull);
+}
+
+/*
+ * Appends attribute 'fnumber' of an SPI result tuple to array column
+ * 'attnum'.
+ */
+static inline void
+push_frame_spi(frame_result *result, int attnum, HeapTuple tuple,
+		TupleDesc tupdesc, int fnumber)
+{
+	bool isnull;
+	Datum value = SPI_getbinval(tuple, tupdesc, fnumber, &isnull);
+
+	value = coerce_frame_value(result, attnum, value, isnull,
+			SPI_gettypeid(tupdesc, fnumber));
+	push_frame_value(result, attnum, value, isnull);
+}
+
+/*
+ * Appends a composite element to array column 'attnum', built from the
+ * leading attributes of an SPI result tuple in the order of the element
+ * type's fields.
+ */
+static inline void
+push_frame_record(
+		frame_result *result, int attnum, HeapTuple tuple, TupleDesc tupdesc)
+{
+	frame_column *column = &result->columns[attnum];
+	frame_result *record = column->record;
+	HeapTuple rectuple;
+	int i;
+
+	if (record == NULL) {
+		MemoryContext oldcontext = MemoryContextSwitchTo(result->mcxt);
+
+		record = (frame_result *) palloc(sizeof(frame_result));
+		init_frame_columns(
+				record, lookup_rowtype_tupdesc_copy(column->type, -1));
+		column->record = record;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	for (i = 0; i < record->tupdesc->natts; i++) {
+		set_frame_spi(record, i, tuple, tupdesc, i + 1);
+	}
+
+	rectuple = heap_form_tuple(record->tupdesc, record->values, record->nulls);
+	push_frame_value(result, attnum, HeapTupleGetDatum(rectuple), false);
+}
+
+/*
+ * Turns the collected array elements into arrays and forms the tuple to
+ * return.
+ */
+static inline HeapTuple
+build_frame_tuple(frame_result *result)
+{
+	MemoryContext oldcontext = MemoryContextSwitchTo(result->mcxt);
+	HeapTuple tuple;
+	int i;
+
+	for (i = 0; i < result->tupdesc->natts; i++) {
+		frame_column *column = &result->columns[i];
+
+		if (!column->isarray) {
+			continue;
+		}
+
+		if (column->astate == NULL) {
+			result->values[i]
+					= PointerGetDatum(construct_empty_array(column->type));
+		} else {
+			result->values[i] = makeArrayResult(column->astate, result->mcxt);
+			column->astate = NULL;
+		}
+		result->nulls[i] = false;
+	}
+
+	tuple = heap_form_tuple(result->tupdesc, result->values, result->nulls);
+	MemoryContextSwitchTo(oldcontext);
+
+	return tuple;
+}
+
+/*
+ * Converts an amount computed in the frame to a numeric rounded to 'scale'
+ * digits, as it used to be when formatted with "%.2f".
+ */
+static inline Datum
+float8_numeric_round(double value, int scale)
+{
+	return DirectFunctionCall2(numeric_round,
+			DirectFunctionCall1(float8_numeric, Float8GetDatum(value)),
+			Int32GetDatum(scale));
+}
+
+#ifdef DEBUG
+/* Logs the columns of a frame's result after build_frame_tuple(). */
+static inline void
+dump_frame_result(const char *frame, frame_result *result)
+{
+	int i;
+
+	for (i = 0; i < result->tupdesc->natts; i++) {
+		Oid typoutput;
+		bool typisvarlena;
+
+		if (result->nulls[i]) {
+			elog(DEBUG1, "%s OUT: %d NULL", frame, i);
+			continue;
+		}
+
+		getTypeOutputInfo(TupleDescAttr(result->tupdesc, i)->atttypid,
+				&typoutput, &typisvarlena);
+		elog(DEBUG1, "%s OUT: %d %s", frame, i,
+				OidOutputFunctionCall(typoutput, result->values[i]));
+	}
+}
+#endif /* DEBUG */
 #endif /* _DBT5COMMON_H_ */
@@ -213,13 +213,12 @@ Datum
 SecurityDetailFrame1(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i;
 
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -228,8 +227,10 @@ SecurityDetailFrame1(PG_FUNCTION_ARGS)
 		bool access_lob_flag = (PG_GETARG_INT16(0) != 0);
 		int max_rows_to_return = PG_GETARG_INT32(1);
 		DateADT start_date_p = PG_GETARG_DATEADT(2);
-		char *symbol_p = (char *) PG_GETARG_TEXT_P(3);
+		text *symbol_p = PG_GETARG_TEXT_P(3);
+#ifdef DEBUG
 		char symbol[S_SYMB_LEN + 1];
+#endif /* DEBUG */
 
 		enum sdf1
 		{
@@ -280,65 +281,29 @@ SecurityDetailFrame1(PG_FUNCTION_ARGS)
 			i_yield
 		};
 
-		char *tmp;
 		int ret;
 		TupleDesc tupdesc;
 		SPITupleTable *tuptable = NULL;
 		HeapTuple tuple = NULL;
-		char *co_id = NULL;
+		Datum co_id;
+		bool isnull;
 		Datum args[3];
 		char nulls[3] = { ' ', ' ', ' ' };
 
-		int length_cn, length_d, length_f, length_in, length_n;
-
+#ifdef DEBUG
 		strncpy(symbol,
 				DatumGetCString(DirectFunctionCall1(
 						textout, PointerGetDatum(symbol_p))),
 				S_SYMB_LEN);
 		symbol[S_SYMB_LEN] = '\0';
-#ifdef DEBUG
 		dump_sdf1_inputs(access_lob_flag, max_rows_to_return,
 				DatumGetCString(DirectFunctionCall1(
 						date_out, DateADTGetDatum(start_date_p))),
 				symbol);
 #endif
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		length_cn = MAX_COMP_LEN * (CO_NAME_LEN + 3) + 3;
-		length_in = MAX_COMP_LEN * (IN_NAME_LEN + 3) + 3;
-
-		values = (char **) palloc(sizeof(char *) * 45);
-		values[i_cp_co_name] = (char *) palloc(sizeof(char) * length_cn--);
-		values[i_cp_in_name] = (char *) palloc(sizeof(char) * length_in--);
-
-		length_d = (MAXDATELEN + DM_CLOSE_LEN + DM_HIGH_LEN + DM_LOW_LEN
-						   + DM_VOL_LEN + 9)
-						   * max_rows_to_return
-				   + 3;
-		values[i_day] = (char *) palloc(sizeof(char) * length_d--);
-
-		values[i_day_len] = (char *) palloc(sizeof(char) * (INTEGER_LEN + 1));
-
-		length_f
-				= (FI_YEAR_LEN + FI_QTR_LEN + MAXDATELEN + FI_REVENUE_LEN
-						  + FI_NET_EARN_LEN + FI_BASIC_EPS_LEN + FI_MARGIN_LEN
-						  + FI_INVENTORY_LEN + FI_ASSETS_LEN + FI_LIABILITY_LEN
-						  + FI_OUT_BASIC_LEN + FI_OUT_DILUT_LEN + 16)
-						  * MAX_FIN_LEN
-				  + 3;
-		values[i_fin] = (char *) palloc(length_f-- * sizeof(char));
-		values[i_fin_len] = (char *) palloc(sizeof(char) * (INTEGER_LEN + 1));
-
-		length_n = (NI_ITEM_LEN + MAXDATELEN + NI_SOURCE_LEN + NI_AUTHOR_LEN
-						   + NI_SUMMARY_LEN + NI_HEADLINE_LEN + 35)
-						   * MAX_NEWS_LEN
-				   + 3;
-		values[i_news] = (char *) palloc(sizeof(char) * length_n--);
-		values[i_news_len] = (char *) palloc(sizeof(char) * (INTEGER_LEN + 1));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 		/* create a function context for cross-call persistence */
 		funcctx = SRF_FIRSTCALL_INIT();
@@ -352,7 +317,7 @@ SecurityDetailFrame1(PG_FUNCTION_ARGS)
 #ifdef DEBUG
 		elog(DEBUG1, "%s", SQLSDF1_1);
 #endif /* DEBUG */
-		args[0] = CStringGetTextDatum(symbol);
+		args[0] = PointerGetDatum(symbol_p);
 		ret = SPI_execute_plan(SDF1_1, args, nulls, true, 0);
 		if (ret != SPI_OK_SELECT || SPI_processed == 0) {
 			FAIL_FRAME_SET(&funcctx->max_calls, SDF1_statements[0].sql);
@@ -364,46 +329,46 @@ SecurityDetailFrame1(PG_FUNCTION_ARGS)
 		tuptable = SPI_tuptable;
 		tuple = tuptable->vals[0];
 
-		values[i_s_name] = SPI_getvalue(tuple, tupdesc, 1);
-		co_id = SPI_getvalue(tuple, tupdesc, 2);
-		values[i_co_name] = SPI_getvalue(tuple, tupdesc, 3);
-		values[i_sp_rate] = SPI_getvalue(tuple, tupdesc, 4);
-		values[i_ceo_name] = SPI_getvalue(tuple, tupdesc, 5);
-		values[i_co_desc] = SPI_getvalue(tuple, tupdesc, 6);
-		values[i_open_date] = SPI_getvalue(tuple, tupdesc, 7);
-		values[i_co_st_id] = SPI_getvalue(tuple, tupdesc, 8);
-		values[i_co_ad_line1] = SPI_getvalue(tuple, tupdesc, 9);
-		values[i_co_ad_line2] = SPI_getvalue(tuple, tupdesc, 10);
-		values[i_co_ad_town] = SPI_getvalue(tuple, tupdesc, 11);
-		values[i_co_ad_div] = SPI_getvalue(tuple, tupdesc, 12);
-		values[i_co_ad_zip] = SPI_getvalue(tuple, tupdesc, 13);
-		values[i_co_ad_ctry] = SPI_getvalue(tuple, tupdesc, 14);
-		values[i_num_out] = SPI_getvalue(tuple, tupdesc, 15);
-		values[i_start_date] = SPI_getvalue(tuple, tupdesc, 16);
-		values[i_ex_date] = SPI_getvalue(tuple, tupdesc, 17);
-		values[i_pe_ratio] = SPI_getvalue(tuple, tupdesc, 18);
-		values[i_x52_wk_high] = SPI_getvalue(tuple, tupdesc, 19);
-		values[i_x52_wk_high_date] = SPI_getvalue(tuple, tupdesc, 20);
-		values[i_x52_wk_low] = SPI_getvalue(tuple, tupdesc, 21);
-		values[i_x52_wk_low_date] = SPI_getvalue(tuple, tupdesc, 22);
-		values[i_divid] = SPI_getvalue(tuple, tupdesc, 23);
-		values[i_yield] = SPI_getvalue(tuple, tupdesc, 24);
-		values[i_ex_ad_div] = SPI_getvalue(tuple, tupdesc, 25);
-		values[i_ex_ad_ctry] = SPI_getvalue(tuple, tupdesc, 26);
-		values[i_ex_ad_line1] = SPI_getvalue(tuple, tupdesc, 27);
-		values[i_ex_ad_line2] = SPI_getvalue(tuple, tupdesc, 28);
-		values[i_ex_ad_town] = SPI_getvalue(tuple, tupdesc, 29);
-		values[i_ex_ad_zip] = SPI_getvalue(tuple, tupdesc, 30);
-		values[i_ex_close] = SPI_getvalue(tuple, tupdesc, 31);
-		values[i_ex_desc] = SPI_getvalue(tuple, tupdesc, 32);
-		values[i_ex_name] = SPI_getvalue(tuple, tupdesc, 33);
-		values[i_ex_num_symb] = SPI_getvalue(tuple, tupdesc, 34);
-		values[i_ex_open] = SPI_getvalue(tuple, tupdesc, 35);
+		set_frame_spi(&values, i_s_name, tuple, tupdesc, 1);
+		co_id = SPI_getbinval(tuple, tupdesc, 2, &isnull);
+		set_frame_spi(&values, i_co_name, tuple, tupdesc, 3);
+		set_frame_spi(&values, i_sp_rate, tuple, tupdesc, 4);
+		set_frame_spi(&values, i_ceo_name, tuple, tupdesc, 5);
+		set_frame_spi(&values, i_co_desc, tuple, tupdesc, 6);
+		set_frame_spi(&values, i_open_date, tuple, tupdesc, 7);
+		set_frame_spi(&values, i_co_st_id, tuple, tupdesc, 8);
+		set_frame_spi(&values, i_co_ad_line1, tuple, tupdesc, 9);
+		set_frame_spi(&values, i_co_ad_line2, tuple, tupdesc, 10);
+		set_frame_spi(&values, i_co_ad_town, tuple, tupdesc, 11);
+		set_frame_spi(&values, i_co_ad_div, tuple, tupdesc, 12);
+		set_frame_spi(&values, i_co_ad_zip, tuple, tupdesc, 13);
+		set_frame_spi(&values, i_co_ad_ctry, tuple, tupdesc, 14);
+		set_frame_spi(&values, i_num_out, tuple, tupdesc, 15);
+		set_frame_spi(&values, i_start_date, tuple, tupdesc, 16);
+		set_frame_spi(&values, i_ex_date, tuple, tupdesc, 17);
+		set_frame_spi(&values, i_pe_ratio, tuple, tupdesc, 18);
+		set_frame_spi(&values, i_x52_wk_high, tuple, tupdesc, 19);
+		set_frame_spi(&values, i_x52_wk_high_date, tuple, tupdesc, 20);
+		set_frame_spi(&values, i_x52_wk_low, tuple, tupdesc, 21);
+		set_frame_spi(&values, i_x52_wk_low_date, tuple, tupdesc, 22);
+		set_frame_spi(&values, i_divid, tuple, tupdesc, 23);
+		set_frame_spi(&values, i_yield, tuple, tupdesc, 24);
+		set_frame_spi(&values, i_ex_ad_div, tuple, tupdesc, 25);
+		set_frame_spi(&values, i_ex_ad_ctry, tuple, tupdesc, 26);
+		set_frame_spi(&values, i_ex_ad_line1, tuple, tupdesc, 27);
+		set_frame_spi(&values, i_ex_ad_line2, tuple, tupdesc, 28);
+		set_frame_spi(&values, i_ex_ad_town, tuple, tupdesc, 29);
+		set_frame_spi(&values, i_ex_ad_zip, tuple, tupdesc, 30);
+		set_frame_spi(&values, i_ex_close, tuple, tupdesc, 31);
+		set_frame_spi(&values, i_ex_desc, tuple, tupdesc, 32);
+		set_frame_spi(&values, i_ex_name, tuple, tupdesc, 33);
+		set_frame_spi(&values, i_ex_num_symb, tuple, tupdesc, 34);
+		set_frame_spi(&values, i_ex_open, tuple, tupdesc, 35);
 
 #ifdef DEBUG
 		elog(DEBUG1, "%s", SQLSDF1_2);
 #endif /* DEBUG */
-		args[0] = Int64GetDatum(atoll(co_id));
+		args[0] = co_id;
 		args[1] = Int16GetDatum(MAX_COMP_LEN);
 		ret = SPI_execute_plan(SDF1_2, args, nulls, true, 0);
 		if (ret != SPI_OK_SELECT) {
@@ -415,109 +380,17 @@ SecurityDetailFrame1(PG_FUNCTION_ARGS)
 		tupdesc = SPI_tuptable->tupdesc;
 		tuptable = SPI_tuptable;
 
-		values[i_cp_co_name][0] = '{';
-		values[i_cp_co_name][1] = '\0';
-		if (length_cn < 0) {
-			FAIL_FRAME("cp_co_name values needs to be increased");
-		}
-
-		values[i_cp_in_name][0] = '{';
-		values[i_cp_in_name][1] = '\0';
-		if (length_in < 0) {
-			FAIL_FRAME("cp_in_name values needs to be increased");
-		}
-
-		if (SPI_processed > 0) {
-			tuple = tuptable->vals[0];
-
-			strncat(values[i_cp_co_name], "\"", length_cn--);
-			if (length_cn < 0) {
-				FAIL_FRAME("cp_co_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_cp_co_name], tmp, length_cn);
-			length_cn -= strlen(tmp);
-			if (length_cn < 0) {
-				FAIL_FRAME("cp_co_name values needs to be increased");
-			}
-
-			strncat(values[i_cp_co_name], "\"", length_cn--);
-			if (length_cn < 0) {
-				FAIL_FRAME("cp_co_name values needs to be increased");
-			}
-
-			strncat(values[i_cp_in_name], "\"", length_in--);
-			if (length_in < 0) {
-				FAIL_FRAME("cp_in_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_cp_in_name], tmp, length_in);
-			length_in -= strlen(tmp);
-			if (length_in < 0) {
-				FAIL_FRAME("cp_in_name values needs to be increased");
-			}
-
-			strncat(values[i_cp_in_name], "\"", length_in--);
-			if (length_in < 0) {
-				FAIL_FRAME("cp_in_name values needs to be increased");
-			}
-		}
-		for (i = 1; i < SPI_processed; i++) {
+		for (i = 0; i < SPI_processed; i++) {
 			tuple = tuptable->vals[i];
 
-			strncat(values[i_cp_co_name], ",\"", length_cn);
-			length_cn -= 2;
-			if (length_cn < 0) {
-				FAIL_FRAME("cp_co_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_cp_co_name], tmp, length_cn);
-			length_cn -= strlen(tmp);
-			if (length_cn < 0) {
-				FAIL_FRAME("cp_co_name values needs to be increased");
-			}
-
-			strncat(values[i_cp_co_name], "\"", length_cn--);
-			if (length_cn < 0) {
-				FAIL_FRAME("cp_co_name values needs to be increased");
-			}
-
-			strncat(values[i_cp_in_name], ",\"", length_in);
-			length_in -= 2;
-			if (length_in < 0) {
-				FAIL_FRAME("cp_in_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_cp_in_name], tmp, length_in);
-			length_in -= strlen(tmp);
-			if (length_in < 0) {
-				FAIL_FRAME("cp_in_name values needs to be increased");
-			}
-
-			strncat(values[i_cp_in_name], "\"", length_in--);
-			if (length_in < 0) {
-				FAIL_FRAME("cp_in_name values needs to be increased");
-			}
-		}
-
-		strncat(values[i_cp_co_name], "}", length_cn--);
-		if (length_cn < 0) {
-			FAIL_FRAME("cp_co_name values needs to be increased");
-		}
-
-		strncat(values[i_cp_in_name], "}", length_in--);
-		if (length_in < 0) {
-			FAIL_FRAME("cp_in_name values needs to be increased");
+			push_frame_spi(&values, i_cp_co_name, tuple, tupdesc, 1);
+			push_frame_spi(&values, i_cp_in_name, tuple, tupdesc, 2);
 		}
 
 #ifdef DEBUG
 		elog(DEBUG1, "%s", SQLSDF1_3);
 #endif /* DEBUG */
-		args[0] = Int64GetDatum(atoll(co_id));
+		args[0] = co_id;
 		args[1] = Int16GetDatum(MAX_FIN_LEN);
 		ret = SPI_execute_plan(SDF1_3, args, nulls, true, 0);
 		if (ret != SPI_OK_SELECT) {
@@ -528,189 +401,17 @@ SecurityDetailFrame1(PG_FUNCTION_ARGS)
 		}
 		tupdesc = SPI_tuptable->tupdesc;
 		tuptable = SPI_tuptable;
-		snprintf(values[i_fin_len], INTEGER_LEN + 1, "%" PRId64,
-				SPI_processed);
-		values[i_fin][0] = '{';
-		values[i_fin][1] = '\0';
+
+		set_frame_value(&values, i_fin_len,
+				Int32GetDatum((int32) SPI_processed), false);
 		for (i = 0; i < SPI_processed; i++) {
-			tuple = tuptable->vals[i];
-			if (i > 0) {
-				strncat(values[i_fin], ",", length_f--);
-				if (length_f < 0) {
-					FAIL_FRAME("fin values needs to be increased");
-				}
-			}
-			strncat(values[i_fin], "\"(", length_f);
-			length_f -= 2;
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 3);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 4);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 5);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 6);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 7);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 8);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 9);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 10);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 11);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 12);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ",", length_f--);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 13);
-			strncat(values[i_fin], tmp, length_f);
-			length_f -= strlen(tmp);
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-
-			strncat(values[i_fin], ")\"", length_f);
-			length_f -= 2;
-			if (length_f < 0) {
-				FAIL_FRAME("fin values needs to be increased");
-			}
-		}
-		strncat(values[i_fin], "}", length_f--);
-		if (length_f < 0) {
-			FAIL_FRAME("fin values needs to be increased");
+			push_frame_record(&values, i_fin, tuptable->vals[i], tupdesc);
 		}
+
 #ifdef DEBUG
 		elog(DEBUG1, "%s", SQLSDF1_4);
 #endif /* DEBUG */
-		args[0] = CStringGetTextDatum(symbol);
+		args[0] = PointerGetDatum(symbol_p);
 		args[1] = DateADTGetDatum(start_date_p);
 		args[2] = Int16GetDatum(max_rows_to_return);
 		ret = SPI_execute_plan(SDF1_4, args, nulls, true, 0);
@@ -722,111 +423,32 @@ SecurityDetailFrame1(PG_FUNCTION_ARGS)
 		}
 		tupdesc = SPI_tuptable->tupdesc;
 		tuptable = SPI_tuptable;
-		snprintf(values[i_day_len], INTEGER_LEN + 1, "%" PRId64,
-				SPI_processed);
-		values[i_day][0] = '{';
-		values[i_day][1] = '\0';
+
+		set_frame_value(&values, i_day_len,
+				Int32GetDatum((int32) SPI_processed), false);
 		for (i = 0; i < SPI_processed; i++) {
-			tuple = tuptable->vals[i];
-			if (i > 0) {
-				strncat(values[i_day], ",", length_d--);
-				if (length_d < 0) {
-					FAIL_FRAME("day values needs to be increased");
-				}
-			}
-			strncat(values[i_day], "\"(", length_d);
-			length_d -= 2;
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_day], tmp, length_d);
-			length_d -= strlen(tmp);
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			strncat(values[i_day], ",", length_d--);
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_day], tmp, length_d);
-			length_d -= strlen(tmp);
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			strncat(values[i_day], ",", length_d--);
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 3);
-			strncat(values[i_day], tmp, length_d);
-			length_d -= strlen(tmp);
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			strncat(values[i_day], ",", length_d--);
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 4);
-			strncat(values[i_day], tmp, length_d);
-			length_d -= strlen(tmp);
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			strncat(values[i_day], ",", length_d--);
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 5);
-			strncat(values[i_day], tmp, length_d);
-			length_d -= strlen(tmp);
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-
-			strncat(values[i_day], ")\"", length_d);
-			length_d -= 2;
-			if (length_d < 0) {
-				FAIL_FRAME("day values needs to be increased");
-			}
-		}
-		strncat(values[i_day], "}", length_d--);
-		if (length_d < 0) {
-			FAIL_FRAME("day values needs to be increased");
+			push_frame_record(&values, i_day, tuptable->vals[i], tupdesc);
 		}
 
 #ifdef DEBUG
 		elog(DEBUG1, "%s", SQLSDF1_5);
 #endif /* DEBUG */
-		args[0] = CStringGetTextDatum(symbol);
+		args[0] = PointerGetDatum(symbol_p);
 		ret = SPI_execute_plan(SDF1_5, args, nulls, true, 0);
 		if (ret != SPI_OK_SELECT || SPI_processed == 0) {
 			FAIL_FRAME_SET(&funcctx->max_calls, SDF1_statements[4].sql);
-			values[i_last_open] = NULL;
-			values[i_last_price] = NULL;
-			values[i_last_vol] = NULL;
 		} else {
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
-			values[i_last_price] = SPI_getvalue(tuple, tupdesc, 1);
-			values[i_last_open] = SPI_getvalue(tuple, tupdesc, 2);
-			values[i_last_vol] = SPI_getvalue(tuple, tupdesc, 3);
+
+			set_frame_spi(&values, i_last_price, tuple, tupdesc, 1);
+			set_frame_spi(&values, i_last_open, tuple, tupdesc, 2);
+			set_frame_spi(&values, i_last_vol, tuple, tupdesc, 3);
 		}
-		args[0] = Int64GetDatum(atoll(co_id));
-		args[1] = Int16GetDatum(MAX_NEWS_LEN);
 
+		args[0] = co_id;
+		args[1] = Int16GetDatum(MAX_NEWS_LEN);
 		if (access_lob_flag == true) {
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLSDF1_6);
@@ -848,140 +470,17 @@ SecurityDetailFrame1(PG_FUNCTION_ARGS)
 		}
 		tupdesc = SPI_tuptable->tupdesc;
 		tuptable = SPI_tuptable;
-		snprintf(values[i_news_len], INTEGER_LEN + 1, "%" PRId64,
-				SPI_processed);
-		values[i_news][0] = '{';
-		values[i_news][1] = '\0';
-		for (i = 0; i < SPI_processed; i++) {
-			tuple = tuptable->vals[i];
-			if (i > 0) {
-				strncat(values[i_news], ",", length_n--);
-				if (length_n < 0) {
-					FAIL_FRAME("news values needs to be increased");
-				}
-			}
-			strncat(values[i_news], "\"(\\\"", length_n);
-			length_n -= 4;
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			if (access_lob_flag == true && tmp[0] == '\\') {
-				/*
-				 * ni_item is a bytea and its text form starts with a
-				 * backslash (e.g. \x...).  The array and composite
-				 * input parsers each consume one level of doubled
-				 * backslashes, so emit 4 backslashes for the 1 that
-				 * must reach the bytea input function.
-				 */
-				strncat(values[i_news], "\\\\\\\\", length_n);
-				length_n -= 4;
-				if (length_n < 0) {
-					FAIL_FRAME("news values needs to be increased");
-				}
-				++tmp;
-			}
-			strncat(values[i_news], tmp, length_n);
-			length_n -= strlen(tmp);
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			strncat(values[i_news], "\\\",\\\"", length_n);
-			length_n -= 5;
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_news], tmp, length_n);
-			length_n -= strlen(tmp);
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			strncat(values[i_news], "\\\",\\\"", length_n);
-			length_n -= 5;
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 3);
-			strncat(values[i_news], tmp, length_n);
-			length_n -= strlen(tmp);
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			strncat(values[i_news], "\\\",\\\"", length_n);
-			length_n -= 5;
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			/* ni_author is allowed to be NULL. */
-			tmp = SPI_getvalue(tuple, tupdesc, 4);
-			if (tmp != NULL) {
-				strncat(values[i_news], tmp, length_n);
-				length_n -= strlen(tmp);
-				if (length_n < 0) {
-					FAIL_FRAME("news values needs to be increased");
-				}
-			}
-
-			strncat(values[i_news], "\\\",\\\"", length_n);
-			length_n -= 5;
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 5);
-			strncat(values[i_news], tmp, length_n);
-			length_n -= strlen(tmp);
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			strncat(values[i_news], "\\\",\\\"", length_n);
-			length_n -= 5;
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 6);
-			strncat(values[i_news], tmp, length_n);
-			length_n -= strlen(tmp);
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-
-			strncat(values[i_news], "\\\")\"", length_n);
-			length_n -= 4;
-			if (length_n < 0) {
-				FAIL_FRAME("news values needs to be increased");
-			}
-		}
-		strncat(values[i_news], "}", length_n--);
-		if (length_n < 0) {
-			FAIL_FRAME("news values needs to be increased");
-		}
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
 
 		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
+		 * ni_item is passed through as a bytea, so there is no longer any
+		 * need to escape its text form for the array and composite input
+		 * parsers.
 		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
+		set_frame_value(&values, i_news_len,
+				Int32GetDatum((int32) SPI_processed), false);
+		for (i = 0; i < SPI_processed; i++) {
+			push_frame_record(&values, i_news, tuptable->vals[i], tupdesc);
+		}
 
 		MemoryContextSwitchTo(oldcontext);
 	}
@@ -991,23 +490,19 @@ SecurityDetailFrame1(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 45; i++) {
-			elog(DEBUG1, "SDF1 OUT: %d %s", i,
-					values[i] != NULL ? values[i] : "(null)");
-		}
+		dump_frame_result("SDF1", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -308,7 +308,6 @@ Datum
 TradeLookupFrame1(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
@@ -316,7 +315,7 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 
 	long *trade_id;
 
-	char **values = NULL;
+	frame_result values;
 
 	enum tlf1
 	{
@@ -338,11 +337,6 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 
 	int num_found_count = 0;
 
-	/* Helper counters to determine when to add commas. */
-	int num_cash_txn = 0;
-	int num_settlement = 0;
-	int num_history = 0;
-
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
 		MemoryContext oldcontext;
@@ -362,67 +356,8 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 		Datum args[1];
 		char nulls[1] = { ' ' };
 
-		char *tmp;
-		int length_bp, length_cta, length_ctd, length_ctn, length_en,
-				length_ic, length_im, length_sa, length_scdd, length_sct,
-				length_thd, length_thsi, length_tp;
-
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 14);
-
-		length_bp = (S_PRICE_T_LEN + 1) * max_trades + 2;
-		values[i_bid_price] = (char *) palloc(length_bp-- * sizeof(char));
-
-		length_cta = (VALUE_T_LEN + 1) * max_trades + 2;
-		values[i_cash_transaction_amount]
-				= (char *) palloc(length_cta-- * sizeof(char));
-
-		length_ctd = (MYMAXDATELEN + 3) * max_trades + 2;
-		values[i_cash_transaction_dts]
-				= (char *) palloc(length_ctd-- * sizeof(char));
-
-		length_ctn = (CT_NAME_LEN + 3) * max_trades + 2;
-		values[i_cash_transaction_name]
-				= (char *) palloc(length_ctn-- * sizeof(char));
-
-		length_en = (T_EXEC_NAME_LEN + 3) * max_trades + 2;
-		values[i_exec_name] = (char *) palloc(length_en-- * sizeof(char));
-
-		length_ic = (BOOLEAN_LEN + 1) * max_trades + 2;
-		values[i_is_cash] = (char *) palloc(length_ic-- * sizeof(char));
-
-		length_im = (BOOLEAN_LEN + 1) * max_trades + 3;
-		values[i_is_market] = (char *) palloc(length_im-- * sizeof(char));
-
-		values[i_num_found]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-
-		length_sa = (VALUE_T_LEN + 1) * max_trades + 2;
-		values[i_settlement_amount]
-				= (char *) palloc(length_sa-- * sizeof(char));
-
-		length_scdd = (MYMAXDATELEN + 3) * max_trades + 2;
-		values[i_settlement_cash_due_date]
-				= (char *) palloc(length_scdd-- * sizeof(char));
-
-		length_sct = (SE_CASH_TYPE_LEN + 3) * max_trades + 2;
-		values[i_settlement_cash_type]
-				= (char *) palloc(length_sct-- * sizeof(char));
-
-		length_thd = ((MYMAXDATELEN + 1) * max_trades + 3) * 3 + 2;
-		values[i_trade_history_dts]
-				= (char *) palloc(length_thd-- * sizeof(char));
-
-		length_thsi = ((ST_ID_LEN + 3) * max_trades + 3) * 3 + 2;
-		values[i_trade_history_status_id]
-				= (char *) palloc(length_thsi-- * sizeof(char));
-
-		length_tp = (S_PRICE_T_LEN + 1) * max_trades + 2;
-		values[i_trade_price] = (char *) palloc(length_tp-- * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 		get_typlenbyvalalign(
 				ARR_ELEMTYPE(trade_id_p), &typlen, &typbyval, &typalign);
@@ -448,47 +383,9 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 		dump_tlf1_inputs(max_trades, trade_id_p);
 #endif
 
-		values[i_bid_price][0] = '{';
-		values[i_bid_price][1] = '\0';
-
-		values[i_cash_transaction_amount][0] = '{';
-		values[i_cash_transaction_amount][1] = '\0';
-
-		values[i_cash_transaction_dts][0] = '{';
-		values[i_cash_transaction_dts][1] = '\0';
-
-		values[i_cash_transaction_name][0] = '{';
-		values[i_cash_transaction_name][1] = '\0';
-
-		values[i_exec_name][0] = '{';
-		values[i_exec_name][1] = '\0';
-
-		values[i_is_cash][0] = '{';
-		values[i_is_cash][1] = '\0';
-
-		values[i_is_market][0] = '{';
-		values[i_is_market][1] = '\0';
-
-		values[i_settlement_amount][0] = '{';
-		values[i_settlement_amount][1] = '\0';
-
-		values[i_settlement_cash_due_date][0] = '{';
-		values[i_settlement_cash_due_date][1] = '\0';
-
-		values[i_settlement_cash_type][0] = '{';
-		values[i_settlement_cash_type][1] = '\0';
-
-		values[i_trade_history_dts][0] = '{';
-		values[i_trade_history_dts][1] = '\0';
-
-		values[i_trade_history_status_id][0] = '{';
-		values[i_trade_history_status_id][1] = '\0';
-
-		values[i_trade_price][0] = '{';
-		values[i_trade_price][1] = '\0';
-
 		for (i = 0; i < num_trades; i++) {
-			char *is_cash_str = NULL;
+			bool is_cash = false;
+			bool isnull;
 
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTLF1_1);
@@ -507,98 +404,24 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			for (j = 0; j < SPI_processed; j++) {
-				char *trade_price;
-				if (num_found_count > 0) {
-					strncat(values[i_bid_price], ",", length_bp--);
-					if (length_bp < 0) {
-						FAIL_FRAME("bid_price values needs to be increased");
-					}
-
-					strncat(values[i_exec_name], ",", length_en--);
-					if (length_en < 0) {
-						FAIL_FRAME("exec_name values needs to be increased");
-					}
-
-					strncat(values[i_is_cash], ",", length_ic--);
-					if (length_ic < 0) {
-						FAIL_FRAME("is_cash values needs to be increased");
-					}
-
-					strncat(values[i_is_market], ",", length_im--);
-					if (length_im < 0) {
-						FAIL_FRAME("is_market values needs to be increased");
-					}
-
-					strncat(values[i_trade_price], ",", length_tp--);
-					if (length_tp < 0) {
-						FAIL_FRAME("trade_price values needs to be increased");
-					}
-				}
-
 				tuple = tuptable->vals[j];
 
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				length_bp -= strlen(tmp);
-				strncat(values[i_bid_price], tmp, length_bp);
-				if (length_bp < 0) {
-					FAIL_FRAME("bid_price values needs to be increased");
-				}
-
-				strncat(values[i_exec_name], "\"", length_en--);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
+				push_frame_spi(&values, i_bid_price, tuple, tupdesc, 1);
+				push_frame_spi(&values, i_exec_name, tuple, tupdesc, 2);
 
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_exec_name], tmp, length_en--);
-				length_en -= strlen(tmp);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
+				is_cash = DatumGetBool(
+						SPI_getbinval(tuple, tupdesc, 3, &isnull));
+				push_frame_value(
+						&values, i_is_cash, Int16GetDatum(is_cash), false);
 
-				strncat(values[i_exec_name], "\"", length_en--);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
+				push_frame_value(&values, i_is_market,
+						Int16GetDatum(DatumGetBool(
+								SPI_getbinval(tuple, tupdesc, 4, &isnull))),
+						false);
 
-				/* Use the is_cash pointer, easier to reference later. */
-				is_cash_str = SPI_getvalue(tuple, tupdesc, 3);
-				if (is_cash_str[0] == 't') {
-					strncat(values[i_is_cash], "1", length_ic--);
-				} else {
-					strncat(values[i_is_cash], "0", length_ic--);
-				}
-				if (length_ic < 0) {
-					FAIL_FRAME("is_cash values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 4);
-				if (tmp[0] == 't') {
-					strncat(values[i_is_market], "1", length_im--);
-				} else {
-					strncat(values[i_is_market], "0", length_im--);
-				}
-				if (length_im < 0) {
-					FAIL_FRAME("is_market values needs to be increased");
-				}
-
-				trade_price = SPI_getvalue(tuple, tupdesc, 5);
-				if (trade_price != NULL) {
-					tmp = SPI_getvalue(tuple, tupdesc, 5);
-					strncat(values[i_trade_price], tmp, length_tp);
-					length_tp -= strlen(tmp);
-					if (length_tp < 0) {
-						FAIL_FRAME("trade_price values needs to be increased");
-					}
-				} else {
-					strncat(values[i_trade_price], "NULL", length_tp);
-					length_tp -= 4;
-					if (length_tp < 0) {
-						FAIL_FRAME("trade_price values needs to be increased");
-					}
-				}
+				push_frame_spi(&values, i_trade_price, tuple, tupdesc, 5);
 #ifdef DEBUG
-				elog(DEBUG1, "t_is_cash = %s", is_cash_str);
+				elog(DEBUG1, "t_is_cash = %d", is_cash);
 #endif /* DEBUG */
 
 				++num_found_count;
@@ -616,83 +439,17 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			for (j = 0; j < SPI_processed; j++) {
-				if (num_settlement > 0) {
-					strncat(values[i_settlement_amount], ",", length_sa--);
-					if (length_sa < 0) {
-						FAIL_FRAME("settlement_amount values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_settlement_cash_due_date], ",",
-							length_scdd--);
-					if (length_scdd < 0) {
-						FAIL_FRAME("settlement_cash_due_date values needs "
-								   "to be increased");
-					}
-
-					strncat(values[i_settlement_cash_type], ",", length_sct--);
-					if (length_sct < 0) {
-						FAIL_FRAME("settlement_cash_type values needs to "
-								   "be increased");
-					}
-				}
-
 				tuple = tuptable->vals[j];
 
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_settlement_amount], tmp, length_sa);
-				length_sa -= strlen(tmp);
-				if (length_sa < 0) {
-					FAIL_FRAME("settlement_amount values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_due_date], "\"",
-						length_scdd--);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_settlement_cash_due_date], tmp, length_scdd);
-				length_scdd -= strlen(tmp);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to "
-							   "be increased");
-				}
-
-				strncat(values[i_settlement_cash_due_date], "\"",
-						length_scdd--);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 3);
-				strncat(values[i_settlement_cash_type], tmp, length_sct);
-				length_sct -= strlen(tmp);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				++num_settlement;
+				push_frame_spi(
+						&values, i_settlement_amount, tuple, tupdesc, 1);
+				push_frame_spi(&values, i_settlement_cash_due_date, tuple,
+						tupdesc, 2);
+				push_frame_spi(
+						&values, i_settlement_cash_type, tuple, tupdesc, 3);
 			}
 
-			if (is_cash_str[0] == 't') {
+			if (is_cash) {
 #ifdef DEBUG
 				elog(DEBUG1, "%s", SQLTLF1_3);
 #endif /* DEBUG */
@@ -706,142 +463,23 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 				tuptable = SPI_tuptable;
 
 				for (j = 0; j < SPI_processed; j++) {
-					if (num_cash_txn > 0) {
-						strncat(values[i_cash_transaction_amount], ",",
-								length_cta--);
-						if (length_cta < 0) {
-							FAIL_FRAME("cash_transaction_amount values "
-									   "needs to be increased");
-						}
-
-						strncat(values[i_cash_transaction_dts], ",",
-								length_ctd--);
-						if (length_ctd < 0) {
-							FAIL_FRAME("cash_transaction_dts values needs "
-									   "to be increased");
-						}
-
-						strncat(values[i_cash_transaction_name], ",",
-								length_ctn--);
-						if (length_ctn < 0) {
-							FAIL_FRAME("cash_transaction_name values "
-									   "needs to be increased");
-						}
-					}
 					tuple = tuptable->vals[j];
 
-					strncat(values[i_cash_transaction_amount], "\"",
-							length_cta--);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
-
-					tmp = SPI_getvalue(tuple, tupdesc, 1);
-					strncat(values[i_cash_transaction_amount], tmp,
-							length_cta);
-					length_cta -= strlen(tmp);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs "
-								   "to be increased");
-					}
-
-					strncat(values[i_cash_transaction_amount], "\"",
-							length_cta--);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to "
-								   "be increased");
-					}
-
-					tmp = SPI_getvalue(tuple, tupdesc, 2);
-					strncat(values[i_cash_transaction_dts], tmp, length_ctd);
-					length_ctd -= strlen(tmp);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to "
-								   "be increased");
-					}
-
-					tmp = SPI_getvalue(tuple, tupdesc, 3);
-					strncat(values[i_cash_transaction_name], tmp, length_ctn);
-					length_ctn -= strlen(tmp);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to "
-								   "be increased");
-					}
-
-					++num_cash_txn;
+					push_frame_spi(&values, i_cash_transaction_amount, tuple,
+							tupdesc, 1);
+					push_frame_spi(&values, i_cash_transaction_dts, tuple,
+							tupdesc, 2);
+					push_frame_spi(&values, i_cash_transaction_name, tuple,
+							tupdesc, 3);
 				}
 			} else {
-				if (num_cash_txn > 0) {
-					strncat(values[i_cash_transaction_amount], ",",
-							length_cta--);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], ",", length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_name], ",",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to "
-								   "be increased");
-					}
-				}
-				strncat(values[i_cash_transaction_amount], "0", length_cta--);
-				if (length_cta < 0) {
-					FAIL_FRAME("cash_transaction_amount values needs to "
-							   "be increased");
-				}
-
-				strncat(values[i_cash_transaction_dts], "NULL", length_ctd);
-				length_ctd -= 4;
-				if (length_ctd < 0) {
-					FAIL_FRAME("cash_transaction_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_name], "\"\"", length_ctn);
-				length_ctn -= 2;
-				if (length_ctn < 0) {
-					FAIL_FRAME("cash_transaction_name values needs to be "
-							   "increased");
-				}
-
-				++num_cash_txn;
+				push_frame_value(&values, i_cash_transaction_amount,
+						DirectFunctionCall1(int4_numeric, Int32GetDatum(0)),
+						false);
+				push_frame_value(
+						&values, i_cash_transaction_dts, (Datum) 0, true);
+				push_frame_value(&values, i_cash_transaction_name,
+						CStringGetTextDatum(""), false);
 			}
 
 #ifdef DEBUG
@@ -855,85 +493,13 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 
-			/*
-			 * Emit the separator between trades whenever a previous
-			 * trade already added elements, even if this trade has no
-			 * trade_history rows and only padding is added below.
-			 */
-			if (num_history > 0) {
-				strncat(values[i_trade_history_dts], ",", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME("trade_history_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_trade_history_status_id], ",",
-						length_thsi--);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs "
-							   "to be increased");
-				}
-			}
-
 			for (j = 0; j < SPI_processed; j++) {
 				tuple = tuptable->vals[j];
 
-				if (j > 0) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						FAIL_FRAME("trade_history_status_id values needs "
-								   "to be increased");
-					}
-				}
-
-				strncat(values[i_trade_history_dts], "\"", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME("trade_history_dts values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_trade_history_dts], tmp, length_thd);
-				length_thd -= strlen(tmp);
-				if (length_thd < 0) {
-					FAIL_FRAME("trade_history_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_trade_history_dts], "\"", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME("trade_history_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_trade_history_status_id], "\"",
-						length_thsi--);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs "
-							   "to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_trade_history_status_id], tmp, length_thsi);
-				length_thsi -= strlen(tmp);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs "
-							   "to be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], "\"",
-						length_thsi--);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs "
-							   "to be increased");
-				}
+				push_frame_spi(
+						&values, i_trade_history_dts, tuple, tupdesc, 1);
+				push_frame_spi(&values, i_trade_history_status_id, tuple,
+						tupdesc, 2);
 			}
 
 			/*
@@ -942,124 +508,15 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 			 * the array up to 3 all the time.
 			 */
 			for (j = SPI_processed; j < 3; j++) {
-				if (j > 0) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						FAIL_FRAME("trade_history_status_id values "
-								   "needs to be increased");
-					}
-				}
-				strncat(values[i_trade_history_dts], "NULL", length_thd);
-				length_thd -= 4;
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], "\"\"",
-						length_thsi);
-				length_thsi -= 2;
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs "
-							   "to be increased");
-				}
+				push_frame_value(
+						&values, i_trade_history_dts, (Datum) 0, true);
+				push_frame_value(&values, i_trade_history_status_id,
+						CStringGetTextDatum(""), false);
 			}
-
-			++num_history;
 		}
 
-		strncat(values[i_bid_price], "}", length_bp--);
-		if (length_bp < 0) {
-			FAIL_FRAME("bid_price values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_amount], "}", length_cta--);
-		if (length_cta < 0) {
-			FAIL_FRAME("cash_transaction_amount values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_cash_transaction_dts], "}", length_ctd--);
-		if (length_ctd < 0) {
-			FAIL_FRAME("cash_transaction_dts values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_name], "}", length_ctn--);
-		if (length_ctn < 0) {
-			FAIL_FRAME("cash_transaction_name values needs to be increased");
-		}
-
-		strncat(values[i_exec_name], "}", length_en--);
-		if (length_en < 0) {
-			FAIL_FRAME("exec_name values needs to be increased");
-		}
-
-		strncat(values[i_is_cash], "}", length_ic--);
-		if (length_ic < 0) {
-			FAIL_FRAME("is_cash values needs to be increased");
-		}
-
-		strncat(values[i_is_market], "}", length_im--);
-		if (length_im < 0) {
-			FAIL_FRAME("is_market values needs to be increased");
-		}
-
-		strncat(values[i_settlement_amount], "}", length_sa--);
-		if (length_sa < 0) {
-			FAIL_FRAME("settlement_amount values needs to be increased");
-		}
-
-		strncat(values[i_settlement_cash_due_date], "}", length_scdd--);
-		if (length_scdd < 0) {
-			FAIL_FRAME("settlement_cash_due_date values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_settlement_cash_type], "}", length_sct--);
-		if (length_sct < 0) {
-			FAIL_FRAME("settlement_cash_type values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_dts], "}", length_thd--);
-		if (length_thd < 0) {
-			FAIL_FRAME("trade_history_dts values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_status_id], "}", length_thsi--);
-		if (length_thsi < 0) {
-			FAIL_FRAME("trade_history_status_id values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_trade_price], "}", length_tp--);
-		if (length_tp < 0) {
-			FAIL_FRAME("trade_price values needs to be increased");
-		}
-
-		snprintf(values[i_num_found], INTEGER_LEN + 1, "%d", num_found_count);
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from
-		 * raw C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
+		set_frame_value(
+				&values, i_num_found, Int32GetDatum(num_found_count), false);
 
 		MemoryContextSwitchTo(oldcontext);
 	}
@@ -1069,22 +526,19 @@ TradeLookupFrame1(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 14; i++) {
-			elog(DEBUG1, "TLF1 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TLF1", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -1101,13 +555,12 @@ Datum
 TradeLookupFrame2(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i;
 
-	char **values = NULL;
+	frame_result values;
 
 	enum tlf2
 	{
@@ -1136,11 +589,13 @@ TradeLookupFrame2(PG_FUNCTION_ARGS)
 		int max_trades = PG_GETARG_INT32(2);
 		Timestamp start_trade_dts_ts = PG_GETARG_TIMESTAMP(3);
 
+#ifdef DEBUG
 		struct pg_tm tt, *tm = &tt;
 		fsec_t fsec;
 		char *tzn = NULL;
 		char end_trade_dts[MYMAXDATELEN + 1];
 		char start_trade_dts[MYMAXDATELEN + 1];
+#endif /* DEBUG */
 		Datum args[4];
 		char nulls[4] = { ' ', ' ', ' ', ' ' };
 		int ret;
@@ -1149,17 +604,10 @@ TradeLookupFrame2(PG_FUNCTION_ARGS)
 		HeapTuple tuple = NULL;
 
 		int num_found_count = 0;
-		int num_settlements = 0;
-		int num_cash_txn = 0;
-		int num_trade_history = 0;
-
-		char *is_cash_str;
 
 		int j;
-		int length_bp, length_cta, length_ctd, length_ctn, length_en,
-				length_ic, length_sa, length_scdd, length_sct, length_thd,
-				length_thsi, length_tl, length_tp;
 
+#ifdef DEBUG
 		if (timestamp2tm(end_trade_dts_ts, NULL, tm, &fsec, NULL, NULL) == 0) {
 			EncodeDateTimeM(tm, fsec, tzn, end_trade_dts);
 		}
@@ -1168,66 +616,11 @@ TradeLookupFrame2(PG_FUNCTION_ARGS)
 			EncodeDateTimeM(tm, fsec, tzn, start_trade_dts);
 		}
 
-#ifdef DEBUG
 		dump_tlf2_inputs(acct_id, end_trade_dts, max_trades, start_trade_dts);
 #endif /* DEBUG */
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 14);
-
-		length_bp = (S_PRICE_T_LEN + 1) * max_trades + 2;
-		values[i_bid_price] = (char *) palloc(length_bp-- * sizeof(char));
-
-		length_cta = (VALUE_T_LEN + 1) * max_trades + 2;
-		values[i_cash_transaction_amount]
-				= (char *) palloc(length_cta-- * sizeof(char));
-
-		length_ctd = (MYMAXDATELEN + 1) * max_trades + 2;
-		values[i_cash_transaction_dts]
-				= (char *) palloc(length_ctd-- * sizeof(char));
-
-		length_ctn = (CT_NAME_LEN + 3) * max_trades + 2;
-		values[i_cash_transaction_name]
-				= (char *) palloc(length_ctn-- * sizeof(char));
-
-		length_en = (T_EXEC_NAME_LEN + 1) * max_trades + 3;
-		values[i_exec_name] = (char *) palloc(length_en-- * sizeof(char));
-
-		length_ic = (BOOLEAN_LEN + 1) * max_trades + 2;
-		values[i_is_cash] = (char *) palloc(length_ic-- * sizeof(char));
-
-		values[i_num_found]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-
-		length_sa = (VALUE_T_LEN + 1) * max_trades + 2;
-		values[i_settlement_amount]
-				= (char *) palloc(length_sa-- * sizeof(char));
-
-		length_scdd = (MYMAXDATELEN + 1) * max_trades + 2;
-		values[i_settlement_cash_due_date]
-				= (char *) palloc(length_scdd-- * sizeof(char));
-
-		length_sct = (SE_CASH_TYPE_LEN + 1) * max_trades + 2;
-		values[i_settlement_cash_type]
-				= (char *) palloc(length_sct-- * sizeof(char));
-
-		length_thd = (MYMAXDATELEN + 1) * 3 * max_trades + 2;
-		values[i_trade_history_dts]
-				= (char *) palloc(length_thd-- * sizeof(char));
-
-		length_thsi = (ST_ID_LEN + 1) * 3 * max_trades + 2;
-		values[i_trade_history_status_id]
-				= (char *) palloc(length_thsi-- * sizeof(char));
-
-		length_tl = (TRADE_T_LEN + 1) * max_trades + 2;
-		values[i_trade_list] = (char *) palloc(length_tl-- * sizeof(char));
-
-		length_tp = (S_PRICE_T_LEN + 1) * max_trades + 2;
-		values[i_trade_price] = (char *) palloc(length_tp-- * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 		/* create a function context for cross-call persistence */
 		funcctx = SRF_FIRSTCALL_INIT();
@@ -1259,145 +652,36 @@ TradeLookupFrame2(PG_FUNCTION_ARGS)
 			tuptable = SPI_tuptable;
 			num_found_count = SPI_processed;
 		}
-		snprintf(values[i_num_found], INTEGER_LEN + 1, "%d", num_found_count);
+		set_frame_value(
+				&values, i_num_found, Int32GetDatum(num_found_count), false);
 
 #ifdef DEBUG
 		elog(DEBUG1, "num_found = %d", num_found_count);
 #endif /* DEBUG */
 
-		values[i_bid_price][0] = '{';
-		values[i_bid_price][1] = '\0';
-
-		values[i_cash_transaction_amount][0] = '{';
-		values[i_cash_transaction_amount][1] = '\0';
-
-		values[i_cash_transaction_dts][0] = '{';
-		values[i_cash_transaction_dts][1] = '\0';
-
-		values[i_cash_transaction_name][0] = '{';
-		values[i_cash_transaction_name][1] = '\0';
-
-		values[i_exec_name][0] = '{';
-		values[i_exec_name][1] = '\0';
-
-		values[i_is_cash][0] = '{';
-		values[i_is_cash][1] = '\0';
-
-		values[i_settlement_amount][0] = '{';
-		values[i_settlement_amount][1] = '\0';
-
-		values[i_settlement_cash_due_date][0] = '{';
-		values[i_settlement_cash_due_date][1] = '\0';
-
-		values[i_settlement_cash_type][0] = '{';
-		values[i_settlement_cash_type][1] = '\0';
-
-		values[i_trade_history_dts][0] = '{';
-		values[i_trade_history_dts][1] = '\0';
-
-		values[i_trade_history_status_id][0] = '{';
-		values[i_trade_history_status_id][1] = '\0';
-
-		values[i_trade_list][0] = '{';
-		values[i_trade_list][1] = '\0';
-
-		values[i_trade_price][0] = '{';
-		values[i_trade_price][1] = '\0';
-
 		for (i = 0; i < num_found_count; i++) {
-			char *tmp;
 			TupleDesc tupdesc2;
 			SPITupleTable *tuptable2 = NULL;
 			HeapTuple tuple2 = NULL;
 
-			char *trade_list_str;
+			bool is_cash;
+			bool isnull;
 
 			tuple = tuptable->vals[i];
 
-			if (i > 0) {
-				strncat(values[i_bid_price], ",", length_bp--);
-				if (length_bp < 0) {
-					FAIL_FRAME("bid_price values needs to be increased");
-				}
-
-				strncat(values[i_exec_name], ",", length_en--);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
-
-				strncat(values[i_is_cash], ",", length_ic--);
-				if (length_ic < 0) {
-					FAIL_FRAME("is_cash values needs to be increased");
-				}
-
-				strncat(values[i_trade_list], ",", length_tl--);
-				if (length_tl < 0) {
-					FAIL_FRAME("trade_list values needs to be increased");
-				}
-
-				strncat(values[i_trade_price], ",", length_tp--);
-				if (length_tp < 0) {
-					FAIL_FRAME("trade_price values needs to be increased");
-				}
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_bid_price], tmp, length_bp);
-			length_bp -= strlen(tmp);
-			if (length_bp < 0) {
-				FAIL_FRAME("bid_price values needs to be increased");
-			}
+			push_frame_spi(&values, i_bid_price, tuple, tupdesc, 1);
+			push_frame_spi(&values, i_exec_name, tuple, tupdesc, 2);
 
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_exec_name], tmp, length_en--);
-			length_en -= strlen(tmp);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
+			is_cash = DatumGetBool(SPI_getbinval(tuple, tupdesc, 3, &isnull));
+			push_frame_value(&values, i_is_cash, Int16GetDatum(is_cash), false);
 
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			is_cash_str = SPI_getvalue(tuple, tupdesc, 3);
-			strncat(values[i_is_cash], (is_cash_str[0] == 't' ? "1" : "0"),
-					length_ic--);
-			if (length_ic < 0) {
-				FAIL_FRAME("is_cash values needs to be increased");
-			}
-
-			trade_list_str = SPI_getvalue(tuple, tupdesc, 4);
-			strncat(values[i_trade_list], trade_list_str, length_tl);
-			length_tl -= strlen(trade_list_str);
-			if (length_tl < 0) {
-				FAIL_FRAME("trade_list values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 5);
-			if (tmp != NULL) {
-				strncat(values[i_trade_price], tmp, length_tp);
-				length_tp -= strlen(tmp);
-				if (length_tp < 0) {
-					FAIL_FRAME("trade_price values needs to be increased");
-				}
-			} else {
-				strncat(values[i_trade_price], "NULL", length_tp);
-				length_tp -= 4;
-				if (length_tp < 0) {
-					FAIL_FRAME("trade_price values needs to be increased");
-				}
-			}
+			push_frame_spi(&values, i_trade_list, tuple, tupdesc, 4);
+			push_frame_spi(&values, i_trade_price, tuple, tupdesc, 5);
 
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTLF2_2);
 #endif /* DEBUG */
-			args[0] = Int64GetDatum(atoll(trade_list_str));
+			args[0] = SPI_getbinval(tuple, tupdesc, 4, &isnull);
 			ret = SPI_execute_plan(TLF2_2, args, nulls, true, 0);
 			if (ret != SPI_OK_SELECT) {
 #ifdef DEBUG
@@ -1407,61 +691,20 @@ TradeLookupFrame2(PG_FUNCTION_ARGS)
 				FAIL_FRAME_SET(&funcctx->max_calls, TLF2_statements[1].sql);
 				break;
 			}
+			tupdesc2 = SPI_tuptable->tupdesc;
+			tuptable2 = SPI_tuptable;
 			for (j = 0; j < SPI_processed; j++) {
-				tupdesc2 = SPI_tuptable->tupdesc;
-				tuptable2 = SPI_tuptable;
-				++num_settlements;
-
-				if (num_settlements > 1) {
-					strncat(values[i_settlement_amount], ",", length_sa--);
-					if (length_sa < 0) {
-						FAIL_FRAME("settlement_amount values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_settlement_cash_due_date], ",",
-							length_scdd--);
-					if (length_scdd < 0) {
-						FAIL_FRAME(
-								"settlement_cash_due_date values needs to be "
-								"increased");
-					}
-
-					strncat(values[i_settlement_cash_type], ",", length_sct--);
-					if (length_sct < 0) {
-						FAIL_FRAME("settlement_cash_type values needs to be "
-								   "increased");
-					}
-				}
-
 				tuple2 = tuptable2->vals[j];
 
-				tmp = SPI_getvalue(tuple2, tupdesc2, 1);
-				strncat(values[i_settlement_amount], tmp, length_sa);
-				length_sa -= strlen(tmp);
-				if (length_sa < 0) {
-					FAIL_FRAME(
-							"settlement_amount values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 2);
-				strncat(values[i_settlement_cash_due_date], tmp, length_scdd);
-				length_scdd -= strlen(tmp);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 3);
-				strncat(values[i_settlement_cash_type], tmp, length_sct);
-				length_sct -= strlen(tmp);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
+				push_frame_spi(
+						&values, i_settlement_amount, tuple2, tupdesc2, 1);
+				push_frame_spi(&values, i_settlement_cash_due_date, tuple2,
+						tupdesc2, 2);
+				push_frame_spi(
+						&values, i_settlement_cash_type, tuple2, tupdesc2, 3);
 			}
 
-			if (is_cash_str[0] == 't') {
+			if (is_cash) {
 #ifdef DEBUG
 				elog(DEBUG1, "%s", SQLTLF2_3);
 #endif /* DEBUG */
@@ -1479,129 +722,22 @@ TradeLookupFrame2(PG_FUNCTION_ARGS)
 				tuptable2 = SPI_tuptable;
 				for (j = 0; j < SPI_processed; j++) {
 					tuple2 = tuptable2->vals[j];
-					++num_cash_txn;
-
-					if (num_cash_txn > 1) {
-						strncat(values[i_cash_transaction_amount], ",",
-								length_cta--);
-						if (length_cta < 0) {
-							FAIL_FRAME("cash_transaction_amount values needs "
-									   "to be increased");
-						}
-
-						strncat(values[i_cash_transaction_dts], ",",
-								length_ctd--);
-						if (length_ctd < 0) {
-							FAIL_FRAME("cash_transaction_dts values needs to "
-									   "be increased");
-						}
-
-						strncat(values[i_cash_transaction_name], ",",
-								length_ctn--);
-						if (length_ctn < 0) {
-							FAIL_FRAME("cash_transaction_name values needs to "
-									   "be increased");
-						}
-					}
-
-					tmp = SPI_getvalue(tuple2, tupdesc2, 1);
-					strncat(values[i_cash_transaction_amount], tmp,
-							length_cta);
-					length_cta -= strlen(tmp);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					tmp = SPI_getvalue(tuple2, tupdesc2, 2);
-					strncat(values[i_cash_transaction_dts], tmp, length_ctd);
-					length_ctd -= strlen(tmp);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					tmp = SPI_getvalue(tuple2, tupdesc2, 3);
-					strncat(values[i_cash_transaction_name], tmp, length_ctn);
-					length_ctn -= strlen(tmp);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-				}
-			} else {
-				++num_cash_txn;
-
-				if (num_cash_txn > 1) {
-					strncat(values[i_cash_transaction_amount], ",",
-							length_cta--);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs "
-								   "to be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], ",",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_name], ",",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to "
-								   "be increased");
-					}
-				}
 
-				strncat(values[i_cash_transaction_amount], "0", length_cta--);
-				if (length_cta < 0) {
-					FAIL_FRAME("cash_transaction_amount values needs to "
-							   "be increased");
-				}
-
-				strncat(values[i_cash_transaction_dts], "NULL", length_ctd);
-				length_ctd -= 4;
-				if (length_ctd < 0) {
-					FAIL_FRAME("cash_transaction_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_name], "\"\"", length_ctn);
-				length_ctn -= 2;
-				if (length_ctn < 0) {
-					FAIL_FRAME("cash_transaction_name values needs to be "
-							   "increased");
+					push_frame_spi(&values, i_cash_transaction_amount, tuple2,
+							tupdesc2, 1);
+					push_frame_spi(&values, i_cash_transaction_dts, tuple2,
+							tupdesc2, 2);
+					push_frame_spi(&values, i_cash_transaction_name, tuple2,
+							tupdesc2, 3);
 				}
+			} else {
+				push_frame_value(&values, i_cash_transaction_amount,
+						DirectFunctionCall1(int4_numeric, Int32GetDatum(0)),
+						false);
+				push_frame_value(
+						&values, i_cash_transaction_dts, (Datum) 0, true);
+				push_frame_value(&values, i_cash_transaction_name,
+						CStringGetTextDatum(""), false);
 			}
 
 #ifdef DEBUG
@@ -1623,168 +759,19 @@ TradeLookupFrame2(PG_FUNCTION_ARGS)
 			for (j = 0; j < SPI_processed; j++) {
 				tuple2 = tuptable2->vals[j];
 
-				++num_trade_history;
-
-				if (num_trade_history > 1) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						FAIL_FRAME(
-								"trade_history_status_id values needs to be "
-								"increased");
-					}
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 1);
-				strncat(values[i_trade_history_dts], tmp, length_thd);
-				length_thd -= strlen(tmp);
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 2);
-				strncat(values[i_trade_history_status_id], tmp, length_thsi);
-				length_thsi -= strlen(tmp);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to be "
-							   "increased");
-				}
+				push_frame_spi(
+						&values, i_trade_history_dts, tuple2, tupdesc2, 1);
+				push_frame_spi(&values, i_trade_history_status_id, tuple2,
+						tupdesc2, 2);
 			}
 			for (j = SPI_processed; j < 3; j++) {
-				++num_trade_history;
-
-				if (num_trade_history > 1) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						elog(DEBUG1,
-								"TUF2 trade_history_status_id out of space: "
-								"%s",
-								values[i_trade_history_status_id]);
-						FAIL_FRAME("trade_history_status_id values needs to "
-								   "be increased");
-					}
-				}
-				strncat(values[i_trade_history_dts], "NULL", length_thd);
-				length_thd -= 4;
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], "\"\"",
-						length_thsi);
-				length_thsi -= 2;
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to be "
-							   "increased");
-				}
-#ifdef DEBUG
-				elog(DEBUG1, "TUF2 trade_history_dts[%d][%d] %s", i, j,
-						values[i_trade_history_dts]);
-				elog(DEBUG1, "TUF2 trade_history_status_id[%d][%d] %s", i, j,
-						values[i_trade_history_status_id]);
-#endif /* DEBUG */
+				push_frame_value(
+						&values, i_trade_history_dts, (Datum) 0, true);
+				push_frame_value(&values, i_trade_history_status_id,
+						CStringGetTextDatum(""), false);
 			}
 		}
 
-		strncat(values[i_bid_price], "}", length_bp--);
-		if (length_bp < 0) {
-			FAIL_FRAME("bid_price values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_amount], "}", length_cta--);
-		if (length_cta < 0) {
-			FAIL_FRAME("cash_transaction_amount values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_cash_transaction_dts], "}", length_ctd--);
-		if (length_ctd < 0) {
-			FAIL_FRAME("cash_transaction_dts values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_name], "}", length_ctn--);
-		if (length_ctn < 0) {
-			FAIL_FRAME("cash_transaction_name values needs to be increased");
-		}
-
-		strncat(values[i_exec_name], "}", length_en--);
-		if (length_en < 0) {
-			FAIL_FRAME("exec_name values needs to be increased");
-		}
-
-		strncat(values[i_is_cash], "}", length_ic--);
-		if (length_ic < 0) {
-			FAIL_FRAME("is_cash values needs to be increased");
-		}
-
-		strncat(values[i_settlement_amount], "}", length_sa--);
-		if (length_sa < 0) {
-			FAIL_FRAME("settlement_amount values needs to be increased");
-		}
-
-		strncat(values[i_settlement_cash_due_date], "}", length_scdd--);
-		if (length_scdd < 0) {
-			FAIL_FRAME("settlement_cash_due_date values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_settlement_cash_type], "}", length_sct--);
-		if (length_sct < 0) {
-			FAIL_FRAME("settlement_cash_type values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_dts], "}", length_thd--);
-		if (length_thd < 0) {
-			FAIL_FRAME("trade_history_dts values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_status_id], "}", length_thsi--);
-		if (length_thsi < 0) {
-			FAIL_FRAME("trade_history_status_id values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_trade_list], "}", length_tl--);
-		if (length_tl < 0) {
-			FAIL_FRAME("trade_list values needs to be increased");
-		}
-
-		strncat(values[i_trade_price], "}", length_tp--);
-		if (length_tp < 0) {
-			FAIL_FRAME("trade_price values needs to be increased");
-		}
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from
-		 * raw C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
-
 		MemoryContextSwitchTo(oldcontext);
 	}
 
@@ -1793,22 +780,19 @@ TradeLookupFrame2(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 14; i++) {
-			elog(DEBUG1, "TLF2 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TLF2", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -1824,13 +808,12 @@ Datum
 TradeLookupFrame3(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i;
 
-	char **values = NULL;
+	frame_result values;
 
 	enum tlf3
 	{
@@ -1864,15 +847,16 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 #endif /* DEBUG */
 		int max_trades = PG_GETARG_INT32(2);
 		Timestamp start_trade_dts_ts = PG_GETARG_TIMESTAMP(3);
-		char *symbol_p = (char *) PG_GETARG_TEXT_P(4);
+		text *symbol_p = PG_GETARG_TEXT_P(4);
 
+#ifdef DEBUG
 		char symbol[S_SYMB_LEN + 1];
-
 		struct pg_tm tt, *tm = &tt;
 		fsec_t fsec;
 		char *tzn = NULL;
 		char end_trade_dts[MYMAXDATELEN + 1];
 		char start_trade_dts[MYMAXDATELEN + 1];
+#endif /* DEBUG */
 		Datum args[4];
 		char nulls[4] = { ' ', ' ', ' ', ' ' };
 		int ret;
@@ -1881,19 +865,10 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 		HeapTuple tuple = NULL;
 
 		int num_found_count = 0;
-		int num_settlements = 0;
-		int num_cash_txn = 0;
-		int num_trade_history = 0;
-
-		char *is_cash_str;
 
 		int j;
-		char *tmp;
-		int length_ai, length_cta, length_ctd, length_ctn, length_en,
-				length_ic, length_p, length_q, length_sa, length_scdd,
-				length_sct, length_td, length_tl, length_thd, length_thsi,
-				length_tt;
 
+#ifdef DEBUG
 		if (timestamp2tm(end_trade_dts_ts, NULL, tm, &fsec, NULL, NULL) == 0) {
 			EncodeDateTimeM(tm, fsec, tzn, end_trade_dts);
 		}
@@ -1906,77 +881,12 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 						textout, PointerGetDatum(symbol_p))),
 				sizeof(symbol));
 
-#ifdef DEBUG
 		dump_tlf3_inputs(end_trade_dts, max_acct_id, max_trades,
 				start_trade_dts, symbol);
 #endif /* DEBUG */
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 17);
-
-		length_ai = (IDENT_T_LEN + 1) * max_trades + 2;
-		values[i_acct_id] = (char *) palloc(length_ai-- * sizeof(char));
-
-		length_cta = (VALUE_T_LEN + 1) * max_trades + 2;
-		values[i_cash_transaction_amount]
-				= (char *) palloc(length_cta-- * sizeof(char));
-
-		length_ctd = (MYMAXDATELEN + 1) * max_trades + 2;
-
-		values[i_cash_transaction_dts]
-				= (char *) palloc(length_ctd-- * sizeof(char));
-
-		length_ctn = (CT_NAME_LEN + 3) * max_trades + 2;
-		values[i_cash_transaction_name]
-				= (char *) palloc(length_ctn-- * sizeof(char));
-
-		length_en = (T_EXEC_NAME_LEN + 3) * max_trades + 2;
-		values[i_exec_name] = (char *) palloc(length_en-- * sizeof(char));
-
-		length_ic = (BOOLEAN_LEN + 1) * max_trades + 2;
-		values[i_is_cash] = (char *) palloc(length_ic-- * sizeof(char));
-
-		values[i_num_found]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-
-		length_p = (S_PRICE_T_LEN + 1) * max_trades + 2;
-		values[i_price] = (char *) palloc(length_p-- * sizeof(char));
-
-		length_q = (INTEGER_LEN + 1) * max_trades + 2;
-		values[i_quantity] = (char *) palloc(length_q-- * sizeof(char));
-
-		length_sa = (VALUE_T_LEN + 1) * max_trades + 2;
-		values[i_settlement_amount]
-				= (char *) palloc(length_sa-- * sizeof(char));
-
-		length_scdd = (MYMAXDATELEN + 1) * max_trades + 2;
-		values[i_settlement_cash_due_date]
-				= (char *) palloc(length_scdd-- * sizeof(char));
-
-		length_sct = (SE_CASH_TYPE_LEN + 3) * max_trades + 2;
-		values[i_settlement_cash_type]
-				= (char *) palloc(length_sct-- * sizeof(char));
-
-		length_td = (MYMAXDATELEN * 3 + 4) * max_trades + max_trades + 2;
-		values[i_trade_dts] = (char *) palloc(length_td-- * sizeof(char));
-
-		length_thd = (MYMAXDATELEN * 3 + 4) * max_trades + max_trades + 2;
-		values[i_trade_history_dts]
-				= (char *) palloc(length_thd-- * sizeof(char));
-
-		length_thsi = (ST_ID_LEN + 3) * max_trades * 3 + 2;
-		values[i_trade_history_status_id]
-				= (char *) palloc(length_thsi-- * sizeof(char));
-
-		length_tl = (TRADE_T_LEN + 1) * max_trades + 2;
-		values[i_trade_list] = (char *) palloc(length_tl-- * sizeof(char));
-
-		length_tt = (TT_ID_LEN + 3) * max_trades + 2;
-		values[i_trade_type] = (char *) palloc(length_tt-- * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 		/* create a function context for cross-call persistence */
 		funcctx = SRF_FIRSTCALL_INIT();
@@ -1988,6 +898,7 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 
 		SPI_connect();
 		plan_queries(TLF3_statements);
+
 #ifdef DEBUG
 		elog(DEBUG1, "SQLTLF3_1\n%s", SQLTLF3_1);
 		elog(DEBUG1, "$1 %s", symbol);
@@ -1995,7 +906,7 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 		elog(DEBUG1, "$3 %s", end_trade_dts);
 		elog(DEBUG1, "$4 %d", max_trades);
 #endif /* DEBUG */
-		args[0] = CStringGetTextDatum(symbol);
+		args[0] = PointerGetDatum(symbol_p);
 		args[1] = TimestampGetDatum(start_trade_dts_ts);
 		args[2] = TimestampGetDatum(end_trade_dts_ts);
 		args[3] = Int32GetDatum(max_trades);
@@ -2011,209 +922,40 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 			tuptable = SPI_tuptable;
 			num_found_count = SPI_processed;
 		}
-		snprintf(values[i_num_found], INTEGER_LEN + 1, "%d", num_found_count);
+		set_frame_value(
+				&values, i_num_found, Int32GetDatum(num_found_count), false);
 
 #ifdef DEBUG
 		elog(DEBUG1, "num_found = %d", num_found_count);
 #endif /* DEBUG */
 
-		values[i_acct_id][0] = '{';
-		values[i_acct_id][1] = '\0';
-
-		values[i_cash_transaction_amount][0] = '{';
-		values[i_cash_transaction_amount][1] = '\0';
-
-		values[i_cash_transaction_dts][0] = '{';
-		values[i_cash_transaction_dts][1] = '\0';
-
-		values[i_cash_transaction_name][0] = '{';
-		values[i_cash_transaction_name][1] = '\0';
-
-		values[i_exec_name][0] = '{';
-		values[i_exec_name][1] = '\0';
-
-		values[i_is_cash][0] = '{';
-		values[i_is_cash][1] = '\0';
-
-		values[i_price][0] = '{';
-		values[i_price][1] = '\0';
-
-		values[i_quantity][0] = '{';
-		values[i_quantity][1] = '\0';
-
-		values[i_settlement_amount][0] = '{';
-		values[i_settlement_amount][1] = '\0';
-
-		values[i_settlement_cash_due_date][0] = '{';
-		values[i_settlement_cash_due_date][1] = '\0';
-
-		values[i_settlement_cash_type][0] = '{';
-		values[i_settlement_cash_type][1] = '\0';
-
-		values[i_trade_dts][0] = '{';
-		values[i_trade_dts][1] = '\0';
-
-		values[i_trade_history_dts][0] = '{';
-		values[i_trade_history_dts][1] = '\0';
-
-		values[i_trade_history_status_id][0] = '{';
-		values[i_trade_history_status_id][1] = '\0';
-
-		values[i_trade_list][0] = '{';
-		values[i_trade_list][1] = '\0';
-
-		values[i_trade_type][0] = '{';
-		values[i_trade_type][1] = '\0';
-
 		for (i = 0; i < num_found_count; i++) {
 			TupleDesc tupdesc2;
 			SPITupleTable *tuptable2 = NULL;
 			HeapTuple tuple2 = NULL;
 
-			char *trade_list_str;
+			bool is_cash;
+			bool isnull;
 
 			tuple = tuptable->vals[i];
-			if (i > 0) {
-				strncat(values[i_acct_id], ",", length_ai--);
-				if (length_ai < 0) {
-					FAIL_FRAME("acct_id values needs to be increased");
-				}
-
-				strncat(values[i_exec_name], ",", length_en--);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
-
-				strncat(values[i_is_cash], ",", length_ic--);
-				if (length_ic < 0) {
-					FAIL_FRAME("is_cash values needs to be increased");
-				}
-
-				strncat(values[i_price], ",", length_p--);
-				if (length_p < 0) {
-					FAIL_FRAME("price values needs to be increased");
-				}
-
-				strncat(values[i_quantity], ",", length_q--);
-				if (length_q < 0) {
-					FAIL_FRAME("quantity values needs to be increased");
-				}
-
-				strncat(values[i_trade_dts], ",", length_td--);
-				if (length_td < 0) {
-					FAIL_FRAME("trade_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_list], ",", length_tl--);
-				if (length_tl < 0) {
-					FAIL_FRAME("trade_list values needs to be increased");
-				}
 
-				strncat(values[i_trade_type], ",", length_tt--);
-				if (length_tt < 0) {
-					FAIL_FRAME("trade_type values needs to be increased");
-				}
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_acct_id], tmp, length_ai);
-			length_ai -= strlen(tmp);
-			if (length_ai < 0) {
-				FAIL_FRAME("acct_id values needs to be increased");
-			}
-
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_exec_name], tmp, length_en--);
-			length_en -= strlen(tmp);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
+			push_frame_spi(&values, i_acct_id, tuple, tupdesc, 1);
+			push_frame_spi(&values, i_exec_name, tuple, tupdesc, 2);
 
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			is_cash_str = SPI_getvalue(tuple, tupdesc, 3);
-			strncat(values[i_is_cash], (is_cash_str[0] == 't' ? "1" : "0"),
-					length_ic--);
-			if (length_ic < 0) {
-				FAIL_FRAME("is_cash values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 4);
-			if (tmp != NULL) {
-				strncat(values[i_price], tmp, length_p);
-				length_p -= strlen(tmp);
-				if (length_p < 0) {
-					FAIL_FRAME("price values needs to be increased");
-				}
-			} else {
-				strncat(values[i_price], "NULL", length_p);
-				length_p -= 4;
-				if (length_p < 0) {
-					FAIL_FRAME("price values needs to be increased");
-				}
-			}
+			is_cash = DatumGetBool(SPI_getbinval(tuple, tupdesc, 3, &isnull));
+			push_frame_value(&values, i_is_cash, Int16GetDatum(is_cash), false);
 
-			tmp = SPI_getvalue(tuple, tupdesc, 5);
-			strncat(values[i_quantity], tmp, length_q);
-			length_q -= strlen(tmp);
-			if (length_q < 0) {
-				FAIL_FRAME("quantity values needs to be increased");
-			}
-
-			strncat(values[i_trade_dts], "\"", length_td--);
-			if (length_td < 0) {
-				FAIL_FRAME("trade_dts values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 6);
-			strncat(values[i_trade_dts], tmp, length_td);
-			length_td -= strlen(tmp);
-			if (length_td < 0) {
-				FAIL_FRAME("trade_dts values needs to be increased");
-			}
-
-			strncat(values[i_trade_dts], "\"", length_td--);
-			if (length_td < 0) {
-				FAIL_FRAME("trade_dts values needs to be increased");
-			}
-
-			trade_list_str = SPI_getvalue(tuple, tupdesc, 7);
-			strncat(values[i_trade_list], trade_list_str, length_tl);
-			length_tl -= strlen(trade_list_str);
-			if (length_tl < 0) {
-				FAIL_FRAME("trade_list values needs to be increased");
-			}
-
-			strncat(values[i_trade_type], "\"", length_tt--);
-			if (length_tt < 0) {
-				FAIL_FRAME("trade_type values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 8);
-			strncat(values[i_trade_type], tmp, length_tt);
-			length_tt -= strlen(tmp);
-			if (length_tt < 0) {
-				FAIL_FRAME("trade_type values needs to be increased");
-			}
-
-			strncat(values[i_trade_type], "\"", length_tt--);
-			if (length_tt < 0) {
-				FAIL_FRAME("trade_type values needs to be increased");
-			}
+			push_frame_spi(&values, i_price, tuple, tupdesc, 4);
+			push_frame_spi(&values, i_quantity, tuple, tupdesc, 5);
+			push_frame_spi(&values, i_trade_dts, tuple, tupdesc, 6);
+			push_frame_spi(&values, i_trade_list, tuple, tupdesc, 7);
+			push_frame_spi(&values, i_trade_type, tuple, tupdesc, 8);
 
+			args[0] = SPI_getbinval(tuple, tupdesc, 7, &isnull);
 #ifdef DEBUG
 			elog(DEBUG1, "SQLTLF3_2\n%s", SQLTLF3_2);
-			elog(DEBUG1, "$1 %s", trade_list_str);
+			elog(DEBUG1, "$1 %ld", DatumGetInt64(args[0]));
 #endif /* DEBUG */
-			args[0] = Int64GetDatum(atoll(trade_list_str));
 			ret = SPI_execute_plan(TLF3_2, args, nulls, true, 0);
 			if (ret != SPI_OK_SELECT) {
 #ifdef DEBUG
@@ -2223,87 +965,22 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 				FAIL_FRAME_SET(&funcctx->max_calls, TLF3_statements[1].sql);
 				break;
 			}
+			tupdesc2 = SPI_tuptable->tupdesc;
+			tuptable2 = SPI_tuptable;
 			for (j = 0; j < SPI_processed; j++) {
-				tupdesc2 = SPI_tuptable->tupdesc;
-				tuptable2 = SPI_tuptable;
 				tuple2 = tuptable2->vals[j];
-				++num_settlements;
-
-				if (num_settlements > 1) {
-					strncat(values[i_settlement_amount], ",", length_sa--);
-					if (length_sa < 0) {
-						FAIL_FRAME("settlement_amount values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_settlement_cash_due_date], ",",
-							length_scdd--);
-					if (length_scdd < 0) {
-						FAIL_FRAME("settlement_cash_due_date values needs "
-								   "to be increased");
-					}
-
-					strncat(values[i_settlement_cash_type], ",", length_sct--);
-					if (length_sct < 0) {
-						FAIL_FRAME("settlement_cash_type values needs to "
-								   "be increased");
-					}
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 1);
-				strncat(values[i_settlement_amount], tmp, length_sa);
-				length_sa -= strlen(tmp);
-				if (length_sa < 0) {
-					FAIL_FRAME("settlement_amount values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_due_date], "\"",
-						length_scdd--);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to "
-							   "be increased");
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 2);
-				strncat(values[i_settlement_cash_due_date], tmp, length_scdd);
-				length_scdd -= strlen(tmp);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to "
-							   "be increased");
-				}
-
-				strncat(values[i_settlement_cash_due_date], "\"",
-						length_scdd--);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to "
-							   "be increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
 
-				tmp = SPI_getvalue(tuple2, tupdesc2, 3);
-				strncat(values[i_settlement_cash_type], tmp, length_sct);
-				length_sct -= strlen(tmp);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
+				push_frame_spi(
+						&values, i_settlement_amount, tuple2, tupdesc2, 1);
+				push_frame_spi(&values, i_settlement_cash_due_date, tuple2,
+						tupdesc2, 2);
+				push_frame_spi(
+						&values, i_settlement_cash_type, tuple2, tupdesc2, 3);
 			}
 
 #ifdef DEBUG
 			elog(DEBUG1, "SQLTLF3_3\n%s", SQLTLF3_3);
-			elog(DEBUG1, "$1 %s", trade_list_str);
+			elog(DEBUG1, "$1 %ld", DatumGetInt64(args[0]));
 #endif /* DEBUG */
 			ret = SPI_execute_plan(TLF3_3, args, nulls, true, 0);
 			if (ret != SPI_OK_SELECT) {
@@ -2314,82 +991,17 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 				FAIL_FRAME_SET(&funcctx->max_calls, TLF3_statements[2].sql);
 				break;
 			}
+			tupdesc2 = SPI_tuptable->tupdesc;
+			tuptable2 = SPI_tuptable;
 			for (j = 0; j < SPI_processed; j++) {
-				tupdesc2 = SPI_tuptable->tupdesc;
-				tuptable2 = SPI_tuptable;
 				tuple2 = tuptable2->vals[j];
 
-				if (num_cash_txn > 0) {
-					strncat(values[i_cash_transaction_amount], ",",
-							length_cta--);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs "
-								   "to be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], ",", length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_name], ",",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to "
-								   "be increased");
-					}
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 1);
-				strncat(values[i_cash_transaction_amount], tmp, length_cta);
-				length_cta -= strlen(tmp);
-				if (length_cta < 0) {
-					FAIL_FRAME("cash_transaction_amount values needs to "
-							   "be increased");
-				}
-
-				strncat(values[i_cash_transaction_dts], "\"", length_ctd--);
-				if (length_ctd < 0) {
-					FAIL_FRAME("cash_transaction_dts values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 2);
-				strncat(values[i_cash_transaction_dts], tmp, length_ctd--);
-				length_ctd -= strlen(tmp);
-				if (length_ctd < 0) {
-					FAIL_FRAME("cash_transaction_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_dts], "\"", length_ctd--);
-				if (length_ctd < 0) {
-					FAIL_FRAME("cash_transaction_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_name], "\"", length_ctn--);
-				if (length_ctn < 0) {
-					FAIL_FRAME("cash_transaction_name values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 3);
-				strncat(values[i_cash_transaction_name], tmp, length_ctn);
-				length_ctn -= strlen(tmp);
-				if (length_ctn < 0) {
-					FAIL_FRAME("cash_transaction_name values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_name], "\"", length_ctn--);
-				if (length_ctn < 0) {
-					FAIL_FRAME("cash_transaction_name values needs to be "
-							   "increased");
-				}
-
-				++num_cash_txn;
+				push_frame_spi(&values, i_cash_transaction_amount, tuple2,
+						tupdesc2, 1);
+				push_frame_spi(
+						&values, i_cash_transaction_dts, tuple2, tupdesc2, 2);
+				push_frame_spi(
+						&values, i_cash_transaction_name, tuple2, tupdesc2, 3);
 			}
 
 			/*
@@ -2397,54 +1009,19 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 			 * positionally aligned with the trades when the trade is not
 			 * settled with cash.
 			 */
-			if (is_cash_str[0] != 't') {
-				if (num_cash_txn > 0) {
-					strncat(values[i_cash_transaction_amount], ",",
-							length_cta--);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs "
-								   "to be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], ",", length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_name], ",",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to "
-								   "be increased");
-					}
-				}
-				strncat(values[i_cash_transaction_amount], "0", length_cta--);
-				if (length_cta < 0) {
-					FAIL_FRAME("cash_transaction_amount values needs to "
-							   "be increased");
-				}
-
-				strncat(values[i_cash_transaction_dts], "NULL", length_ctd);
-				length_ctd -= 4;
-				if (length_ctd < 0) {
-					FAIL_FRAME("cash_transaction_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_name], "\"\"", length_ctn);
-				length_ctn -= 2;
-				if (length_ctn < 0) {
-					FAIL_FRAME("cash_transaction_name values needs to be "
-							   "increased");
-				}
-
-				++num_cash_txn;
+			if (!is_cash) {
+				push_frame_value(&values, i_cash_transaction_amount,
+						DirectFunctionCall1(int4_numeric, Int32GetDatum(0)),
+						false);
+				push_frame_value(
+						&values, i_cash_transaction_dts, (Datum) 0, true);
+				push_frame_value(&values, i_cash_transaction_name,
+						CStringGetTextDatum(""), false);
 			}
 
 #ifdef DEBUG
 			elog(DEBUG1, "SQLTLF3_4\n%s", SQLTLF3_4);
-			elog(DEBUG1, "$1 %s", trade_list_str);
+			elog(DEBUG1, "$1 %ld", DatumGetInt64(args[0]));
 #endif /* DEBUG */
 			ret = SPI_execute_plan(TLF3_4, args, nulls, true, 0);
 			if (ret != SPI_OK_SELECT) {
@@ -2457,67 +1034,13 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 			}
 			tupdesc2 = SPI_tuptable->tupdesc;
 			tuptable2 = SPI_tuptable;
-
 			for (j = 0; j < SPI_processed; j++) {
 				tuple2 = tuptable2->vals[j];
 
-				++num_trade_history;
-				if (num_trade_history > 1) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						FAIL_FRAME("trade_history_status_id values needs "
-								   "to be increased");
-					}
-				}
-
-				strncat(values[i_trade_history_dts], "\"", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME("trade_history_dts values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 1);
-				strncat(values[i_trade_history_dts], tmp, length_thd);
-				length_thd -= strlen(tmp);
-				if (length_thd < 0) {
-					FAIL_FRAME("trade_history_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_trade_history_dts], "\"", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME("trade_history_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_trade_history_status_id], "\"",
-						length_thsi--);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to "
-							   "be increased");
-				}
-
-				tmp = SPI_getvalue(tuple2, tupdesc2, 2);
-				strncat(values[i_trade_history_status_id], tmp, length_thsi);
-				length_thsi -= strlen(tmp);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to "
-							   "be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], "\"",
-						length_thsi--);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to "
-							   "be increased");
-				}
+				push_frame_spi(
+						&values, i_trade_history_dts, tuple2, tupdesc2, 1);
+				push_frame_spi(&values, i_trade_history_status_id, tuple2,
+						tupdesc2, 2);
 			}
 
 			/*
@@ -2526,139 +1049,13 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 			 * the array up to 3 all the time.
 			 */
 			for (j = SPI_processed; j < 3; j++) {
-				++num_trade_history;
-
-				if (num_trade_history > 1) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						FAIL_FRAME("trade_history_status_id values "
-								   "needs to be increased");
-					}
-				}
-				strncat(values[i_trade_history_dts], "NULL", length_thd);
-				length_thd -= 4;
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], "\"\"",
-						length_thsi);
-				length_thsi -= 2;
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs "
-							   "to be increased");
-				}
+				push_frame_value(
+						&values, i_trade_history_dts, (Datum) 0, true);
+				push_frame_value(&values, i_trade_history_status_id,
+						CStringGetTextDatum(""), false);
 			}
 		}
 
-		strncat(values[i_acct_id], "}", length_ai--);
-		if (length_ai < 0) {
-			FAIL_FRAME("acct_id values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_amount], "}", length_cta--);
-		if (length_cta < 0) {
-			FAIL_FRAME("cash_transaction_amount values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_cash_transaction_dts], "}", length_ctd--);
-		if (length_ctd < 0) {
-			FAIL_FRAME("cash_transaction_dts values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_name], "}", length_ctn--);
-		if (length_ctn < 0) {
-			FAIL_FRAME("cash_transaction_name values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_exec_name], "}", length_en--);
-		if (length_en < 0) {
-			FAIL_FRAME("exec_name values needs to be increased");
-		}
-
-		strncat(values[i_is_cash], "}", length_ic);
-		if (length_ic < 0) {
-			FAIL_FRAME("is_cash values needs to be increased");
-		}
-
-		strncat(values[i_price], "}", length_p--);
-		if (length_p < 0) {
-			FAIL_FRAME("price values needs to be increased");
-		}
-
-		strncat(values[i_quantity], "}", length_q--);
-		if (length_q < 0) {
-			FAIL_FRAME("quantity values needs to be increased");
-		}
-
-		strncat(values[i_settlement_amount], "}", length_sa--);
-		if (length_sa < 0) {
-			FAIL_FRAME("settlement_amount values needs to be increased");
-		}
-
-		strncat(values[i_settlement_cash_due_date], "}", length_scdd--);
-		if (length_scdd < 0) {
-			FAIL_FRAME("settlement_cash_due_date values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_settlement_cash_type], "}", length_sct--);
-		if (length_sct < 0) {
-			FAIL_FRAME("settlement_cash_type values needs to be increased");
-		}
-
-		strncat(values[i_trade_dts], "}", length_td--);
-		if (length_td < 0) {
-			FAIL_FRAME("trade_dts values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_dts], "}", length_thd--);
-		if (length_thd < 0) {
-			FAIL_FRAME("trade_history_dts values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_status_id], "}", length_thsi--);
-		if (length_thsi < 0) {
-			FAIL_FRAME("trade_history_status_id values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_trade_list], "}", length_tl--);
-		if (length_tl < 0) {
-			FAIL_FRAME("trade_list values needs to be increased");
-		}
-
-		strncat(values[i_trade_type], "}", length_tt--);
-		if (length_tt < 0) {
-			FAIL_FRAME("trade_type values needs to be increased");
-		}
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from
-		 * raw C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
-
 		MemoryContextSwitchTo(oldcontext);
 	}
 
@@ -2667,22 +1064,19 @@ TradeLookupFrame3(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 17; i++) {
-			elog(DEBUG1, "TLF3 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TLF3", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -2699,13 +1093,12 @@ Datum
 TradeLookupFrame4(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i;
 
-	char **values = NULL;
+	frame_result values;
 
 	enum tlf4
 	{
@@ -2725,10 +1118,12 @@ TradeLookupFrame4(PG_FUNCTION_ARGS)
 		long acct_id = PG_GETARG_INT64(0);
 		Timestamp start_trade_dts_ts = PG_GETARG_TIMESTAMP(1);
 
+#ifdef DEBUG
 		struct pg_tm tt, *tm = &tt;
 		fsec_t fsec;
 		char *tzn = NULL;
 		char start_trade_dts[MYMAXDATELEN + 1];
+#endif /* DEBUG */
 		int num_found_count = 0;
 		int num_trades_found_count = 0;
 		Datum args[2];
@@ -2739,44 +1134,17 @@ TradeLookupFrame4(PG_FUNCTION_ARGS)
 		SPITupleTable *tuptable = NULL;
 		HeapTuple tuple = NULL;
 
-		char *tmp;
-		int length_hhi, length_hhti, length_qa, length_qb;
-
+#ifdef DEBUG
 		if (timestamp2tm(start_trade_dts_ts, NULL, tm, &fsec, NULL, NULL)
 				== 0) {
 			EncodeDateTimeM(tm, fsec, tzn, start_trade_dts);
 		}
 
-#ifdef DEBUG
 		dump_tlf4_inputs(acct_id, start_trade_dts);
 #endif /* DEBUG */
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 7);
-
-		length_hhi = (TRADE_T_LEN + 1) * 20 + 2;
-		values[i_holding_history_id]
-				= (char *) palloc(length_hhi-- * sizeof(char));
-
-		length_hhti = (TRADE_T_LEN + 1) * 20 + 2;
-		values[i_holding_history_trade_id]
-				= (char *) palloc(length_hhti-- * sizeof(char));
-
-		values[i_num_found]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-		values[i_num_trades_found]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-
-		length_qa = (S_QTY_T_LEN + 1) * 20 + 2;
-		values[i_quantity_after] = (char *) palloc(length_qa-- * sizeof(char));
-
-		length_qb = (S_QTY_T_LEN + 1) * 20 + 2;
-		values[i_quantity_before]
-				= (char *) palloc(length_qb-- * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 		/* create a function context for cross-call persistence */
 		funcctx = SRF_FIRSTCALL_INIT();
@@ -2795,7 +1163,6 @@ TradeLookupFrame4(PG_FUNCTION_ARGS)
 		args[1] = TimestampGetDatum(start_trade_dts_ts);
 		ret = SPI_execute_plan(TLF4_1, args, nulls, true, 0);
 		if (ret != SPI_OK_SELECT) {
-			values[i_trade_id] = NULL;
 #ifdef DEBUG
 			dump_tlf4_inputs(acct_id, start_trade_dts);
 #endif /* DEBUG */
@@ -2805,17 +1172,16 @@ TradeLookupFrame4(PG_FUNCTION_ARGS)
 			tuptable = SPI_tuptable;
 			if (SPI_processed > 0) {
 				tuple = tuptable->vals[0];
-				values[i_trade_id] = SPI_getvalue(tuple, tupdesc, 1);
-			} else
-				values[i_trade_id] = NULL;
+				set_frame_spi(&values, i_trade_id, tuple, tupdesc, 1);
+			}
 			num_trades_found_count = SPI_processed;
 		}
 
-		if (values[i_trade_id] != NULL) {
+		if (!values.nulls[i_trade_id]) {
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTLF4_2);
 #endif /* DEBUG */
-			args[0] = Int64GetDatum(atoll(values[i_trade_id]));
+			args[0] = values.values[i_trade_id];
 			ret = SPI_execute_plan(TLF4_2, args, nulls, true, 0);
 			if (ret != SPI_OK_SELECT) {
 #ifdef DEBUG
@@ -2831,121 +1197,25 @@ TradeLookupFrame4(PG_FUNCTION_ARGS)
 		} else
 			num_found_count = 0;
 
-		snprintf(values[i_num_found], INTEGER_LEN + 1, "%d", num_found_count);
-		snprintf(values[i_num_trades_found], INTEGER_LEN + 1, "%d",
-				num_trades_found_count);
+		set_frame_value(
+				&values, i_num_found, Int32GetDatum(num_found_count), false);
+		set_frame_value(&values, i_num_trades_found,
+				Int32GetDatum(num_trades_found_count), false);
 #ifdef DEBUG
 		elog(DEBUG1, "num_found = %d", num_found_count);
 		elog(DEBUG1, "num_trades_found = %d", num_trades_found_count);
 #endif /* DEBUG */
 
-		values[i_holding_history_id][0] = '{';
-		values[i_holding_history_id][1] = '\0';
-
-		values[i_holding_history_trade_id][0] = '{';
-		values[i_holding_history_trade_id][1] = '\0';
-
-		values[i_quantity_after][0] = '{';
-		values[i_quantity_after][1] = '\0';
-
-		values[i_quantity_before][0] = '{';
-		values[i_quantity_before][1] = '\0';
-
 		for (i = 0; i < num_found_count; i++) {
 			tuple = tuptable->vals[i];
-			if (i > 0) {
-				strncat(values[i_holding_history_id], ",", length_hhi--);
-				if (length_hhi < 0) {
-					FAIL_FRAME("holding_history_id values needs to be "
-							   "increased");
-				}
 
-				strncat(values[i_holding_history_trade_id], ",",
-						length_hhti--);
-				if (length_hhti < 0) {
-					FAIL_FRAME("holding_history_trade_id values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_quantity_after], ",", length_qa--);
-				if (length_qa < 0) {
-					FAIL_FRAME("quantify_after values needs to be increased");
-				}
-
-				strncat(values[i_quantity_before], ",", length_qb--);
-				if (length_qb < 0) {
-					FAIL_FRAME("quantify_before values needs to be "
-							   "increased");
-				}
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_holding_history_id], tmp, length_hhi);
-			length_hhi -= strlen(tmp);
-			if (length_hhi < 0) {
-				FAIL_FRAME("holding_history_id values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_holding_history_trade_id], tmp, length_hhti);
-			length_hhti -= strlen(tmp);
-			if (length_hhti < 0) {
-				FAIL_FRAME("holding_history_trade_id values needs to be "
-						   "increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 3);
-			strncat(values[i_quantity_before], tmp, length_qb);
-			length_qb -= strlen(tmp);
-			if (length_qb < 0) {
-				FAIL_FRAME("quantify_before values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 4);
-			strncat(values[i_quantity_after], tmp, length_qa);
-			length_qa -= strlen(tmp);
-			if (length_qa < 0) {
-				FAIL_FRAME("quantify_after values needs to be increased");
-			}
-		}
-
-		strncat(values[i_holding_history_id], "}", length_hhi--);
-		if (length_hhi < 0) {
-			FAIL_FRAME("holding_history_id values needs to be increased");
+			push_frame_spi(&values, i_holding_history_id, tuple, tupdesc, 1);
+			push_frame_spi(
+					&values, i_holding_history_trade_id, tuple, tupdesc, 2);
+			push_frame_spi(&values, i_quantity_before, tuple, tupdesc, 3);
+			push_frame_spi(&values, i_quantity_after, tuple, tupdesc, 4);
 		}
 
-		strncat(values[i_holding_history_trade_id], "}", length_hhti--);
-		if (length_hhti < 0) {
-			FAIL_FRAME("holding_history_trade_id values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_quantity_after], "}", length_qa--);
-		if (length_qa < 0) {
-			FAIL_FRAME("quantify_after values needs to be increased");
-		}
-
-		strncat(values[i_quantity_before], "}", length_qb--);
-		if (length_qb < 0) {
-			FAIL_FRAME("quantify_before values needs to be increased");
-		}
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from
-		 * raw C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
-
 		MemoryContextSwitchTo(oldcontext);
 	}
 
@@ -2954,22 +1224,19 @@ TradeLookupFrame4(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 7; i++) {
-			elog(DEBUG1, "TLF4 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TLF4", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -392,15 +392,10 @@ Datum
 TradeOrderFrame1(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
-#ifdef DEBUG
-	int i;
-#endif /* DEBUG */
-
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -428,13 +423,10 @@ TradeOrderFrame1(PG_FUNCTION_ARGS)
 		HeapTuple tuple = NULL;
 		Datum args[1];
 		char nulls[1] = { ' ' };
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc0(sizeof(char *) * 10);
-		values[i_num_found] = (char *) palloc((BIGINT_LEN + 1) * sizeof(char));
+		bool isnull;
+
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 #ifdef DEBUG
 		dump_tof1_inputs(acct_id);
@@ -458,49 +450,52 @@ TradeOrderFrame1(PG_FUNCTION_ARGS)
 
 		ret = SPI_execute_plan(TOF1_1, args, nulls, true, 0);
 		if (ret == SPI_OK_SELECT && SPI_processed > 0) {
+			Datum broker_id;
+
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
-			values[i_acct_name] = SPI_getvalue(tuple, tupdesc, 1);
-			values[i_broker_id] = SPI_getvalue(tuple, tupdesc, 2);
-			values[i_cust_id] = SPI_getvalue(tuple, tupdesc, 3);
-			values[i_tax_status] = SPI_getvalue(tuple, tupdesc, 4);
-			snprintf(values[i_num_found], BIGINT_LEN + 1, "%" PRId64,
-					SPI_processed);
+			set_frame_spi(&values, i_acct_name, tuple, tupdesc, 1);
+			set_frame_spi(&values, i_broker_id, tuple, tupdesc, 2);
+			set_frame_spi(&values, i_cust_id, tuple, tupdesc, 3);
+			set_frame_spi(&values, i_tax_status, tuple, tupdesc, 4);
+			set_frame_value(&values, i_num_found,
+					Int32GetDatum((int32) SPI_processed), false);
+			broker_id = SPI_getbinval(tuple, tupdesc, 2, &isnull);
 
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTOF1_2);
 #endif /* DEBUG */
-			args[0] = Int64GetDatum(atoll(values[i_cust_id]));
+			args[0] = SPI_getbinval(tuple, tupdesc, 3, &isnull);
 
 			ret = SPI_execute_plan(TOF1_2, args, nulls, true, 0);
 			if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				values[i_cust_f_name] = SPI_getvalue(tuple, tupdesc, 1);
-				values[i_cust_l_name] = SPI_getvalue(tuple, tupdesc, 2);
-				values[i_cust_tier] = SPI_getvalue(tuple, tupdesc, 3);
-				values[i_tax_id] = SPI_getvalue(tuple, tupdesc, 4);
+				set_frame_spi(&values, i_cust_f_name, tuple, tupdesc, 1);
+				set_frame_spi(&values, i_cust_l_name, tuple, tupdesc, 2);
+				set_frame_spi(&values, i_cust_tier, tuple, tupdesc, 3);
+				set_frame_spi(&values, i_tax_id, tuple, tupdesc, 4);
 			} else {
 				FAIL_FRAME(TOF1_statements[1].sql);
-				snprintf(values[i_num_found], BIGINT_LEN + 1, "0");
+				set_frame_value(&values, i_num_found, Int32GetDatum(0), false);
 			}
 
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTOF1_3);
 #endif /* DEBUG */
-			args[0] = Int64GetDatum(atoll(values[i_broker_id]));
+			args[0] = broker_id;
 
 			ret = SPI_execute_plan(TOF1_3, args, nulls, true, 0);
 			if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				values[i_broker_name] = SPI_getvalue(tuple, tupdesc, 1);
+				set_frame_spi(&values, i_broker_name, tuple, tupdesc, 1);
 			} else {
 				FAIL_FRAME(TOF1_statements[2].sql);
-				snprintf(values[i_num_found], BIGINT_LEN + 1, "0");
+				set_frame_value(&values, i_num_found, Int32GetDatum(0), false);
 			}
 		} else {
 			/*
@@ -509,25 +504,9 @@ TradeOrderFrame1(PG_FUNCTION_ARGS)
 			 * result set.
 			 */
 			FAIL_FRAME(TOF1_statements[0].sql);
-			snprintf(values[i_num_found], BIGINT_LEN + 1, "0");
-		}
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
+			set_frame_value(&values, i_num_found, Int32GetDatum(0), false);
 		}
 
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
-
 		MemoryContextSwitchTo(oldcontext);
 	}
 
@@ -536,22 +515,19 @@ TradeOrderFrame1(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 10; i++) {
-			elog(DEBUG1, "TOF1 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TOF1", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -653,7 +629,6 @@ Datum
 TradeOrderFrame3(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
@@ -677,7 +652,7 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 		i_type_is_sell
 	};
 
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -700,8 +675,6 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 
 		char co_name[CO_NAME_LEN + 1];
 		char issue[7];
-		char st_pending_id[10];
-		char st_submitted_id[10];
 		char trade_type_id[TT_ID_LEN + 1];
 		char symbol[S_SYMB_LEN + 1];
 		double requested_price;
@@ -709,13 +682,17 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 		int needed_qty;
 		double buy_value = 0;
 		double sell_value = 0;
-		char *exch_id = NULL;
+		double cust_assets = 0;
+		bool type_is_market;
+		bool type_is_sell;
+		Datum exch_id;
+		bool isnull;
 
 		int ret;
 		TupleDesc tupdesc;
 		SPITupleTable *tuptable = NULL;
 		HeapTuple tuple = NULL;
-		char *co_id = NULL;
+		Datum co_id;
 		double tax_amount = 0;
 		Datum args[5];
 		char nulls[5] = { ' ', ' ', ' ', ' ', ' ' };
@@ -730,16 +707,6 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 						textout, PointerGetDatum(issue_p))),
 				sizeof(issue));
 		issue[sizeof(issue) - 1] = '\0';
-		strncpy(st_pending_id,
-				DatumGetCString(DirectFunctionCall1(
-						textout, PointerGetDatum(st_pending_id_p))),
-				sizeof(st_pending_id));
-		st_pending_id[sizeof(st_pending_id) - 1] = '\0';
-		strncpy(st_submitted_id,
-				DatumGetCString(DirectFunctionCall1(
-						textout, PointerGetDatum(st_submitted_id_p))),
-				sizeof(st_submitted_id));
-		st_submitted_id[sizeof(st_submitted_id) - 1] = '\0';
 		strncpy(trade_type_id,
 				DatumGetCString(DirectFunctionCall1(
 						textout, PointerGetDatum(trade_type_id_p))),
@@ -755,32 +722,14 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 				DirectFunctionCall1(numeric_float8_no_overflow,
 						PointerGetDatum(requested_price_num)));
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 14);
-		values[i_requested_price]
-				= (char *) palloc((S_PRICE_T_LEN + 1) * sizeof(char));
-		values[i_buy_value]
-				= (char *) palloc((S_PRICE_T_LEN + 1) * sizeof(char));
-		values[i_cust_assets]
-				= (char *) palloc((FIN_AGG_T_LEN + 1) * sizeof(char));
-		values[i_sell_value]
-				= (char *) palloc((S_PRICE_T_LEN + 1) * sizeof(char));
-		values[i_tax_amount]
-				= (char *) palloc((S_PRICE_T_LEN + 1) * sizeof(char));
-		values[i_type_is_market] = (char *) palloc((2) * sizeof(char));
-		values[i_type_is_sell] = (char *) palloc((2) * sizeof(char));
-
-		values[i_symbol] = NULL;
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
+		set_frame_value(&values, i_requested_price,
+				NumericGetDatum(requested_price_num), false);
 
 		/* create a function context for cross-call persistence */
 		funcctx = SRF_FIRSTCALL_INIT();
 		funcctx->max_calls = 1;
-		snprintf(values[i_requested_price], S_PRICE_T_LEN + 1, "%8.2f",
-				requested_price);
 
 		/* switch to memory context appropriate for multiple function calls */
 		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
@@ -789,7 +738,8 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 		plan_queries(TOF3_statements);
 
 		if (strlen(symbol) == 0) {
-			values[i_co_name] = pstrdup(co_name);
+			set_frame_value(
+					&values, i_co_name, PointerGetDatum(co_name_p), false);
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTOF3_1a);
 #endif /* DEBUG */
@@ -800,7 +750,7 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				co_id = SPI_getvalue(tuple, tupdesc, 1);
+				co_id = SPI_getbinval(tuple, tupdesc, 1, &isnull);
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[0].sql);
 
@@ -811,7 +761,7 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTOF3_2a);
 #endif /* DEBUG */
-			args[0] = Int64GetDatum(atoll(co_id));
+			args[0] = co_id;
 			args[1] = CStringGetTextDatum(issue);
 
 			ret = SPI_execute_plan(TOF3_2a, args, nulls, true, 0);
@@ -819,9 +769,9 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				exch_id = SPI_getvalue(tuple, tupdesc, 1);
-				values[i_s_name] = SPI_getvalue(tuple, tupdesc, 2);
-				values[i_symbol] = SPI_getvalue(tuple, tupdesc, 3);
+				exch_id = SPI_getbinval(tuple, tupdesc, 1, &isnull);
+				set_frame_spi(&values, i_s_name, tuple, tupdesc, 2);
+				set_frame_spi(&values, i_symbol, tuple, tupdesc, 3);
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[1].sql);
 
@@ -829,7 +779,8 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 				SRF_RETURN_DONE(funcctx);
 			}
 		} else {
-			values[i_symbol] = symbol;
+			set_frame_value(
+					&values, i_symbol, PointerGetDatum(symbol_p), false);
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTOF3_1b);
 #endif /* DEBUG */
@@ -840,9 +791,9 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				co_id = SPI_getvalue(tuple, tupdesc, 1);
-				exch_id = SPI_getvalue(tuple, tupdesc, 2);
-				values[i_s_name] = SPI_getvalue(tuple, tupdesc, 3);
+				co_id = SPI_getbinval(tuple, tupdesc, 1, &isnull);
+				exch_id = SPI_getbinval(tuple, tupdesc, 2, &isnull);
+				set_frame_spi(&values, i_s_name, tuple, tupdesc, 3);
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[2].sql);
 
@@ -853,14 +804,14 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTOF3_2b);
 #endif /* DEBUG */
-			args[0] = Int64GetDatum(atoll(co_id));
+			args[0] = co_id;
 
 			ret = SPI_execute_plan(TOF3_2b, args, nulls, true, 0);
 			if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				values[i_co_name] = SPI_getvalue(tuple, tupdesc, 1);
+				set_frame_spi(&values, i_co_name, tuple, tupdesc, 1);
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[3].sql);
 
@@ -872,14 +823,14 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 #ifdef DEBUG
 		elog(DEBUG1, "%s", SQLTOF3_3);
 #endif /* DEBUG */
-		args[0] = CStringGetTextDatum(values[i_symbol]);
+		args[0] = values.values[i_symbol];
 
 		ret = SPI_execute_plan(TOF3_3, args, nulls, true, 0);
 		if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
-			values[i_market_price] = SPI_getvalue(tuple, tupdesc, 1);
+			set_frame_spi(&values, i_market_price, tuple, tupdesc, 1);
 		} else {
 			FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[4].sql);
 
@@ -898,19 +849,14 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
 
-			if (SPI_getvalue(tuple, tupdesc, 1)[0] == 'f') {
-				values[i_type_is_market][0] = '0';
-			} else {
-				values[i_type_is_market][0] = '1';
-			}
-			values[i_type_is_market][1] = '\0';
-
-			if (SPI_getvalue(tuple, tupdesc, 2)[0] == 'f') {
-				values[i_type_is_sell][0] = '0';
-			} else {
-				values[i_type_is_sell][0] = '1';
-			}
-			values[i_type_is_sell][1] = '\0';
+			type_is_market
+					= DatumGetBool(SPI_getbinval(tuple, tupdesc, 1, &isnull));
+			type_is_sell
+					= DatumGetBool(SPI_getbinval(tuple, tupdesc, 2, &isnull));
+			set_frame_value(&values, i_type_is_market,
+					Int16GetDatum(type_is_market), false);
+			set_frame_value(&values, i_type_is_sell,
+					Int16GetDatum(type_is_sell), false);
 		} else {
 			FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[5].sql);
 
@@ -918,9 +864,12 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 			SRF_RETURN_DONE(funcctx);
 		}
 
-		if (values[i_type_is_market][0] == '1') {
-			values[i_requested_price] = values[i_market_price];
-			requested_price = atof(values[i_market_price]);
+		if (type_is_market) {
+			set_frame_value(&values, i_requested_price,
+					values.values[i_market_price], false);
+			requested_price = DatumGetFloat8(
+					DirectFunctionCall1(numeric_float8_no_overflow,
+							values.values[i_market_price]));
 		}
 
 		needed_qty = trade_qty;
@@ -929,24 +878,24 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 		elog(DEBUG1, "%s", SQLTOF3_5);
 #endif /* DEBUG */
 		args[0] = Int64GetDatum(acct_id);
-		args[1] = CStringGetTextDatum(values[i_symbol]);
+		args[1] = values.values[i_symbol];
 
 		ret = SPI_execute_plan(TOF3_5, args, nulls, true, 0);
 		if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
-			hs_qty = atoi(SPI_getvalue(tuple, tupdesc, 1));
+			hs_qty = DatumGetInt32(SPI_getbinval(tuple, tupdesc, 1, &isnull));
 		} else {
 			hs_qty = 0;
 		}
 
-		if (values[i_type_is_sell][0] == '1') {
+		if (type_is_sell) {
 			int rows = 0;
 
 			if (hs_qty > 0) {
 				args[0] = Int64GetDatum(acct_id);
-				args[1] = CStringGetTextDatum(values[i_symbol]);
+				args[1] = values.values[i_symbol];
 				if (is_lifo == 1) {
 #ifdef DEBUG
 					elog(DEBUG1, "%s", SQLTOF3_6a);
@@ -977,8 +926,11 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 				double hold_price;
 
 				tuple = tuptable->vals[i];
-				hold_qty = atoi(SPI_getvalue(tuple, tupdesc, 1));
-				hold_price = atof(SPI_getvalue(tuple, tupdesc, 2));
+				hold_qty = DatumGetInt32(
+						SPI_getbinval(tuple, tupdesc, 1, &isnull));
+				hold_price = DatumGetFloat8(
+						DirectFunctionCall1(numeric_float8_no_overflow,
+								SPI_getbinval(tuple, tupdesc, 2, &isnull)));
 				if (hold_qty > needed_qty) {
 					buy_value += needed_qty * hold_price;
 					sell_value += needed_qty * requested_price;
@@ -995,7 +947,7 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 
 			if (hs_qty < 0) {
 				args[0] = Int64GetDatum(acct_id);
-				args[1] = CStringGetTextDatum(values[i_symbol]);
+				args[1] = values.values[i_symbol];
 				if (is_lifo == 1) {
 #ifdef DEBUG
 					elog(DEBUG1, "%s", SQLTOF3_6a);
@@ -1026,8 +978,11 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 				double hold_price;
 
 				tuple = tuptable->vals[i];
-				hold_qty = atoi(SPI_getvalue(tuple, tupdesc, 1));
-				hold_price = atof(SPI_getvalue(tuple, tupdesc, 2));
+				hold_qty = DatumGetInt32(
+						SPI_getbinval(tuple, tupdesc, 1, &isnull));
+				hold_price = DatumGetFloat8(
+						DirectFunctionCall1(numeric_float8_no_overflow,
+								SPI_getbinval(tuple, tupdesc, 2, &isnull)));
 				if (hold_qty + needed_qty < 0) {
 					sell_value += needed_qty * hold_price;
 					buy_value += needed_qty * requested_price;
@@ -1042,9 +997,10 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 			}
 		}
 
-		snprintf(values[i_buy_value], S_PRICE_T_LEN + 1, "%8.2f", buy_value);
-		snprintf(values[i_sell_value], S_PRICE_T_LEN + 1, "%8.2f",
-				sell_value);
+		set_frame_value(&values, i_buy_value,
+				float8_numeric_round(buy_value, 2), false);
+		set_frame_value(&values, i_sell_value,
+				float8_numeric_round(sell_value, 2), false);
 
 		if (sell_value > buy_value && (tax_status == 1 || tax_status == 2)) {
 #ifdef DEBUG
@@ -1054,28 +1010,31 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 
 			ret = SPI_execute_plan(TOF3_7, args, nulls, true, 0);
 			if (ret == SPI_OK_SELECT && SPI_processed > 0) {
-				char *tax_rates;
+				Datum tax_rates;
 
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				tax_rates = SPI_getvalue(tuple, tupdesc, 1);
-				if (tax_rates != NULL) {
-					tax_amount = (sell_value - buy_value) * atof(tax_rates);
+				tax_rates = SPI_getbinval(tuple, tupdesc, 1, &isnull);
+				if (!isnull) {
+					tax_amount = (sell_value - buy_value)
+								 * DatumGetFloat8(DirectFunctionCall1(
+										 numeric_float8_no_overflow,
+										 tax_rates));
 				}
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[9].sql);
 			}
 		}
-		snprintf(values[i_tax_amount], S_PRICE_T_LEN + 1, "%8.2f",
-				tax_amount);
+		set_frame_value(&values, i_tax_amount,
+				float8_numeric_round(tax_amount, 2), false);
 
 #ifdef DEBUG
 		elog(DEBUG1, "%s", SQLTOF3_8);
 #endif /* DEBUG */
 		args[0] = Int16GetDatum(cust_tier);
 		args[1] = CStringGetTextDatum(trade_type_id);
-		args[2] = CStringGetTextDatum(exch_id);
+		args[2] = exch_id;
 		args[3] = Int32GetDatum(trade_qty);
 		args[4] = Int32GetDatum(trade_qty);
 
@@ -1084,7 +1043,7 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
-			values[i_comm_rate] = SPI_getvalue(tuple, tupdesc, 1);
+			set_frame_spi(&values, i_comm_rate, tuple, tupdesc, 1);
 		} else {
 			FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[10].sql);
 		}
@@ -1100,12 +1059,11 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
-			values[i_charge_amount] = SPI_getvalue(tuple, tupdesc, 1);
+			set_frame_spi(&values, i_charge_amount, tuple, tupdesc, 1);
 		} else {
 			FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[11].sql);
 		}
 
-		strncpy(values[i_cust_assets], "0.00", 5);
 		if (type_is_margin == 1) {
 			double acct_bal = 0;
 
@@ -1119,7 +1077,9 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				acct_bal = atof(SPI_getvalue(tuple, tupdesc, 1));
+				acct_bal = DatumGetFloat8(
+						DirectFunctionCall1(numeric_float8_no_overflow,
+								SPI_getbinval(tuple, tupdesc, 1, &isnull)));
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[12].sql);
 			}
@@ -1129,47 +1089,37 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 #endif /* DEBUG */
 			ret = SPI_execute_plan(TOF3_11, args, nulls, true, 0);
 			if (ret == SPI_OK_SELECT && SPI_processed > 0) {
-				char *hold_assets;
+				Datum hold_assets;
 
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				hold_assets = SPI_getvalue(tuple, tupdesc, 1);
-				if (hold_assets == NULL) {
+				hold_assets = SPI_getbinval(tuple, tupdesc, 1, &isnull);
+				if (isnull) {
 					/* The account currently has no holdings. */
-					snprintf(values[i_cust_assets], FIN_AGG_T_LEN + 1,
-							"%10.2f", acct_bal);
+					cust_assets = acct_bal;
 				} else {
-					snprintf(values[i_cust_assets], FIN_AGG_T_LEN + 1,
-							"%10.2f", atof(hold_assets) + acct_bal);
+					cust_assets = DatumGetFloat8(DirectFunctionCall1(
+										  numeric_float8_no_overflow,
+										  hold_assets))
+								  + acct_bal;
 				}
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TOF3_statements[13].sql);
 			}
 		}
 
-		if (values[i_type_is_market][0] == '1') {
-			values[i_status_id] = st_submitted_id;
-		} else {
-			values[i_status_id] = st_pending_id;
-		}
+		set_frame_value(&values, i_cust_assets,
+				float8_numeric_round(cust_assets, 2), false);
 
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
+		if (type_is_market) {
+			set_frame_value(&values, i_status_id,
+					PointerGetDatum(st_submitted_id_p), false);
+		} else {
+			set_frame_value(&values, i_status_id,
+					PointerGetDatum(st_pending_id_p), false);
 		}
 
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
-
 		MemoryContextSwitchTo(oldcontext);
 	}
 
@@ -1178,22 +1128,19 @@ TradeOrderFrame3(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 14; i++) {
-			elog(DEBUG1, "TOF3 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TOF3", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
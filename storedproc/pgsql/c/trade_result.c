@@ -13,7 +13,6 @@
 #include <postgres.h>
 #include <fmgr.h>
 #include <math.h>
-#include <time.h>
 #include <executor/spi.h> /* this should include most necessary APIs */
 #include <executor/executor.h> /* for GetAttributeByName() */
 #include <funcapi.h> /* for returning set of rows in order_status */
@@ -500,16 +499,11 @@ Datum
 TradeResultFrame1(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 	int num_found = 0;
 
-#ifdef DEBUG
-	int i;
-#endif /* DEBUG */
-
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -539,14 +533,10 @@ TradeResultFrame1(PG_FUNCTION_ARGS)
 		HeapTuple tuple = NULL;
 		Datum args[2];
 		char nulls[2] = { ' ', ' ' };
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 12);
-		values[i_num_found]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
+		bool isnull;
+
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 #ifdef DEBUG
 		dump_trf1_inputs(trade_id);
@@ -572,29 +562,29 @@ TradeResultFrame1(PG_FUNCTION_ARGS)
 			num_found = SPI_processed;
 			if (SPI_processed > 0) {
 				tuple = tuptable->vals[0];
-				values[i_acct_id] = SPI_getvalue(tuple, tupdesc, 1);
-				values[i_type_id] = SPI_getvalue(tuple, tupdesc, 2);
-				values[i_symbol] = SPI_getvalue(tuple, tupdesc, 3);
-				values[i_trade_qty] = SPI_getvalue(tuple, tupdesc, 4);
-				values[i_charge] = SPI_getvalue(tuple, tupdesc, 5);
-				values[i_is_lifo] = SPI_getvalue(tuple, tupdesc, 6);
-				values[i_trade_is_cash] = SPI_getvalue(tuple, tupdesc, 7);
+				set_frame_spi(&values, i_acct_id, tuple, tupdesc, 1);
+				set_frame_spi(&values, i_type_id, tuple, tupdesc, 2);
+				set_frame_spi(&values, i_symbol, tuple, tupdesc, 3);
+				set_frame_spi(&values, i_trade_qty, tuple, tupdesc, 4);
+				set_frame_spi(&values, i_charge, tuple, tupdesc, 5);
+				set_frame_spi(&values, i_is_lifo, tuple, tupdesc, 6);
+				set_frame_spi(&values, i_trade_is_cash, tuple, tupdesc, 7);
 
 #ifdef DEBUG
 				elog(DEBUG1, "%s", SQLTRF1_2);
 #endif /* DEBUG */
-				args[0] = CStringGetTextDatum(values[i_type_id]);
+				args[0] = SPI_getbinval(tuple, tupdesc, 2, &isnull);
 				ret = SPI_execute_plan(TRF1_2, args, nulls, true, 0);
 				if (ret == SPI_OK_SELECT) {
 					tupdesc = SPI_tuptable->tupdesc;
 					tuptable = SPI_tuptable;
 					if (SPI_processed > 0) {
 						tuple = tuptable->vals[0];
-						values[i_type_name] = SPI_getvalue(tuple, tupdesc, 1);
-						values[i_type_is_sell]
-								= SPI_getvalue(tuple, tupdesc, 2);
-						values[i_type_is_market]
-								= SPI_getvalue(tuple, tupdesc, 3);
+						set_frame_spi(&values, i_type_name, tuple, tupdesc, 1);
+						set_frame_spi(
+								&values, i_type_is_sell, tuple, tupdesc, 2);
+						set_frame_spi(
+								&values, i_type_is_market, tuple, tupdesc, 3);
 					} else {
 						FAIL_FRAME_SET(
 								&funcctx->max_calls, TRF1_statements[1].sql);
@@ -607,8 +597,8 @@ TradeResultFrame1(PG_FUNCTION_ARGS)
 #ifdef DEBUG
 				elog(DEBUG1, "%s", SQLTRF1_3);
 #endif /* DEBUG */
-				args[0] = Int64GetDatum(atoll(values[i_acct_id]));
-				args[1] = CStringGetTextDatum(values[i_symbol]);
+				args[0] = values.values[i_acct_id];
+				args[1] = values.values[i_symbol];
 				ret = SPI_execute_plan(TRF1_3, args, nulls, true, 0);
 				if (ret != SPI_OK_SELECT) {
 					FAIL_FRAME_SET(
@@ -618,59 +608,40 @@ TradeResultFrame1(PG_FUNCTION_ARGS)
 					tuptable = SPI_tuptable;
 					if (SPI_processed > 0) {
 						tuple = tuptable->vals[0];
-						values[i_hs_qty] = SPI_getvalue(tuple, tupdesc, 1);
+						set_frame_spi(&values, i_hs_qty, tuple, tupdesc, 1);
 					} else {
-						values[i_hs_qty] = (char *) palloc(sizeof(char) * 2);
-						strncpy(values[i_hs_qty], "0", 2);
+						set_frame_value(
+								&values, i_hs_qty, Int32GetDatum(0), false);
 					}
 				}
 			} else if (SPI_processed == 0) {
-				values[i_acct_id] = (char *) palloc(2 * sizeof(char));
-				strncpy(values[i_acct_id], "0", 2);
-				values[i_type_id] = (char *) palloc(sizeof(char));
-				values[i_type_id][0] = '\0';
-				values[i_symbol] = (char *) palloc(sizeof(char));
-				values[i_symbol][0] = '\0';
-				values[i_trade_qty] = (char *) palloc(2 * sizeof(char));
-				strncpy(values[i_trade_qty], "0", 2);
-				values[i_charge] = (char *) palloc(2 * sizeof(char));
-				strncpy(values[i_charge], "0", 2);
-				values[i_is_lifo] = (char *) palloc(2 * sizeof(char));
-				strncpy(values[i_is_lifo], "0", 2);
-				values[i_trade_is_cash] = (char *) palloc(2 * sizeof(char));
-				strncpy(values[i_trade_is_cash], "0", 2);
-
-				values[i_type_name] = (char *) palloc(sizeof(char));
-				values[i_type_name][0] = '\0';
-				values[i_type_is_sell] = (char *) palloc(2 * sizeof(char));
-				strncpy(values[i_type_is_sell], "0", 2);
-				values[i_type_is_market] = (char *) palloc(2 * sizeof(char));
-				strncpy(values[i_type_is_market], "0", 2);
-
-				values[i_hs_qty] = (char *) palloc(sizeof(char) * 2);
-				strncpy(values[i_hs_qty], "0", 2);
+				set_frame_value(&values, i_acct_id, Int64GetDatum(0), false);
+				set_frame_value(
+						&values, i_type_id, CStringGetTextDatum(""), false);
+				set_frame_value(
+						&values, i_symbol, CStringGetTextDatum(""), false);
+				set_frame_value(&values, i_trade_qty, Int32GetDatum(0), false);
+				set_frame_value(&values, i_charge,
+						DirectFunctionCall1(int4_numeric, Int32GetDatum(0)),
+						false);
+				set_frame_value(&values, i_is_lifo, Int16GetDatum(0), false);
+				set_frame_value(
+						&values, i_trade_is_cash, Int16GetDatum(0), false);
+
+				set_frame_value(
+						&values, i_type_name, CStringGetTextDatum(""), false);
+				set_frame_value(
+						&values, i_type_is_sell, Int16GetDatum(0), false);
+				set_frame_value(
+						&values, i_type_is_market, Int16GetDatum(0), false);
+
+				set_frame_value(&values, i_hs_qty, Int32GetDatum(0), false);
 			}
 		} else {
 			FAIL_FRAME_SET(&funcctx->max_calls, TRF1_statements[0].sql);
 		}
 
-		snprintf(values[i_num_found], INTEGER_LEN + 1, "%d", num_found);
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
+		set_frame_value(&values, i_num_found, Int32GetDatum(num_found), false);
 
 		MemoryContextSwitchTo(oldcontext);
 	}
@@ -680,22 +651,19 @@ TradeResultFrame1(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 12; i++) {
-			elog(DEBUG1, "TRF1 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TRF1", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -712,13 +680,12 @@ Datum
 TradeResultFrame2(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i, n;
 
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -758,6 +725,7 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 
 		double buy_value = 0;
 		double sell_value = 0;
+		bool isnull;
 
 		strncpy(symbol,
 				DatumGetCString(DirectFunctionCall1(
@@ -767,16 +735,8 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 		trade_price = DatumGetFloat8(DirectFunctionCall1(
 				numeric_float8_no_overflow, PointerGetDatum(trade_price_num)));
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 6);
-		values[i_buy_value]
-				= (char *) palloc((S_PRICE_T_LEN + 1) * sizeof(char));
-		values[i_sell_value]
-				= (char *) palloc((S_PRICE_T_LEN + 1) * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 #ifdef DEBUG
 		dump_trf2_inputs(acct_id, hs_qty, is_lifo, symbol, trade_id,
@@ -802,7 +762,7 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
-			values[i_trade_dts] = SPI_getvalue(tuple, tupdesc, 1);
+			set_frame_spi(&values, i_trade_dts, tuple, tupdesc, 1);
 		} else {
 			FAIL_FRAME_SET(&funcctx->max_calls, sql);
 		}
@@ -818,9 +778,9 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
-			values[i_broker_id] = SPI_getvalue(tuple, tupdesc, 1);
-			values[i_cust_id] = SPI_getvalue(tuple, tupdesc, 2);
-			values[i_tax_status] = SPI_getvalue(tuple, tupdesc, 3);
+			set_frame_spi(&values, i_broker_id, tuple, tupdesc, 1);
+			set_frame_spi(&values, i_cust_id, tuple, tupdesc, 2);
+			set_frame_spi(&values, i_tax_status, tuple, tupdesc, 3);
 		}
 
 		/* Determine if sell or buy order */
@@ -891,9 +851,13 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 					double hold_price;
 
 					tuple = tuptable->vals[i++];
-					hold_id = atoll(SPI_getvalue(tuple, tupdesc, 1));
-					hold_qty = atoi(SPI_getvalue(tuple, tupdesc, 2));
-					hold_price = atof(SPI_getvalue(tuple, tupdesc, 3));
+					hold_id = DatumGetInt64(
+							SPI_getbinval(tuple, tupdesc, 1, &isnull));
+					hold_qty = DatumGetInt32(
+							SPI_getbinval(tuple, tupdesc, 2, &isnull));
+					hold_price = DatumGetFloat8(DirectFunctionCall1(
+							numeric_float8_no_overflow,
+							SPI_getbinval(tuple, tupdesc, 3, &isnull)));
 
 					if (hold_qty > needed_qty) {
 						/* Selling some of the holdings */
@@ -964,10 +928,6 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 			 */
 
 			if (needed_qty > 0) {
-				struct tm tm;
-				struct pg_tm tt;
-				Timestamp dt;
-
 #ifdef DEBUG
 				elog(DEBUG1, "%s", SQLTRF2_4a);
 #endif /* DEBUG */
@@ -987,23 +947,11 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 				args[1] = Int64GetDatum(acct_id);
 				args[2] = CStringGetTextDatum(symbol);
 
-				memset(&tm, 0, sizeof(tm));
-				if (strptime(values[i_trade_dts], "%Y-%m-%d %H:%M:%S", &tm)
-						== NULL) {
+				if (values.nulls[i_trade_dts]) {
 					FAIL_FRAME_SET(
 							&funcctx->max_calls, TRF2_statements[8].sql);
 				} else {
-					tt.tm_year = tm.tm_year - 1900;
-					tt.tm_mon = tm.tm_mon - 1;
-					tt.tm_mday = tm.tm_mday;
-					tt.tm_hour = tm.tm_hour;
-					tt.tm_min = tm.tm_min;
-					tt.tm_sec = tm.tm_sec;
-					tt.tm_isdst = tm.tm_isdst;
-					tt.tm_gmtoff = tm.tm_gmtoff;
-					tt.tm_zone = tm.tm_zone;
-					tm2timestamp(&tt, 0, NULL, &dt);
-					args[3] = TimestampGetDatum(dt);
+					args[3] = values.values[i_trade_dts];
 
 					args[4] = Float8GetDatum(trade_price);
 					args[5] = Int32GetDatum(-1 * needed_qty);
@@ -1094,9 +1042,13 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 					double hold_price;
 
 					tuple = tuptable->vals[i++];
-					hold_id = atoll(SPI_getvalue(tuple, tupdesc, 1));
-					hold_qty = atoi(SPI_getvalue(tuple, tupdesc, 2));
-					hold_price = atof(SPI_getvalue(tuple, tupdesc, 3));
+					hold_id = DatumGetInt64(
+							SPI_getbinval(tuple, tupdesc, 1, &isnull));
+					hold_qty = DatumGetInt32(
+							SPI_getbinval(tuple, tupdesc, 2, &isnull));
+					hold_price = DatumGetFloat8(DirectFunctionCall1(
+							numeric_float8_no_overflow,
+							SPI_getbinval(tuple, tupdesc, 3, &isnull)));
 
 					if (hold_qty + needed_qty < 0) {
 						/* Buying back some of the Short Sell */
@@ -1168,10 +1120,6 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 			 */
 
 			if (needed_qty > 0) {
-				struct tm tm;
-				struct pg_tm tt;
-				Timestamp dt;
-
 #ifdef DEBUG
 				elog(DEBUG1, "%s", SQLTRF2_4a);
 #endif /* DEBUG */
@@ -1191,23 +1139,11 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 				args[1] = Int64GetDatum(acct_id);
 				args[2] = CStringGetTextDatum(symbol);
 
-				memset(&tm, 0, sizeof(tm));
-				if (strptime(values[i_trade_dts], "%Y-%m-%d %H:%M:%S", &tm)
-						== NULL) {
+				if (values.nulls[i_trade_dts]) {
 					FAIL_FRAME_SET(
 							&funcctx->max_calls, TRF2_statements[8].sql);
 				} else {
-					tt.tm_year = tm.tm_year - 1900;
-					tt.tm_mon = tm.tm_mon - 1;
-					tt.tm_mday = tm.tm_mday;
-					tt.tm_hour = tm.tm_hour;
-					tt.tm_min = tm.tm_min;
-					tt.tm_sec = tm.tm_sec;
-					tt.tm_isdst = tm.tm_isdst;
-					tt.tm_gmtoff = tm.tm_gmtoff;
-					tt.tm_zone = tm.tm_zone;
-					tm2timestamp(&tt, 0, NULL, &dt);
-					args[3] = TimestampGetDatum(dt);
+					args[3] = values.values[i_trade_dts];
 
 					args[4] = Float8GetDatum(trade_price);
 					args[5] = Int32GetDatum(needed_qty);
@@ -1231,24 +1167,10 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 			}
 		}
 
-		snprintf(values[i_buy_value], S_PRICE_T_LEN + 1, "%.2f", buy_value);
-		snprintf(values[i_sell_value], S_PRICE_T_LEN + 1, "%.2f", sell_value);
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
+		set_frame_value(&values, i_buy_value,
+				float8_numeric_round(buy_value, 2), false);
+		set_frame_value(&values, i_sell_value,
+				float8_numeric_round(sell_value, 2), false);
 
 		MemoryContextSwitchTo(oldcontext);
 	}
@@ -1258,22 +1180,19 @@ TradeResultFrame2(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 6; i++) {
-			elog(DEBUG1, "TRF2 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TRF2", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -1370,15 +1289,10 @@ Datum
 TradeResultFrame4(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
-#ifdef DEBUG
-	int i;
-#endif /* DEBUG */
-
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -1405,8 +1319,9 @@ TradeResultFrame4(PG_FUNCTION_ARGS)
 		char symbol[S_SYMB_LEN + 1];
 		char type_id[TT_ID_LEN + 1];
 
-		char *s_ex_id = NULL;
-		char *c_tier = NULL;
+		Datum s_ex_id = (Datum) 0;
+		Datum c_tier = (Datum) 0;
+		bool isnull = true;
 
 		strncpy(symbol,
 				DatumGetCString(DirectFunctionCall1(
@@ -1419,12 +1334,8 @@ TradeResultFrame4(PG_FUNCTION_ARGS)
 				TT_ID_LEN);
 		type_id[TT_ID_LEN] = '\0';
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 2);
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 #ifdef DEBUG
 		dump_trf4_inputs(cust_id, symbol, trade_qty, type_id);
@@ -1448,13 +1359,13 @@ TradeResultFrame4(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			tuple = tuptable->vals[0];
-			s_ex_id = SPI_getvalue(tuple, tupdesc, 1);
-			values[i_s_name] = SPI_getvalue(tuple, tupdesc, 2);
+			s_ex_id = SPI_getbinval(tuple, tupdesc, 1, &isnull);
+			set_frame_spi(&values, i_s_name, tuple, tupdesc, 2);
 		} else {
 			FAIL_FRAME_SET(&funcctx->max_calls, TRF4_statements[0].sql);
 		}
 
-		if (s_ex_id != NULL) {
+		if (!isnull) {
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTRF4_2);
 #endif /* DEBUG */
@@ -1464,19 +1375,20 @@ TradeResultFrame4(PG_FUNCTION_ARGS)
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				c_tier = SPI_getvalue(tuple, tupdesc, 1);
+				c_tier = SPI_getbinval(tuple, tupdesc, 1, &isnull);
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TRF4_statements[1].sql);
+				isnull = true;
 			}
 		}
 
-		if (c_tier != NULL) {
+		if (!isnull) {
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTRF4_3);
 #endif /* DEBUG */
-			args[0] = Int16GetDatum(atoi(c_tier));
+			args[0] = c_tier;
 			args[1] = CStringGetTextDatum(type_id);
-			args[2] = CStringGetTextDatum(s_ex_id);
+			args[2] = s_ex_id;
 			args[3] = Int32GetDatum(trade_qty);
 			args[4] = Int32GetDatum(trade_qty);
 			ret = SPI_execute_plan(TRF4_3, args, nulls, true, 0);
@@ -1484,28 +1396,12 @@ TradeResultFrame4(PG_FUNCTION_ARGS)
 				tupdesc = SPI_tuptable->tupdesc;
 				tuptable = SPI_tuptable;
 				tuple = tuptable->vals[0];
-				values[i_comm_rate] = SPI_getvalue(tuple, tupdesc, 1);
+				set_frame_spi(&values, i_comm_rate, tuple, tupdesc, 1);
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TRF4_statements[2].sql);
 			}
 		}
 
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
-
 		MemoryContextSwitchTo(oldcontext);
 	}
 
@@ -1514,22 +1410,19 @@ TradeResultFrame4(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 2; i++) {
-			elog(DEBUG1, "TRF4 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TRF4", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
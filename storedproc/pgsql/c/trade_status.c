@@ -97,13 +97,12 @@ Datum
 TradeStatusFrame1(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i;
 
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -141,52 +140,8 @@ TradeStatusFrame1(PG_FUNCTION_ARGS)
 		Datum args[1];
 		char nulls[1] = { ' ' };
 
-		char *tmp;
-		int length_c, length_en, length_en2, length_s, length_sn, length_sn2,
-				length_td, length_ti, length_tn, length_tq;
-
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 */
-		values = (char **) palloc(sizeof(char *) * 14);
-
-		length_c = (VALUE_T_LEN + 1) * 50;
-		values[i_charge] = (char *) palloc(length_c-- * sizeof(char));
-
-		length_en2 = (EX_NAME_LEN + 3) * 50;
-		values[i_ex_name] = (char *) palloc(length_en2-- * sizeof(char));
-
-		length_en = (T_EXEC_NAME_LEN + 3) * 50;
-		values[i_exec_name] = (char *) palloc(length_en-- * sizeof(char));
-
-		values[i_num_found] = (char *) palloc((BIGINT_LEN + 1) * sizeof(char));
-
-		length_sn2 = (S_NAME_LEN + 3) * 50;
-		values[i_s_name] = (char *) palloc(length_sn2-- * sizeof(char));
-
-		length_sn = (ST_NAME_LEN + 3) * 50;
-		values[i_status_name] = (char *) palloc(length_sn-- * sizeof(char));
-
-		length_s = (S_SYMB_LEN + 3) * 50;
-		values[i_symbol] = (char *) palloc(length_s-- * sizeof(char));
-
-		length_td = (MAXDATELEN + 1) * 50;
-		values[i_trade_dts] = (char *) palloc(length_td-- * sizeof(char));
-
-		length_ti = (BIGINT_LEN + 1) * 50;
-		values[i_trade_id] = (char *) palloc(length_ti-- * sizeof(char));
-
-		length_tq = (INTEGER_LEN + 1) * 50;
-		values[i_trade_qty] = (char *) palloc(length_tq-- * sizeof(char));
-
-		length_tn = (TT_NAME_LEN + 3) * 50;
-		values[i_type_name] = (char *) palloc(length_tn-- * sizeof(char));
-
-		values[i_cust_l_name] = NULL;
-		values[i_cust_f_name] = NULL;
-		values[i_broker_name] = NULL;
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 #ifdef DEBUG
 		dump_tsf1_inputs(acct_id);
@@ -214,272 +169,22 @@ TradeStatusFrame1(PG_FUNCTION_ARGS)
 		}
 		tupdesc = SPI_tuptable->tupdesc;
 		tuptable = SPI_tuptable;
-		snprintf(values[i_num_found], BIGINT_LEN + 1, "%" PRId64,
-				SPI_processed);
-
-		values[i_trade_id][0] = '{';
-		values[i_trade_id][1] = '\0';
-
-		values[i_trade_dts][0] = '{';
-		values[i_trade_dts][1] = '\0';
-
-		values[i_status_name][0] = '{';
-		values[i_status_name][1] = '\0';
-
-		values[i_type_name][0] = '{';
-		values[i_type_name][1] = '\0';
-
-		values[i_symbol][0] = '{';
-		values[i_symbol][1] = '\0';
-
-		values[i_trade_qty][0] = '{';
-		values[i_trade_qty][1] = '\0';
-
-		values[i_exec_name][0] = '{';
-		values[i_exec_name][1] = '\0';
-
-		values[i_charge][0] = '{';
-		values[i_charge][1] = '\0';
-
-		values[i_s_name][0] = '{';
-		values[i_s_name][1] = '\0';
-
-		values[i_ex_name][0] = '{';
-		values[i_ex_name][1] = '\0';
+		set_frame_value(
+				&values, i_num_found, Int32GetDatum((int32) SPI_processed), false);
 
 		for (i = 0; i < SPI_processed; i++) {
 			tuple = tuptable->vals[i];
-			if (i > 0) {
-				strncat(values[i_trade_id], ",", length_ti--);
-				if (length_ti < 0) {
-					FAIL_FRAME("trade_id values needs to be increased");
-				}
-
-				strncat(values[i_trade_dts], ",", length_td--);
-				if (length_td < 0) {
-					FAIL_FRAME("trade_dts values needs to be increased");
-				}
-
-				strncat(values[i_status_name], ",", length_sn--);
-				if (length_sn < 0) {
-					FAIL_FRAME("status_name values needs to be increased");
-				}
-
-				strncat(values[i_type_name], ",", length_tn--);
-				if (length_tn < 0) {
-					FAIL_FRAME("type_name values needs to be increased");
-				}
-
-				strncat(values[i_symbol], ",", length_s--);
-				if (length_s < 0) {
-					FAIL_FRAME("symbol values needs to be increased");
-				}
-
-				strncat(values[i_trade_qty], ",", length_tq--);
-				if (length_tq < 0) {
-					FAIL_FRAME("trade_qty values needs to be increased");
-				}
-
-				strncat(values[i_exec_name], ",", length_en--);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
-
-				strncat(values[i_charge], ",", length_c--);
-				if (length_c < 0) {
-					FAIL_FRAME("charge values needs to be increased");
-				}
-
-				strncat(values[i_s_name], ",", length_sn2--);
-				if (length_sn2 < 0) {
-					FAIL_FRAME("s_name values needs to be increased");
-				}
-
-				strncat(values[i_ex_name], ",", length_en2--);
-				if (length_en2 < 0) {
-					FAIL_FRAME("ex_name values needs to be increased");
-				}
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_trade_id], tmp, length_ti);
-			length_ti -= strlen(tmp);
-			if (length_ti < 0) {
-				FAIL_FRAME("trade_id values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_trade_dts], tmp, length_td);
-			length_td -= strlen(tmp);
-			if (length_td < 0) {
-				FAIL_FRAME("trade_dts values needs to be increased");
-			}
-
-			strncat(values[i_status_name], "\"", length_sn--);
-			if (length_sn < 0) {
-				FAIL_FRAME("status_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 3);
-			strncat(values[i_status_name], tmp, length_sn);
-			length_sn -= strlen(tmp);
-			if (length_sn < 0) {
-				FAIL_FRAME("status_name values needs to be increased");
-			}
-
-			strncat(values[i_status_name], "\"", length_sn--);
-			if (length_sn < 0) {
-				FAIL_FRAME("status_name values needs to be increased");
-			}
-
-			strncat(values[i_type_name], "\"", length_tn--);
-			if (length_tn < 0) {
-				FAIL_FRAME("type_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 4);
-			strncat(values[i_type_name], tmp, length_tn);
-			length_tn -= strlen(tmp);
-			if (length_tn < 0) {
-				FAIL_FRAME("type_name values needs to be increased");
-			}
-
-			strncat(values[i_type_name], "\"", length_tn--);
-			if (length_tn < 0) {
-				FAIL_FRAME("type_name values needs to be increased");
-			}
-
-			strncat(values[i_symbol], "\"", length_s--);
-			if (length_s < 0) {
-				FAIL_FRAME("symbol values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 5);
-			strncat(values[i_symbol], tmp, length_s);
-			length_s -= strlen(tmp);
-			if (length_s < 0) {
-				FAIL_FRAME("symbol values needs to be increased");
-			}
-
-			strncat(values[i_symbol], "\"", length_s--);
-			if (length_s < 0) {
-				FAIL_FRAME("symbol values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 6);
-			strncat(values[i_trade_qty], tmp, length_tq);
-			length_tq -= strlen(tmp);
-			if (length_tq < 0) {
-				FAIL_FRAME("trade_qty values needs to be increased");
-			}
-
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 7);
-			strncat(values[i_exec_name], tmp, length_en);
-			length_en -= strlen(tmp);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 8);
-			strncat(values[i_charge], tmp, length_c);
-			length_c -= strlen(tmp);
-			if (length_c < 0) {
-				FAIL_FRAME("charge values needs to be increased");
-			}
-
-			strncat(values[i_s_name], "\"", length_sn2--);
-			if (length_sn2 < 0) {
-				FAIL_FRAME("s_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 9);
-			strncat(values[i_s_name], tmp, length_sn2);
-			length_sn2 -= strlen(tmp);
-			if (length_sn2 < 0) {
-				FAIL_FRAME("s_name values needs to be increased");
-			}
-
-			strncat(values[i_s_name], "\"", length_sn2--);
-			if (length_sn2 < 0) {
-				FAIL_FRAME("s_name values needs to be increased");
-			}
-
-			strncat(values[i_ex_name], "\"", length_en2--);
-			if (length_en2 < 0) {
-				FAIL_FRAME("ex_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 10);
-			strncat(values[i_ex_name], tmp, length_en2);
-			length_en2 -= strlen(tmp);
-			if (length_en2 < 0) {
-				FAIL_FRAME("ex_name values needs to be increased");
-			}
-
-			strncat(values[i_ex_name], "\"", length_en2--);
-			if (length_en2 < 0) {
-				FAIL_FRAME("ex_name values needs to be increased");
-			}
-		}
 
-		strncat(values[i_trade_id], "}", length_ti--);
-		if (length_ti < 0) {
-			FAIL_FRAME("trade_id values needs to be increased");
-		}
-
-		strncat(values[i_trade_dts], "}", length_td--);
-		if (length_td < 0) {
-			FAIL_FRAME("trade_dts values needs to be increased");
-		}
-
-		strncat(values[i_status_name], "}", length_sn--);
-		if (length_sn < 0) {
-			FAIL_FRAME("status_name values needs to be increased");
-		}
-
-		strncat(values[i_type_name], "}", length_tn--);
-		if (length_tn < 0) {
-			FAIL_FRAME("type_name values needs to be increased");
-		}
-
-		strncat(values[i_symbol], "}", length_s--);
-		if (length_s < 0) {
-			FAIL_FRAME("symbol values needs to be increased");
-		}
-
-		strncat(values[i_trade_qty], "}", length_tq--);
-		if (length_tq < 0) {
-			FAIL_FRAME("trade_qty values needs to be increased");
-		}
-
-		strncat(values[i_exec_name], "}", length_en--);
-		if (length_en < 0) {
-			FAIL_FRAME("exec_name values needs to be increased");
-		}
-
-		strncat(values[i_charge], "}", length_c--);
-		if (length_c < 0) {
-			FAIL_FRAME("charge values needs to be increased");
-		}
-
-		strncat(values[i_s_name], "}", length_sn2--);
-		if (length_sn2 < 0) {
-			FAIL_FRAME("s_name values needs to be increased");
-		}
-
-		strncat(values[i_ex_name], "}", length_en2--);
-		if (length_en2 < 0) {
-			FAIL_FRAME("ex_name values needs to be increased");
+			push_frame_spi(&values, i_trade_id, tuple, tupdesc, 1);
+			push_frame_spi(&values, i_trade_dts, tuple, tupdesc, 2);
+			push_frame_spi(&values, i_status_name, tuple, tupdesc, 3);
+			push_frame_spi(&values, i_type_name, tuple, tupdesc, 4);
+			push_frame_spi(&values, i_symbol, tuple, tupdesc, 5);
+			push_frame_spi(&values, i_trade_qty, tuple, tupdesc, 6);
+			push_frame_spi(&values, i_exec_name, tuple, tupdesc, 7);
+			push_frame_spi(&values, i_charge, tuple, tupdesc, 8);
+			push_frame_spi(&values, i_s_name, tuple, tupdesc, 9);
+			push_frame_spi(&values, i_ex_name, tuple, tupdesc, 10);
 		}
 
 #ifdef DEBUG
@@ -496,26 +201,11 @@ TradeStatusFrame1(PG_FUNCTION_ARGS)
 		tuptable = SPI_tuptable;
 		if (SPI_processed > 0) {
 			tuple = tuptable->vals[0];
-			values[i_cust_l_name] = SPI_getvalue(tuple, tupdesc, 1);
-			values[i_cust_f_name] = SPI_getvalue(tuple, tupdesc, 2);
-			values[i_broker_name] = SPI_getvalue(tuple, tupdesc, 3);
-		}
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
+			set_frame_spi(&values, i_cust_l_name, tuple, tupdesc, 1);
+			set_frame_spi(&values, i_cust_f_name, tuple, tupdesc, 2);
+			set_frame_spi(&values, i_broker_name, tuple, tupdesc, 3);
 		}
 
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
-
 		MemoryContextSwitchTo(oldcontext);
 	}
 
@@ -524,23 +214,19 @@ TradeStatusFrame1(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 14; i++) {
-			elog(DEBUG1, "TSF1 OUT: %d %s", i,
-					values[i] ? values[i] : "(null)");
-		}
+		dump_frame_result("TSF1", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
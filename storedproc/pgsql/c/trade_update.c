@@ -299,14 +299,13 @@ Datum
 TradeUpdateFrame1(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i;
 	int j;
 
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -334,9 +333,7 @@ TradeUpdateFrame1(PG_FUNCTION_ARGS)
 		int max_trades = PG_GETARG_INT32(0);
 		int max_updates = PG_GETARG_INT32(1);
 		ArrayType *trade_id_p = PG_GETARG_ARRAYTYPE_P(2);
-
 		int num_trade_ids;
-
 		int64 *trade_id;
 
 		int ret;
@@ -348,15 +345,6 @@ TradeUpdateFrame1(PG_FUNCTION_ARGS)
 
 		int num_found = 0;
 		int num_updated = 0;
-		int num_updated4 = 0;
-		int num_updated5 = 0;
-		int num_updated7 = 0;
-		int num_cash = 0;
-
-		char *tmp;
-		int length_bp, length_cta, length_ctd, length_ctn, length_en,
-				length_ic, length_im, length_sa, length_scdd, length_sct,
-				length_thd, length_thsi, length_tp;
 
 		num_trade_ids = ArrayGetNItems(
 				ARR_NDIM(trade_id_p), ARR_DIMS(trade_id_p));
@@ -365,65 +353,8 @@ TradeUpdateFrame1(PG_FUNCTION_ARGS)
 		}
 		trade_id = (int64 *) ARR_DATA_PTR(trade_id_p);
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 * Don't forget to factor in commas (,) and braces ({}) for the arrays.
-		 */
-		values = (char **) palloc(sizeof(char *) * 15);
-
-		length_bp = (S_PRICE_T_LEN + 1) * 20 + 2;
-		values[i_bid_price] = (char *) palloc(length_bp-- * sizeof(char));
-
-		length_cta = ((VALUE_T_LEN + 1) * 20 + 2);
-		values[i_cash_transaction_amount]
-				= (char *) palloc(length_cta-- * sizeof(char));
-
-		length_ctd = (MAXDATELEN + 3) * 20 + 2;
-		values[i_cash_transaction_dts]
-				= (char *) palloc(length_ctd-- * sizeof(char));
-
-		length_ctn = (CT_NAME_LEN + 3) * 20 + 2;
-		values[i_cash_transaction_name]
-				= (char *) palloc(length_ctn-- * sizeof(char));
-
-		length_en = (T_EXEC_NAME_LEN + 3) * 20 + 2;
-		values[i_exec_name] = (char *) palloc(length_en-- * sizeof(char));
-
-		length_ic = (SMALLINT_LEN + 1) * 20 + 2;
-		values[i_is_cash] = (char *) palloc(length_ic-- * sizeof(char));
-
-		length_im = (SMALLINT_LEN + 1) * 20 + 3;
-		values[i_is_market] = (char *) palloc(length_im-- * sizeof(char));
-
-		values[i_num_found]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-		values[i_num_updated]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-
-		length_sa = (VALUE_T_LEN + 1) * 20 + 2;
-		values[i_settlement_amount]
-				= (char *) palloc(length_sa-- * sizeof(char));
-
-		length_scdd = (MAXDATELEN + 1) * 20 + 2;
-		values[i_settlement_cash_due_date]
-				= (char *) palloc(length_scdd-- * sizeof(char));
-
-		length_sct = (SE_CASH_TYPE_LEN + 3) * 20 + 2;
-		values[i_settlement_cash_type]
-				= (char *) palloc(length_sct-- * sizeof(char));
-
-		length_thd = (MAXDATELEN + 2) * 60 + 62;
-		values[i_trade_history_dts]
-				= (char *) palloc(length_thd-- * sizeof(char));
-
-		length_thsi = (ST_ID_LEN) * 60 + 62;
-		values[i_trade_history_status_id]
-				= (char *) palloc(length_thsi-- * sizeof(char));
-
-		length_tp = (S_PRICE_T_LEN + 1) * 20 + 2;
-		values[i_trade_price] = (char *) palloc(length_tp-- * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 #ifdef DEBUG
 		dump_tuf1_inputs(max_trades, max_updates, trade_id);
@@ -439,48 +370,10 @@ TradeUpdateFrame1(PG_FUNCTION_ARGS)
 		SPI_connect();
 		plan_queries(TUF1_statements);
 
-		values[i_bid_price][0] = '{';
-		values[i_bid_price][1] = '\0';
-
-		values[i_exec_name][0] = '{';
-		values[i_exec_name][1] = '\0';
-
-		values[i_is_cash][0] = '{';
-		values[i_is_cash][1] = '\0';
-
-		values[i_is_market][0] = '{';
-		values[i_is_market][1] = '\0';
-
-		values[i_trade_price][0] = '{';
-		values[i_trade_price][1] = '\0';
-
-		values[i_settlement_amount][0] = '{';
-		values[i_settlement_amount][1] = '\0';
-
-		values[i_settlement_cash_due_date][0] = '{';
-		values[i_settlement_cash_due_date][1] = '\0';
-
-		values[i_settlement_cash_type][0] = '{';
-		values[i_settlement_cash_type][1] = '\0';
-
-		values[i_cash_transaction_amount][0] = '{';
-		values[i_cash_transaction_amount][1] = '\0';
-
-		values[i_cash_transaction_dts][0] = '{';
-		values[i_cash_transaction_dts][1] = '\0';
-
-		values[i_cash_transaction_name][0] = '{';
-		values[i_cash_transaction_name][1] = '\0';
-
-		values[i_trade_history_dts][0] = '{';
-		values[i_trade_history_dts][1] = '\0';
-
-		values[i_trade_history_status_id][0] = '{';
-		values[i_trade_history_status_id][1] = '\0';
-
 		for (i = 0; i < max_trades; i++) {
-			char *is_cash_str = NULL;
-			char *is_market_str;
+			bool found = false;
+			bool is_cash = false;
+			bool isnull;
 
 			if (num_updated < max_updates) {
 				char *ex_name;
@@ -558,100 +451,27 @@ TradeUpdateFrame1(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			for (j = 0; j < SPI_processed; j++) {
-				char *trade_price;
-				if (num_updated4 > 0) {
-					strncat(values[i_bid_price], ",", length_bp--);
-					if (length_bp < 0) {
-						FAIL_FRAME("bid_price values needs to be increased");
-					}
-
-					strncat(values[i_exec_name], ",", length_en--);
-					if (length_en < 0) {
-						FAIL_FRAME("exec_name values needs to be increased");
-					}
-
-					strncat(values[i_is_cash], ",", length_ic--);
-					if (length_ic < 0) {
-						FAIL_FRAME("is_cash values needs to be increased");
-					}
-
-					strncat(values[i_is_market], ",", length_im--);
-					if (length_im < 0) {
-						FAIL_FRAME("is_market values needs to be increased");
-					}
-
-					strncat(values[i_trade_price], ",", length_tp--);
-					if (length_tp < 0) {
-						FAIL_FRAME("trade_price values needs to be increased");
-					}
-				}
-
 				tuple = tuptable->vals[j];
 
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_bid_price], tmp, length_bp);
-				length_bp -= strlen(tmp);
-				if (length_bp < 0) {
-					FAIL_FRAME("bid_price values needs to be increased");
-				}
-
-				strncat(values[i_exec_name], "\"", length_en--);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_exec_name], tmp, length_en);
-				length_en -= strlen(tmp);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
-
-				strncat(values[i_exec_name], "\"", length_en--);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
+				push_frame_spi(&values, i_bid_price, tuple, tupdesc, 1);
+				push_frame_spi(&values, i_exec_name, tuple, tupdesc, 2);
 
-				is_cash_str = SPI_getvalue(tuple, tupdesc, 3);
-				if (is_cash_str[0] == 't') {
-					strncat(values[i_is_cash], "1", length_ic--);
-				} else {
-					strncat(values[i_is_cash], "0", length_ic--);
-				}
-				if (length_ic < 0) {
-					FAIL_FRAME("is_cash values needs to be increased");
-				}
+				is_cash = DatumGetBool(
+						SPI_getbinval(tuple, tupdesc, 3, &isnull));
+				push_frame_value(
+						&values, i_is_cash, Int16GetDatum(is_cash), false);
 
-				is_market_str = SPI_getvalue(tuple, tupdesc, 4);
-				if (is_market_str[0] == 't') {
-					strncat(values[i_is_market], "1", length_im--);
-				} else {
-					strncat(values[i_is_market], "0", length_im--);
-				}
-				if (length_im < 0) {
-					FAIL_FRAME("is_market values needs to be increased");
-				}
+				push_frame_value(&values, i_is_market,
+						Int16GetDatum(DatumGetBool(
+								SPI_getbinval(tuple, tupdesc, 4, &isnull))),
+						false);
 
-				trade_price = SPI_getvalue(tuple, tupdesc, 5);
-				if (trade_price != NULL) {
-					tmp = SPI_getvalue(tuple, tupdesc, 5);
-					strncat(values[i_trade_price], tmp, length_tp);
-					length_tp -= strlen(tmp);
-					if (length_tp < 0) {
-						FAIL_FRAME("trade_price values needs to be increased");
-					}
-				} else {
-					strncat(values[i_trade_price], "NULL", length_tp);
-					length_tp -= 4;
-					if (length_tp < 0) {
-						FAIL_FRAME("trade_price values needs to be increased");
-					}
-				}
+				push_frame_spi(&values, i_trade_price, tuple, tupdesc, 5);
 
-				num_updated4++;
+				found = true;
 			}
 
-			if (is_cash_str == NULL) {
+			if (!found) {
 				/* The trade was not found, skip the rest of its body. */
 				continue;
 			}
@@ -668,69 +488,17 @@ TradeUpdateFrame1(PG_FUNCTION_ARGS)
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
 			for (j = 0; j < SPI_processed; j++) {
-				if (num_updated5 > 0) {
-					strncat(values[i_settlement_amount], ",", length_sa--);
-					if (length_sa < 0) {
-						FAIL_FRAME("settlement_amount values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_settlement_cash_due_date], ",",
-							length_scdd--);
-					if (length_scdd < 0) {
-						FAIL_FRAME("settlement_cash_due_date values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_settlement_cash_type], ",", length_sct--);
-					if (length_sct < 0) {
-						FAIL_FRAME("settlement_cash_type values needs to be "
-								   "increased");
-					}
-				}
-
 				tuple = tuptable->vals[j];
 
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_settlement_amount], tmp, length_sa);
-				length_sa -= strlen(tmp);
-				if (length_sa < 0) {
-					FAIL_FRAME(
-							"settlement_amount values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_settlement_cash_due_date], tmp, length_scdd);
-				length_scdd -= strlen(tmp);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 3);
-				strncat(values[i_settlement_cash_type], tmp, length_sct);
-				length_sct -= strlen(tmp);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				num_updated5++;
+				push_frame_spi(
+						&values, i_settlement_amount, tuple, tupdesc, 1);
+				push_frame_spi(&values, i_settlement_cash_due_date, tuple,
+						tupdesc, 2);
+				push_frame_spi(
+						&values, i_settlement_cash_type, tuple, tupdesc, 3);
 			}
 
-			if (is_cash_str[0] == 't') {
+			if (is_cash) {
 #ifdef DEBUG
 				elog(DEBUG1, "%s", SQLTUF1_6);
 #endif /* DEBUG */
@@ -740,131 +508,25 @@ TradeUpdateFrame1(PG_FUNCTION_ARGS)
 					tuptable = SPI_tuptable;
 					tuple = tuptable->vals[0];
 
-					if (num_cash > 0) {
-						strncat(values[i_cash_transaction_amount], ",",
-								length_cta--);
-						if (length_cta < 0) {
-							FAIL_FRAME("cash_transaction_amount values needs "
-									   "to be increased");
-						}
-
-						strncat(values[i_cash_transaction_dts], ",",
-								length_ctd--);
-						if (length_ctd < 0) {
-							FAIL_FRAME("cash_transaction_dts values needs to "
-									   "be increased");
-						}
-
-						strncat(values[i_cash_transaction_name], ",",
-								length_ctn--);
-						if (length_ctn < 0) {
-							FAIL_FRAME("cash_transaction_name values needs to "
-									   "be increased");
-						}
-					}
-
-					tmp = SPI_getvalue(tuple, tupdesc, 1);
-					strncat(values[i_cash_transaction_amount], tmp,
-							length_cta);
-					length_cta -= strlen(tmp);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					tmp = SPI_getvalue(tuple, tupdesc, 2);
-					strncat(values[i_cash_transaction_dts], tmp, length_ctd);
-					length_ctd -= strlen(tmp);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					tmp = SPI_getvalue(tuple, tupdesc, 3);
-					strncat(values[i_cash_transaction_name], tmp, length_ctn);
-					length_ctn -= strlen(tmp);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					++num_cash;
+					push_frame_spi(&values, i_cash_transaction_amount, tuple,
+							tupdesc, 1);
+					push_frame_spi(&values, i_cash_transaction_dts, tuple,
+							tupdesc, 2);
+					push_frame_spi(&values, i_cash_transaction_name, tuple,
+							tupdesc, 3);
 				} else {
 					FAIL_FRAME_SET(
 							&funcctx->max_calls, TUF1_statements[6].sql);
 					continue;
 				}
 			} else {
-				if (num_cash > 0) {
-					strncat(values[i_cash_transaction_amount], ",",
-							length_cta--);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], ",", length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], ",",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-				}
-				strncat(values[i_cash_transaction_amount], "0", length_cta--);
-				if (length_cta < 0) {
-					FAIL_FRAME("cash_transaction_amount values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_dts], "NULL", length_ctd);
-				length_ctd -= 4;
-				if (length_ctd < 0) {
-					FAIL_FRAME("cash_transaction_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_name], "\"\"", length_ctn);
-				length_ctn -= 2;
-				if (length_ctn < 0) {
-					FAIL_FRAME("cash_transaction_name values needs to be "
-							   "increased");
-				}
-
-				++num_cash;
+				push_frame_value(&values, i_cash_transaction_amount,
+						DirectFunctionCall1(int4_numeric, Int32GetDatum(0)),
+						false);
+				push_frame_value(
+						&values, i_cash_transaction_dts, (Datum) 0, true);
+				push_frame_value(&values, i_cash_transaction_name,
+						CStringGetTextDatum(""), false);
 			}
 
 #ifdef DEBUG
@@ -875,178 +537,28 @@ TradeUpdateFrame1(PG_FUNCTION_ARGS)
 				FAIL_FRAME_SET(&funcctx->max_calls, TUF1_statements[7].sql);
 				continue;
 			}
+
 			tupdesc = SPI_tuptable->tupdesc;
 			tuptable = SPI_tuptable;
-
-			if (num_updated7 > 0) {
-				strncat(values[i_trade_history_dts], ",", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], ",", length_thsi--);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to be "
-							   "increased");
-				}
-			}
-
 			for (j = 0; j < SPI_processed; j++) {
-				if (j > 0) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						FAIL_FRAME("trade_history_status_id values needs to "
-								   "be increased");
-					}
-				}
-
 				tuple = tuptable->vals[j];
 
-				tmp = SPI_getvalue(tuple, tupdesc, 1);
-				strncat(values[i_trade_history_dts], tmp, length_thd);
-				length_thd -= strlen(tmp);
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(tuple, tupdesc, 2);
-				strncat(values[i_trade_history_status_id], tmp, length_thsi);
-				length_thsi -= strlen(tmp);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to be "
-							   "increased");
-				}
-
-				num_updated7++;
+				push_frame_spi(
+						&values, i_trade_history_dts, tuple, tupdesc, 1);
+				push_frame_spi(&values, i_trade_history_status_id, tuple,
+						tupdesc, 2);
 			}
 			for (j = SPI_processed; j < 3; j++) {
-				if (j > 0) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						FAIL_FRAME("trade_history_status_id values needs to "
-								   "be increased");
-					}
-				}
-
-				strncat(values[i_trade_history_dts], "NULL", length_thd);
-				length_thd -= 4;
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], "NULL",
-						length_thsi);
-				length_thsi -= 4;
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to be "
-							   "increased");
-				}
-
-				num_updated7++;
+				push_frame_value(
+						&values, i_trade_history_dts, (Datum) 0, true);
+				push_frame_value(
+						&values, i_trade_history_status_id, (Datum) 0, true);
 			}
 		}
 
-		strncat(values[i_bid_price], "}", length_bp--);
-		if (length_bp < 0) {
-			FAIL_FRAME("bid_price values needs to be increased");
-		}
-
-		strncat(values[i_exec_name], "}", length_en--);
-		if (length_en < 0) {
-			FAIL_FRAME("exec_name values needs to be increased");
-		}
-
-		strncat(values[i_is_cash], "}", length_ic--);
-		if (length_ic < 0) {
-			FAIL_FRAME("is_cash values needs to be increased");
-		}
-
-		strncat(values[i_is_market], "}", length_im--);
-		if (length_im < 0) {
-			FAIL_FRAME("is_market values needs to be increased");
-		}
-
-		strncat(values[i_trade_price], "}", length_tp--);
-		if (length_tp < 0) {
-			FAIL_FRAME("trade_price values needs to be increased");
-		}
-
-		strncat(values[i_settlement_amount], "}", length_sa--);
-		if (length_sa < 0) {
-			FAIL_FRAME("settlement_amount values needs to be increased");
-		}
-
-		strncat(values[i_settlement_cash_due_date], "}", length_scdd--);
-		if (length_scdd < 0) {
-			FAIL_FRAME(
-					"settlement_cash_due_date values needs to be increased");
-		}
-
-		strncat(values[i_settlement_cash_type], "}", length_sct--);
-		if (length_sct < 0) {
-			FAIL_FRAME("settlement_cash_type values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_amount], "}", length_cta--);
-		if (length_cta < 0) {
-			FAIL_FRAME("cash_transaction_amount values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_dts], "}", length_ctd--);
-		if (length_ctd < 0) {
-			FAIL_FRAME("cash_transaction_dts values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_name], "}", length_ctn--);
-		if (length_ctn < 0) {
-			FAIL_FRAME("cash_transaction_name values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_dts], "}", length_thd--);
-		if (length_thd < 0) {
-			FAIL_FRAME("trade_history_dts values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_status_id], "}", length_thsi--);
-		if (length_thsi < 0) {
-			FAIL_FRAME("trade_history_status_id values needs to be increased");
-		}
-
-		snprintf(values[i_num_found], INTEGER_LEN + 1, "%d", num_found);
-		snprintf(values[i_num_updated], INTEGER_LEN + 1, "%d", num_updated);
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
+		set_frame_value(&values, i_num_found, Int32GetDatum(num_found), false);
+		set_frame_value(
+				&values, i_num_updated, Int32GetDatum(num_updated), false);
 
 		MemoryContextSwitchTo(oldcontext);
 	}
@@ -1056,22 +568,19 @@ TradeUpdateFrame1(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 15; i++) {
-			elog(DEBUG1, "TUF1 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TUF1", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -1088,14 +597,13 @@ Datum
 TradeUpdateFrame2(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i;
 	int j;
 
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -1131,24 +639,20 @@ TradeUpdateFrame2(PG_FUNCTION_ARGS)
 		SPITupleTable *tuptable = NULL;
 		HeapTuple tuple = NULL;
 
+#ifdef DEBUG
 		struct pg_tm tt, *tm = &tt;
 		fsec_t fsec;
 		char *tzn = NULL;
-		Datum args[4];
-		char nulls[4] = { ' ', ' ', ' ', ' ' };
-
 		char end_trade_dts[MAXDATELEN + 1];
 		char start_trade_dts[MAXDATELEN + 1];
+#endif /* DEBUG */
+		Datum args[4];
+		char nulls[4] = { ' ', ' ', ' ', ' ' };
 
 		int num_found;
 		int num_updated = 0;
-		int num_cash = 0;
-
-		char *tmp;
-		int length_bp, length_cta, length_ctd, length_ctn, length_en,
-				length_ic, length_sa, length_scdd, length_sct, length_thd,
-				length_thsi, length_tl, length_tp;
 
+#ifdef DEBUG
 		if (timestamp2tm(end_trade_dts_ts, NULL, tm, &fsec, NULL, NULL) == 0) {
 			EncodeDateTimeM(tm, fsec, tzn, end_trade_dts);
 		}
@@ -1157,70 +661,12 @@ TradeUpdateFrame2(PG_FUNCTION_ARGS)
 			EncodeDateTimeM(tm, fsec, tzn, start_trade_dts);
 		}
 
-#ifdef DEBUG
 		dump_tuf2_inputs(acct_id, end_trade_dts, max_trades, max_updates,
 				start_trade_dts);
 #endif
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 * Don't forget to factor in commas (,) and braces ({}) for the arrays.
-		 */
-		values = (char **) palloc(sizeof(char *) * 15);
-
-		length_bp = (S_PRICE_T_LEN + 1) * 20 + 2;
-		values[i_bid_price] = (char *) palloc(length_bp-- * sizeof(char));
-
-		length_cta = (VALUE_T_LEN + 1) * 20 + 2;
-		values[i_cash_transaction_amount]
-				= (char *) palloc(length_cta-- * sizeof(char));
-
-		length_ctd = (MAXDATELEN + 3) * 20 + 2;
-		values[i_cash_transaction_dts]
-				= (char *) palloc(length_ctd-- * sizeof(char));
-
-		length_ctn = (CT_NAME_LEN + 3) * 20 + 2;
-		values[i_cash_transaction_name]
-				= (char *) palloc(length_ctn-- * sizeof(char));
-
-		length_en = (T_EXEC_NAME_LEN + 3) * 20 + 2;
-		values[i_exec_name] = (char *) palloc(length_en-- * sizeof(char));
-
-		length_ic = (SMALLINT_LEN + 1) * 20 + 2;
-		values[i_is_cash] = (char *) palloc(length_ic-- * sizeof(char));
-
-		values[i_num_found]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-		values[i_num_updated]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-
-		length_sa = (VALUE_T_LEN + 1) * 20 + 2;
-		values[i_settlement_amount]
-				= (char *) palloc(length_sa-- * sizeof(char));
-
-		length_scdd = (MAXDATELEN + 3) * 20 + 2;
-		values[i_settlement_cash_due_date]
-				= (char *) palloc(length_scdd-- * sizeof(char));
-
-		length_sct = (SE_CASH_TYPE_LEN + 3) * 20 + 2;
-		values[i_settlement_cash_type]
-				= (char *) palloc(length_sct-- * sizeof(char));
-
-		length_thd = (MAXDATELEN + 2) * 60 + 62;
-		values[i_trade_history_dts]
-				= (char *) palloc(length_thd-- * sizeof(char));
-
-		length_thsi = (ST_ID_LEN) * 60 + 62;
-		values[i_trade_history_status_id]
-				= (char *) palloc(length_thsi-- * sizeof(char));
-
-		length_tl = (BIGINT_LEN + 1) * 20 + 2;
-		values[i_trade_list] = (char *) palloc(length_tl-- * sizeof(char));
-
-		length_tp = (S_PRICE_T_LEN + 1) * 20 + 2;
-		values[i_trade_price] = (char *) palloc(length_tp-- * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 		/* create a function context for cross-call persistence */
 		funcctx = SRF_FIRSTCALL_INIT();
@@ -1255,45 +701,6 @@ TradeUpdateFrame2(PG_FUNCTION_ARGS)
 
 		num_found = SPI_processed;
 
-		values[i_bid_price][0] = '{';
-		values[i_bid_price][1] = '\0';
-
-		values[i_exec_name][0] = '{';
-		values[i_exec_name][1] = '\0';
-
-		values[i_is_cash][0] = '{';
-		values[i_is_cash][1] = '\0';
-
-		values[i_trade_list][0] = '{';
-		values[i_trade_list][1] = '\0';
-
-		values[i_trade_price][0] = '{';
-		values[i_trade_price][1] = '\0';
-
-		values[i_settlement_amount][0] = '{';
-		values[i_settlement_amount][1] = '\0';
-
-		values[i_settlement_cash_due_date][0] = '{';
-		values[i_settlement_cash_due_date][1] = '\0';
-
-		values[i_settlement_cash_type][0] = '{';
-		values[i_settlement_cash_type][1] = '\0';
-
-		values[i_cash_transaction_amount][0] = '{';
-		values[i_cash_transaction_amount][1] = '\0';
-
-		values[i_cash_transaction_dts][0] = '{';
-		values[i_cash_transaction_dts][1] = '\0';
-
-		values[i_cash_transaction_name][0] = '{';
-		values[i_cash_transaction_name][1] = '\0';
-
-		values[i_trade_history_dts][0] = '{';
-		values[i_trade_history_dts][1] = '\0';
-
-		values[i_trade_history_status_id][0] = '{';
-		values[i_trade_history_status_id][1] = '\0';
-
 #ifdef DEBUG
 		elog(DEBUG1, "TUF2 num_found %d", num_found);
 #endif /* DEBUG */
@@ -1302,145 +709,31 @@ TradeUpdateFrame2(PG_FUNCTION_ARGS)
 			SPITupleTable *l_tuptable = NULL;
 			HeapTuple l_tuple = NULL;
 
-			char *is_cash_str;
-			char *trade_list;
+			bool is_cash;
+			bool isnull;
+			Datum trade_list;
 			char cash_type[41];
 
 			tuple = tuptable->vals[i];
 
-			if (i > 0) {
-				strncat(values[i_bid_price], ",", length_bp--);
-				if (length_bp < 0) {
-					FAIL_FRAME("bid_price values needs to be increased");
-				}
-
-				strncat(values[i_exec_name], ",", length_en--);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
-
-				strncat(values[i_is_cash], ",", length_ic--);
-				if (length_ic < 0) {
-					FAIL_FRAME("is_cash values needs to be increased");
-				}
-
-				strncat(values[i_trade_list], ",", length_tl--);
-				if (length_tl < 0) {
-					FAIL_FRAME("trade_list values needs to be increased");
-				}
-
-				strncat(values[i_trade_price], ",", length_tp--);
-				if (length_tp < 0) {
-					FAIL_FRAME("trade_price values needs to be increased");
-				}
-
-				strncat(values[i_settlement_amount], ",", length_sa--);
-				if (length_sa < 0) {
-					FAIL_FRAME(
-							"settlement_amount values needs to be increased");
-				}
-
-				strncat(values[i_settlement_cash_due_date], ",",
-						length_scdd--);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], ",", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_trade_history_dts], ",", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], ",", length_thsi--);
-				if (length_thsi < 0) {
-					elog(DEBUG1,
-							"TUF2 trade_history_status_id out of space: %s",
-							values[i_trade_history_status_id]);
-					FAIL_FRAME("trade_history_status_id values needs to be "
-							   "increased");
-				}
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_bid_price], tmp, length_bp);
-			length_bp -= strlen(tmp);
-			if (length_bp < 0) {
-				FAIL_FRAME("bid_price values needs to be increased");
-			}
-
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_exec_name], tmp, length_en);
-			length_en -= strlen(tmp);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			is_cash_str = SPI_getvalue(tuple, tupdesc, 3);
-			if (is_cash_str[0] == 't') {
-				strncat(values[i_is_cash], "1", length_ic--);
-			} else {
-				strncat(values[i_is_cash], "0", length_ic--);
-			}
-			if (length_ic < 0) {
-				FAIL_FRAME("is_cash values needs to be increased");
-			}
-
-			trade_list = SPI_getvalue(tuple, tupdesc, 4);
-			strncat(values[i_trade_list], trade_list, length_tl);
-			length_tl -= strlen(trade_list);
-			if (length_tl < 0) {
-				FAIL_FRAME("trade_list values needs to be increased");
-			}
+			push_frame_spi(&values, i_bid_price, tuple, tupdesc, 1);
+			push_frame_spi(&values, i_exec_name, tuple, tupdesc, 2);
 
-			tmp = SPI_getvalue(tuple, tupdesc, 5);
-			if (tmp != NULL) {
-				strncat(values[i_trade_price], tmp, length_tp);
-				length_tp -= strlen(tmp);
-				if (length_tp < 0) {
-					FAIL_FRAME("trade_price values needs to be increased");
-				}
-			} else {
-				strncat(values[i_trade_price], "NULL", length_tp);
-				length_tp -= 4;
-				if (length_tp < 0) {
-					FAIL_FRAME("trade_price values needs to be increased");
-				}
-			}
+			is_cash = DatumGetBool(SPI_getbinval(tuple, tupdesc, 3, &isnull));
+			push_frame_value(&values, i_is_cash, Int16GetDatum(is_cash), false);
 
-#ifdef DEBUG
-			elog(DEBUG1, "TUF2 bid_price[%d] %s", i, values[i_bid_price]);
-			elog(DEBUG1, "TUF2 exec_name[%d] %s", i, values[i_exec_name]);
-			elog(DEBUG1, "TUF2 is_cash[%d] %s", i, values[i_is_cash]);
-			elog(DEBUG1, "TUF2 trade_ist[%d] %s", i, values[i_trade_list]);
-			elog(DEBUG1, "TUF2 trade_price[%d] %s", i, values[i_trade_price]);
-#endif /* DEBUG */
+			trade_list = SPI_getbinval(tuple, tupdesc, 4, &isnull);
+			push_frame_spi(&values, i_trade_list, tuple, tupdesc, 4);
+			push_frame_spi(&values, i_trade_price, tuple, tupdesc, 5);
 
 			if (num_updated < max_updates) {
 				char *old_cash_type;
 
 #ifdef DEBUG
 				elog(DEBUG1, "TUF2_2 %s", SQLTUF2_2);
-				elog(DEBUG1, "TUF2_2 $1 %lld", atoll(trade_list));
+				elog(DEBUG1, "TUF2_2 $1 %ld", DatumGetInt64(trade_list));
 #endif /* DEBUG */
-				args[0] = Int64GetDatum(atoll(trade_list));
+				args[0] = trade_list;
 				ret = SPI_execute_plan(TUF2_2, args, nulls, true, 0);
 				if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 					l_tupdesc = SPI_tuptable->tupdesc;
@@ -1457,7 +750,7 @@ TradeUpdateFrame2(PG_FUNCTION_ARGS)
 				elog(DEBUG1, "TUF2 cash_type[%d] = '%s'", i, old_cash_type);
 #endif /* DEBUG */
 
-				if (is_cash_str[0] == 't') {
+				if (is_cash) {
 					if (strcmp(old_cash_type, "Cash Account") == 0) {
 						strncpy(cash_type, "Cash", sizeof(cash_type));
 					} else {
@@ -1475,10 +768,10 @@ TradeUpdateFrame2(PG_FUNCTION_ARGS)
 #ifdef DEBUG
 				elog(DEBUG1, "TUF2_3 %s", SQLTUF2_3);
 				elog(DEBUG1, "TUF2_3 $1 %s", cash_type);
-				elog(DEBUG1, "TUF2_3 $2 %s", trade_list);
+				elog(DEBUG1, "TUF2_3 $2 %ld", DatumGetInt64(trade_list));
 #endif /* DEBUG */
 				args[0] = CStringGetTextDatum(cash_type);
-				args[1] = Int64GetDatum(atoll(trade_list));
+				args[1] = trade_list;
 				ret = SPI_execute_plan(TUF2_3, args, nulls, false, 0);
 				if (ret != SPI_OK_UPDATE) {
 					FAIL_FRAME_SET(
@@ -1490,213 +783,65 @@ TradeUpdateFrame2(PG_FUNCTION_ARGS)
 
 #ifdef DEBUG
 			elog(DEBUG1, "TUF2_4 %s", SQLTUF2_4);
-			elog(DEBUG1, "TUF2_4 $1 %s", trade_list);
+			elog(DEBUG1, "TUF2_4 $1 %ld", DatumGetInt64(trade_list));
 #endif /* DEBUG */
 			/*
 			 * read_only must be false to see the settlement row updated
 			 * earlier in this call.
 			 */
-			args[0] = Int64GetDatum(atoll(trade_list));
+			args[0] = trade_list;
 			ret = SPI_execute_plan(TUF2_4, args, nulls, false, 0);
 			if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 				l_tupdesc = SPI_tuptable->tupdesc;
 				l_tuptable = SPI_tuptable;
 				l_tuple = l_tuptable->vals[0];
 
-				tmp = SPI_getvalue(l_tuple, l_tupdesc, 1);
-				strncat(values[i_settlement_amount], tmp, length_sa);
-				length_sa -= strlen(tmp);
-				if (length_sa < 0) {
-					FAIL_FRAME(
-							"settlement_amount values needs to be increased");
-				}
-
-				strncat(values[i_settlement_cash_due_date], "\"",
-						length_scdd--);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(l_tuple, l_tupdesc, 2);
-				strncat(values[i_settlement_cash_due_date], tmp, length_scdd);
-				length_scdd -= strlen(tmp);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_due_date], "\"",
-						length_scdd--);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(l_tuple, l_tupdesc, 3);
-				strncat(values[i_settlement_cash_type], tmp, length_sct);
-				length_sct -= strlen(tmp);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
+				push_frame_spi(
+						&values, i_settlement_amount, l_tuple, l_tupdesc, 1);
+				push_frame_spi(&values, i_settlement_cash_due_date, l_tuple,
+						l_tupdesc, 2);
+				push_frame_spi(&values, i_settlement_cash_type, l_tuple,
+						l_tupdesc, 3);
 			} else {
 				FAIL_FRAME_SET(&funcctx->max_calls, TUF2_statements[3].sql);
 				continue;
 			}
 
-			if (is_cash_str[0] == 't') {
+			if (is_cash) {
 #ifdef DEBUG
 				elog(DEBUG1, "TUF2_5 %s", SQLTUF2_5);
-				elog(DEBUG1, "TUF2_5 $1 %s", trade_list);
+				elog(DEBUG1, "TUF2_5 $1 %ld", DatumGetInt64(trade_list));
 #endif /* DEBUG */
 				ret = SPI_execute_plan(TUF2_5, args, nulls, true, 0);
 				if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 					l_tupdesc = SPI_tuptable->tupdesc;
 					l_tuptable = SPI_tuptable;
 					l_tuple = l_tuptable->vals[0];
-					if (num_cash > 0) {
-						strncat(values[i_cash_transaction_amount], ",",
-								length_cta--);
-						if (length_cta < 0) {
-							FAIL_FRAME("cash_transaction_amount values needs "
-									   "to be increased");
-						}
-
-						strncat(values[i_cash_transaction_dts], ",",
-								length_ctd--);
-						if (length_ctd < 0) {
-							FAIL_FRAME("cash_transaction_dts values needs to "
-									   "be increased");
-						}
-
-						strncat(values[i_cash_transaction_name], ",",
-								length_ctn--);
-						if (length_ctn < 0) {
-							FAIL_FRAME("cash_transaction_name values needs to "
-									   "be increased");
-						}
-					}
-
-					tmp = SPI_getvalue(l_tuple, l_tupdesc, 1);
-					strncat(values[i_cash_transaction_amount], tmp,
-							length_cta);
-					length_cta -= strlen(tmp);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
 
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					tmp = SPI_getvalue(l_tuple, l_tupdesc, 2);
-					strncat(values[i_cash_transaction_dts], tmp, length_ctd);
-					length_ctd -= strlen(tmp);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					tmp = SPI_getvalue(l_tuple, l_tupdesc, 3);
-					strncat(values[i_cash_transaction_name], tmp, length_ctn);
-					length_ctn -= strlen(tmp);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					++num_cash;
+					push_frame_spi(&values, i_cash_transaction_amount,
+							l_tuple, l_tupdesc, 1);
+					push_frame_spi(&values, i_cash_transaction_dts, l_tuple,
+							l_tupdesc, 2);
+					push_frame_spi(&values, i_cash_transaction_name, l_tuple,
+							l_tupdesc, 3);
 				} else {
 					FAIL_FRAME_SET(
 							&funcctx->max_calls, TUF2_statements[4].sql);
 					continue;
 				}
 			} else {
-				if (num_cash > 0) {
-					strncat(values[i_cash_transaction_amount], ",",
-							length_cta--);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], ",", length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], ",",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-				}
-				strncat(values[i_cash_transaction_amount], "0", length_cta--);
-				if (length_cta < 0) {
-					FAIL_FRAME("cash_transaction_amount values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_dts], "NULL", length_ctd);
-				length_ctd -= 4;
-				if (length_ctd < 0) {
-					FAIL_FRAME("cash_transaction_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_name], "\"\"", length_ctn);
-				length_ctn -= 2;
-				if (length_ctn < 0) {
-					FAIL_FRAME("cash_transaction_name values needs to be "
-							   "increased");
-				}
-
-				++num_cash;
+				push_frame_value(&values, i_cash_transaction_amount,
+						DirectFunctionCall1(int4_numeric, Int32GetDatum(0)),
+						false);
+				push_frame_value(
+						&values, i_cash_transaction_dts, (Datum) 0, true);
+				push_frame_value(&values, i_cash_transaction_name,
+						CStringGetTextDatum(""), false);
 			}
 
 #ifdef DEBUG
 			elog(DEBUG1, "TUF2_6 %s", SQLTUF2_6);
-			elog(DEBUG1, "TUF2_6 $1 %s", trade_list);
+			elog(DEBUG1, "TUF2_6 $1 %ld", DatumGetInt64(trade_list));
 #endif /* DEBUG */
 
 			ret = SPI_execute_plan(TUF2_6, args, nulls, true, 0);
@@ -1709,183 +854,24 @@ TradeUpdateFrame2(PG_FUNCTION_ARGS)
 			}
 
 			for (j = 0; j < SPI_processed; j++) {
-				if (j > 0) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						elog(DEBUG1,
-								"TUF2 trade_history_status_id out of space: "
-								"%s",
-								values[i_trade_history_status_id]);
-						FAIL_FRAME("trade_history_status_id values needs to "
-								   "be increased");
-					}
-				}
 				l_tuple = l_tuptable->vals[j];
 
-				strncat(values[i_trade_history_dts], "\"", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(l_tuple, l_tupdesc, 1);
-				strncat(values[i_trade_history_dts], tmp, length_thd);
-				length_thd -= strlen(tmp);
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_history_dts], "\"", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(l_tuple, l_tupdesc, 2);
-				strncat(values[i_trade_history_status_id], tmp, length_thsi);
-				length_thsi -= strlen(tmp);
-				if (length_thsi < 0) {
-					elog(DEBUG1,
-							"TUF2 trade_history_status_id out of space: %s",
-							values[i_trade_history_status_id]);
-					FAIL_FRAME("trade_history_status_id values needs to be "
-							   "increased");
-				}
+				push_frame_spi(
+						&values, i_trade_history_dts, l_tuple, l_tupdesc, 1);
+				push_frame_spi(&values, i_trade_history_status_id, l_tuple,
+						l_tupdesc, 2);
 			}
 			for (j = SPI_processed; j < 3; j++) {
-				if (j > 0) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						elog(DEBUG1,
-								"TUF2 trade_history_status_id out of space: "
-								"%s",
-								values[i_trade_history_status_id]);
-						FAIL_FRAME("trade_history_status_id values needs to "
-								   "be increased");
-					}
-				}
-				strncat(values[i_trade_history_dts], "NULL", length_thd);
-				length_thd -= 4;
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], "NULL",
-						length_thsi);
-				length_thsi -= 4;
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to be "
-							   "increased");
-				}
-#ifdef DEBUG
-				elog(DEBUG1, "TUF2 trade_history_dts[%d][%d] %s", i, j,
-						values[i_trade_history_dts]);
-				elog(DEBUG1, "TUF2 trade_history_status_id[%d][%d] %s", i, j,
-						values[i_trade_history_status_id]);
-#endif /* DEBUG */
+				push_frame_value(
+						&values, i_trade_history_dts, (Datum) 0, true);
+				push_frame_value(
+						&values, i_trade_history_status_id, (Datum) 0, true);
 			}
 		}
 
-		strncat(values[i_bid_price], "}", length_bp--);
-		if (length_bp < 0) {
-			FAIL_FRAME("bid_price values needs to be increased");
-		}
-
-		strncat(values[i_exec_name], "}", length_en--);
-		if (length_en < 0) {
-			FAIL_FRAME("exec_name values needs to be increased");
-		}
-
-		strncat(values[i_is_cash], "}", length_ic--);
-		if (length_ic < 0) {
-			FAIL_FRAME("is_cash values needs to be increased");
-		}
-
-		strncat(values[i_trade_list], "}", length_tl--);
-		if (length_tl < 0) {
-			FAIL_FRAME("trade_list values needs to be increased");
-		}
-
-		strncat(values[i_trade_price], "}", length_tp--);
-		if (length_tp < 0) {
-			FAIL_FRAME("trade_price values needs to be increased");
-		}
-
-		strncat(values[i_settlement_amount], "}", length_sa--);
-		if (length_sa < 0) {
-			FAIL_FRAME("settlement_amount values needs to be increased");
-		}
-
-		strncat(values[i_settlement_cash_due_date], "}", length_scdd--);
-		if (length_scdd < 0) {
-			FAIL_FRAME("settlement_cash_due_date values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_settlement_cash_type], "}", length_sct--);
-		if (length_sct < 0) {
-			FAIL_FRAME("settlement_cash_type values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_amount], "}", length_cta--);
-		if (length_cta < 0) {
-			FAIL_FRAME("cash_transaction_amount values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_dts], "}", length_ctd--);
-		if (length_ctd < 0) {
-			FAIL_FRAME("cash_transaction_dts values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_name], "}", length_ctn--);
-		if (length_ctn < 0) {
-			FAIL_FRAME("cash_transaction_name values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_dts], "}", length_thd--);
-		if (length_thd < 0) {
-			FAIL_FRAME("trade_history_dts values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_status_id], "}", length_thsi--);
-		if (length_thsi < 0) {
-			FAIL_FRAME("trade_history_status_id values needs to be increased");
-		}
-
-		snprintf(values[i_num_found], INTEGER_LEN + 1, "%d", num_found);
-		snprintf(values[i_num_updated], INTEGER_LEN + 1, "%d", num_updated);
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
+		set_frame_value(&values, i_num_found, Int32GetDatum(num_found), false);
+		set_frame_value(
+				&values, i_num_updated, Int32GetDatum(num_updated), false);
 
 		MemoryContextSwitchTo(oldcontext);
 	}
@@ -1895,22 +881,19 @@ TradeUpdateFrame2(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 15; i++) {
-			elog(DEBUG1, "TUF2 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TUF2", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 
@@ -1927,14 +910,13 @@ Datum
 TradeUpdateFrame3(PG_FUNCTION_ARGS)
 {
 	FuncCallContext *funcctx;
-	AttInMetadata *attinmeta;
 	int call_cntr;
 	int max_calls;
 
 	int i;
 	int j;
 
-	char **values = NULL;
+	frame_result values;
 
 	/* Stuff done only on the first call of the function. */
 	if (SRF_IS_FIRSTCALL()) {
@@ -1971,33 +953,28 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 		int max_trades = PG_GETARG_INT32(2);
 		int max_updates = PG_GETARG_INT32(3);
 		Timestamp start_trade_dts_ts = PG_GETARG_TIMESTAMP(4);
-		char *symbol_p = (char *) PG_GETARG_TEXT_P(5);
+		text *symbol_p = PG_GETARG_TEXT_P(5);
 
 		int ret;
 		TupleDesc tupdesc;
 		SPITupleTable *tuptable = NULL;
 		HeapTuple tuple = NULL;
 
+#ifdef DEBUG
 		struct pg_tm tt, *tm = &tt;
 		fsec_t fsec;
 		char *tzn = NULL;
-		Datum args[4];
-		char nulls[4] = { ' ', ' ', ' ', ' ' };
-
 		char symbol[S_SYMB_LEN + 1];
 		char end_trade_dts[MAXDATELEN + 1];
 		char start_trade_dts[MAXDATELEN + 1];
+#endif /* DEBUG */
+		Datum args[4];
+		char nulls[4] = { ' ', ' ', ' ', ' ' };
 
 		int num_found;
 		int num_updated = 0;
-		int num_cash = 0;
-
-		char *tmp;
-		int length_ai, length_ic, length_cta, length_ctd, length_ctn,
-				length_en, length_p, length_q, length_sa, length_scdd,
-				length_sct, length_sn, length_td, length_thd, length_thsi,
-				length_tl, length_tn, length_tt;
 
+#ifdef DEBUG
 		strncpy(symbol,
 				DatumGetCString(DirectFunctionCall1(
 						textout, PointerGetDatum(symbol_p))),
@@ -2010,85 +987,12 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 			EncodeDateTimeM(tm, fsec, tzn, start_trade_dts);
 		}
 
-#ifdef DEBUG
 		dump_tuf3_inputs(end_trade_dts, max_acct_id, max_trades, max_updates,
 				start_trade_dts, symbol);
 #endif
 
-		/*
-		 * Prepare a values array for building the returned tuple.
-		 * This should be an array of C strings, which will
-		 * be processed later by the type input functions.
-		 * Don't forget to factor in commas (,) and braces ({}) for the arrays.
-		 */
-		values = (char **) palloc(sizeof(char *) * 20);
-
-		length_ai = BIGINT_LEN * 20 + 22;
-		values[i_acct_id] = (char *) palloc(length_ai-- * sizeof(char));
-
-		length_cta = VALUE_T_LEN * 20 + 22;
-		values[i_cash_transaction_amount]
-				= (char *) palloc(length_cta-- * sizeof(char));
-
-		length_ctd = (MAXDATELEN + 2) * 20 + 22;
-		values[i_cash_transaction_dts]
-				= (char *) palloc(length_ctd-- * sizeof(char));
-
-		length_ctn = (CT_NAME_LEN + 2) * 20 + 22;
-		values[i_cash_transaction_name]
-				= (char *) palloc(length_ctn-- * sizeof(char));
-
-		length_en = (T_EXEC_NAME_LEN + 2) * 20 + 22;
-		values[i_exec_name] = (char *) palloc(length_en-- * sizeof(char));
-
-		length_ic = SMALLINT_LEN * 20 + 22;
-		values[i_is_cash] = (char *) palloc(length_ic-- * sizeof(char));
-
-		values[i_num_found]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-		values[i_num_updated]
-				= (char *) palloc((INTEGER_LEN + 1) * sizeof(char));
-
-		length_p = S_PRICE_T_LEN * 20 + 22;
-		values[i_price] = (char *) palloc(length_p-- * sizeof(char));
-
-		length_q = INTEGER_LEN * 20 + 22;
-		values[i_quantity] = (char *) palloc(length_q-- * sizeof(char));
-
-		length_sn = (S_NAME_LEN + 2) * 20 + 22;
-		values[i_s_name] = (char *) palloc(length_sn-- * sizeof(char));
-
-		length_sa = VALUE_T_LEN * 20 + 22;
-		values[i_settlement_amount]
-				= (char *) palloc(length_sa-- * sizeof(char));
-
-		length_scdd = MAXDATELEN * 20 + 22;
-		values[i_settlement_cash_due_date]
-				= (char *) palloc(length_scdd-- * sizeof(char));
-
-		length_sct = (SE_CASH_TYPE_LEN + 2) * 20 + 22;
-		values[i_settlement_cash_type]
-				= (char *) palloc(length_sct-- * sizeof(char));
-
-		length_td = (MAXDATELEN + 1) * 20 + 2;
-		values[i_trade_dts] = (char *) palloc(length_td-- * sizeof(char));
-
-		length_thd = (MAXDATELEN + 2) * 60 + 62;
-		values[i_trade_history_dts]
-				= (char *) palloc(length_thd-- * sizeof(char));
-
-		length_thsi = ST_ID_LEN * 60 + 62;
-		values[i_trade_history_status_id]
-				= (char *) palloc(length_thsi-- * sizeof(char));
-
-		length_tl = BIGINT_LEN * 20 + 22;
-		values[i_trade_list] = (char *) palloc(length_tl-- * sizeof(char));
-
-		length_tn = (TT_NAME_LEN + 2) * 20 + 22;
-		values[i_type_name] = (char *) palloc(length_tn-- * sizeof(char));
-
-		length_tt = TT_ID_LEN * 20 + 22;
-		values[i_trade_type] = (char *) palloc(length_tt-- * sizeof(char));
+		/* Prepare the Datums for building the returned tuple. */
+		init_frame_result(fcinfo, &values);
 
 		/* create a function context for cross-call persistence */
 		funcctx = SRF_FIRSTCALL_INIT();
@@ -2102,7 +1006,7 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 #ifdef DEBUG
 		elog(DEBUG1, "%s", SQLTUF3_1);
 #endif /* DEBUG */
-		args[0] = CStringGetTextDatum(symbol);
+		args[0] = PointerGetDatum(symbol_p);
 		args[1] = TimestampGetDatum(start_trade_dts_ts);
 		args[2] = TimestampGetDatum(end_trade_dts_ts);
 		args[3] = Int32GetDatum(max_trades);
@@ -2119,281 +1023,37 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 
 		num_found = SPI_processed;
 
-		values[i_acct_id][0] = '{';
-		values[i_acct_id][1] = '\0';
-
-		values[i_cash_transaction_amount][0] = '{';
-		values[i_cash_transaction_amount][1] = '\0';
-
-		values[i_cash_transaction_dts][0] = '{';
-		values[i_cash_transaction_dts][1] = '\0';
-
-		values[i_cash_transaction_name][0] = '{';
-		values[i_cash_transaction_name][1] = '\0';
-
-		values[i_exec_name][0] = '{';
-		values[i_exec_name][1] = '\0';
-
-		values[i_is_cash][0] = '{';
-		values[i_is_cash][1] = '\0';
-
-		values[i_price][0] = '{';
-		values[i_price][1] = '\0';
-
-		values[i_quantity][0] = '{';
-		values[i_quantity][1] = '\0';
-
-		values[i_s_name][0] = '{';
-		values[i_s_name][1] = '\0';
-
-		values[i_settlement_amount][0] = '{';
-		values[i_settlement_amount][1] = '\0';
-
-		values[i_settlement_cash_due_date][0] = '{';
-		values[i_settlement_cash_due_date][1] = '\0';
-
-		values[i_settlement_cash_type][0] = '{';
-		values[i_settlement_cash_type][1] = '\0';
-
-		values[i_trade_dts][0] = '{';
-		values[i_trade_dts][1] = '\0';
-
-		values[i_trade_history_dts][0] = '{';
-		values[i_trade_history_dts][1] = '\0';
-
-		values[i_trade_history_status_id][0] = '{';
-		values[i_trade_history_status_id][1] = '\0';
-
-		values[i_trade_list][0] = '{';
-		values[i_trade_list][1] = '\0';
-
-		values[i_type_name][0] = '{';
-		values[i_type_name][1] = '\0';
-
-		values[i_trade_type][0] = '{';
-		values[i_trade_type][1] = '\0';
-
 		for (i = 0; i < num_found; i++) {
 			TupleDesc l_tupdesc;
 			SPITupleTable *l_tuptable = NULL;
 			HeapTuple l_tuple = NULL;
 
-			char *is_cash_str;
-			char *trade_list;
-			char *old_ct_name;
-			char *quantity;
-			char *s_name;
-			char *type_name;
-			char ct_name[CT_NAME_LEN + 1];
-			char *price;
+			bool is_cash;
+			bool isnull;
+			Datum trade_list;
 
 			tuple = tuptable->vals[i];
 
-			if (i > 0) {
-				strncat(values[i_acct_id], ",", length_ai--);
-				if (length_ai < 0) {
-					FAIL_FRAME("acct_id values needs to be increased");
-				}
+			push_frame_spi(&values, i_acct_id, tuple, tupdesc, 1);
+			push_frame_spi(&values, i_exec_name, tuple, tupdesc, 2);
 
-				strncat(values[i_exec_name], ",", length_en--);
-				if (length_en < 0) {
-					FAIL_FRAME("exec_name values needs to be increased");
-				}
+			is_cash = DatumGetBool(SPI_getbinval(tuple, tupdesc, 3, &isnull));
+			push_frame_value(&values, i_is_cash, Int16GetDatum(is_cash), false);
 
-				strncat(values[i_is_cash], ",", length_ic--);
-				if (length_ic < 0) {
-					FAIL_FRAME("is_cash values needs to be increased");
-				}
+			push_frame_spi(&values, i_price, tuple, tupdesc, 4);
+			push_frame_spi(&values, i_quantity, tuple, tupdesc, 5);
+			push_frame_spi(&values, i_s_name, tuple, tupdesc, 6);
+			push_frame_spi(&values, i_trade_dts, tuple, tupdesc, 7);
 
-				strncat(values[i_price], ",", length_p--);
-				if (length_p < 0) {
-					FAIL_FRAME("price values needs to be increased");
-				}
-
-				strncat(values[i_quantity], ",", length_q--);
-				if (length_q < 0) {
-					FAIL_FRAME("quantity values needs to be increased");
-				}
-
-				strncat(values[i_s_name], ",", length_sn--);
-				if (length_sn < 0) {
-					FAIL_FRAME("s_name values needs to be increased");
-				}
-
-				strncat(values[i_trade_dts], ",", length_td--);
-				if (length_td < 0) {
-					FAIL_FRAME("trade_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_list], ",", length_tl--);
-				if (length_tl < 0) {
-					FAIL_FRAME("trade_list values needs to be increased");
-				}
-
-				strncat(values[i_trade_type], ",", length_tt--);
-				if (length_tt < 0) {
-					FAIL_FRAME("trade_type values needs to be increased");
-				}
-
-				strncat(values[i_type_name], ",", length_tn--);
-				if (length_tn < 0) {
-					FAIL_FRAME("type_name values needs to be increased");
-				}
-
-				strncat(values[i_settlement_amount], ",", length_sa--);
-				if (length_sa < 0) {
-					FAIL_FRAME(
-							"settlement_amount values needs to be increased");
-				}
-
-				strncat(values[i_settlement_cash_due_date], ",",
-						length_scdd--);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], ",", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_trade_history_dts], ",", length_thd--);
-				if (length_thd < 0) {
-					FAIL_FRAME(
-							"trade_history_dts values needs to be increased");
-				}
-
-				strncat(values[i_trade_history_status_id], ",", length_thsi--);
-				if (length_thsi < 0) {
-					FAIL_FRAME("trade_history_status_id values needs to be "
-							   "increased");
-				}
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 1);
-			strncat(values[i_acct_id], tmp, length_ai);
-			length_ai -= strlen(tmp);
-			if (length_ai < 0) {
-				FAIL_FRAME("acct_id values needs to be increased");
-			}
-
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 2);
-			strncat(values[i_exec_name], tmp, length_en);
-			length_en -= strlen(tmp);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			strncat(values[i_exec_name], "\"", length_en--);
-			if (length_en < 0) {
-				FAIL_FRAME("exec_name values needs to be increased");
-			}
-
-			is_cash_str = SPI_getvalue(tuple, tupdesc, 3);
-			if (is_cash_str[0] == 't') {
-				strncat(values[i_is_cash], "1", length_ic--);
-			} else {
-				strncat(values[i_is_cash], "0", length_ic--);
-			}
-			if (length_ic < 0) {
-				FAIL_FRAME("is_cash values needs to be increased");
-			}
-
-			price = SPI_getvalue(tuple, tupdesc, 4);
-			if (price == NULL) {
-				strncat(values[i_price], "NULL", length_p);
-				length_p -= 4;
-			} else {
-				strncat(values[i_price], price, length_p);
-				length_p -= strlen(price);
-			}
-			if (length_p < 0) {
-				FAIL_FRAME("price values needs to be increased");
-			}
-
-			quantity = SPI_getvalue(tuple, tupdesc, 5);
-			strncat(values[i_quantity], quantity, length_q);
-			length_q -= strlen(quantity);
-			if (length_q < 0) {
-				FAIL_FRAME("quantity values needs to be increased");
-			}
-
-			strncat(values[i_s_name], "\"", length_sn--);
-			if (length_sn < 0) {
-				FAIL_FRAME("s_name values needs to be increased");
-			}
-
-			s_name = SPI_getvalue(tuple, tupdesc, 6);
-			strncat(values[i_s_name], s_name, length_sn);
-			length_sn -= strlen(s_name);
-			if (length_sn < 0) {
-				FAIL_FRAME("s_name values needs to be increased");
-			}
-
-			strncat(values[i_s_name], "\"", length_sn--);
-			if (length_sn < 0) {
-				FAIL_FRAME("s_name values needs to be increased");
-			}
-
-			strncat(values[i_trade_dts], "\"", length_td--);
-			if (length_td < 0) {
-				FAIL_FRAME("trade_dts values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 7);
-			strncat(values[i_trade_dts], tmp, length_td);
-			length_td -= strlen(tmp);
-			if (length_td < 0) {
-				FAIL_FRAME("trade_dts values needs to be increased");
-			}
-
-			strncat(values[i_trade_dts], "\"", length_td--);
-			if (length_td < 0) {
-				FAIL_FRAME("trade_dts values needs to be increased");
-			}
-
-			trade_list = SPI_getvalue(tuple, tupdesc, 8);
-			strncat(values[i_trade_list], trade_list, length_tl);
-			length_tl -= strlen(trade_list);
-			if (length_tl < 0) {
-				FAIL_FRAME("trade_list values needs to be increased");
-			}
-
-			tmp = SPI_getvalue(tuple, tupdesc, 9);
-			strncat(values[i_trade_type], tmp, length_tt);
-			length_tt -= strlen(tmp);
-			if (length_tt < 0) {
-				FAIL_FRAME("trade_type values needs to be increased");
-			}
-
-			strncat(values[i_type_name], "\"", length_tn--);
-			if (length_tn < 0) {
-				FAIL_FRAME("type_name values needs to be increased");
-			}
-
-			type_name = SPI_getvalue(tuple, tupdesc, 10);
-			strncat(values[i_type_name], type_name, length_tn);
-			length_tn -= strlen(type_name);
-			if (length_tn < 0) {
-				FAIL_FRAME("type_name values needs to be increased");
-			}
-
-			strncat(values[i_type_name], "\"", length_tn--);
-			if (length_tn < 0) {
-				FAIL_FRAME("type_name values needs to be increased");
-			}
+			trade_list = SPI_getbinval(tuple, tupdesc, 8, &isnull);
+			push_frame_spi(&values, i_trade_list, tuple, tupdesc, 8);
+			push_frame_spi(&values, i_trade_type, tuple, tupdesc, 9);
+			push_frame_spi(&values, i_type_name, tuple, tupdesc, 10);
 
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTUF3_2);
 #endif /* DEBUG */
-			args[0] = Int64GetDatum(atoll(trade_list));
+			args[0] = trade_list;
 			ret = SPI_execute_plan(TUF3_2, args, nulls, true, 0);
 			if (ret != SPI_OK_SELECT) {
 				FAIL_FRAME_SET(&funcctx->max_calls, TUF3_statements[1].sql);
@@ -2402,49 +1062,25 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 
 			l_tupdesc = SPI_tuptable->tupdesc;
 			l_tuptable = SPI_tuptable;
-
 			for (j = 0; j < SPI_processed; j++) {
 				l_tuple = l_tuptable->vals[j];
 
-				tmp = SPI_getvalue(l_tuple, l_tupdesc, 1);
-				strncat(values[i_settlement_amount], tmp, length_sa);
-				length_sa -= strlen(tmp);
-				if (length_sa < 0) {
-					FAIL_FRAME(
-							"settlement_amount values needs to be increased");
-				}
-
-				tmp = SPI_getvalue(l_tuple, l_tupdesc, 2);
-				strncat(values[i_settlement_cash_due_date], tmp, length_scdd);
-				length_scdd -= strlen(tmp);
-				if (length_scdd < 0) {
-					FAIL_FRAME("settlement_cash_due_date values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				tmp = SPI_getvalue(l_tuple, l_tupdesc, 3);
-				strncat(values[i_settlement_cash_type], tmp, length_sct);
-				length_sct -= strlen(tmp);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_settlement_cash_type], "\"", length_sct--);
-				if (length_sct < 0) {
-					FAIL_FRAME("settlement_cash_type values needs to be "
-							   "increased");
-				}
+				push_frame_spi(
+						&values, i_settlement_amount, l_tuple, l_tupdesc, 1);
+				push_frame_spi(&values, i_settlement_cash_due_date, l_tuple,
+						l_tupdesc, 2);
+				push_frame_spi(&values, i_settlement_cash_type, l_tuple,
+						l_tupdesc, 3);
 			}
 
-			if (is_cash_str[0] == 't') {
+			if (is_cash) {
 				if (num_updated < max_updates) {
+					char *old_ct_name;
+					char ct_name[CT_NAME_LEN + 1];
+					char *quantity;
+					char *s_name;
+					char *type_name;
+
 #ifdef DEBUG
 					elog(DEBUG1, "%s", SQLTUF3_3);
 #endif /* DEBUG */
@@ -2460,6 +1096,10 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 						continue;
 					}
 
+					/* The new name is built from the trade's text form. */
+					quantity = SPI_getvalue(tuple, tupdesc, 5);
+					s_name = SPI_getvalue(tuple, tupdesc, 6);
+					type_name = SPI_getvalue(tuple, tupdesc, 10);
 					if (strstr(old_ct_name, " shares of ")) {
 						snprintf(ct_name, sizeof(ct_name),
 								"%s %s Shares of %s", type_name, quantity,
@@ -2474,13 +1114,14 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 					elog(DEBUG1, "%s", SQLTUF3_4);
 #endif /* DEBUG */
 					args[0] = CStringGetTextDatum(ct_name);
-					args[1] = Int64GetDatum(atoll(trade_list));
+					args[1] = trade_list;
 					ret = SPI_execute_plan(TUF3_4, args, nulls, false, 0);
 					if (ret != SPI_OK_UPDATE) {
 						FAIL_FRAME_SET(
 								&funcctx->max_calls, TUF3_statements[3].sql);
 						continue;
 					}
+
 					num_updated += SPI_processed;
 				}
 
@@ -2491,144 +1132,38 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 				 * read_only must be false to see the cash_transaction
 				 * row updated earlier in this call.
 				 */
-				args[0] = Int64GetDatum(atoll(trade_list));
+				args[0] = trade_list;
 				ret = SPI_execute_plan(TUF3_5, args, nulls, false, 0);
 				if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 					l_tupdesc = SPI_tuptable->tupdesc;
 					l_tuptable = SPI_tuptable;
 					l_tuple = l_tuptable->vals[0];
 
-					if (num_cash > 0) {
-						strncat(values[i_cash_transaction_amount], ",",
-								length_cta--);
-						if (length_cta < 0) {
-							FAIL_FRAME("cash_transaction_amount values needs "
-									   "to be increased");
-						}
-
-						strncat(values[i_cash_transaction_dts], ",",
-								length_ctd--);
-						if (length_ctd < 0) {
-							FAIL_FRAME("cash_transaction_dts values needs to "
-									   "be increased");
-						}
-
-						strncat(values[i_cash_transaction_name], ",",
-								length_ctn--);
-						if (length_ctn < 0) {
-							FAIL_FRAME("cash_transaction_name values needs to "
-									   "be increased");
-						}
-					}
-
-					tmp = SPI_getvalue(l_tuple, l_tupdesc, 1);
-					strncat(values[i_cash_transaction_amount], tmp,
-							length_cta);
-					length_cta -= strlen(tmp);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					tmp = SPI_getvalue(l_tuple, l_tupdesc, 2);
-					strncat(values[i_cash_transaction_dts], tmp, length_ctd);
-					length_ctd -= strlen(tmp);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], "\"",
-							length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					tmp = SPI_getvalue(l_tuple, l_tupdesc, 3);
-					strncat(values[i_cash_transaction_name], tmp, length_ctn);
-					length_ctn -= strlen(tmp);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], "\"",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-
-					++num_cash;
+					push_frame_spi(&values, i_cash_transaction_amount,
+							l_tuple, l_tupdesc, 1);
+					push_frame_spi(&values, i_cash_transaction_dts, l_tuple,
+							l_tupdesc, 2);
+					push_frame_spi(&values, i_cash_transaction_name, l_tuple,
+							l_tupdesc, 3);
 				} else {
 					FAIL_FRAME_SET(
 							&funcctx->max_calls, TUF3_statements[4].sql);
 					continue;
 				}
 			} else {
-				if (num_cash > 0) {
-					strncat(values[i_cash_transaction_amount], ",",
-							length_cta--);
-					if (length_cta < 0) {
-						FAIL_FRAME("cash_transaction_amount values needs to "
-								   "be increased");
-					}
-
-					strncat(values[i_cash_transaction_dts], ",", length_ctd--);
-					if (length_ctd < 0) {
-						FAIL_FRAME("cash_transaction_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_cash_transaction_name], ",",
-							length_ctn--);
-					if (length_ctn < 0) {
-						FAIL_FRAME("cash_transaction_name values needs to be "
-								   "increased");
-					}
-				}
-				strncat(values[i_cash_transaction_amount], "0", length_cta--);
-				if (length_cta < 0) {
-					FAIL_FRAME("cash_transaction_amount values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_dts], "NULL", length_ctd);
-				length_ctd -= 4;
-				if (length_ctd < 0) {
-					FAIL_FRAME("cash_transaction_dts values needs to be "
-							   "increased");
-				}
-
-				strncat(values[i_cash_transaction_name], "\"\"", length_ctn);
-				length_ctn -= 2;
-				if (length_ctn < 0) {
-					FAIL_FRAME("cash_transaction_name values needs to be "
-							   "increased");
-				}
-
-				++num_cash;
+				push_frame_value(&values, i_cash_transaction_amount,
+						DirectFunctionCall1(int4_numeric, Int32GetDatum(0)),
+						false);
+				push_frame_value(
+						&values, i_cash_transaction_dts, (Datum) 0, true);
+				push_frame_value(&values, i_cash_transaction_name,
+						CStringGetTextDatum(""), false);
 			}
 
 #ifdef DEBUG
 			elog(DEBUG1, "%s", SQLTUF3_6);
 #endif /* DEBUG */
-			args[0] = Int64GetDatum(atoll(trade_list));
+			args[0] = trade_list;
 			ret = SPI_execute_plan(TUF3_6, args, nulls, true, 0);
 			if (ret == SPI_OK_SELECT && SPI_processed > 0) {
 				l_tupdesc = SPI_tuptable->tupdesc;
@@ -2639,168 +1174,25 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 			}
 
 			for (j = 0; j < 3; j++) {
-				if (j > 0) {
-					strncat(values[i_trade_history_dts], ",", length_thd--);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], ",",
-							length_thsi--);
-					if (length_thsi < 0) {
-						FAIL_FRAME("trade_history_status_id values needs to "
-								   "be increased");
-					}
-				}
 				if (j < SPI_processed) {
 					l_tuple = l_tuptable->vals[j];
 
-					tmp = SPI_getvalue(l_tuple, l_tupdesc, 1);
-					strncat(values[i_trade_history_dts], tmp, length_thd);
-					length_thd -= strlen(tmp);
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					tmp = SPI_getvalue(l_tuple, l_tupdesc, 2);
-					strncat(values[i_trade_history_status_id], tmp,
-							length_thsi);
-					length_thsi -= strlen(tmp);
-					if (length_thsi < 0) {
-						FAIL_FRAME("trade_history_status_id values needs to "
-								   "be increased");
-					}
+					push_frame_spi(&values, i_trade_history_dts, l_tuple,
+							l_tupdesc, 1);
+					push_frame_spi(&values, i_trade_history_status_id,
+							l_tuple, l_tupdesc, 2);
 				} else {
-					strncat(values[i_trade_history_dts], "NULL", length_thd);
-					length_thd -= 4;
-					if (length_thd < 0) {
-						FAIL_FRAME("trade_history_dts values needs to be "
-								   "increased");
-					}
-
-					strncat(values[i_trade_history_status_id], "NULL",
-							length_thsi);
-					length_thsi -= 4;
-					if (length_thsi < 0) {
-						FAIL_FRAME("trade_history_status_id values needs to "
-								   "be increased");
-					}
+					push_frame_value(
+							&values, i_trade_history_dts, (Datum) 0, true);
+					push_frame_value(&values, i_trade_history_status_id,
+							(Datum) 0, true);
 				}
 			}
 		}
 
-		strncat(values[i_acct_id], "}", length_ai--);
-		if (length_ai < 0) {
-			FAIL_FRAME("acct_id values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_amount], "}", length_cta--);
-		if (length_cta < 0) {
-			FAIL_FRAME("cash_transaction_amount values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_dts], "}", length_ctd--);
-		if (length_ctd < 0) {
-			FAIL_FRAME("cash_transaction_dts values needs to be increased");
-		}
-
-		strncat(values[i_cash_transaction_name], "}", length_ctn--);
-		if (length_ctn < 0) {
-			FAIL_FRAME("cash_transaction_name values needs to be increased");
-		}
-
-		strncat(values[i_exec_name], "}", length_en--);
-		if (length_en < 0) {
-			FAIL_FRAME("exec_name values needs to be increased");
-		}
-
-		strncat(values[i_is_cash], "}", length_ic--);
-		if (length_ic < 0) {
-			FAIL_FRAME("is_cash values needs to be increased");
-		}
-
-		strncat(values[i_price], "}", length_p--);
-		if (length_p < 0) {
-			FAIL_FRAME("price values needs to be increased");
-		}
-
-		strncat(values[i_quantity], "}", length_q--);
-		if (length_q < 0) {
-			FAIL_FRAME("quantity values needs to be increased");
-		}
-
-		strncat(values[i_s_name], "}", length_sn--);
-		if (length_sn < 0) {
-			FAIL_FRAME("s_name values needs to be increased");
-		}
-
-		strncat(values[i_settlement_amount], "}", length_sa--);
-		if (length_sa < 0) {
-			FAIL_FRAME("settlement_amount values needs to be increased");
-		}
-
-		strncat(values[i_settlement_cash_due_date], "}", length_scdd--);
-		if (length_scdd < 0) {
-			FAIL_FRAME(
-					"settlement_cash_due_date values needs to be increased");
-		}
-
-		strncat(values[i_settlement_cash_type], "}", length_sct--);
-		if (length_sct < 0) {
-			FAIL_FRAME("settlement_cash_type values needs to be "
-					   "increased");
-		}
-
-		strncat(values[i_trade_dts], "}", length_td);
-		if (length_td < 0) {
-			FAIL_FRAME("trade_dts values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_dts], "}", length_thd--);
-		if (length_thd < 0) {
-			FAIL_FRAME("trade_history_dts values needs to be increased");
-		}
-
-		strncat(values[i_trade_history_status_id], "}", length_thsi--);
-		if (length_thsi < 0) {
-			FAIL_FRAME("trade_history_status_id values needs to be increased");
-		}
-
-		strncat(values[i_trade_list], "}", length_tl--);
-		if (length_tl < 0) {
-			FAIL_FRAME("trade_list values needs to be increased");
-		}
-
-		strncat(values[i_type_name], "}", length_tn--);
-		if (length_tn < 0) {
-			FAIL_FRAME("type_name values needs to be increased");
-		}
-
-		strncat(values[i_trade_type], "}", length_tt--);
-		if (length_tt < 0) {
-			FAIL_FRAME("trade_type values needs to be increased");
-		}
-
-		snprintf(values[i_num_found], INTEGER_LEN + 1, "%d", num_found);
-		snprintf(values[i_num_updated], INTEGER_LEN + 1, "%d", num_updated);
-
-		/* Build a tuple descriptor for our result type */
-		if (get_call_result_type(fcinfo, NULL, &tupdesc)
-				!= TYPEFUNC_COMPOSITE) {
-			ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-								   errmsg("function returning record called "
-										  "in context "
-										  "that cannot accept type record")));
-		}
-
-		/*
-		 * generate attribute metadata needed later to produce tuples from raw
-		 * C strings
-		 */
-		attinmeta = TupleDescGetAttInMetadata(tupdesc);
-		funcctx->attinmeta = attinmeta;
+		set_frame_value(&values, i_num_found, Int32GetDatum(num_found), false);
+		set_frame_value(
+				&values, i_num_updated, Int32GetDatum(num_updated), false);
 
 		MemoryContextSwitchTo(oldcontext);
 	}
@@ -2810,22 +1202,19 @@ TradeUpdateFrame3(PG_FUNCTION_ARGS)
 
 	call_cntr = funcctx->call_cntr;
 	max_calls = funcctx->max_calls;
-	attinmeta = funcctx->attinmeta;
 
 	if (call_cntr < max_calls) {
 		/* do when there is more left to send */
 		HeapTuple tuple;
 		Datum result;
 
+		/* Build a tuple. */
+		tuple = build_frame_tuple(&values);
+
 #ifdef DEBUG
-		for (i = 0; i < 20; i++) {
-			elog(DEBUG1, "TUF3 OUT: %d %s", i, values[i]);
-		}
+		dump_frame_result("TUF3", &values);
 #endif /* DEBUG */
 
-		/* Build a tuple. */
-		tuple = BuildTupleFromCStrings(attinmeta, values);
-
 		/* Make the tuple into a datum. */
 		result = HeapTupleGetDatum(tuple);
 